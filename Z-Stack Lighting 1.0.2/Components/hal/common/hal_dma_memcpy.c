@@ -0,0 +1,108 @@
+/**************************************************************************************************
+  Filename:       hal_dma_memcpy.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Block copies with the memory-to-memory DMA channel.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include "hal_types.h"
+#include "hal_defs.h"
+#include "hal_board_cfg.h"
+#include "hal_dma.h"
+#include "hal_mcu.h"
+
+#if ((defined HAL_DMA) && (HAL_DMA == TRUE)) && (defined HAL_DMA_CH_MEM)
+
+/*********************************************************************
+ * GLOBAL FUNCTIONS
+ */
+
+/******************************************************************************
+ * @fn      HalDmaMemcpy
+ *
+ * @brief   Copy a block of XDATA with the memory-to-memory DMA channel.
+ *          The CPU is stalled for the length of the transfer, so the
+ *          channel is polled with interrupts held off. Shared by the
+ *          targets whose hal_board_cfg.h sets aside HAL_DMA_CH_MEM.
+ *
+ * @param   dst - destination address
+ * @param   src - source address, the last source byte for HAL_DMA_SRCINC_M1
+ * @param   len - number of bytes to copy, 1 to HAL_DMA_MAX_LEN
+ * @param   srcInc - HAL_DMA_SRCINC_1 to copy, HAL_DMA_SRCINC_M1 to reverse
+ *
+ * @return  None
+ *****************************************************************************/
+void HalDmaMemcpy( uint8 *dst, const uint8 *src, uint16 len, uint8 srcInc )
+{
+  halDMADesc_t *ch = HAL_DMA_GET_DESC1234( HAL_DMA_CH_MEM );
+  halIntState_t intState;
+
+  HAL_ENTER_CRITICAL_SECTION( intState );
+
+  HAL_DMA_SET_SOURCE( ch, src );
+  HAL_DMA_SET_DEST( ch, dst );
+  HAL_DMA_SET_VLEN( ch, HAL_DMA_VLEN_USE_LEN );
+  HAL_DMA_SET_LEN( ch, len );
+  HAL_DMA_SET_WORD_SIZE( ch, HAL_DMA_WORDSIZE_BYTE );
+  HAL_DMA_SET_TRIG_MODE( ch, HAL_DMA_TMODE_BLOCK );
+  HAL_DMA_SET_TRIG_SRC( ch, HAL_DMA_TRIG_NONE );
+  HAL_DMA_SET_SRC_INC( ch, srcInc );
+  HAL_DMA_SET_DST_INC( ch, HAL_DMA_DSTINC_1 );
+  HAL_DMA_SET_IRQ( ch, HAL_DMA_IRQMASK_DISABLE );
+  HAL_DMA_SET_M8( ch, HAL_DMA_M8_USE_8_BITS );
+  HAL_DMA_SET_PRIORITY( ch, HAL_DMA_PRI_HIGH );
+
+  HAL_DMA_ARM_CH( HAL_DMA_CH_MEM );
+  do
+  {
+    asm("NOP");
+  } while ( !HAL_DMA_CH_ARMED( HAL_DMA_CH_MEM ) );
+  HAL_DMA_CLEAR_IRQ( HAL_DMA_CH_MEM );
+  HAL_DMA_MAN_TRIGGER( HAL_DMA_CH_MEM );
+
+  while ( !HAL_DMA_CHECK_IRQ( HAL_DMA_CH_MEM ) );
+  HAL_DMA_CLEAR_IRQ( HAL_DMA_CH_MEM );
+
+  HAL_EXIT_CRITICAL_SECTION( intState );
+}
+
+#endif  // HAL_DMA && HAL_DMA_CH_MEM
+
+/*********************************************************************
+*********************************************************************/
@@ -73,13 +73,51 @@
 #include "hal_spi.h"
 #endif
 
+/**************************************************************************************************
+ *                                          CONSTANTS
+ **************************************************************************************************/
+
+#if HAL_CS_STATS || HAL_POLL_STATS
+#if defined HAL_MCU_HOST
+#define HAL_TIME_USEC()             ((uint16)halSimClockUs())
+#else
+#define HAL_TIME_USEC()             halTimeUsec()
+
+/* The MAC timer (Timer 2) runs at 32 MHz and overflows once per 320 us backoff period */
+#define HAL_TIME_TICKS_PER_USEC     32
+#define HAL_TIME_USEC_PER_OVF       320
+#endif
+#endif
+
 /**************************************************************************************************
  *                                      GLOBAL VARIABLES
  **************************************************************************************************/
 uint8 Hal_TaskID;
 
+#if HAL_POLL_PENDING
+volatile uint8 halUartPollPending;
+#endif
+
 extern void HalLedUpdate( void ); /* Notes: This for internal only so it shouldn't be in hal_led.h */
 
+/**************************************************************************************************
+ *                                      LOCAL VARIABLES
+ **************************************************************************************************/
+
+#if HAL_CS_STATS
+/* The section being timed - there can only be one, since interrupts are off until it ends */
+static const char *halCsFname;
+static uint16 halCsLnum;
+static uint16 halCsStart;
+
+static uint16 halCsHist[HAL_CS_STATS_BINS];
+static halCsSite_t halCsSites[HAL_CS_STATS_SITES];
+#endif
+
+#if HAL_POLL_STATS
+static halPollStats_t halPollStats;
+#endif
+
 /**************************************************************************************************
  * @fn      Hal_Init
  *
@@ -270,14 +308,33 @@ uint16 Hal_ProcessEvent( uint8 task_id, uint16 events )
  **************************************************************************************************/
 void Hal_ProcessPoll ()
 {
+#if HAL_POLL_STATS
+  uint16 start = HAL_TIME_USEC();
+
+  halPollStats.passes++;
+#endif
+
 #if defined( POWER_SAVING )
   /* Allow sleep before the next OSAL event loop */
   ALLOW_SLEEP_MODE();
 #endif
   
-  /* UART Poll */
+  /* UART Poll - the poll asks for the next one while it has work left. The USB UART has no
+   * interrupts to ask for it, so it is always polled.
+   */
 #if (defined HAL_UART) && (HAL_UART == TRUE)
-  HalUARTPoll();
+#if HAL_POLL_PENDING && !HAL_UART_USB
+  if (halUartPollPending)
+  {
+    halUartPollPending = FALSE;
+#else
+  {
+#endif
+#if HAL_POLL_STATS
+    halPollStats.uartPolls++;
+#endif
+    HalUARTPoll();
+  }
 #endif
   
   /* SPI Poll */
@@ -289,9 +346,238 @@ void Hal_ProcessPoll ()
 #if (defined HAL_HID) && (HAL_HID == TRUE)
   usbHidProcessEvents();
 #endif
+
+#if HAL_POLL_STATS
+  halPollStats.usec += (uint16)(HAL_TIME_USEC() - start);
+#endif
+
+  /* Host simulation: charge this pass to the virtual clock */
+#if (defined HAL_MCU_HOST)
+  halSimPoll();
+#endif
  
 }
 
+#if (HAL_CS_STATS || HAL_POLL_STATS) && !defined HAL_MCU_HOST
+/**************************************************************************************************
+ * @fn      halTimeUsec
+ *
+ * @brief   Read the MAC timer in microseconds.
+ *
+ * @param   None
+ *
+ * @return  Microseconds, modulo 2^16
+ **************************************************************************************************/
+static uint16 halTimeUsec( void )
+{
+  halIntState_t intState;
+  uint16 tick, ovf;
+  uint8 sel;
+
+  /* Reading T2M0 latches T2M1 and the overflow count */
+  HAL_ENTER_CRITICAL_SECTION(intState);
+  sel = T2MSEL;
+  T2MSEL = 0;
+  tick = T2M0;
+  tick |= (uint16)T2M1 << 8;
+  ovf = T2MOVF0;
+  ovf |= (uint16)T2MOVF1 << 8;
+  T2MSEL = sel;
+  HAL_EXIT_CRITICAL_SECTION(intState);
+
+  return ( (ovf * HAL_TIME_USEC_PER_OVF) + (tick / HAL_TIME_TICKS_PER_USEC) );
+}
+#endif
+
+#if HAL_CS_STATS
+/**************************************************************************************************
+ * @fn      halCsEnter
+ *
+ * @brief   Start timing a critical section. Called by HAL_ENTER_CRITICAL_SECTION() when it
+ *          disables the interrupts.
+ *
+ * @param   fname - file of the caller
+ * @param   lnum - line of the caller
+ *
+ * @return  None
+ **************************************************************************************************/
+void halCsEnter( const char *fname, uint16 lnum )
+{
+  halCsFname = fname;
+  halCsLnum = lnum;
+  halCsStart = HAL_TIME_USEC();
+}
+
+/**************************************************************************************************
+ * @fn      halCsExit
+ *
+ * @brief   Count the critical section that is ending into the histogram and into the entry of
+ *          its call site. A site that is not yet kept replaces the site with the shortest
+ *          longest section, if it took longer than that.
+ *          Called by HAL_EXIT_CRITICAL_SECTION() just before it enables the interrupts.
+ *
+ * @param   None
+ *
+ * @return  None
+ **************************************************************************************************/
+void halCsExit( void )
+{
+  uint16 dur = (uint16)(HAL_TIME_USEC() - halCsStart);
+  halCsSite_t *pSite, *pMin;
+  uint8 bin;
+
+  for (bin = 0; (bin < HAL_CS_STATS_BINS-1) && ((dur >> bin) != 0); bin++);
+  if (halCsHist[bin] != 0xFFFF)
+  {
+    halCsHist[bin]++;
+  }
+
+  pMin = halCsSites;
+  for (pSite = halCsSites; pSite < halCsSites+HAL_CS_STATS_SITES; pSite++)
+  {
+    if ((pSite->lnum == halCsLnum) && (pSite->fname == halCsFname))
+    {
+      break;
+    }
+    if ((pMin->cnt != 0) && ((pSite->cnt == 0) || (pSite->max < pMin->max)))
+    {
+      pMin = pSite;
+    }
+  }
+
+  if (pSite == halCsSites+HAL_CS_STATS_SITES)
+  {
+    if ((pMin->cnt != 0) && (dur <= pMin->max))
+    {
+      return;
+    }
+    pSite = pMin;
+    pSite->fname = halCsFname;
+    pSite->lnum = halCsLnum;
+    pSite->cnt = 0;
+    pSite->max = 0;
+  }
+
+  if (pSite->cnt != 0xFFFF)
+  {
+    pSite->cnt++;
+  }
+  if (dur > pSite->max)
+  {
+    pSite->max = dur;
+  }
+}
+#endif
+
+/**************************************************************************************************
+ * @fn      HalCsStatsGet
+ *
+ * @brief   Read the histogram of the time the interrupts were held off by critical sections.
+ *
+ * @param   pHist - buffer for HAL_CS_STATS_BINS counts, all zero without HAL_CS_STATS
+ *
+ * @return  None
+ **************************************************************************************************/
+void HalCsStatsGet( uint16 *pHist )
+{
+#if HAL_CS_STATS
+  halIntState_t intState;
+
+  HAL_ENTER_CRITICAL_SECTION(intState);
+  (void)osal_memcpy(pHist, halCsHist, sizeof(halCsHist));
+  HAL_EXIT_CRITICAL_SECTION(intState);
+#else
+  (void)osal_memset(pHist, 0, HAL_CS_STATS_BINS * sizeof(uint16));
+#endif
+}
+
+/**************************************************************************************************
+ * @fn      HalCsStatsSite
+ *
+ * @brief   Read the statistics of one of the critical section call sites that are kept.
+ *
+ * @param   idx - 0 to HAL_CS_STATS_SITES-1
+ * @param   pSite - buffer for the site
+ *
+ * @return  TRUE if there is a site at idx, FALSE otherwise
+ **************************************************************************************************/
+uint8 HalCsStatsSite( uint8 idx, halCsSite_t *pSite )
+{
+#if HAL_CS_STATS
+  halIntState_t intState;
+
+  if (idx < HAL_CS_STATS_SITES)
+  {
+    HAL_ENTER_CRITICAL_SECTION(intState);
+    *pSite = halCsSites[idx];
+    HAL_EXIT_CRITICAL_SECTION(intState);
+
+    return (pSite->cnt != 0);
+  }
+#else
+  (void)idx;
+  (void)pSite;
+#endif
+
+  return FALSE;
+}
+
+/**************************************************************************************************
+ * @fn      HalCsStatsReset
+ *
+ * @brief   Clear the critical section statistics.
+ *
+ * @param   None
+ *
+ * @return  None
+ **************************************************************************************************/
+void HalCsStatsReset( void )
+{
+#if HAL_CS_STATS
+  halIntState_t intState;
+
+  HAL_ENTER_CRITICAL_SECTION(intState);
+  (void)osal_memset(halCsHist, 0, sizeof(halCsHist));
+  (void)osal_memset(halCsSites, 0, sizeof(halCsSites));
+  HAL_EXIT_CRITICAL_SECTION(intState);
+#endif
+}
+
+/**************************************************************************************************
+ * @fn      HalPollStatsGet
+ *
+ * @brief   Read the count of passes through Hal_ProcessPoll(), how many of them polled the UART
+ *          and the time spent in it.
+ *
+ * @param   pStats - buffer for the statistics, all zero without HAL_POLL_STATS
+ *
+ * @return  None
+ **************************************************************************************************/
+void HalPollStatsGet( halPollStats_t *pStats )
+{
+#if HAL_POLL_STATS
+  *pStats = halPollStats;
+#else
+  (void)osal_memset(pStats, 0, sizeof(halPollStats_t));
+#endif
+}
+
+/**************************************************************************************************
+ * @fn      HalPollStatsReset
+ *
+ * @brief   Clear the poll statistics.
+ *
+ * @param   None
+ *
+ * @return  None
+ **************************************************************************************************/
+void HalPollStatsReset( void )
+{
+#if HAL_POLL_STATS
+  (void)osal_memset(&halPollStats, 0, sizeof(halPollStats));
+#endif
+}
+
 /**************************************************************************************************
 **************************************************************************************************/
 
@@ -68,12 +68,68 @@ extern "C"
 #define HAL_PWRMGR_CONSERVE_DELAY           10
 #define PERIOD_RSSI_RESET_TIMEOUT           10
 
+/* Set to TRUE to only poll the UART from Hal_ProcessPoll() after its interrupts or its API asked
+ * for it (see HAL_POLL_UART_SET()), rather than on every pass through the OSAL loop.
+ */
+#if !defined HAL_POLL_PENDING
+#define HAL_POLL_PENDING                    FALSE
+#endif
+
+/* Set to TRUE to count the passes through Hal_ProcessPoll() and the time spent in it */
+#if !defined HAL_POLL_STATS
+#define HAL_POLL_STATS                      FALSE
+#endif
+
+/* Critical section statistics (HAL_CS_STATS): bin n of the histogram counts the sections that held
+ * interrupts off for 2^(n-1) to 2^n-1 microseconds, the last bin counts all of the longer ones.
+ */
+#define HAL_CS_STATS_BINS                   12
+
+/* Number of call sites kept - the ones with the longest sections; at most 9 for MT_SYS_CS_STATS */
+#if !defined HAL_CS_STATS_SITES
+#define HAL_CS_STATS_SITES                  8
+#endif
+
+/**************************************************************************************************
+ * MACROS
+ **************************************************************************************************/
+
+/* Ask for the UART to be polled - may be used from an ISR */
+#if HAL_POLL_PENDING
+#define HAL_POLL_UART_SET()                 st( halUartPollPending = TRUE; )
+#else
+#define HAL_POLL_UART_SET()
+#endif
+
+/**************************************************************************************************
+ * TYPEDEFS
+ **************************************************************************************************/
+
+typedef struct
+{
+  uint32 passes;      // Calls of Hal_ProcessPoll()
+  uint32 uartPolls;   // Passes that polled the UART
+  uint32 usec;        // Time spent in Hal_ProcessPoll(), in microseconds
+} halPollStats_t;
+
+typedef struct
+{
+  const char *fname;  // File of the HAL_ENTER_CRITICAL_SECTION()
+  uint16 lnum;        // Line of the HAL_ENTER_CRITICAL_SECTION()
+  uint16 cnt;         // Number of times the section ran, stops at 0xFFFF
+  uint16 max;         // Longest time with interrupts off, in microseconds
+} halCsSite_t;
+
 /**************************************************************************************************
  * GLOBAL VARIABLES
  **************************************************************************************************/
 
 extern uint8 Hal_TaskID;
 
+#if HAL_POLL_PENDING
+extern volatile uint8 halUartPollPending;
+#endif
+
 /**************************************************************************************************
  * FUNCTIONS - API
  **************************************************************************************************/
@@ -95,6 +151,19 @@ extern void Hal_ProcessPoll (void);
  */
 extern void HalDriverInit (void);
 
+/*
+ * Critical section statistics
+ */
+extern void HalCsStatsGet( uint16 *pHist );
+extern uint8 HalCsStatsSite( uint8 idx, halCsSite_t *pSite );
+extern void HalCsStatsReset( void );
+
+/*
+ * Poll statistics
+ */
+extern void HalPollStatsGet( halPollStats_t *pStats );
+extern void HalPollStatsReset( void );
+
 #ifdef __cplusplus
 }
 #endif
@@ -46,6 +46,7 @@
 #include "hal_board.h"
 #include "hal_defs.h"
 #include "hal_dma.h"
+#include "hal_drivers.h"
 #include "hal_mcu.h"
 #include "hal_uart.h"
 #if defined MT_TASK
@@ -486,6 +487,8 @@ static void HalUARTOpenDMA(halUARTCfg_t *config)
   // Initialize that TX DMA is not pending
   dmaCfg.txDMAPending = FALSE;
   dmaCfg.txShdwValid = FALSE;
+
+  HAL_POLL_UART_SET();
 }
 
 /*****************************************************************************
@@ -579,6 +582,8 @@ static uint16 HalUARTWriteDMA(uint8 *buf, uint16 len)
     dmaCfg.txDMAPending = TRUE;
   }
   HAL_EXIT_CRITICAL_SECTION(his);
+
+  HAL_POLL_UART_SET();
   return cnt;
 }
 
@@ -711,6 +716,27 @@ static void HalUARTPollDMA(void)
   {
     dmaCfg.uartCB(HAL_UART_DMA-1, evt);
   }
+
+#if HAL_POLL_PENDING
+  // Keep polling while there is Rx data or Tx work left. Otherwise the next Rx byte or the
+  // Tx done DMA ISR restarts the polls.
+  if (HAL_UART_DMA_NEW_RX_BYTE(dmaCfg.rxHead) || dmaCfg.txShdwValid || dmaCfg.txDMAPending ||
+      dmaCfg.txIdx[dmaCfg.txSel])
+  {
+    HAL_POLL_UART_SET();
+  }
+  else
+  {
+    URXxIF = 0;
+    URXxIE = 1;
+
+    // A byte that came in before the Rx interrupt was enabled.
+    if (HAL_UART_DMA_NEW_RX_BYTE(dmaCfg.rxHead))
+    {
+      HAL_POLL_UART_SET();
+    }
+  }
+#endif
 }
 
 /**************************************************************************************************
@@ -773,6 +799,7 @@ static void HalUARTResumeDMA( void )
   UxUCR |= UCR_FLUSH;
   UxCSR |= CSR_RE;
   PxOUT &= ~HAL_UART_Px_RTS;  // Re-enable Rx flow.
+  HAL_POLL_UART_SET();
 }
 
 /******************************************************************************
@@ -803,7 +830,31 @@ void HalUARTIsrDMA(void)
     // UART TX DMA is expected to be fired
     dmaCfg.txDMAPending = TRUE;
   }
+
+  HAL_POLL_UART_SET();
 }
 
+#if HAL_POLL_PENDING
+/******************************************************************************
+ * @fn      halUartRxIsrDMA
+ *
+ * @brief   Rx interrupt, only enabled while the UART is not being polled. The
+ *          DMA still moves the byte; the ISR just restarts the polls.
+ *
+ * @param   none
+ *
+ * @return  none
+ *****************************************************************************/
+#if (HAL_UART_DMA == 1)
+HAL_ISR_FUNCTION( halUart0RxIsrDMA, URX0_VECTOR )
+#else
+HAL_ISR_FUNCTION( halUart1RxIsrDMA, URX1_VECTOR )
+#endif
+{
+  URXxIE = 0;
+  HAL_POLL_UART_SET();
+}
+#endif
+
 /******************************************************************************
 ******************************************************************************/
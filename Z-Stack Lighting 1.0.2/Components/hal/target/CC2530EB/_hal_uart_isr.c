@@ -45,6 +45,7 @@
 #include "hal_assert.h"
 #include "hal_board.h"
 #include "hal_defs.h"
+#include "hal_drivers.h"
 #include "hal_mcu.h"
 #include "hal_uart.h"
 #if defined MT_TASK
@@ -463,6 +464,12 @@ static void HalUARTPollISR(void)
     {
       isrCfg.uartCB(HAL_UART_ISR-1, evt);
     }
+
+    // Keep polling while there is Rx data left, the ISRs restart the polls otherwise.
+    if (HAL_UART_ISR_RX_AVAIL())
+    {
+      HAL_POLL_UART_SET();
+    }
   }
 }
 
@@ -540,6 +547,7 @@ HAL_ISR_FUNCTION( halUart1RxIsr, URX1_VECTOR )
   }
 
   isrCfg.rxTick = HAL_UART_ISR_IDLE;
+  HAL_POLL_UART_SET();
 }
 
 /***************************************************************************************************
@@ -561,6 +569,7 @@ HAL_ISR_FUNCTION( halUart1TxIsr, UTX1_VECTOR )
   {
     IEN2 &= ~UTXxIE;
     isrCfg.txMT = 1;
+    HAL_POLL_UART_SET();
   }
   else
   {
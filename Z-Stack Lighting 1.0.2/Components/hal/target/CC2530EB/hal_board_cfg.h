@@ -203,6 +203,7 @@
 
 // Used by DMA macros to shift 1 to create a mask for DMA registers.
 #define HAL_NV_DMA_CH              0
+#define HAL_DMA_CH_MEM             1
 #define HAL_DMA_CH_RX              3
 #define HAL_DMA_CH_TX              4
 
@@ -86,6 +86,10 @@ extern "C"
 
 #define HAL_DMA_CHECK_IRQ( ch )       (DMAIRQ & (0x01 << (ch)))
 
+// The DMA controller only reaches the XDATA space. A generic pointer keeps
+// its memory type in the upper byte, which is 0x00 for XDATA.
+#define HAL_DMA_XDATA_PTR( p )        (((uint32)(p) >> 16) == 0)
+
 // Macro for quickly setting the source address of a DMA structure.
 #define HAL_DMA_SET_SOURCE( pDesc, src ) \
   st( \
@@ -245,6 +249,7 @@ extern "C"
 #define HAL_DMA_PRI_ABSOLUTE     0x03 /* Highest, DMA has priority. Reserved for DMA port access.. */
 
 #define HAL_DMA_MAX_ARM_CLOCKS   45   // Maximum number of clocks required if arming all 5 at once.
+#define HAL_DMA_MAX_LEN          0x1FFF // Maximum transfer count of a single descriptor.
 
 /*********************************************************************
  * TYPEDEFS
@@ -289,6 +294,7 @@ extern halDMADesc_t dmaCh1234[4];
  */
 
 void HalDmaInit( void );
+void HalDmaMemcpy( uint8 *dst, const uint8 *src, uint16 len, uint8 srcInc );
 
 #endif  // #if (defined HAL_DMA) && (HAL_DMA == TRUE)
 
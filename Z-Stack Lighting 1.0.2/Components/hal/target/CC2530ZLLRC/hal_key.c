@@ -100,6 +100,11 @@
  **************************************************************************************************/
 #define HAL_KEY_DEBOUNCE_VALUE  25
 
+/* Repeat period of a held key and how late a repeat may come, so that
+ * it can share a wakeup with another timer */
+#define HAL_KEY_REPEAT_VALUE    200
+#define HAL_KEY_REPEAT_SLACK    50
+
 /**************************************************************************************************
  *                                            TYPEDEFS
  **************************************************************************************************/
@@ -306,7 +311,7 @@ void HalKeyPoll (void)
     {
       // In order to trigger callback again as far as the key is depressed,
       // timer is called here.
-      osal_start_timerEx(Hal_TaskID, HAL_KEY_EVENT, 200);
+      osal_start_timer_slack(Hal_TaskID, HAL_KEY_EVENT, HAL_KEY_REPEAT_VALUE, HAL_KEY_REPEAT_SLACK);
     }
     else
     {
@@ -52,6 +52,11 @@
  *                                             CONSTANTS
  ***************************************************************************************************/
 
+/* How late a blink step may come, so that it can share a wakeup with another timer */
+#if !defined HAL_LED_BLINK_SLACK
+#define HAL_LED_BLINK_SLACK   30
+#endif
+
 /***************************************************************************************************
  *                                              MACROS
  ***************************************************************************************************/
@@ -360,7 +365,7 @@ void HalLedUpdate (void)
 
     if (next)
     {
-      osal_start_timerEx(Hal_TaskID, HAL_LED_BLINK_EVENT, next);   /* Schedule event */
+      osal_start_timer_slack(Hal_TaskID, HAL_LED_BLINK_EVENT, next, HAL_LED_BLINK_SLACK);   /* Schedule event */
     }
   }
 }
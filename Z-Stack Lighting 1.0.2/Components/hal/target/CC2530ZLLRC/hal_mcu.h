@@ -95,13 +95,29 @@
  *                                        Interrupt Macros
  * ------------------------------------------------------------------------------------------------
  */
+
+/* Set to TRUE to measure how long interrupts are held off by each critical section. */
+#if !defined HAL_CS_STATS
+#define HAL_CS_STATS  FALSE
+#endif
+
 #define HAL_ENABLE_INTERRUPTS()         st( EA = 1; )
 #define HAL_DISABLE_INTERRUPTS()        st( EA = 0; )
 #define HAL_INTERRUPTS_ARE_ENABLED()    (EA)
 
 typedef unsigned char halIntState_t;
+#if HAL_CS_STATS
+/* Time the critical sections that start with interrupts enabled, keyed by the file and line
+ * of the HAL_ENTER_CRITICAL_SECTION() (see HalCsStatsGet() in hal_drivers.h).
+ */
+extern void halCsEnter( const char *fname, uint16 lnum );
+extern void halCsExit( void );
+#define HAL_ENTER_CRITICAL_SECTION(x)   st( x = EA;  HAL_DISABLE_INTERRUPTS(); if (x) halCsEnter(__FILE__, __LINE__); )
+#define HAL_EXIT_CRITICAL_SECTION(x)    st( if (x) halCsExit(); EA = x; )
+#else
 #define HAL_ENTER_CRITICAL_SECTION(x)   st( x = EA;  HAL_DISABLE_INTERRUPTS(); )
 #define HAL_EXIT_CRITICAL_SECTION(x)    st( EA = x; )
+#endif
 #define HAL_CRITICAL_STATEMENT(x)       st( halIntState_t _s; HAL_ENTER_CRITICAL_SECTION(_s); x; HAL_EXIT_CRITICAL_SECTION(_s); )
 
 #ifdef __IAR_SYSTEMS_ICC__
@@ -0,0 +1,168 @@
+/**************************************************************************************************
+  Filename:       hal_adc.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    ADC stubs for the host (x86-64 Linux) target: only the bus voltage check
+                  used by OSAL NV is simulated.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/* ------------------------------------------------------------------------------------------------
+ *                                          Includes
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#include "hal_adc.h"
+#include "hal_sim.h"
+#include "hal_types.h"
+
+/* ------------------------------------------------------------------------------------------------
+ *                                        Local Variables
+ * ------------------------------------------------------------------------------------------------
+ */
+
+/* Simulated bus voltage in the units of the board VDD_MIN_xxx constants. */
+static uint8 halSimVdd = 0xFF;
+
+/**************************************************************************************************
+ * @fn          halSimVddSet
+ *
+ * @brief       Set the simulated bus voltage, e.g. to exercise the low voltage paths of OSAL NV.
+ *
+ * input parameters
+ *
+ * @param       vdd - The board-specific Vdd reading to return to HalAdcCheckVdd().
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+void halSimVddSet( uint8 vdd )
+{
+  halSimVdd = vdd;
+}
+
+/**************************************************************************************************
+ * @fn          HalAdcInit
+ *
+ * @brief       Initialize ADC Service - nothing to do on the host.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+void HalAdcInit( void )
+{
+}
+
+/**************************************************************************************************
+ * @fn          HalAdcRead
+ *
+ * @brief       Read the ADC - there are no analog inputs on the host.
+ *
+ * input parameters
+ *
+ * @param       channel - Channel where ADC will be read.
+ * @param       resolution - The resolution of the value.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      Zero.
+ **************************************************************************************************
+ */
+uint16 HalAdcRead( uint8 channel, uint8 resolution )
+{
+  (void)channel;
+  (void)resolution;
+
+  return 0;
+}
+
+/**************************************************************************************************
+ * @fn          HalAdcSetReference
+ *
+ * @brief       Set the ADC reference voltage - nothing to do on the host.
+ *
+ * input parameters
+ *
+ * @param       reference - The reference voltage to be used by the ADC.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+void HalAdcSetReference( uint8 reference )
+{
+  (void)reference;
+}
+
+/**************************************************************************************************
+ * @fn          HalAdcCheckVdd
+ *
+ * @brief       Check for minimum Vdd specified.
+ *
+ * input parameters
+ *
+ * @param       vdd - The board-specific Vdd reading to check for.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      TRUE if the simulated Vdd is greater than the 'vdd' minimum parameter;
+ *              FALSE if not.
+ **************************************************************************************************
+ */
+bool HalAdcCheckVdd( uint8 vdd )
+{
+  return (halSimVdd > vdd);
+}
+
+/**************************************************************************************************
+*/
@@ -0,0 +1,206 @@
+/**************************************************************************************************
+  Filename:       hal_board_cfg.h
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Declarations for the host (x86-64 Linux) simulation board.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+#ifndef HAL_BOARD_CFG_H
+#define HAL_BOARD_CFG_H
+
+
+/* ------------------------------------------------------------------------------------------------
+ *                                           Includes
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#include "hal_mcu.h"
+#include "hal_defs.h"
+#include "hal_types.h"
+#include "hal_sim.h"
+
+/* ------------------------------------------------------------------------------------------------
+ *                                       Board Indentifier
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#define HAL_BOARD_HOST
+
+/* ------------------------------------------------------------------------------------------------
+ *                                          Clock Speed
+ * ------------------------------------------------------------------------------------------------
+ */
+
+/* Nominal value only - all time on this target is taken from the virtual clock in hal_sim.c */
+#define HAL_CPU_CLOCK_MHZ     32
+
+#define HAL_CLOCK_STABLE()
+
+/* ------------------------------------------------------------------------------------------------
+ *                                       LED Configuration
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#define HAL_NUM_LEDS            0
+
+#define HAL_LED_BLINK_DELAY()
+
+/* ------------------------------------------------------------------------------------------------
+ *                                    Push Button Configuration
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#define ACTIVE_LOW        !
+#define ACTIVE_HIGH       !!    /* double negation forces result to be '1' */
+
+/* ------------------------------------------------------------------------------------------------
+ *                                    LCD Configuration
+ * ------------------------------------------------------------------------------------------------
+ */
+
+/* LCD Max Chars and Buffer */
+#define HAL_LCD_MAX_CHARS   16
+#define HAL_LCD_MAX_BUFF    25
+
+/* ------------------------------------------------------------------------------------------------
+ *                         OSAL NV implemented by simulated flash pages.
+ * ------------------------------------------------------------------------------------------------
+ */
+
+/* Same geometry as the banked CC2530 build - only the NV pages are simulated (see hal_flash.c). */
+#define HAL_FLASH_PAGE_SIZE        2048
+#define HAL_FLASH_WORD_SIZE        4
+
+#define HAL_NV_PAGE_END            126
+#if !defined HAL_NV_PAGE_CNT
+#define HAL_NV_PAGE_CNT            6
+#endif
+#define HAL_NV_PAGE_BEG           (HAL_NV_PAGE_END-HAL_NV_PAGE_CNT+1)
+
+/* ------------------------------------------------------------------------------------------------
+ *                                            Macros
+ * ------------------------------------------------------------------------------------------------
+ */
+
+/* ----------- Board Initialization ---------- */
+#define HAL_BOARD_INIT()            halSimInit()
+
+/* ----------- Debounce ---------- */
+#define HAL_DEBOUNCE(expr)
+
+/* ----------- Push Buttons ---------- */
+#define HAL_PUSH_BUTTON1()        (0)
+#define HAL_PUSH_BUTTON2()        (0)
+#define HAL_PUSH_BUTTON3()        (0)
+#define HAL_PUSH_BUTTON4()        (0)
+#define HAL_PUSH_BUTTON5()        (0)
+#define HAL_PUSH_BUTTON6()        (0)
+
+/* ----------- LED's ---------- */
+#define HAL_TURN_OFF_LED1()
+#define HAL_TURN_OFF_LED2()
+#define HAL_TURN_OFF_LED3()
+#define HAL_TURN_OFF_LED4()
+
+#define HAL_TURN_ON_LED1()
+#define HAL_TURN_ON_LED2()
+#define HAL_TURN_ON_LED3()
+#define HAL_TURN_ON_LED4()
+
+#define HAL_TOGGLE_LED1()
+#define HAL_TOGGLE_LED2()
+#define HAL_TOGGLE_LED3()
+#define HAL_TOGGLE_LED4()
+
+#define HAL_STATE_LED1()          (0)
+#define HAL_STATE_LED2()          (0)
+#define HAL_STATE_LED3()          (0)
+#define HAL_STATE_LED4()          (0)
+
+/* ----------- Minimum safe bus voltage ---------- */
+
+#define VDD_MIN_RUN   0
+#define VDD_MIN_NV    0
+
+/* ------------------------------------------------------------------------------------------------
+ *                                     Driver Configuration
+ * ------------------------------------------------------------------------------------------------
+ */
+
+/* The simulated board has no peripherals - only the OSAL services are exercised. */
+
+#ifndef HAL_TIMER
+#define HAL_TIMER FALSE
+#endif
+
+#ifndef HAL_ADC
+#define HAL_ADC FALSE
+#endif
+
+#ifndef HAL_DMA
+#define HAL_DMA FALSE
+#endif
+
+#ifndef HAL_FLASH
+#define HAL_FLASH FALSE
+#endif
+
+#ifndef HAL_AES
+#define HAL_AES FALSE
+#endif
+
+#ifndef HAL_LCD
+#define HAL_LCD FALSE
+#endif
+
+#ifndef HAL_LED
+#define HAL_LED FALSE
+#endif
+
+#ifndef HAL_KEY
+#define HAL_KEY FALSE
+#endif
+
+#ifndef HAL_UART
+#define HAL_UART FALSE
+#endif
+
+#define HAL_UART_DMA  0
+#define HAL_UART_ISR  0
+#define HAL_UART_USB  0
+
+#endif
+/*******************************************************************************************************
+*/
@@ -0,0 +1,374 @@
+/**************************************************************************************************
+  Filename:       hal_flash.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Simulated internal flash for the host (x86-64 Linux) target: the
+                  NV pages are kept in RAM with the erase and program rules of the
+                  CC2530 flash.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/* ------------------------------------------------------------------------------------------------
+ *                                          Includes
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#include <string.h>
+
+#include "hal_assert.h"
+#include "hal_board_cfg.h"
+#include "hal_flash.h"
+#include "hal_sim.h"
+#include "hal_types.h"
+
+/* ------------------------------------------------------------------------------------------------
+ *                                           Macros
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#define HAL_SIM_FLASH_PAGE_OK(pg)  (((pg) >= HAL_NV_PAGE_BEG) && ((pg) <= HAL_NV_PAGE_END))
+
+/* ------------------------------------------------------------------------------------------------
+ *                                        Local Variables
+ * ------------------------------------------------------------------------------------------------
+ */
+
+/* Only the NV pages are simulated - there is no code image in flash on the host. */
+static uint8 halSimFlash[HAL_NV_PAGE_CNT][HAL_FLASH_PAGE_SIZE];
+
+/* Count of flash page erases and flash word writes since halSimFlashInit(). */
+static uint32 halSimFlashErases;
+static uint32 halSimFlashWrites;
+
+/* Power cut: the number of flash operations left before it, and the function called instead of
+ * the first operation that does not happen.
+ */
+static uint32 halSimFlashCutOps;
+static void (*halSimFlashCutFn)(void);
+
+/* Failed write: the number of flash operations left before the Flash-WORD write that is lost,
+ * and whether one is to be lost at all.
+ */
+static uint32 halSimFlashFailOps;
+static uint8 halSimFlashFailOn;
+
+/* ------------------------------------------------------------------------------------------------
+ *                                       Local Functions
+ * ------------------------------------------------------------------------------------------------
+ */
+
+static uint8 halSimFlashPower(void);
+
+/**************************************************************************************************
+ * @fn          halSimFlashInit
+ *
+ * @brief       Erase all of the simulated flash pages.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+void halSimFlashInit( void )
+{
+  (void)memset(halSimFlash, 0xFF, sizeof(halSimFlash));
+  halSimFlashErases = 0;
+  halSimFlashWrites = 0;
+  halSimFlashCutFn = NULL;
+  halSimFlashFailOn = FALSE;
+}
+
+/**************************************************************************************************
+ * @fn          halSimFlashImage
+ *
+ * @brief       Access the simulated flash image so that it can be saved, restored or corrupted.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      Pointer to the first byte of HAL_NV_PAGE_BEG; the HAL_NV_PAGE_CNT pages follow.
+ **************************************************************************************************
+ */
+uint8 *halSimFlashImage( void )
+{
+  return &halSimFlash[0][0];
+}
+
+/**************************************************************************************************
+ * @fn          halSimFlashStats
+ *
+ * @brief       Read the count of flash page erases and flash word writes.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * @param       erases - Page erases since halSimFlashInit(), if not NULL.
+ * @param       writes - Flash-WORD writes since halSimFlashInit(), if not NULL.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+void halSimFlashStats( uint32 *erases, uint32 *writes )
+{
+  if (erases != NULL)
+  {
+    *erases = halSimFlashErases;
+  }
+  if (writes != NULL)
+  {
+    *writes = halSimFlashWrites;
+  }
+}
+
+/**************************************************************************************************
+ * @fn          halSimFlashCut
+ *
+ * @brief       Cut the power after the given number of flash operations - Flash-WORD writes and
+ *              page erases. The next operation is not done; the cut function is called instead,
+ *              and must not return: it longjmp()s back to the test, which restarts as from a reset.
+ *
+ * input parameters
+ *
+ * @param       ops - Number of flash operations still done.
+ * @param       pFn - Function called at the cut, NULL to cancel a cut not reached yet.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+void halSimFlashCut( uint32 ops, void (*pFn)(void) )
+{
+  halSimFlashCutOps = ops;
+  halSimFlashCutFn = pFn;
+}
+
+/**************************************************************************************************
+ * @fn          halSimFlashFail
+ *
+ * @brief       Lose a Flash-WORD write after the given number of flash operations, as when the
+ *              supply droops during the write: the word keeps its bits and nothing else happens.
+ *              Only the first write at or after that point is lost.
+ *
+ * input parameters
+ *
+ * @param       ops - Number of flash operations still done.
+ * @param       on - TRUE to lose a write, FALSE to cancel one not reached yet.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+void halSimFlashFail( uint32 ops, uint8 on )
+{
+  halSimFlashFailOps = ops;
+  halSimFlashFailOn = on;
+}
+
+/**************************************************************************************************
+ * @fn          halSimFlashPower
+ *
+ * @brief       Account one flash operation towards a power cut or a lost write, and cut the power
+ *              when it is due.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      TRUE if a Flash-WORD write is to be lost at this operation; FALSE otherwise.
+ **************************************************************************************************
+ */
+static uint8 halSimFlashPower(void)
+{
+  if (halSimFlashCutFn != NULL)
+  {
+    if (halSimFlashCutOps == 0)
+    {
+      void (*pFn)(void) = halSimFlashCutFn;
+
+      halSimFlashCutFn = NULL;
+      pFn();
+      HAL_ASSERT(FALSE);  // The cut function must not return.
+    }
+
+    halSimFlashCutOps--;
+  }
+
+  if (halSimFlashFailOn)
+  {
+    if (halSimFlashFailOps == 0)
+    {
+      return TRUE;
+    }
+
+    halSimFlashFailOps--;
+  }
+
+  return FALSE;
+}
+
+/**************************************************************************************************
+ * @fn          HalFlashRead
+ *
+ * @brief       This function reads 'cnt' bytes from the simulated flash.
+ *
+ * input parameters
+ *
+ * @param       pg - A valid NV page number.
+ * @param       offset - A valid offset into the page.
+ * @param       buf - A valid buffer space at least as big as the 'cnt' parameter.
+ * @param       cnt - A valid number of bytes to read.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+void HalFlashRead(uint8 pg, uint16 offset, uint8 *buf, uint16 cnt)
+{
+  HAL_ASSERT(HAL_SIM_FLASH_PAGE_OK(pg));
+  HAL_ASSERT(((uint32)offset + cnt) <= HAL_FLASH_PAGE_SIZE);
+
+  (void)memcpy(buf, &halSimFlash[pg - HAL_NV_PAGE_BEG][offset], cnt);
+}
+
+/**************************************************************************************************
+ * @fn          HalFlashWrite
+ *
+ * @brief       This function writes 'cnt' Flash-WORDs to the simulated flash. As with the real
+ *              flash, a write can only clear bits - it is AND'ed with the current contents.
+ *
+ * input parameters
+ *
+ * @param       addr - Valid HAL flash write address: actual addr / 4 and quad-aligned.
+ * @param       buf - Valid buffer space at least as big as 'cnt' X 4.
+ * @param       cnt - Number of 4-byte blocks to write.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+void HalFlashWrite(uint16 addr, uint8 *buf, uint16 cnt)
+{
+  uint32 byteAddr = (uint32)addr * HAL_FLASH_WORD_SIZE;
+  uint8 pg = (uint8)(byteAddr / HAL_FLASH_PAGE_SIZE);
+  uint16 offset = (uint16)(byteAddr % HAL_FLASH_PAGE_SIZE);
+  uint32 len = (uint32)cnt * HAL_FLASH_WORD_SIZE;
+  uint8 *pFlash;
+
+  HAL_ASSERT(HAL_SIM_FLASH_PAGE_OK(pg));
+  HAL_ASSERT((offset + len) <= HAL_FLASH_PAGE_SIZE);
+
+  pFlash = &halSimFlash[pg - HAL_NV_PAGE_BEG][offset];
+
+  // One Flash-WORD at a time, so that a power cut can split a multi-word write.
+  while (len != 0)
+  {
+    uint8 lost = halSimFlashPower();
+    uint8 byte;
+
+    halSimFlashWrites++;
+
+    if (lost)
+    {
+      halSimFlashFailOn = FALSE;
+      pFlash += HAL_FLASH_WORD_SIZE;
+      buf += HAL_FLASH_WORD_SIZE;
+    }
+    else
+    {
+      for (byte = 0; byte < HAL_FLASH_WORD_SIZE; byte++)
+      {
+        *pFlash++ &= *buf++;
+      }
+    }
+    len -= HAL_FLASH_WORD_SIZE;
+  }
+}
+
+/**************************************************************************************************
+ * @fn          HalFlashErase
+ *
+ * @brief       This function erases the specified page of the simulated flash.
+ *
+ * input parameters
+ *
+ * @param       pg - A valid NV page number to erase.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+void HalFlashErase(uint8 pg)
+{
+  HAL_ASSERT(HAL_SIM_FLASH_PAGE_OK(pg));
+
+  (void)halSimFlashPower();  // An erase is never lost.
+  (void)memset(halSimFlash[pg - HAL_NV_PAGE_BEG], 0xFF, HAL_FLASH_PAGE_SIZE);
+  halSimFlashErases++;
+}
+
+/**************************************************************************************************
+*/
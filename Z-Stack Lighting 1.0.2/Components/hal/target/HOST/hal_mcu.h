@@ -0,0 +1,149 @@
+/**************************************************************************************************
+  Filename:       hal_mcu.h
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    MCU abstraction for the host (x86-64 Linux) simulation target.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+#ifndef _HAL_MCU_H
+#define _HAL_MCU_H
+
+/*
+ *  Target : Host simulation (x86-64 Linux)
+ *
+ */
+
+
+/* ------------------------------------------------------------------------------------------------
+ *                                           Includes
+ * ------------------------------------------------------------------------------------------------
+ */
+#include "hal_defs.h"
+#include "hal_types.h"
+
+
+/* ------------------------------------------------------------------------------------------------
+ *                                        Target Defines
+ * ------------------------------------------------------------------------------------------------
+ */
+#define HAL_MCU_HOST
+
+
+/* ------------------------------------------------------------------------------------------------
+ *                                     Compiler Abstraction
+ * ------------------------------------------------------------------------------------------------
+ */
+
+/* ---------------------- GNU Compiler ---------------------- */
+#ifdef __GNUC__
+#define HAL_COMPILER_GNU
+#define HAL_MCU_LITTLE_ENDIAN()   (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define HAL_ISR_FUNC_DECLARATION(f,v)   void f(void)
+#define HAL_ISR_FUNC_PROTOTYPE(f,v)     void f(void)
+#define HAL_ISR_FUNCTION(f,v)           HAL_ISR_FUNC_PROTOTYPE(f,v); HAL_ISR_FUNC_DECLARATION(f,v)
+
+/* 8051 memory and function attributes have no meaning on the host. */
+#define __no_init
+#define __near_func
+#define __data
+#define __code
+#define __xdata
+
+/* ------------------ Unrecognized Compiler ------------------ */
+#else
+#error "ERROR: Unknown compiler."
+#endif
+
+
+/* ------------------------------------------------------------------------------------------------
+ *                                        Interrupt Macros
+ * ------------------------------------------------------------------------------------------------
+ */
+
+/* Set to TRUE to measure how long interrupts are held off by each critical section. */
+#if !defined HAL_CS_STATS
+#define HAL_CS_STATS  FALSE
+#endif
+
+/* Simulated global interrupt enable flag - the equivalent of the 8051 EA bit. */
+extern volatile uint8 halSimIntEnable;
+
+#define HAL_ENABLE_INTERRUPTS()         st( halSimIntEnable = 1; )
+#define HAL_DISABLE_INTERRUPTS()        st( halSimIntEnable = 0; )
+#define HAL_INTERRUPTS_ARE_ENABLED()    (halSimIntEnable)
+
+typedef unsigned char halIntState_t;
+#if HAL_CS_STATS
+/* Time the critical sections that start with interrupts enabled, keyed by the file and line
+ * of the HAL_ENTER_CRITICAL_SECTION() (see HalCsStatsGet() in hal_drivers.h).
+ */
+extern void halCsEnter( const char *fname, uint16 lnum );
+extern void halCsExit( void );
+#define HAL_ENTER_CRITICAL_SECTION(x)   st( x = halSimIntEnable;  HAL_DISABLE_INTERRUPTS(); if (x) halCsEnter(__FILE__, __LINE__); )
+#define HAL_EXIT_CRITICAL_SECTION(x)    st( if (x) halCsExit(); halSimIntEnable = x; )
+#else
+#define HAL_ENTER_CRITICAL_SECTION(x)   st( x = halSimIntEnable;  HAL_DISABLE_INTERRUPTS(); )
+#define HAL_EXIT_CRITICAL_SECTION(x)    st( halSimIntEnable = x; )
+#endif
+#define HAL_CRITICAL_STATEMENT(x)       st( halIntState_t _s; HAL_ENTER_CRITICAL_SECTION(_s); x; HAL_EXIT_CRITICAL_SECTION(_s); )
+
+#define HAL_ENTER_ISR()
+#define HAL_EXIT_ISR()
+
+/* Dummy for this platform */
+#define HAL_AES_ENTER_WORKAROUND()
+#define HAL_AES_EXIT_WORKAROUND()
+
+/* ------------------------------------------------------------------------------------------------
+ *                                        Reset Macro
+ * ------------------------------------------------------------------------------------------------
+ */
+extern void halSimReset(void);
+
+#define WD_KICK()
+
+/* disable interrupts and terminate the simulation */
+#define HAL_SYSTEM_RESET()  st( HAL_DISABLE_INTERRUPTS(); halSimReset(); )
+
+/* ------------------------------------------------------------------------------------------------
+ *                                        Sleep common code
+ * ------------------------------------------------------------------------------------------------
+ */
+#define CLEAR_SLEEP_MODE()
+#define ALLOW_SLEEP_MODE()
+
+/**************************************************************************************************
+ */
+#endif
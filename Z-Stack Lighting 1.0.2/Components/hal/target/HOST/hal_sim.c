@@ -0,0 +1,351 @@
+/**************************************************************************************************
+  Filename:       hal_sim.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Simulated MCU services for the host (x86-64 Linux) target: a virtual
+                  clock which replaces the MAC backoff timer, the interrupt enable flag
+                  and sleep.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/* ------------------------------------------------------------------------------------------------
+ *                                          Includes
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#include <stdlib.h>
+
+#include "hal_board.h"
+#include "hal_mcu.h"
+#include "hal_sim.h"
+#include "hal_sleep.h"
+#include "hal_types.h"
+
+/* ------------------------------------------------------------------------------------------------
+ *                                           Constants
+ * ------------------------------------------------------------------------------------------------
+ */
+
+/* The MAC backoff timer which drives osalTimeUpdate() ticks every 320 usec. */
+#define HAL_SIM_USEC_PER_TICK      320
+
+/* ------------------------------------------------------------------------------------------------
+ *                                        Global Variables
+ * ------------------------------------------------------------------------------------------------
+ */
+
+volatile uint8 halSimIntEnable;
+
+/* ------------------------------------------------------------------------------------------------
+ *                                        Local Variables
+ * ------------------------------------------------------------------------------------------------
+ */
+
+/* The virtual clock only moves when the simulation says so, which makes every run of the OSAL
+ * loop reproducible regardless of the speed or the load of the host.
+ */
+static uint64_t halSimUsec;
+static uint32 halSimSleeps;
+
+/**************************************************************************************************
+ * @fn          halSimInit
+ *
+ * @brief       Reset the virtual clock and the simulated interrupt state, and erase the
+ *              simulated flash.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+void halSimInit( void )
+{
+  halSimIntEnable = 0;
+  halSimUsec = 0;
+  halSimSleeps = 0;
+
+  halSimFlashInit();
+}
+
+/**************************************************************************************************
+ * @fn          halSimPoll
+ *
+ * @brief       Charge the cost of one pass through the OSAL loop to the virtual clock.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+void halSimPoll( void )
+{
+  halSimUsec += HAL_SIM_LOOP_USEC;
+}
+
+/**************************************************************************************************
+ * @fn          halSimClockAdvance
+ *
+ * @brief       Advance the virtual clock.
+ *
+ * input parameters
+ *
+ * @param       usec - Number of microseconds to add to the virtual clock.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+void halSimClockAdvance( uint32 usec )
+{
+  halSimUsec += usec;
+}
+
+/**************************************************************************************************
+ * @fn          halSimClockMs
+ *
+ * @brief       Read the virtual clock in milliseconds.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      Milliseconds elapsed since halSimInit().
+ **************************************************************************************************
+ */
+uint32 halSimClockMs( void )
+{
+  return (uint32)(halSimUsec / 1000);
+}
+
+/**************************************************************************************************
+ * @fn          halSimClockUs
+ *
+ * @brief       Read the virtual clock in microseconds.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      Microseconds elapsed since halSimInit(), modulo 2^32.
+ **************************************************************************************************
+ */
+uint32 halSimClockUs( void )
+{
+  return (uint32)halSimUsec;
+}
+
+/**************************************************************************************************
+ * @fn          halSimSleepCnt
+ *
+ * @brief       Return the number of times halSleep() was entered.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      Number of simulated sleeps since halSimInit().
+ **************************************************************************************************
+ */
+uint32 halSimSleepCnt( void )
+{
+  return halSimSleeps;
+}
+
+/**************************************************************************************************
+ * @fn          halSimReset
+ *
+ * @brief       Simulated watchdog reset - there is nothing to restart, so end the simulation.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      Does not return.
+ **************************************************************************************************
+ */
+void halSimReset( void )
+{
+  abort();
+}
+
+/**************************************************************************************************
+ * @fn          macMcuPrecisionCount
+ *
+ * @brief       Replacement for the MAC backoff timer overflow count used by osalTimeUpdate().
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      Number of 320 usec ticks on the virtual clock.
+ **************************************************************************************************
+ */
+uint32 macMcuPrecisionCount( void )
+{
+  return (uint32)(halSimUsec / HAL_SIM_USEC_PER_TICK);
+}
+
+/**************************************************************************************************
+ * @fn          halSleep
+ *
+ * @brief       Skip the virtual clock forward to the next OSAL timer expiration instead of
+ *              sleeping, since no interrupt can arrive while the simulated CPU is asleep.
+ *
+ * input parameters
+ *
+ * @param       osal_timeout - Next OSAL timer timeout in msec, or zero if there is none.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+void halSleep( uint32 osal_timeout )
+{
+  halSimSleeps++;
+
+  if (osal_timeout == 0)
+  {
+    halSimUsec += HAL_SIM_LOOP_USEC;
+  }
+  else
+  {
+    halSimUsec += (uint64_t)osal_timeout * 1000;
+  }
+}
+
+/**************************************************************************************************
+ * @fn          halSleepWait
+ *
+ * @brief       Busy wait on the virtual clock.
+ *
+ * input parameters
+ *
+ * @param       duration - Duration of wait in microseconds.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+void halSleepWait( uint16 duration )
+{
+  halSimUsec += duration;
+}
+
+/**************************************************************************************************
+ * @fn          TimerElapsed
+ *
+ * @brief       Determine the number of OSAL timer ticks elapsed during sleep.
+ *              Sleep is accounted for directly on the virtual clock.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      Number of timer ticks elapsed during sleep.
+ **************************************************************************************************
+ */
+uint32 TimerElapsed( void )
+{
+  /* Stubs */
+  return (0);
+}
+
+/**************************************************************************************************
+ * @fn          halRestoreSleepLevel
+ *
+ * @brief       Restore the deepest timer sleep level.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+void halRestoreSleepLevel( void )
+{
+  /* Stubs */
+}
+
+/**************************************************************************************************
+*/
@@ -0,0 +1,141 @@
+/**************************************************************************************************
+  Filename:       hal_sim.h
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Simulated MCU services for the host (x86-64 Linux) target.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+#ifndef HAL_SIM_H
+#define HAL_SIM_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* ------------------------------------------------------------------------------------------------
+ *                                          Includes
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#include "hal_types.h"
+
+/* ------------------------------------------------------------------------------------------------
+ *                                          Constants
+ * ------------------------------------------------------------------------------------------------
+ */
+
+/* Virtual time charged to every pass through the OSAL loop (see Hal_ProcessPoll()). The default
+ * of one MAC backoff period keeps the idle loop moving forward without sleep enabled.
+ */
+#if !defined HAL_SIM_LOOP_USEC
+#define HAL_SIM_LOOP_USEC          320
+#endif
+
+/* ------------------------------------------------------------------------------------------------
+ *                                          Functions
+ * ------------------------------------------------------------------------------------------------
+ */
+
+/*
+ * Reset the virtual clock and the simulated interrupt state, and erase the simulated flash.
+ */
+extern void halSimInit( void );
+
+/*
+ * Charge the cost of one OSAL loop pass to the virtual clock.
+ */
+extern void halSimPoll( void );
+
+/*
+ * Advance the virtual clock by the given number of microseconds.
+ */
+extern void halSimClockAdvance( uint32 usec );
+
+/*
+ * Read the virtual clock - milliseconds since halSimInit().
+ */
+extern uint32 halSimClockMs( void );
+
+/*
+ * Read the virtual clock - microseconds since halSimInit(), modulo 2^32.
+ */
+extern uint32 halSimClockUs( void );
+
+/*
+ * Number of times the simulated CPU was put to sleep by the power manager.
+ */
+extern uint32 halSimSleepCnt( void );
+
+/*
+ * Erase all of the simulated NV flash pages.
+ */
+extern void halSimFlashInit( void );
+
+/*
+ * Access the simulated NV flash pages - HAL_NV_PAGE_CNT pages starting at HAL_NV_PAGE_BEG.
+ */
+extern uint8 *halSimFlashImage( void );
+
+/*
+ * Read the count of simulated flash page erases and Flash-WORD writes.
+ */
+extern void halSimFlashStats( uint32 *erases, uint32 *writes );
+
+/*
+ * Cut the power after the given number of flash operations; pFn is called at the cut and must
+ * not return.
+ */
+extern void halSimFlashCut( uint32 ops, void (*pFn)(void) );
+
+/*
+ * Lose the first Flash-WORD write after the given number of flash operations; the word keeps
+ * its bits. FALSE cancels a lost write not reached yet.
+ */
+extern void halSimFlashFail( uint32 ops, uint8 on );
+
+/*
+ * Set the simulated bus voltage returned by HalAdcCheckVdd().
+ */
+extern void halSimVddSet( uint8 vdd );
+
+/**************************************************************************************************
+*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
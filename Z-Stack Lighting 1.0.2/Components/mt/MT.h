@@ -94,10 +94,15 @@ extern "C"
 #define MT_SYS_OSAL_NV_DELETE                0x12
 #define MT_SYS_OSAL_NV_LENGTH                0x13
 #define MT_SYS_SET_TX_POWER                  0x14
+#define MT_SYS_HEAP_TRACE                    0x15
+#define MT_SYS_SCHED_STATS                   0x16
+#define MT_SYS_NV_STATS                      0x17
+#define MT_SYS_CS_STATS                      0x18
 
 /* AREQ to host */
 #define MT_SYS_RESET_IND                     0x80
 #define MT_SYS_OSAL_TIMER_EXPIRED            0x81
+#define MT_SYS_HEAP_TRACE_IND                0x82
 
 /***************************************************************************************************
  * MAC COMMANDS
@@ -498,6 +503,9 @@ extern "C"
 #define MT_SRNG_EVENT                   0x1000
 #endif
 
+/* Next MT_SYS_HEAP_TRACE_IND */
+#define MT_SYS_HEAP_TRACE_EVT           0x2000
+
 /* Message Command IDs */
 #define CMD_SERIAL_MSG                  0x01
 #define CMD_DEBUG_MSG                   0x02
@@ -90,7 +90,7 @@ typedef struct
 typedef struct _mtAfInMsgList_t
 {
   struct _mtAfInMsgList_t *next;
-  uint8 *data;
+  osalMsgSlice_t data;      // Data of the incoming message, kept without a copy
   uint32 timestamp;         // Receipt timestamp from MAC.
   uint8 tick;
 } mtAfInMsgList_t;
@@ -159,6 +159,8 @@ void MT_AfExec(void)
   {
     if (--(pItem->tick) == 0)
     {
+      osal_msg_slice_release(&pItem->data);
+
       if (pMtAfInMsgList == pItem)
       {
         pMtAfInMsgList = pItem->next;
@@ -689,25 +691,35 @@ void MT_AfIncomingMsg(afIncomingMSGPacket_t *pMsg)
 
   if (respLen > (uint16)MT_RPC_DATA_MAX)
   {
-    if ((pItem = (mtAfInMsgList_t *)osal_mem_alloc(sizeof(mtAfInMsgList_t) + dataLen)) == NULL)
+    if ((pItem = (mtAfInMsgList_t *)osal_mem_alloc(sizeof(mtAfInMsgList_t))) == NULL)
     {
       return;  // If cannot hold a huge message, cannot give indication at all.
     }
 
-    pItem->data = (uint8 *)(pItem+1);
+    // Keep the data in the incoming message rather than a copy of it.
+    if (osal_msg_slice(&pItem->data, (uint8 *)pMsg, pMsg->cmd.Data, dataLen) != SUCCESS)
+    {
+      (void)osal_mem_free(pItem);
+      return;
+    }
+
     respLen -= dataLen;  // Zero data bytes are sent with an over-sized incoming indication.
   }
 
-  // Attempt to allocate memory for the response packet.
-  if ((pRsp = osal_mem_alloc(respLen)) == NULL)
+  // Build the response directly in the transport frame.
+  if ((pRsp = MT_TransportAlloc(((uint8)MT_RPC_CMD_AREQ | (uint8)MT_RPC_SYS_AF), respLen)) == NULL)
   {
     if (pItem != NULL)
     {
+      osal_msg_slice_release(&pItem->data);
       (void)osal_mem_free(pItem);
     }
     return;
   }
-  pTmp = pRsp;
+  pRsp[MT_RPC_POS_LEN] = respLen;
+  pRsp[MT_RPC_POS_CMD0] = ((uint8)MT_RPC_CMD_AREQ | (uint8)MT_RPC_SYS_AF);
+  pRsp[MT_RPC_POS_CMD1] = cmd;
+  pTmp = pRsp + MT_RPC_POS_DAT0;
 
   /* Group ID */
   *pTmp++ = LO_UINT16(pMsg->groupId);
@@ -802,17 +814,14 @@ void MT_AfIncomingMsg(afIncomingMSGPacket_t *pMsg)
     }
 
     pItem->timestamp = pMsg->timestamp;
-    (void)osal_memcpy(pItem->data, pMsg->cmd.Data, dataLen);
   }
   else
   {
     (void)osal_memcpy(pTmp, pMsg->cmd.Data, dataLen);
   }
 
-  /* Build and send back the response */
-  MT_BuildAndSendZToolResponse(((uint8)MT_RPC_CMD_AREQ|(uint8)MT_RPC_SYS_AF), cmd, respLen, pRsp);
-
-  (void)osal_mem_free(pRsp);
+  /* Send back the response */
+  MT_TransportSend(pRsp);
 }
 
 /**************************************************************************************************
@@ -873,6 +882,7 @@ void MT_AfDataRetrieve(uint8 *pBuf)
       {
         pPrev->next = pItem->next;
       }
+      osal_msg_slice_release(&pItem->data);
       (void)osal_mem_free(pItem);
       rtrn = afStatus_SUCCESS;
     }
@@ -885,7 +895,7 @@ void MT_AfDataRetrieve(uint8 *pBuf)
     {
       pRsp[0] = ZSuccess;
       pRsp[1] = len;
-      (void)osal_memcpy(pRsp + MT_AF_RTV_HDR_SZ, pItem->data+idx, len);
+      (void)osal_memcpy(pRsp + MT_AF_RTV_HDR_SZ, pItem->data.data+idx, len);
       MT_BuildAndSendZToolResponse(((uint8)MT_RPC_CMD_SRSP | (uint8)MT_RPC_SYS_AF),
                                            MT_AF_DATA_RETRIEVE, len + MT_AF_RTV_HDR_SZ, pRsp);
       (void)osal_mem_free(pRsp);
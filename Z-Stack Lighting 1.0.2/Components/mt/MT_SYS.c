@@ -48,6 +48,7 @@
 #include "OSAL_NV.h"
 #include "Onboard.h"  /* This is here because RAM read/write macros need it */
 #include "hal_adc.h"
+#include "hal_drivers.h"
 #include "OSAL_Clock.h"
 #include "mac_low_level.h"
 #include "ZMAC.h"
@@ -61,6 +62,25 @@
 
 #define MT_SYS_DEVICE_INFO_RESPONSE_LEN 14
 #define MT_NV_ITEM_MAX_LENGTH           250
+#define MT_SYS_HEAP_TRACE_FNAME_MAX     32
+#define MT_SYS_NV_STATS_PAGES           8
+#define MT_SYS_NV_STATS_ITEMS           8
+#define MT_SYS_NV_STATS_LEN            (19 + 1 + (6 * MT_SYS_NV_STATS_PAGES) + 1 + (6 * MT_SYS_NV_STATS_ITEMS))
+#define MT_SYS_CS_STATS_FNAME_MAX       16
+#define MT_SYS_CS_STATS_LEN            (2 + (2 * HAL_CS_STATS_BINS) + 1 + \
+                                        ((7 + MT_SYS_CS_STATS_FNAME_MAX) * HAL_CS_STATS_SITES))
+
+/* The MT_SYS_CS_STATS response has to fit in one MT frame, which holds up to 9 call sites with
+ * their file names.
+ */
+#if HAL_CS_STATS && (MT_SYS_CS_STATS_LEN > MT_RPC_DATA_MAX)
+#error HAL_CS_STATS_SITES is too big for the MT_SYS_CS_STATS response.
+#endif
+
+/* The MT_SYS_HEAP_TRACE response counts the records in one byte. */
+#if OSALMEM_TRACE && (OSALMEM_TRACE_CNT > 255)
+#error OSALMEM_TRACE_CNT is too big for the MT_SYS_HEAP_TRACE response.
+#endif
 
 #if !defined HAL_GPIO || !HAL_GPIO
 #define GPIO_DIR_IN(IDX)
@@ -84,6 +104,13 @@
 #define MT_SYS_OSAL_NV_READ_CERTIFICATE_DATA  FALSE
 #endif
 
+/* Time between two MT_SYS_HEAP_TRACE_IND, so that a whole trace does not overrun the UART transmit
+ * buffer: an IND with a full file name takes 15 msecs to send at 38400 baud.
+ */
+#if !defined MT_SYS_HEAP_TRACE_DLY
+#define MT_SYS_HEAP_TRACE_DLY  20
+#endif
+
 const uint16 MT_SysOsalEventId [] = {
                                       MT_SYS_OSAL_EVENT_0,
                                       MT_SYS_OSAL_EVENT_1,
@@ -101,6 +128,16 @@ typedef enum {
   GPIO_HiD = 0x12
 } GPIO_Op_t;
 
+/***************************************************************************************************
+ * LOCAL VARIABLES
+ ***************************************************************************************************/
+#if defined (MT_SYS_FUNC) && OSALMEM_TRACE
+static osalMemTrace_t *mtSysHeapTrace;  // Copy of the heap trace records being sent, NULL if none.
+static uint16 mtSysHeapTraceSeq;        // Sequence number of the first copied record.
+static uint8 mtSysHeapTraceIdx;         // Next copied record to send.
+static uint8 mtSysHeapTraceCnt;         // Number of copied records.
+#endif
+
 /***************************************************************************************************
  * LOCAL FUNCTIONS
  ***************************************************************************************************/
@@ -125,6 +162,18 @@ void MT_SysGetDeviceInfo(uint8 *pBuf);
 void MT_SysSetUtcTime(uint8 *pBuf);
 void MT_SysGetUtcTime(void);
 void MT_SysSetTxPower(uint8 *pBuf);
+#if OSALMEM_TRACE
+void MT_SysHeapTrace(uint8 *pBuf);
+#endif
+#if OSAL_SCHED_STATS
+void MT_SysSchedStats(uint8 *pBuf);
+#endif
+#if OSAL_NV_STATS
+void MT_SysNvStats(uint8 *pBuf);
+#endif
+#if HAL_CS_STATS
+void MT_SysCsStats(uint8 *pBuf);
+#endif
 #endif /* MT_SYS_FUNC */
 
 #if defined (MT_SYS_FUNC)
@@ -225,6 +274,30 @@ uint8 MT_SysCommandProcessing(uint8 *pBuf)
       MT_SysSetTxPower(pBuf);
       break;
 
+#if OSALMEM_TRACE
+    case MT_SYS_HEAP_TRACE:
+      MT_SysHeapTrace(pBuf);
+      break;
+#endif
+
+#if OSAL_SCHED_STATS
+    case MT_SYS_SCHED_STATS:
+      MT_SysSchedStats(pBuf);
+      break;
+#endif
+
+#if OSAL_NV_STATS
+    case MT_SYS_NV_STATS:
+      MT_SysNvStats(pBuf);
+      break;
+#endif
+
+#if HAL_CS_STATS
+    case MT_SYS_CS_STATS:
+      MT_SysCsStats(pBuf);
+      break;
+#endif
+
     default:
       status = MT_RPC_ERR_COMMAND_ID;
       break;
@@ -1041,6 +1114,424 @@ void MT_SysSetTxPower(uint8 *pBuf)
                                        MT_SYS_SET_TX_POWER, 1,
                                        &signed_dBm_of_TxPower_range_corrected);
 }
+
+#if OSALMEM_TRACE
+/***************************************************************************************************
+ * @fn      MT_SysHeapTrace
+ *
+ * @brief   Stream out the heap trace records from a sequence number onward. The SRSP gives the
+ *          sequence number to ask for next time and the number of records, which then follow
+ *          as one MT_SYS_HEAP_TRACE_IND each, MT_SYS_HEAP_TRACE_DLY apart. The records are copied
+ *          out of the trace first, so the ones still to be sent cannot be overwritten. Records
+ *          that were overwritten before the request are skipped.
+ *
+ * @param   pBuf - pointer to the data
+ *
+ *          | FirstSeq |
+ *          |    2     |
+ *
+ *          SRSP: | Status | NextSeq | Count |
+ *                |   1    |    2    |   1   |
+ *
+ *          IND:  | Seq | Op | Size | Offset | BlkFree | Time | Line | FileLen | File |
+ *                |  2  | 1  |  2   |   2    |    2    |  4   |  2   |    1    |  n   |
+ *
+ * @return  None
+ ***************************************************************************************************/
+void MT_SysHeapTrace(uint8 *pBuf)
+{
+  uint8 retArray[4];
+  uint16 seq, nextSeq;
+  uint8 status = ZSuccess;
+  uint8 cnt = 0;
+  uint8 idx;
+
+  pBuf += MT_RPC_FRAME_HDR_SZ;
+  seq = BUILD_UINT16(pBuf[0], pBuf[1]);
+
+  // Don't trace the copy, the timer nor the SRSP, they would push out records still to be sent.
+  osal_mem_trace_pause(TRUE);
+
+  nextSeq = osal_mem_trace_seq();
+  if (mtSysHeapTrace != NULL)
+  {
+    // The last request is still being sent.
+    status = ZFailure;
+    nextSeq = seq;
+  }
+  else if ((uint16)(nextSeq - seq) > OSALMEM_TRACE_CNT)
+  {
+    seq = nextSeq - OSALMEM_TRACE_CNT;
+  }
+
+  if (nextSeq != seq)
+  {
+    mtSysHeapTrace = osal_mem_alloc((nextSeq - seq) * sizeof(osalMemTrace_t));
+
+    if ((mtSysHeapTrace != NULL) &&
+        (ZSuccess != osal_start_reload_timer(MT_TaskID, MT_SYS_HEAP_TRACE_EVT, MT_SYS_HEAP_TRACE_DLY)))
+    {
+      osal_mem_free(mtSysHeapTrace);
+      mtSysHeapTrace = NULL;
+    }
+
+    if (mtSysHeapTrace == NULL)
+    {
+      status = ZMemError;
+      nextSeq = seq;
+    }
+    else
+    {
+      cnt = (uint8)(nextSeq - seq);
+      for (idx = 0; idx < cnt; idx++)
+      {
+        (void)osal_mem_trace_get(seq + idx, mtSysHeapTrace + idx);
+      }
+
+      mtSysHeapTraceSeq = seq;
+      mtSysHeapTraceIdx = 0;
+      mtSysHeapTraceCnt = cnt;
+    }
+  }
+
+  retArray[0] = status;
+  retArray[1] = LO_UINT16(nextSeq);
+  retArray[2] = HI_UINT16(nextSeq);
+  retArray[3] = cnt;
+
+  MT_BuildAndSendZToolResponse(((uint8)MT_RPC_CMD_SRSP | (uint8)MT_RPC_SYS_SYS),
+                                MT_SYS_HEAP_TRACE, sizeof(retArray), retArray);
+
+  osal_mem_trace_pause(FALSE);
+}
+
+/***************************************************************************************************
+ * @fn      MT_SysHeapTraceSend
+ *
+ * @brief   Send the next MT_SYS_HEAP_TRACE_IND of the records copied by MT_SysHeapTrace, and
+ *          stop its reload timer after the last one.
+ *
+ * @param   None
+ *
+ * @return  None
+ ***************************************************************************************************/
+void MT_SysHeapTraceSend(void)
+{
+  uint8 rec[16 + MT_SYS_HEAP_TRACE_FNAME_MAX];
+  osalMemTrace_t *pTrace;
+  const char *fname;
+  uint8 *pRec = rec;
+  uint16 seq;
+  uint8 len = 0;
+
+  if (mtSysHeapTrace == NULL)
+  {
+    return;
+  }
+
+  pTrace = mtSysHeapTrace + mtSysHeapTraceIdx;
+  seq = mtSysHeapTraceSeq + mtSysHeapTraceIdx;
+
+  *pRec++ = LO_UINT16(seq);
+  *pRec++ = HI_UINT16(seq);
+  *pRec++ = pTrace->op;
+  *pRec++ = LO_UINT16(pTrace->size);
+  *pRec++ = HI_UINT16(pTrace->size);
+  *pRec++ = LO_UINT16(pTrace->offset);
+  *pRec++ = HI_UINT16(pTrace->offset);
+  *pRec++ = LO_UINT16(pTrace->blkFree);
+  *pRec++ = HI_UINT16(pTrace->blkFree);
+  pRec = osal_buffer_uint32(pRec, pTrace->time);
+  *pRec++ = LO_UINT16(pTrace->lnum);
+  *pRec++ = HI_UINT16(pTrace->lnum);
+
+  // Only send the file name without its path.
+  fname = pTrace->fname;
+  if (fname != NULL)
+  {
+    const char *pName;
+
+    for (pName = fname; *pName != '\0'; pName++)
+    {
+      if ((*pName == '/') || (*pName == '\\'))
+      {
+        fname = pName + 1;
+      }
+    }
+
+    while ((fname[len] != '\0') && (len < MT_SYS_HEAP_TRACE_FNAME_MAX))
+    {
+      pRec[len + 1] = fname[len];
+      len++;
+    }
+  }
+  *pRec++ = len;
+  pRec += len;
+
+  osal_mem_trace_pause(TRUE);
+
+  MT_BuildAndSendZToolResponse(((uint8)MT_RPC_CMD_AREQ | (uint8)MT_RPC_SYS_SYS),
+                                MT_SYS_HEAP_TRACE_IND, (uint8)(pRec - rec), rec);
+
+  if (++mtSysHeapTraceIdx == mtSysHeapTraceCnt)
+  {
+    (void)osal_stop_timerEx(MT_TaskID, MT_SYS_HEAP_TRACE_EVT);
+    osal_mem_free(mtSysHeapTrace);
+    mtSysHeapTrace = NULL;
+  }
+
+  osal_mem_trace_pause(FALSE);
+}
+#endif
+
+#if OSAL_SCHED_STATS
+/***************************************************************************************************
+ * @fn      MT_SysSchedStats
+ *
+ * @brief   Read the OSAL scheduler statistics of a task, or of one event of a task. Asking for an
+ *          event of a task that is not the watched one starts watching that task, and returns
+ *          zeroed statistics. A TaskId of 0xFF clears all the statistics. Times are in ticks of
+ *          OSAL_SCHED_TIME().
+ *
+ * @param   pBuf - pointer to the data
+ *
+ *          | TaskId | EventBit (0-15, 0xFF for the whole task) |
+ *          |   1    |                    1                     |
+ *
+ *          SRSP: | Status | RunCnt | RunTotal | RunMax | WaitTotal | WaitMax |
+ *                |   1    |   4    |    4     |   2    |     4     |    2    |
+ *
+ * @return  None
+ ***************************************************************************************************/
+void MT_SysSchedStats(uint8 *pBuf)
+{
+  uint8 retArray[17];
+  uint8 *pRet = retArray;
+  osalSchedStats_t stats;
+  uint8 taskId, eventBit;
+
+  pBuf += MT_RPC_FRAME_HDR_SZ;
+  taskId = pBuf[0];
+  eventBit = pBuf[1];
+
+  osal_memset(&stats, 0, sizeof(stats));
+
+  if (taskId == 0xFF)
+  {
+    osal_sched_stats_reset();
+    *pRet = ZSuccess;
+  }
+  else if (eventBit == 0xFF)
+  {
+    *pRet = osal_sched_stats_get(taskId, &stats);
+  }
+  else
+  {
+    (void)osal_sched_stats_watch(taskId);
+    *pRet = osal_sched_event_stats_get(eventBit, &stats);
+  }
+  pRet++;
+
+  pRet = osal_buffer_uint32(pRet, stats.runCnt);
+  pRet = osal_buffer_uint32(pRet, stats.runTotal);
+  *pRet++ = LO_UINT16(stats.runMax);
+  *pRet++ = HI_UINT16(stats.runMax);
+  pRet = osal_buffer_uint32(pRet, stats.waitTotal);
+  *pRet++ = LO_UINT16(stats.waitMax);
+  *pRet++ = HI_UINT16(stats.waitMax);
+
+  MT_BuildAndSendZToolResponse(((uint8)MT_RPC_CMD_SRSP | (uint8)MT_RPC_SYS_SYS),
+                                MT_SYS_SCHED_STATS, (uint8)(pRet - retArray), retArray);
+}
+#endif
+
+#if OSAL_NV_STATS
+/***************************************************************************************************
+ * @fn      MT_SysNvStats
+ *
+ * @brief   Read the NV write statistics, the projected NV lifetime in hours, the erase count and
+ *          space usage of each NV page and the items written the most. A non-zero Clear restarts
+ *          the statistics after they are read; the page erase counts are kept.
+ *
+ * @param   pBuf - pointer to the data
+ *
+ *          | Clear |
+ *          |   1   |
+ *
+ *          SRSP: | Status | Bytes | BytesPerHour | LifeHours | Erases | EraseMax | PageCnt |
+ *                |   1    |   4   |      4       |     4     |   2    |    2     |    1    |
+ *
+ *                | PageCnt x (Erases | Free | Lost) | ItemCnt | ItemCnt x (Id | Writes) |
+ *                |           (  2    |  2   |  2  ) |    1    |           ( 2  |   4   ) |
+ *
+ * @return  None
+ ***************************************************************************************************/
+void MT_SysNvStats(uint8 *pBuf)
+{
+  uint8 *pRetBuf, *pRet, *pCnt;
+  osalNvStats_t stats;
+  osalNvPageStats_t pgStats;
+  uint32 writes;
+  uint16 id;
+  uint8 idx;
+
+  pBuf += MT_RPC_FRAME_HDR_SZ;
+
+  pRetBuf = osal_mem_alloc(MT_SYS_NV_STATS_LEN);
+  if (pRetBuf == NULL)
+  {
+    idx = ZMemError;
+    MT_BuildAndSendZToolResponse(((uint8)MT_RPC_CMD_SRSP | (uint8)MT_RPC_SYS_SYS),
+                                  MT_SYS_NV_STATS, 1, &idx);
+    return;
+  }
+
+  osal_nv_stats_get(&stats);
+  pRetBuf[0] = ZSuccess;
+  pRet = pRetBuf + 1;
+
+  pRet = osal_buffer_uint32(pRet, stats.bytes);
+  pRet = osal_buffer_uint32(pRet, stats.bytesPerHour);
+  pRet = osal_buffer_uint32(pRet, stats.lifeHours);
+  *pRet++ = LO_UINT16(stats.erases);
+  *pRet++ = HI_UINT16(stats.erases);
+  *pRet++ = LO_UINT16(stats.eraseMax);
+  *pRet++ = HI_UINT16(stats.eraseMax);
+
+  pCnt = pRet++;
+  for (idx = 0; (idx < MT_SYS_NV_STATS_PAGES) && (osal_nv_page_stats_get(idx, &pgStats) == SUCCESS); idx++)
+  {
+    *pRet++ = LO_UINT16(pgStats.erases);
+    *pRet++ = HI_UINT16(pgStats.erases);
+    *pRet++ = LO_UINT16(pgStats.free);
+    *pRet++ = HI_UINT16(pgStats.free);
+    *pRet++ = LO_UINT16(pgStats.lost);
+    *pRet++ = HI_UINT16(pgStats.lost);
+  }
+  *pCnt = idx;
+
+  pCnt = pRet++;
+  for (idx = 0; (idx < MT_SYS_NV_STATS_ITEMS) && (osal_nv_item_stats_get(idx, &id, &writes) == SUCCESS); idx++)
+  {
+    *pRet++ = LO_UINT16(id);
+    *pRet++ = HI_UINT16(id);
+    pRet = osal_buffer_uint32(pRet, writes);
+  }
+  *pCnt = idx;
+
+  if (pBuf[0] != 0)
+  {
+    osal_nv_stats_reset();
+  }
+
+  MT_BuildAndSendZToolResponse(((uint8)MT_RPC_CMD_SRSP | (uint8)MT_RPC_SYS_SYS),
+                                MT_SYS_NV_STATS, (uint8)(pRet - pRetBuf), pRetBuf);
+
+  osal_mem_free(pRetBuf);
+}
+#endif
+
+#if HAL_CS_STATS
+/***************************************************************************************************
+ * @fn      MT_SysCsStats
+ *
+ * @brief   Read how long the critical sections held the interrupts off: a histogram of all of
+ *          them (bin n counts 2^(n-1) to 2^n-1 us) and the count and longest time in us of the
+ *          call sites with the longest sections. A non-zero Clear restarts the statistics after
+ *          they are read.
+ *
+ * @param   pBuf - pointer to the data
+ *
+ *          | Clear |
+ *          |   1   |
+ *
+ *          SRSP: | Status | BinCnt | BinCnt x Count | SiteCnt |
+ *                |   1    |   1    |      2         |    1    |
+ *
+ *                | SiteCnt x (Line | Count | MaxUs | FileLen | File) |
+ *                |           (  2  |   2   |   2   |    1    |  n  ) |
+ *
+ * @return  None
+ ***************************************************************************************************/
+void MT_SysCsStats(uint8 *pBuf)
+{
+  uint16 hist[HAL_CS_STATS_BINS];
+  uint8 *pRetBuf, *pRet, *pCnt;
+  halCsSite_t site;
+  uint8 idx;
+
+  pBuf += MT_RPC_FRAME_HDR_SZ;
+
+  pRetBuf = osal_mem_alloc(MT_SYS_CS_STATS_LEN);
+  if (pRetBuf == NULL)
+  {
+    idx = ZMemError;
+    MT_BuildAndSendZToolResponse(((uint8)MT_RPC_CMD_SRSP | (uint8)MT_RPC_SYS_SYS),
+                                  MT_SYS_CS_STATS, 1, &idx);
+    return;
+  }
+
+  pRetBuf[0] = ZSuccess;
+  pRetBuf[1] = HAL_CS_STATS_BINS;
+  pRet = pRetBuf + 2;
+
+  HalCsStatsGet(hist);
+  for (idx = 0; idx < HAL_CS_STATS_BINS; idx++)
+  {
+    *pRet++ = LO_UINT16(hist[idx]);
+    *pRet++ = HI_UINT16(hist[idx]);
+  }
+
+  pCnt = pRet++;
+  *pCnt = 0;
+  for (idx = 0; idx < HAL_CS_STATS_SITES; idx++)
+  {
+    const char *fname, *pName;
+    uint8 len = 0;
+
+    if (!HalCsStatsSite(idx, &site))
+    {
+      continue;
+    }
+
+    *pRet++ = LO_UINT16(site.lnum);
+    *pRet++ = HI_UINT16(site.lnum);
+    *pRet++ = LO_UINT16(site.cnt);
+    *pRet++ = HI_UINT16(site.cnt);
+    *pRet++ = LO_UINT16(site.max);
+    *pRet++ = HI_UINT16(site.max);
+
+    // Only send the file name without its path.
+    fname = site.fname;
+    for (pName = fname; *pName != '\0'; pName++)
+    {
+      if ((*pName == '/') || (*pName == '\\'))
+      {
+        fname = pName + 1;
+      }
+    }
+
+    while ((fname[len] != '\0') && (len < MT_SYS_CS_STATS_FNAME_MAX))
+    {
+      pRet[len + 1] = fname[len];
+      len++;
+    }
+    *pRet++ = len;
+    pRet += len;
+    (*pCnt)++;
+  }
+
+  if (pBuf[0] != 0)
+  {
+    HalCsStatsReset();
+  }
+
+  MT_BuildAndSendZToolResponse(((uint8)MT_RPC_CMD_SRSP | (uint8)MT_RPC_SYS_SYS),
+                                MT_SYS_CS_STATS, (uint8)(pRet - pRetBuf), pRetBuf);
+
+  osal_mem_free(pRetBuf);
+}
+#endif
 #endif /* MT_SYS_FUNC */
 
 /***************************************************************************************************
@@ -74,6 +74,13 @@ extern void MT_SysResetInd( void );
  */
 extern void MT_SysOsalTimerExpired(uint8 Id);
 
+#if defined (MT_SYS_FUNC)
+/*
+ * Send the next heap trace record
+ */
+extern void MT_SysHeapTraceSend(void);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
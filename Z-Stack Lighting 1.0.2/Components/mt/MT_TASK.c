@@ -173,6 +173,14 @@ UINT16 MT_ProcessEvent(uint8 task_id, uint16 events)
 
     return events;
   }
+
+#if OSALMEM_TRACE
+  if ( events & MT_SYS_HEAP_TRACE_EVT )
+  {
+    MT_SysHeapTraceSend();
+    return (events ^ MT_SYS_HEAP_TRACE_EVT);
+  }
+#endif
 #endif
 
 #ifdef MT_SRNG
@@ -56,8 +56,13 @@
 #include "OnBoard.h"
 
 /* HAL */
+#include "hal_assert.h"
 #include "hal_drivers.h"
 
+#if ( OSAL_MEMCPY_DMA_THRESHOLD )
+  #include "hal_dma.h"
+#endif
+
 #ifdef IAR_ARMCM3_LM
   #include "FreeRTOSConfig.h"
   #include "osal_task.h"
@@ -67,21 +72,87 @@
  * MACROS
  */
 
+// Mark a task as ready, or as not ready, in the ready-task bitmap. Ints must be disabled.
+#define OSAL_READY_SET( idx )  st( osalReadyMap[(idx) >> 3] |= BV( (idx) & 0x07 ); \
+                                   osalReadyAny |= BV( (idx) >> 3 ); )
+
+#define OSAL_READY_CLR( idx )  st( if ( (osalReadyMap[(idx) >> 3] &= ~BV( (idx) & 0x07 )) == 0 ) \
+                                   { osalReadyAny &= ~BV( (idx) >> 3 ); } )
+
 /*********************************************************************
  * CONSTANTS
  */
 
+// Task whose events are set in tasksEvents directly, without osal_set_event(),
+// by the MAC library. It is checked on every pass through osal_run_system(),
+// the other tasks are found through the ready-task bitmap.
+#if !defined ( OSAL_READY_POLL_TASK )
+  #define OSAL_READY_POLL_TASK  0
+#endif
+
+// Number of times in a row the highest priority ready task may run
+// before the next ready task gets a turn. 0 lets it run for as long
+// as it has events.
+#if !defined ( OSAL_TASK_QUANTUM )
+  #define OSAL_TASK_QUANTUM  0
+#endif
+
+#if OSAL_SCHED_STATS
+// Time stamp source of the scheduler statistics, 320 us ticks by default.
+#if !defined ( OSAL_SCHED_TIME )
+  #define OSAL_SCHED_TIME()  macMcuPrecisionCount()
+#endif
+
+#define OSAL_SCHED_EVENT_BITS  16
+#endif
+
+// Copies of at least this many bytes between XDATA buffers are handed to
+// the HAL memory-to-memory DMA channel. 0 keeps every copy on the CPU.
+#if !defined ( OSAL_MEMCPY_DMA_THRESHOLD )
+  #define OSAL_MEMCPY_DMA_THRESHOLD  0
+#endif
+
+#if ( OSAL_MEMCPY_DMA_THRESHOLD )
+#if !((defined HAL_DMA) && (HAL_DMA == TRUE))
+#error OSAL_MEMCPY_DMA_THRESHOLD requires HAL_DMA.
+#endif
+#if !defined ( HAL_DMA_CH_MEM )
+#error OSAL_MEMCPY_DMA_THRESHOLD requires a target with a HAL_DMA_CH_MEM channel.
+#endif
+
+#define OSAL_MEMCPY_DMA( src, len )  ( ((len) >= OSAL_MEMCPY_DMA_THRESHOLD) && \
+                                       ((len) <= HAL_DMA_MAX_LEN) && \
+                                       HAL_DMA_XDATA_PTR( (src) ) )
+#endif
+
 /*********************************************************************
  * TYPEDEFS
  */
 
+// Message queue of a single task - urgent messages are kept at the front.
+typedef struct
+{
+  osal_msg_q_t head;     // First message waiting for the task
+  void        *tail;     // Last message waiting for the task
+  void        *urgTail;  // Last urgent message waiting for the task
+  uint16       cnt;      // Number of messages waiting for the task
+  uint8        urgCnt;   // Number of urgent messages waiting for the task
+} osalTaskMsgQ_t;
+
+#if OSAL_SCHED_STATS
+// Scheduler statistics of a single task
+typedef struct
+{
+  osalSchedStats_t stats;
+  uint32           readyTime;  // Time the first pending event was set
+  uint8            ready;      // TRUE when readyTime is valid
+} osalSchedTask_t;
+#endif
+
 /*********************************************************************
  * GLOBAL VARIABLES
  */
 
-// Message Pool Definitions
-osal_msg_q_t osal_qHead;
-
 /*********************************************************************
  * EXTERNAL VARIABLES
  */
@@ -90,6 +161,10 @@ osal_msg_q_t osal_qHead;
  * EXTERNAL FUNCTIONS
  */
 
+#if OSAL_SCHED_STATS
+extern uint32 macMcuPrecisionCount(void);
+#endif
+
 /*********************************************************************
  * LOCAL VARIABLES
  */
@@ -97,11 +172,48 @@ osal_msg_q_t osal_qHead;
 // Index of active task
 static uint8 activeTaskID = TASK_NO_TASK;
 
+// Message Pool Definitions - one queue per task, indexed by task ID
+static osalTaskMsgQ_t *osalTaskMsgQ;
+
+// Number of urgent messages waiting for all the tasks
+static uint8 osalUrgentCnt;
+
+// Ready-task bitmap - bit (idx & 7) of osalReadyMap[idx >> 3] is set when
+// task idx may have events, and bit n of osalReadyAny when osalReadyMap[n]
+// is not zero. It is only a hint, events are always read from tasksEvents.
+static uint8 *osalReadyMap;
+static uint8 osalReadyAny;
+
+// Index of the lowest bit set in a nibble
+static const uint8 osalLowBit[16] = { 0, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0 };
+
+#if OSAL_TASK_QUANTUM
+// Task that ran last and the number of times it ran in a row
+static uint8 quantumTaskID = TASK_NO_TASK;
+static uint8 quantumCnt;
+#endif
+
+#if OSAL_SCHED_STATS
+// Scheduler statistics, one entry per task, indexed by task ID
+static osalSchedTask_t *osalSchedTask;
+
+// Task whose events are measured one by one and their statistics
+static uint8 osalSchedWatchID = TASK_NO_TASK;
+static osalSchedStats_t osalSchedEvent[OSAL_SCHED_EVENT_BITS];
+#endif
+
 /*********************************************************************
  * LOCAL FUNCTION PROTOTYPES
  */
 
 static uint8 osal_msg_enqueue_push( uint8 destination_task, uint8 *msg_ptr, uint8 urgent );
+static uint8 osalLowestBit( uint8 val );
+static uint8 osalReadyFirst( void );
+static uint8 osalUrgentFirst( void );
+#if OSAL_SCHED_STATS
+static void osalSchedStatsAdd( osalSchedStats_t *pStats, uint32 runTime );
+static void osalSchedStatsRun( uint8 task_id, uint16 events, uint32 startTime );
+#endif
 
 /*********************************************************************
  * HELPER FUNCTIONS
@@ -156,8 +268,39 @@ void *osal_memcpy( void *dst, const void GENERIC *src, unsigned int len )
   pSrc = src;
   pDst = dst;
 
-  while ( len-- )
+#if ( OSAL_MEMCPY_DMA_THRESHOLD )
+  if ( OSAL_MEMCPY_DMA( pSrc, len ) )
+  {
+    HalDmaMemcpy( pDst, (const uint8 *)pSrc, len, HAL_DMA_SRCINC_1 );
+    return ( pDst + len );
+  }
+#endif
+
+  // Eight bytes per pass keeps the 16-bit loop count off most bytes.
+  for ( ; len >= 8; len -= 8 )
+  {
+    *pDst++ = *pSrc++;
+    *pDst++ = *pSrc++;
+    *pDst++ = *pSrc++;
+    *pDst++ = *pSrc++;
     *pDst++ = *pSrc++;
+    *pDst++ = *pSrc++;
+    *pDst++ = *pSrc++;
+    *pDst++ = *pSrc++;
+  }
+
+  // Each case copies one byte and falls through to the next.
+  switch ( len )
+  {
+    case 7: *pDst++ = *pSrc++;  // fall through
+    case 6: *pDst++ = *pSrc++;  // fall through
+    case 5: *pDst++ = *pSrc++;  // fall through
+    case 4: *pDst++ = *pSrc++;  // fall through
+    case 3: *pDst++ = *pSrc++;  // fall through
+    case 2: *pDst++ = *pSrc++;  // fall through
+    case 1: *pDst++ = *pSrc++;
+    default: break;
+  }
 
   return ( pDst );
 }
@@ -188,6 +331,22 @@ void *osal_revmemcpy( void *dst, const void GENERIC *src, unsigned int len )
   pSrc += (len-1);
   pDst = dst;
 
+#if ( OSAL_MEMCPY_DMA_THRESHOLD )
+  if ( OSAL_MEMCPY_DMA( src, len ) )
+  {
+    HalDmaMemcpy( pDst, (const uint8 *)pSrc, len, HAL_DMA_SRCINC_M1 );
+    return ( pDst + len );
+  }
+#endif
+
+  for ( ; len >= 4; len -= 4 )
+  {
+    *pDst++ = *pSrc--;
+    *pDst++ = *pSrc--;
+    *pDst++ = *pSrc--;
+    *pDst++ = *pSrc--;
+  }
+
   while ( len-- )
     *pDst++ = *pSrc--;
 
@@ -240,6 +399,17 @@ uint8 osal_memcmp( const void GENERIC *src1, const void GENERIC *src2, unsigned
   pSrc1 = src1;
   pSrc2 = src2;
 
+  for ( ; len >= 4; len -= 4 )
+  {
+    if ( (pSrc1[0] != pSrc2[0]) || (pSrc1[1] != pSrc2[1]) ||
+         (pSrc1[2] != pSrc2[2]) || (pSrc1[3] != pSrc2[3]) )
+    {
+      return FALSE;
+    }
+    pSrc1 += 4;
+    pSrc2 += 4;
+  }
+
   while ( len-- )
   {
     if( *pSrc1++ != *pSrc2++ )
@@ -321,9 +491,9 @@ uint32 osal_build_uint32( uint8 *swapped, uint8 len )
  *
  * @return  pointer to buffer
  */
-unsigned char * _ltoa(unsigned long l, unsigned char *buf, unsigned char radix)
+uint8 * _ltoa(uint32 l, uint8 *buf, uint8 radix)
 {
-#if defined( __GNUC__ )
+#if defined( __GNUC__ ) && !defined( HAL_MCU_HOST )
   return ( (char*)ltoa( l, buf, radix ) );
 #else
   unsigned char tmp1[10] = "", tmp2[10] = "", tmp3[10] = "";
@@ -434,6 +604,9 @@ uint8 * osal_msg_allocate( uint16 len )
   hdr = (osal_msg_hdr_t *) osal_mem_alloc( (short)(len + sizeof( osal_msg_hdr_t )) );
   if ( hdr )
   {
+    hdr->ref = NULL;
+    hdr->refCnt = 1;
+    hdr->priority = OSAL_MSG_PRIO_NORMAL;
     hdr->next = NULL;
     hdr->len = len;
     hdr->dest_id = TASK_NO_TASK;
@@ -450,7 +623,9 @@ uint8 * osal_msg_allocate( uint16 len )
  *
  *    This function is used to deallocate a message buffer. This function
  *    is called by a task (or processing element) after it has finished
- *    processing a received message.
+ *    processing a received message. The buffer is only freed once all
+ *    the references taken with osal_msg_retain() are given back, and
+ *    freeing it gives back the reference it held with osal_msg_attach().
  *
  *
  * @param   uint8 *msg_ptr - pointer to new message buffer
@@ -459,22 +634,171 @@ uint8 * osal_msg_allocate( uint16 len )
  */
 uint8 osal_msg_deallocate( uint8 *msg_ptr )
 {
-  uint8 *x;
+  osal_msg_hdr_t *hdr;
+  halIntState_t intState;
 
   if ( msg_ptr == NULL )
     return ( INVALID_MSG_POINTER );
 
-  // don't deallocate queued buffer
-  if ( OSAL_MSG_ID( msg_ptr ) != TASK_NO_TASK )
+  do
+  {
+    hdr = (osal_msg_hdr_t *)msg_ptr - 1;
+
+    HAL_ENTER_CRITICAL_SECTION(intState);
+    if ( hdr->refCnt > 1 )
+    {
+      // Still used by another holder, which may be a queue
+      hdr->refCnt--;
+      HAL_EXIT_CRITICAL_SECTION(intState);
+      return ( SUCCESS );
+    }
+    HAL_EXIT_CRITICAL_SECTION(intState);
+
+    // don't deallocate queued buffer, its last reference is the queue's
+    if ( hdr->dest_id != TASK_NO_TASK )
+      return ( MSG_BUFFER_NOT_AVAIL );
+
+    // Then release the message this one held - a loop, not a recursion
+    msg_ptr = hdr->ref;
+    osal_mem_free( (void *)hdr );
+  } while ( msg_ptr != NULL );
+
+  return ( SUCCESS );
+}
+
+/*********************************************************************
+ * @fn      osal_msg_retain
+ *
+ * @brief
+ *
+ *    Take one more reference to a message buffer, so that it can be
+ *    passed on without copying it. Each reference is given back with
+ *    osal_msg_deallocate().
+ *
+ * @param   uint8 *msg_ptr - message buffer
+ *
+ * @return  msg_ptr, NULL if the reference count is exhausted
+ */
+uint8 *osal_msg_retain( uint8 *msg_ptr )
+{
+  halIntState_t intState;
+
+  if ( msg_ptr == NULL )
+    return ( NULL );
+
+  HAL_ENTER_CRITICAL_SECTION(intState);
+  if ( OSAL_MSG_REFS( msg_ptr ) == 0xFF )
+  {
+    msg_ptr = NULL;
+  }
+  else
+  {
+    OSAL_MSG_REFS( msg_ptr )++;
+  }
+  HAL_EXIT_CRITICAL_SECTION(intState);
+
+  return ( msg_ptr );
+}
+
+/*********************************************************************
+ * @fn      osal_msg_attach
+ *
+ * @brief
+ *
+ *    Make a message hold a reference to another message until it is
+ *    deallocated, typically because it points into the data of the
+ *    other one. The receiver deallocates the message as usual.
+ *
+ * @param   uint8 *msg_ptr - message that takes the reference
+ * @param   uint8 *ref_ptr - message to reference
+ *
+ * @return  SUCCESS, INVALID_MSG_POINTER, MSG_BUFFER_NOT_AVAIL if the
+ *          message already holds a reference
+ */
+uint8 osal_msg_attach( uint8 *msg_ptr, uint8 *ref_ptr )
+{
+  osal_msg_hdr_t *hdr;
+
+  if ( (msg_ptr == NULL) || (ref_ptr == NULL) || (msg_ptr == ref_ptr) )
+    return ( INVALID_MSG_POINTER );
+
+  hdr = (osal_msg_hdr_t *)msg_ptr - 1;
+  if ( hdr->ref != NULL )
     return ( MSG_BUFFER_NOT_AVAIL );
 
-  x = (uint8 *)((uint8 *)msg_ptr - sizeof( osal_msg_hdr_t ));
+  hdr->ref = osal_msg_retain( ref_ptr );
+
+  return ( (hdr->ref != NULL) ? SUCCESS : MSG_BUFFER_NOT_AVAIL );
+}
+
+/*********************************************************************
+ * @fn      osal_msg_slice
+ *
+ * @brief
+ *
+ *    Reference a part of a message buffer. The slice keeps the buffer
+ *    alive until osal_msg_slice_release(). When the data is not in the
+ *    message itself, the messages it holds with osal_msg_attach() are
+ *    looked at, and the one with the data is referenced.
+ *
+ * @param   osalMsgSlice_t *pSlice - slice to fill in
+ * @param   uint8 *msg_ptr - message buffer
+ * @param   uint8 *data - first byte of the slice, inside the buffer
+ * @param   uint16 len - number of bytes in the slice
+ *
+ * @return  SUCCESS, INVALID_MSG_POINTER, INVALIDPARAMETER if the slice
+ *          is not inside the buffer, MSG_BUFFER_NOT_AVAIL
+ */
+uint8 osal_msg_slice( osalMsgSlice_t *pSlice, uint8 *msg_ptr, uint8 *data, uint16 len )
+{
+  pSlice->msg = NULL;
+  pSlice->data = NULL;
+  pSlice->len = 0;
+
+  if ( msg_ptr == NULL )
+    return ( INVALID_MSG_POINTER );
 
-  osal_mem_free( (void *)x );
+  while ( (data < msg_ptr) || (len > OSAL_MSG_LEN( msg_ptr )) ||
+          ((uint16)(data - msg_ptr) > (OSAL_MSG_LEN( msg_ptr ) - len)) )
+  {
+    msg_ptr = ((osal_msg_hdr_t *)msg_ptr - 1)->ref;
+    if ( msg_ptr == NULL )
+      return ( INVALIDPARAMETER );
+  }
+
+  if ( osal_msg_retain( msg_ptr ) == NULL )
+    return ( MSG_BUFFER_NOT_AVAIL );
+
+  pSlice->msg = msg_ptr;
+  pSlice->data = data;
+  pSlice->len = len;
 
   return ( SUCCESS );
 }
 
+/*********************************************************************
+ * @fn      osal_msg_slice_release
+ *
+ * @brief
+ *
+ *    Give back the reference held by a slice and clear it.
+ *
+ * @param   osalMsgSlice_t *pSlice - slice to release
+ *
+ * @return  none
+ */
+void osal_msg_slice_release( osalMsgSlice_t *pSlice )
+{
+  if ( pSlice->msg != NULL )
+  {
+    (void)osal_msg_deallocate( pSlice->msg );
+  }
+
+  pSlice->msg = NULL;
+  pSlice->data = NULL;
+  pSlice->len = 0;
+}
+
 /*********************************************************************
  * @fn      osal_msg_send
  *
@@ -503,7 +827,7 @@ uint8 osal_msg_send( uint8 destination_task, uint8 *msg_ptr )
  * @brief
  *
  *    This function is called by a task to push a command message
- *    to the head of the OSAL queue. The destination_task field
+ *    to the head of the task's OSAL queue. The destination_task field
  *    must refer to a valid task, since the task ID will be used to
  *    send the message to. This function will also set a message
  *    ready event in the destination task's event list.
@@ -525,7 +849,12 @@ uint8 osal_msg_push_front( uint8 destination_task, uint8 *msg_ptr )
  *
  *    This function is called by a task to either enqueue (append to
  *    queue) or push (prepend to queue) a command message to the OSAL
- *    queue. The destination_task field must refer to a valid task,
+ *    queue of the destination task. Both are done in constant time
+ *    regardless of the number of messages queued for other tasks.
+ *    Urgent messages (OSAL_MSG_PRIO) are queued ahead of the normal
+ *    ones and a pushed message only goes ahead of messages of its own
+ *    priority.
+ *    The destination_task field must refer to a valid task,
  *    since the task ID will be used to send the message to. This 
  *    function will also set a message ready event in the destination
  *    task's event list.
@@ -538,6 +867,11 @@ uint8 osal_msg_push_front( uint8 destination_task, uint8 *msg_ptr )
  */
 static uint8 osal_msg_enqueue_push( uint8 destination_task, uint8 *msg_ptr, uint8 push )
 {
+  osalTaskMsgQ_t *taskQ;
+  void           *prev;
+  uint8           urgent;
+  halIntState_t   intState;
+
   if ( msg_ptr == NULL )
   {
     return ( INVALID_MSG_POINTER );
@@ -559,20 +893,58 @@ static uint8 osal_msg_enqueue_push( uint8 destination_task, uint8 *msg_ptr, uint
 
   OSAL_MSG_ID( msg_ptr ) = destination_task;
 
-  if ( push == TRUE )
+  taskQ = &osalTaskMsgQ[destination_task];
+  urgent = ( OSAL_MSG_PRIO( msg_ptr ) != OSAL_MSG_PRIO_NORMAL );
+
+  // Hold off interrupts
+  HAL_ENTER_CRITICAL_SECTION(intState);
+
+  // Find the message to insert after, NULL to insert at the head
+  if ( urgent )
+  {
+    prev = ( push == TRUE ) ? NULL : taskQ->urgTail;
+  }
+  else
+  {
+    prev = ( push == TRUE ) ? taskQ->urgTail : taskQ->tail;
+  }
+
+  if ( prev == NULL )
   {
     // prepend the message
-    osal_msg_push( &osal_qHead, msg_ptr );
+    OSAL_MSG_NEXT( msg_ptr ) = taskQ->head;
+    taskQ->head = msg_ptr;
   }
   else
   {
-    // append the message
-    osal_msg_enqueue( &osal_qHead, msg_ptr );
+    // insert the message
+    OSAL_MSG_NEXT( msg_ptr ) = OSAL_MSG_NEXT( prev );
+    OSAL_MSG_NEXT( prev ) = msg_ptr;
+  }
+
+  if ( OSAL_MSG_NEXT( msg_ptr ) == NULL )
+  {
+    // last message for the task
+    taskQ->tail = msg_ptr;
+  }
+
+  if ( urgent )
+  {
+    if ( (push != TRUE) || (taskQ->urgTail == NULL) )
+    {
+      taskQ->urgTail = msg_ptr;
+    }
+    taskQ->urgCnt++;
+    osalUrgentCnt++;
   }
+  taskQ->cnt++;
 
   // Signal the task that a message is waiting
   osal_set_event( destination_task, SYS_EVENT_MSG );
 
+  // Release interrupts
+  HAL_EXIT_CRITICAL_SECTION(intState);
+
   return ( SUCCESS );
 }
 
@@ -591,42 +963,48 @@ static uint8 osal_msg_enqueue_push( uint8 destination_task, uint8 *msg_ptr, uint
  */
 uint8 *osal_msg_receive( uint8 task_id )
 {
-  osal_msg_hdr_t *listHdr;
-  osal_msg_hdr_t *prevHdr = NULL;
-  osal_msg_hdr_t *foundHdr = NULL;
+  osalTaskMsgQ_t *taskQ;
+  osal_msg_hdr_t *foundHdr;
   halIntState_t   intState;
 
+  if ( task_id >= tasksCnt )
+  {
+    return ( NULL );
+  }
+
+  taskQ = &osalTaskMsgQ[task_id];
+
   // Hold off interrupts
   HAL_ENTER_CRITICAL_SECTION(intState);
 
-  // Point to the top of the queue
-  listHdr = osal_qHead;
+  // The oldest urgent message, else the oldest message, for the task is
+  // always at the head of its queue
+  foundHdr = taskQ->head;
 
-  // Look through the queue for a message that belongs to the asking task
-  while ( listHdr != NULL )
+  // Did we find a message?
+  if ( foundHdr != NULL )
   {
-    if ( (listHdr - 1)->dest_id == task_id )
+    // Take out of the link list
+    taskQ->head = OSAL_MSG_NEXT( foundHdr );
+    taskQ->cnt--;
+    OSAL_MSG_NEXT( foundHdr ) = NULL;
+    OSAL_MSG_ID( foundHdr ) = TASK_NO_TASK;
+    OSAL_MSG_PRIO( foundHdr ) = OSAL_MSG_PRIO_NORMAL;
+
+    if ( taskQ->urgCnt != 0 )
     {
-      if ( foundHdr == NULL )
-      {
-        // Save the first one
-        foundHdr = listHdr;
-      }
-      else
+      taskQ->urgCnt--;
+      osalUrgentCnt--;
+
+      if ( taskQ->urgCnt == 0 )
       {
-        // Second msg found, stop looking
-        break;
+        taskQ->urgTail = NULL;
       }
     }
-    if ( foundHdr == NULL )
-    {
-      prevHdr = listHdr;
-    }
-    listHdr = OSAL_MSG_NEXT( listHdr );
   }
 
   // Is there more than one?
-  if ( listHdr != NULL )
+  if ( taskQ->cnt != 0 )
   {
     // Yes, Signal the task that a message is waiting
     osal_set_event( task_id, SYS_EVENT_MSG );
@@ -634,16 +1012,10 @@ uint8 *osal_msg_receive( uint8 task_id )
   else
   {
     // No more
+    taskQ->tail = NULL;
     osal_clear_event( task_id, SYS_EVENT_MSG );
   }
 
-  // Did we find a message?
-  if ( foundHdr != NULL )
-  {
-    // Take out of the link list
-    osal_msg_extract( &osal_qHead, foundHdr, prevHdr );
-  }
-
   // Release interrupts
   HAL_EXIT_CRITICAL_SECTION(intState);
 
@@ -673,14 +1045,19 @@ osal_event_hdr_t *osal_msg_find(uint8 task_id, uint8 event)
   osal_msg_hdr_t *pHdr;
   halIntState_t intState;
 
+  if (task_id >= tasksCnt)
+  {
+    return NULL;
+  }
+
   HAL_ENTER_CRITICAL_SECTION(intState);  // Hold off interrupts.
 
-  pHdr = osal_qHead;  // Point to the top of the queue.
+  pHdr = osalTaskMsgQ[task_id].head;  // Point to the top of the task's queue.
 
-  // Look through the queue for a message that matches the task_id and event parameters.
+  // Look through the queue for a message that matches the event parameter.
   while (pHdr != NULL)
   {
-    if (((pHdr-1)->dest_id == task_id) && (((osal_event_hdr_t *)pHdr)->event == event))
+    if (((osal_event_hdr_t *)pHdr)->event == event)
     {
       break;
     }
@@ -905,7 +1282,16 @@ uint8 osal_set_event( uint8 task_id, uint16 event_flag )
   {
     halIntState_t   intState;
     HAL_ENTER_CRITICAL_SECTION(intState);    // Hold off interrupts
+#if OSAL_SCHED_STATS
+    if ( (osalSchedTask != NULL) && !osalSchedTask[task_id].ready )
+    {
+      // The task is waiting to run from now on
+      osalSchedTask[task_id].readyTime = OSAL_SCHED_TIME();
+      osalSchedTask[task_id].ready = TRUE;
+    }
+#endif
     tasksEvents[task_id] |= event_flag;  // Stuff the event bit(s)
+    OSAL_READY_SET( task_id );
     HAL_EXIT_CRITICAL_SECTION(intState);     // Release interrupts
     return ( SUCCESS );
   }
@@ -935,6 +1321,10 @@ uint8 osal_clear_event( uint8 task_id, uint16 event_flag )
     halIntState_t   intState;
     HAL_ENTER_CRITICAL_SECTION(intState);    // Hold off interrupts
     tasksEvents[task_id] &= ~(event_flag);   // Clear the event bit(s)
+    if ( tasksEvents[task_id] == 0 )
+    {
+      OSAL_READY_CLR( task_id );
+    }
     HAL_EXIT_CRITICAL_SECTION(intState);     // Release interrupts
     return ( SUCCESS );
   }
@@ -1043,8 +1433,21 @@ uint8 osal_init_system( void )
   // Initialize the Memory Allocation System
   osal_mem_init();
 
-  // Initialize the message queue
-  osal_qHead = NULL;
+  // Initialize the message queues - a long-lived allocation, like tasksEvents.
+  osalTaskMsgQ = osal_mem_alloc( sizeof( osalTaskMsgQ_t ) * tasksCnt );
+  osal_memset( osalTaskMsgQ, 0, (sizeof( osalTaskMsgQ_t ) * tasksCnt) );
+
+  // Initialize the ready-task bitmap - osalReadyAny covers up to 64 tasks.
+  HAL_ASSERT( tasksCnt <= 64 );
+  osalReadyMap = osal_mem_alloc( (tasksCnt + 7) >> 3 );
+  osal_memset( osalReadyMap, 0, ((tasksCnt + 7) >> 3) );
+  osalReadyAny = 0;
+
+#if OSAL_SCHED_STATS
+  // Initialize the scheduler statistics
+  osalSchedTask = osal_mem_alloc( sizeof( osalSchedTask_t ) * tasksCnt );
+  osal_sched_stats_reset();
+#endif
 
   // Initialize the timers
   osalTimerInit();
@@ -1107,29 +1510,107 @@ void osal_run_system( void )
   
   Hal_ProcessPoll();
 
-  do {
-    if (tasksEvents[idx])  // Task is highest priority that is ready.
+  idx = osalReadyFirst();  // Task is highest priority that is ready.
+
+  if ((osalUrgentCnt != 0) && (idx < tasksCnt))
+  {
+    // Ready tasks with urgent messages waiting go first, in priority order.
+    uint8 urgent = osalUrgentFirst();
+
+    if (urgent < tasksCnt)
     {
-      break;
+#if OSAL_TASK_QUANTUM
+      // Unless it used up its quantum, then it waits its turn like the others.
+      if ((urgent != quantumTaskID) || (quantumCnt < OSAL_TASK_QUANTUM))
+#endif
+      {
+        idx = urgent;
+      }
+    }
+  }
+
+#if OSAL_TASK_QUANTUM
+  if (idx < tasksCnt)
+  {
+    // Once the task has used up its quantum, let the next ready task run.
+    if ((idx == quantumTaskID) && (quantumCnt >= OSAL_TASK_QUANTUM))
+    {
+      uint8 next = idx;
+
+      while (++next < tasksCnt)
+      {
+        if (tasksEvents[next])
+        {
+          idx = next;
+          break;
+        }
+      }
     }
-  } while (++idx < tasksCnt);
+
+    if (idx == quantumTaskID)
+    {
+      quantumCnt++;
+    }
+    else
+    {
+      quantumTaskID = idx;
+      quantumCnt = 1;
+    }
+  }
+#endif
 
   if (idx < tasksCnt)
   {
     uint16 events;
     halIntState_t intState;
+#if OSAL_SCHED_STATS
+    uint16 runEvents;
+    uint32 startTime;
+#endif
 
     HAL_ENTER_CRITICAL_SECTION(intState);
     events = tasksEvents[idx];
     tasksEvents[idx] = 0;  // Clear the Events for this task.
+    OSAL_READY_CLR(idx);
+#if OSAL_SCHED_STATS
+    startTime = OSAL_SCHED_TIME();
+    runEvents = events;
+    if (osalSchedTask[idx].ready)
+    {
+      uint32 waitTime = startTime - osalSchedTask[idx].readyTime;
+
+      osalSchedTask[idx].stats.waitTotal += waitTime;
+      if (osalSchedTask[idx].stats.waitMax < waitTime)
+      {
+        osalSchedTask[idx].stats.waitMax = (waitTime > 0xFFFF) ? 0xFFFF : (uint16)waitTime;
+      }
+      osalSchedTask[idx].ready = FALSE;
+    }
+#endif
     HAL_EXIT_CRITICAL_SECTION(intState);
 
     activeTaskID = idx;
     events = (tasksArr[idx])( idx, events );
     activeTaskID = TASK_NO_TASK;
 
+#if OSAL_SCHED_STATS
+    osalSchedStatsRun(idx, (runEvents & ~events), startTime);
+#endif
+
     HAL_ENTER_CRITICAL_SECTION(intState);
     tasksEvents[idx] |= events;  // Add back unprocessed events to the current task.
+    if (tasksEvents[idx] != 0)
+    {
+      OSAL_READY_SET(idx);
+    }
+#if OSAL_SCHED_STATS
+    if ((tasksEvents[idx] != 0) && !osalSchedTask[idx].ready)
+    {
+      // Unprocessed events wait from now on for the next run.
+      osalSchedTask[idx].readyTime = OSAL_SCHED_TIME();
+      osalSchedTask[idx].ready = TRUE;
+    }
+#endif
     HAL_EXIT_CRITICAL_SECTION(intState);
   }
 #if defined( POWER_SAVING )
@@ -1147,6 +1628,276 @@ void osal_run_system( void )
 #endif
 }
 
+/*********************************************************************
+ * @fn      osalLowestBit
+ *
+ * @brief   Find the lowest bit set in a byte.
+ *
+ * @param   val - byte, must not be zero
+ *
+ * @return  index of the lowest bit set
+ */
+static uint8 osalLowestBit( uint8 val )
+{
+  if ( val & 0x0F )
+  {
+    return ( osalLowBit[val & 0x0F] );
+  }
+  else
+  {
+    return ( 4 + osalLowBit[val >> 4] );
+  }
+}
+
+/*********************************************************************
+ * @fn      osalReadyFirst
+ *
+ * @brief   Find the highest priority task that has events, using the
+ *          ready-task bitmap. Tasks marked ready whose events were
+ *          cleared behind OSAL's back are dropped from the bitmap.
+ *
+ * @param   none
+ *
+ * @return  task ID, tasksCnt if no task has events
+ */
+static uint8 osalReadyFirst( void )
+{
+  uint8 idx = tasksCnt;
+  halIntState_t intState;
+
+  HAL_ENTER_CRITICAL_SECTION(intState);
+
+  // Catch up with the events that the MAC library sets on its own.
+  if ( tasksEvents[OSAL_READY_POLL_TASK] )
+  {
+    OSAL_READY_SET( OSAL_READY_POLL_TASK );
+  }
+
+  while ( osalReadyAny != 0 )
+  {
+    uint8 byte = osalLowestBit( osalReadyAny );
+
+    idx = (byte << 3) + osalLowestBit( osalReadyMap[byte] );
+
+    if ( tasksEvents[idx] )
+    {
+      break;
+    }
+
+    OSAL_READY_CLR( idx );
+    idx = tasksCnt;
+  }
+
+  HAL_EXIT_CRITICAL_SECTION(intState);
+
+  return ( idx );
+}
+
+/*********************************************************************
+ * @fn      osalUrgentFirst
+ *
+ * @brief   Find the highest priority task that is ready to receive an
+ *          urgent message: marked in the ready-task bitmap, with an
+ *          urgent message queued and SYS_EVENT_MSG set. Called after
+ *          osalReadyFirst() has brought the bitmap up to date.
+ *
+ * @param   none
+ *
+ * @return  task ID, tasksCnt if no task is ready with an urgent message
+ */
+static uint8 osalUrgentFirst( void )
+{
+  uint8 idx;
+  halIntState_t intState;
+
+  HAL_ENTER_CRITICAL_SECTION(intState);
+
+  for ( idx = 0; idx < tasksCnt; idx++ )
+  {
+    if ( (osalTaskMsgQ[idx].urgCnt != 0) &&
+         (osalReadyMap[idx >> 3] & BV( idx & 0x07 )) &&
+         (tasksEvents[idx] & SYS_EVENT_MSG) )
+    {
+      break;
+    }
+  }
+
+  HAL_EXIT_CRITICAL_SECTION(intState);
+
+  return ( idx );
+}
+
+#if OSAL_SCHED_STATS
+/*********************************************************************
+ * @fn      osalSchedStatsAdd
+ *
+ * @brief   Add a run to scheduler statistics.
+ *
+ * @param   pStats - statistics to update
+ * @param   runTime - duration of the run
+ *
+ * @return  none
+ */
+static void osalSchedStatsAdd( osalSchedStats_t *pStats, uint32 runTime )
+{
+  pStats->runCnt++;
+  pStats->runTotal += runTime;
+
+  if ( pStats->runMax < runTime )
+  {
+    pStats->runMax = (runTime > 0xFFFF) ? 0xFFFF : (uint16)runTime;
+  }
+}
+
+/*********************************************************************
+ * @fn      osalSchedStatsRun
+ *
+ * @brief   Account a run of a task's event handler. For the watched
+ *          task, the run is also accounted to each event it processed.
+ *
+ * @param   task_id - task that ran
+ * @param   events - events processed by the run
+ * @param   startTime - time the run started
+ *
+ * @return  none
+ */
+static void osalSchedStatsRun( uint8 task_id, uint16 events, uint32 startTime )
+{
+  uint32 runTime = OSAL_SCHED_TIME() - startTime;
+  uint8 bit;
+
+  osalSchedStatsAdd( &osalSchedTask[task_id].stats, runTime );
+
+  if ( task_id == osalSchedWatchID )
+  {
+    for ( bit = 0; events != 0; bit++, events >>= 1 )
+    {
+      if ( events & 0x0001 )
+      {
+        osalSchedStatsAdd( &osalSchedEvent[bit], runTime );
+      }
+    }
+  }
+}
+
+/*********************************************************************
+ * @fn      osal_sched_stats_get
+ *
+ * @brief
+ *
+ *   Copy the scheduler statistics of a task. Times are in ticks of
+ *   OSAL_SCHED_TIME(). The wait time is not measured for the events
+ *   set without osal_set_event().
+ *
+ * @param   task_id - task to get the statistics of
+ * @param   pStats - buffer for the statistics
+ *
+ * @return  SUCCESS, INVALID_TASK
+ */
+uint8 osal_sched_stats_get( uint8 task_id, osalSchedStats_t *pStats )
+{
+  halIntState_t intState;
+
+  if ( task_id >= tasksCnt )
+  {
+    return ( INVALID_TASK );
+  }
+
+  HAL_ENTER_CRITICAL_SECTION(intState);
+  *pStats = osalSchedTask[task_id].stats;
+  HAL_EXIT_CRITICAL_SECTION(intState);
+
+  return ( SUCCESS );
+}
+
+/*********************************************************************
+ * @fn      osal_sched_event_stats_get
+ *
+ * @brief
+ *
+ *   Copy the scheduler statistics of one event of the watched task.
+ *   A run that processes several events is accounted to each of them.
+ *   There is no wait time per event.
+ *
+ * @param   event_bit - bit number of the event, 0 for 0x0001
+ * @param   pStats - buffer for the statistics
+ *
+ * @return  SUCCESS, INVALID_EVENT_ID, INVALID_TASK if no task is watched
+ */
+uint8 osal_sched_event_stats_get( uint8 event_bit, osalSchedStats_t *pStats )
+{
+  halIntState_t intState;
+
+  if ( osalSchedWatchID == TASK_NO_TASK )
+  {
+    return ( INVALID_TASK );
+  }
+
+  if ( event_bit >= OSAL_SCHED_EVENT_BITS )
+  {
+    return ( INVALID_EVENT_ID );
+  }
+
+  HAL_ENTER_CRITICAL_SECTION(intState);
+  *pStats = osalSchedEvent[event_bit];
+  HAL_EXIT_CRITICAL_SECTION(intState);
+
+  return ( SUCCESS );
+}
+
+/*********************************************************************
+ * @fn      osal_sched_stats_watch
+ *
+ * @brief
+ *
+ *   Start collecting per event statistics for a task. Only one task
+ *   is watched at a time, watching another task clears the per event
+ *   statistics.
+ *
+ * @param   task_id - task to watch, TASK_NO_TASK to stop watching
+ *
+ * @return  task watched so far
+ */
+uint8 osal_sched_stats_watch( uint8 task_id )
+{
+  uint8 prevID = osalSchedWatchID;
+
+  if ( task_id >= tasksCnt )
+  {
+    task_id = TASK_NO_TASK;
+  }
+
+  if ( task_id != prevID )
+  {
+    osalSchedWatchID = task_id;
+    osal_memset( osalSchedEvent, 0, sizeof( osalSchedEvent ) );
+  }
+
+  return ( prevID );
+}
+
+/*********************************************************************
+ * @fn      osal_sched_stats_reset
+ *
+ * @brief
+ *
+ *   Clear the scheduler statistics of all the tasks and events.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void osal_sched_stats_reset( void )
+{
+  halIntState_t intState;
+
+  HAL_ENTER_CRITICAL_SECTION(intState);
+  osal_memset( osalSchedTask, 0, (sizeof( osalSchedTask_t ) * tasksCnt) );
+  osal_memset( osalSchedEvent, 0, sizeof( osalSchedEvent ) );
+  HAL_EXIT_CRITICAL_SECTION(intState);
+}
+#endif
+
 /*********************************************************************
  * @fn      osal_buffer_uint32
  *
@@ -50,8 +50,6 @@
  * MACROS
  */
 
-#define	YearLength(yr)	((uint16)(IsLeapYear(yr) ? 366 : 365))
-
 /*********************************************************************
  * CONSTANTS
  */
@@ -60,6 +58,13 @@
 
 #define	DAY      86400UL  // 24 hours * 60 minutes * 60 seconds
 
+// Days in a 4 year cycle starting with a leap year (2000, 2004, ...)
+#define QUADYEAR ((uint16)(4 * 365 + 1))
+
+// Day number of 01/03/2100 - 2100 is the only non-leap 4th year that
+// fits in UTCTime, which runs out in February 2136
+#define DAY2100  ((uint16)(25 * QUADYEAR + 31 + 28))
+
 /* Check Below for an explanation */
 #define COUNTER_TICK320US 204775UL 
 
@@ -151,6 +156,12 @@ static uint32 previousMacTimerTick = 0;
 static uint16 remUsTicks = 0;
 static uint32 timeMSec = 0;
 
+// Days before the 1st of each month in a non-leap year
+static CONST uint16 monthDays[13] =
+{
+  0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334, 365
+};
+
 // number of seconds since 0 hrs, 0 minutes, 0 seconds, on the
 // 1st of January 2000 UTC
 UTCTime OSAL_timeSeconds = 0;
@@ -158,8 +169,6 @@ UTCTime OSAL_timeSeconds = 0;
 /*********************************************************************
  * LOCAL FUNCTION PROTOTYPES
  */
-static uint8 monthLength( uint8 lpyr, uint8 mon );
-
 static void osalClockUpdate( uint32 elapsedMSec );
 
 /*********************************************************************
@@ -336,55 +345,49 @@ void osal_ConvertUTCTime( UTCTimeStruct *tm, UTCTime secTime )
   // Fill in the calendar - day, month, year
   {
     uint16 numDays = secTime / DAY;
-    tm->year = BEGYEAR;
-    while ( numDays >= YearLength( tm->year ) )
-    {
-      numDays -= YearLength( tm->year );
-      tm->year++;
-    }
+    uint8 leap;
+    uint8 mon;
 
-    tm->month = 0;
-    while ( numDays >= monthLength( IsLeapYear( tm->year ), tm->month ) )
+    // Pretend 2100 has a 29th of February so the 4 year cycle holds
+    if ( numDays >= DAY2100 )
     {
-      numDays -= monthLength( IsLeapYear( tm->year ), tm->month );
-      tm->month++;
+      numDays++;
     }
 
-    tm->day = numDays;
-  }
-}
+    tm->year = BEGYEAR + (4 * (numDays / QUADYEAR));
+    numDays %= QUADYEAR;
 
-/*********************************************************************
- * @fn      monthLength
- *
- * @param   lpyr - 1 for leap year, 0 if not
- *
- * @param   mon - 0 - 11 (jan - dec)
- *
- * @return  number of days in specified month
- */
-static uint8 monthLength( uint8 lpyr, uint8 mon )
-{
-  uint8 days = 31;
+    // The first year of each cycle is the leap year
+    leap = ( numDays < 366 );
+    if ( !leap )
+    {
+      numDays -= 366;
+      tm->year += 1 + (numDays / 365);
+      numDays %= 365;
+    }
 
-	if ( mon == 1 ) // feb
-  {
-		days = ( 28 + lpyr );
-  }
-  else
-  {
-    if ( mon > 6 ) // aug-dec
+    if ( leap && (numDays >= monthDays[2]) )
     {
-      mon--;
+      if ( numDays == monthDays[2] )
+      {
+        // 29th of February
+        tm->month = 1;
+        tm->day = 28;
+        return;
+      }
+      numDays--;
     }
 
-    if ( mon & 1 )
+    // No month is longer than 32 days, so this is at most one month short
+    mon = numDays >> 5;
+    if ( numDays >= monthDays[mon + 1] )
     {
-      days = 30;
+      mon++;
     }
-  }
 
-	return ( days );
+    tm->month = mon;
+    tm->day = numDays - monthDays[mon];
+  }
 }
 
 /*********************************************************************
@@ -409,20 +412,23 @@ UTCTime osal_ConvertUTCSecs( UTCTimeStruct *tm )
     uint16 days = tm->day;
 
     /* Next, complete months in current year */
+    days += monthDays[tm->month];
+    if ( (tm->month > 1) && IsLeapYear( tm->year ) )
     {
-      int8 month = tm->month;
-      while ( --month >= 0 )
-      {
-        days += monthLength( IsLeapYear( tm->year ), month );
-      }
+      days++;
     }
 
-    /* Next, complete years before current year */
+    /* Next, complete years before current year - every 4th one is a
+     * leap year, except 2100
+     */
+    if ( tm->year > BEGYEAR )
     {
-      uint16 year = tm->year;
-      while ( --year >= BEGYEAR )
+      uint16 years = tm->year - BEGYEAR;
+
+      days += (years * 365) + ((years + 3) / 4);
+      if ( tm->year > 2100 )
       {
-        days += YearLength( year );
+        days--;
       }
     }
 
@@ -50,6 +50,14 @@
 #include "hal_mcu.h"
 #include "hal_assert.h"
 
+#if OSALMEM_TRACE && !defined DPRINTF_OSALHEAPTRACE
+// The libraries call osal_mem_alloc() and osal_mem_free() directly, so they remain functions.
+#undef osal_mem_alloc
+#undef osal_mem_free
+void *osal_mem_alloc( uint16 size );
+void osal_mem_free( void *ptr );
+#endif
+
 /* ------------------------------------------------------------------------------------------------
  *                                           Constants
  * ------------------------------------------------------------------------------------------------
@@ -147,6 +155,38 @@
 #define OSALMEM_REIN              'F'
 #endif
 
+/* Select the segregated-fit allocator instead of the first-fit allocator. It keeps a free list per
+ * size class so that allocating and freeing take bounded time and blocks of one class are never
+ * split up by allocations of another. Blocks above the largest class are carved from the
+ * wilderness and recycled through a first-fit list of large blocks.
+ */
+#if !defined OSALMEM_SEGFIT
+#define OSALMEM_SEGFIT             FALSE
+#endif
+
+#if OSALMEM_TRACE && !OSALMEM_METRICS
+#error OSALMEM_TRACE requires OSALMEM_METRICS.
+#endif
+#if OSALMEM_TRACE && (OSALMEM_TRACE_CNT & (OSALMEM_TRACE_CNT - 1))
+#error OSALMEM_TRACE_CNT must be a power of 2.
+#endif
+
+#if OSALMEM_SEGFIT
+#if OSALMEM_PROFILER
+#error OSALMEM_PROFILER is only supported by the first-fit allocator.
+#endif
+
+// Block sizes of the size classes, including the header. Must be in increasing order.
+#define OSALMEM_SEG_CLASSES        4
+#define OSALMEM_SEG_CLASS0        (OSALMEM_ROUND(16))
+#define OSALMEM_SEG_CLASS1        (OSALMEM_ROUND(32))
+#define OSALMEM_SEG_CLASS2        (OSALMEM_ROUND(64))
+#define OSALMEM_SEG_CLASS3        (OSALMEM_ROUND(128))
+
+// A free block links to the next free block of its list through its first data bytes.
+#define OSALMEM_SEG_NEXT(HDR)     (*(osalMemHdr_t **)((HDR) + 1))
+#endif
+
 /* ------------------------------------------------------------------------------------------------
  *                                           Typedefs
  * ------------------------------------------------------------------------------------------------
@@ -183,6 +223,14 @@ static osalMemHdr_t *ff1;  // First free block in the small-block bucket.
 
 static uint8 osalMemStat;            // Discrete status flags: 0x01 = kicked.
 
+#if OSALMEM_SEGFIT
+static const uint16 segClassSz[OSALMEM_SEG_CLASSES] = {
+OSALMEM_SEG_CLASS0, OSALMEM_SEG_CLASS1, OSALMEM_SEG_CLASS2, OSALMEM_SEG_CLASS3 };
+static osalMemHdr_t *segFree[OSALMEM_SEG_CLASSES];  // Free blocks of each size class.
+static osalMemHdr_t *segLarge;  // Free blocks that are not of a size class.
+static osalMemHdr_t *segTop;    // First block of the wilderness.
+#endif
+
 #if OSALMEM_METRICS
 static uint16 blkMax;  // Max cnt of all blocks ever seen at once.
 static uint16 blkCnt;  // Current cnt of all blocks.
@@ -205,6 +253,12 @@ static uint16 proTot[OSALMEM_PROMAX] = { 0 };
 static uint16 proSmallBlkMiss;
 #endif
 
+#if OSALMEM_TRACE
+static osalMemTrace_t memTrace[OSALMEM_TRACE_CNT];  // Ring buffer of the latest trace records.
+static uint16 memTraceSeq;                          // Cnt of trace records ever written.
+static uint8 memTracePause;                         // TRUE while no trace records are written.
+#endif
+
 /* ------------------------------------------------------------------------------------------------
  *                                           Global Variables
  * ------------------------------------------------------------------------------------------------
@@ -214,6 +268,26 @@ static uint16 proSmallBlkMiss;
 extern int dprintf(const char *fmt, ...);
 #endif /* DPRINTF_HEAPTRACE */
 
+/* ------------------------------------------------------------------------------------------------
+ *                                           Local Functions
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#if OSALMEM_TRACE
+static void osalMemTraceAdd(uint8 op, uint16 size, void *ptr, const char *fname, unsigned lnum);
+#endif
+
+#if OSALMEM_SEGFIT
+static uint8 osalMemSegClass(uint16 size);
+static void osalMemSegPut(osalMemHdr_t *hdr);
+static osalMemHdr_t *osalMemSegCarve(uint16 size);
+static osalMemHdr_t *osalMemSegLarge(uint16 size);
+static osalMemHdr_t *osalMemSegFind(uint16 size);
+static uint8 osalMemSegMerge(void);
+static osalMemHdr_t *osalMemSegAlloc(uint16 size);
+static void osalMemSegFree(osalMemHdr_t *hdr);
+#endif
+
 /**************************************************************************************************
  * @fn          osal_mem_init
  *
@@ -242,6 +316,17 @@ void osal_mem_init(void)
   // Setup a NULL block at the end of the heap for fast comparisons with zero.
   theHeap[OSALMEM_LASTBLK_IDX].val = 0;
 
+#if OSALMEM_SEGFIT
+  // The whole heap starts out as the wilderness, all the free lists are empty.
+  segTop = theHeap;
+  segLarge = NULL;
+  (void)osal_memset(segFree, 0, sizeof(segFree));
+
+#if ( OSALMEM_METRICS )
+  // Start with the wilderness - don't count the end-of-heap NULL block.
+  blkCnt = blkFree = 1;
+#endif
+#else
   // Setup the small-block bucket.
   ff1 = theHeap;
   ff1->val = OSALMEM_SMALLBLK_BUCKET;                   // Set 'len' & clear 'inUse' field.
@@ -258,6 +343,7 @@ void osal_mem_init(void)
    */
   blkCnt = blkFree = 2;
 #endif
+#endif
 }
 
 /**************************************************************************************************
@@ -312,16 +398,21 @@ void osal_mem_kick(void)
  *
  * @return      None.
  */
-#ifdef DPRINTF_OSALHEAPTRACE
+#if defined DPRINTF_OSALHEAPTRACE || OSALMEM_TRACE
 void *osal_mem_alloc_dbg( uint16 size, const char *fname, unsigned lnum )
 #else /* DPRINTF_OSALHEAPTRACE */
 void *osal_mem_alloc( uint16 size )
 #endif /* DPRINTF_OSALHEAPTRACE */
 {
+#if !OSALMEM_SEGFIT
   osalMemHdr_t *prev = NULL;
+  uint8 coal = 0;
+#endif
   osalMemHdr_t *hdr;
   halIntState_t intState;
-  uint8 coal = 0;
+#if OSALMEM_TRACE
+  const uint16 reqSize = size;
+#endif
 
   size += OSALMEM_HDRSZ;
 
@@ -342,6 +433,14 @@ void *osal_mem_alloc( uint16 size )
 
   HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
 
+#if OSALMEM_SEGFIT
+  hdr = osalMemSegAlloc(size);
+
+  if ( hdr != NULL )
+  {
+    hdr++;
+  }
+#else
   // Smaller allocations are first attempted in the small-block bucket, and all long-lived
   // allocations are channeled into the LL block reserved within this bucket.
   if ((osalMemStat == 0) || (size <= OSALMEM_SMALL_BLKSZ))
@@ -480,6 +579,7 @@ void *osal_mem_alloc( uint16 size )
 
     hdr++;
   }
+#endif
 
   HAL_EXIT_CRITICAL_SECTION( intState );  // Re-enable interrupts.
 
@@ -493,6 +593,9 @@ void *osal_mem_alloc( uint16 size )
 #ifdef DPRINTF_OSALHEAPTRACE
   dprintf("osal_mem_alloc(%u)->%lx:%s:%u\n", size, (unsigned) hdr, fname, lnum);
 #endif /* DPRINTF_OSALHEAPTRACE */
+#if OSALMEM_TRACE
+  osalMemTraceAdd(OSALMEM_TRACE_ALLOC, reqSize, hdr, fname, lnum);
+#endif
   return (void *)hdr;
 }
 
@@ -511,7 +614,7 @@ void *osal_mem_alloc( uint16 size )
  *
  * @return      None.
  */
-#ifdef DPRINTF_OSALHEAPTRACE
+#if defined DPRINTF_OSALHEAPTRACE || OSALMEM_TRACE
 void osal_mem_free_dbg(void *ptr, const char *fname, unsigned lnum)
 #else /* DPRINTF_OSALHEAPTRACE */
 void osal_mem_free(void *ptr)
@@ -519,6 +622,9 @@ void osal_mem_free(void *ptr)
 {
   osalMemHdr_t *hdr = (osalMemHdr_t *)ptr - 1;
   halIntState_t intState;
+#if OSALMEM_TRACE
+  const uint16 blkSize = hdr->hdr.len - OSALMEM_HDRSZ;
+#endif
 
 #ifdef DPRINTF_OSALHEAPTRACE
   dprintf("osal_mem_free(%lx):%s:%u\n", (unsigned) ptr, fname, lnum);
@@ -528,6 +634,10 @@ void osal_mem_free(void *ptr)
   HAL_ASSERT(hdr->hdr.inUse);
 
   HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
+
+#if OSALMEM_SEGFIT
+  osalMemSegFree(hdr);
+#else
   hdr->hdr.inUse = FALSE;
 
   if (ff1 > hdr)
@@ -559,9 +669,563 @@ void osal_mem_free(void *ptr)
   memAlo -= hdr->hdr.len;
   blkFree++;
 #endif
+#endif
+
+  HAL_EXIT_CRITICAL_SECTION( intState );  // Re-enable interrupts.
+
+#if OSALMEM_TRACE
+  osalMemTraceAdd(OSALMEM_TRACE_FREE, blkSize, ptr, fname, lnum);
+#endif
+}
+
+#if OSALMEM_TRACE && !defined DPRINTF_OSALHEAPTRACE
+/**************************************************************************************************
+ * @fn          osal_mem_alloc
+ *
+ * @brief       Traced allocation for callers that were not compiled with OSALMEM_TRACE.
+ *
+ * input parameters
+ *
+ * @param size - the number of bytes to allocate from the HEAP.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ */
+void *osal_mem_alloc(uint16 size)
+{
+  return osal_mem_alloc_dbg(size, NULL, 0);
+}
+
+/**************************************************************************************************
+ * @fn          osal_mem_free
+ *
+ * @brief       Traced de-allocation for callers that were not compiled with OSALMEM_TRACE.
+ *
+ * input parameters
+ *
+ * @param ptr - A valid pointer (i.e. a pointer returned by osal_mem_alloc()) to the memory to free.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ */
+void osal_mem_free(void *ptr)
+{
+  osal_mem_free_dbg(ptr, NULL, 0);
+}
+#endif
+
+#if OSALMEM_TRACE
+/**************************************************************************************************
+ * @fn          osalMemTraceAdd
+ *
+ * @brief       Write a heap trace record, overwriting the oldest one when the trace is full.
+ *
+ * input parameters
+ *
+ * @param op - OSALMEM_TRACE_ALLOC or OSALMEM_TRACE_FREE.
+ * @param size - the number of bytes asked for or freed.
+ * @param ptr - the memory allocated or freed, NULL for a failed allocation.
+ * @param fname - the file of the caller.
+ * @param lnum - the line of the caller.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ */
+static void osalMemTraceAdd(uint8 op, uint16 size, void *ptr, const char *fname, unsigned lnum)
+{
+  osalMemTrace_t *pRec;
+  halIntState_t intState;
+
+  if ( memTracePause )
+  {
+    return;
+  }
+
+  HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
+
+  pRec = memTrace + (memTraceSeq % OSALMEM_TRACE_CNT);
+  memTraceSeq++;
+
+  pRec->fname = fname;
+  pRec->lnum = (uint16)lnum;
+  pRec->time = osal_GetSystemClock();
+  pRec->size = size;
+  pRec->offset = (ptr == NULL) ? 0xFFFF : (uint16)((uint8 *)ptr - (uint8 *)theHeap);
+  pRec->blkFree = blkFree;
+  pRec->op = op;
+
+  HAL_EXIT_CRITICAL_SECTION( intState );  // Re-enable interrupts.
+}
+
+/**************************************************************************************************
+ * @fn          osal_mem_trace_seq
+ *
+ * @brief       Return the number of heap trace records ever written, which is also the sequence
+ *              number of the next record. It wraps around at 0xFFFF.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      Number of heap trace records ever written.
+ */
+uint16 osal_mem_trace_seq(void)
+{
+  return memTraceSeq;
+}
+
+/**************************************************************************************************
+ * @fn          osal_mem_trace_get
+ *
+ * @brief       Copy a heap trace record by sequence number. Only the last OSALMEM_TRACE_CNT records
+ *              are held in the trace.
+ *
+ * input parameters
+ *
+ * @param seq - the sequence number of the record.
+ *
+ * output parameters
+ *
+ * @param pRec - the copy of the record.
+ *
+ * @return      TRUE if the record was copied, FALSE if it is not or no longer in the trace.
+ */
+uint8 osal_mem_trace_get(uint16 seq, osalMemTrace_t *pRec)
+{
+  uint8 found = FALSE;
+  halIntState_t intState;
+
+  HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
+
+  if ((uint16)(memTraceSeq - seq - 1) < OSALMEM_TRACE_CNT)
+  {
+    *pRec = memTrace[seq % OSALMEM_TRACE_CNT];
+    found = TRUE;
+  }
 
   HAL_EXIT_CRITICAL_SECTION( intState );  // Re-enable interrupts.
+
+  return found;
+}
+
+/**************************************************************************************************
+ * @fn          osal_mem_trace_pause
+ *
+ * @brief       Stop or restart writing heap trace records, i.e. so that sending the trace out does
+ *              not overwrite the records that are still to be sent.
+ *
+ * input parameters
+ *
+ * @param pause - TRUE to stop writing records, FALSE to restart.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ */
+void osal_mem_trace_pause(uint8 pause)
+{
+  memTracePause = pause;
+}
+#endif
+
+#if OSALMEM_SEGFIT
+/**************************************************************************************************
+ * @fn          osalMemSegClass
+ *
+ * @brief       Find the smallest size class that fits a block.
+ *
+ * input parameters
+ *
+ * @param size - the size of the block, including the header.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      Index of the size class, OSALMEM_SEG_CLASSES if the block is larger than all of them.
+ */
+static uint8 osalMemSegClass(uint16 size)
+{
+  uint8 idx;
+
+  for (idx = 0; idx < OSALMEM_SEG_CLASSES; idx++)
+  {
+    if (size <= segClassSz[idx])
+    {
+      break;
+    }
+  }
+
+  return idx;
+}
+
+/**************************************************************************************************
+ * @fn          osalMemSegPut
+ *
+ * @brief       Put a free block on the free list of its size class, or on the list of large blocks
+ *              when its size is not exactly the one of a size class.
+ *              Ints must be disabled.
+ *
+ * input parameters
+ *
+ * @param hdr - the header of the free block.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ */
+static void osalMemSegPut(osalMemHdr_t *hdr)
+{
+  uint8 idx = osalMemSegClass(hdr->hdr.len);
+
+  hdr->hdr.inUse = FALSE;
+
+  if ((idx < OSALMEM_SEG_CLASSES) && (hdr->hdr.len == segClassSz[idx]))
+  {
+    OSALMEM_SEG_NEXT(hdr) = segFree[idx];
+    segFree[idx] = hdr;
+  }
+  else
+  {
+    OSALMEM_SEG_NEXT(hdr) = segLarge;
+    segLarge = hdr;
+  }
+}
+
+/**************************************************************************************************
+ * @fn          osalMemSegCarve
+ *
+ * @brief       Carve a new free block from the front of the wilderness.
+ *              Ints must be disabled.
+ *
+ * input parameters
+ *
+ * @param size - the size of the block, including the header.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      The header of the new block, NULL if the wilderness is too small.
+ */
+static osalMemHdr_t *osalMemSegCarve(uint16 size)
+{
+  osalMemHdr_t *hdr = segTop;
+
+  if ((uint16)((uint8 *)(theHeap + OSALMEM_LASTBLK_IDX) - (uint8 *)hdr) < size)
+  {
+    return NULL;
+  }
+
+  hdr->val = size;  // Set 'len' & clear 'inUse' field.
+  segTop = (osalMemHdr_t *)((uint8 *)hdr + size);
+
+#if ( OSALMEM_METRICS )
+  blkCnt++;
+  blkFree++;
+  if ( blkMax < blkCnt )
+  {
+    blkMax = blkCnt;
+  }
+#endif
+
+  return hdr;
+}
+
+/**************************************************************************************************
+ * @fn          osalMemSegLarge
+ *
+ * @brief       Take the first large enough block from the list of large blocks, splitting off the
+ *              rest of it when that is big enough to be of use.
+ *              Ints must be disabled.
+ *
+ * input parameters
+ *
+ * @param size - the size of the block, including the header.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      The header of the block, NULL if none is large enough.
+ */
+static osalMemHdr_t *osalMemSegLarge(uint16 size)
+{
+  osalMemHdr_t *prev = NULL;
+  osalMemHdr_t *hdr;
+
+  for (hdr = segLarge; hdr != NULL; hdr = OSALMEM_SEG_NEXT(hdr))
+  {
+    if (hdr->hdr.len >= size)
+    {
+      break;
+    }
+    prev = hdr;
+  }
+
+  if (hdr != NULL)
+  {
+    uint16 tmp = hdr->hdr.len - size;
+
+    if (prev == NULL)
+    {
+      segLarge = OSALMEM_SEG_NEXT(hdr);
+    }
+    else
+    {
+      OSALMEM_SEG_NEXT(prev) = OSALMEM_SEG_NEXT(hdr);
+    }
+
+    // The rest must be able to hold the link to the next free block.
+    if (tmp >= OSALMEM_SEG_CLASS0)
+    {
+      osalMemHdr_t *next = (osalMemHdr_t *)((uint8 *)hdr + size);
+      next->val = tmp;
+      hdr->val = size;
+      osalMemSegPut(next);
+
+#if ( OSALMEM_METRICS )
+      blkCnt++;
+      blkFree++;
+      if ( blkMax < blkCnt )
+      {
+        blkMax = blkCnt;
+      }
+#endif
+    }
+  }
+
+  return hdr;
+}
+
+/**************************************************************************************************
+ * @fn          osalMemSegFind
+ *
+ * @brief       Find a free block for an allocation and take it off its free list.
+ *              A size class allocation is taken from the free list of its class, else from the
+ *              wilderness, else from a larger class and only then from the list of large blocks.
+ *              Ints must be disabled.
+ *
+ * input parameters
+ *
+ * @param size - the size of the block, including the header.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      The header of the block, NULL if there is no free block large enough.
+ */
+static osalMemHdr_t *osalMemSegFind(uint16 size)
+{
+  osalMemHdr_t *hdr = NULL;
+  uint8 idx = osalMemSegClass(size);
+
+  if (idx < OSALMEM_SEG_CLASSES)
+  {
+    size = segClassSz[idx];
+
+    if (segFree[idx] == NULL)
+    {
+      hdr = osalMemSegCarve(size);
+    }
+
+    for ( ; (hdr == NULL) && (idx < OSALMEM_SEG_CLASSES); idx++)
+    {
+      hdr = segFree[idx];
+
+      if (hdr != NULL)
+      {
+        segFree[idx] = OSALMEM_SEG_NEXT(hdr);
+      }
+    }
+
+    if (hdr == NULL)
+    {
+      hdr = osalMemSegLarge(size);
+    }
+  }
+  else
+  {
+    size = OSALMEM_ROUND(size);
+
+    if ((hdr = osalMemSegLarge(size)) == NULL)
+    {
+      hdr = osalMemSegCarve(size);
+    }
+  }
+
+  return hdr;
+}
+
+/**************************************************************************************************
+ * @fn          osalMemSegMerge
+ *
+ * @brief       Merge all runs of adjacent free blocks and rebuild the free lists. Free blocks are
+ *              never coalesced when freed so as to keep osal_mem_free() bounded in time, so this
+ *              walk over the whole heap is only done when an allocation would otherwise fail.
+ *              Ints must be disabled.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      TRUE if any free blocks were merged, FALSE otherwise.
+ */
+static uint8 osalMemSegMerge(void)
+{
+  osalMemHdr_t *hdr = theHeap;
+  uint8 merged = FALSE;
+
+  segLarge = NULL;
+  (void)osal_memset(segFree, 0, sizeof(segFree));
+
+  while (hdr < segTop)
+  {
+    osalMemHdr_t *next = (osalMemHdr_t *)((uint8 *)hdr + hdr->hdr.len);
+
+    if (!hdr->hdr.inUse)
+    {
+      while ((next < segTop) && !next->hdr.inUse)
+      {
+        hdr->hdr.len += next->hdr.len;
+        next = (osalMemHdr_t *)((uint8 *)next + next->hdr.len);
+        merged = TRUE;
+
+#if ( OSALMEM_METRICS )
+        blkCnt--;
+        blkFree--;
+#endif
+      }
+
+      if (next == segTop)
+      {
+        // Give the last free run back to the wilderness.
+        segTop = hdr;
+        merged = TRUE;
+
+#if ( OSALMEM_METRICS )
+        blkCnt--;
+        blkFree--;
+#endif
+      }
+      else
+      {
+        osalMemSegPut(hdr);
+      }
+    }
+
+    hdr = next;
+  }
+
+  return merged;
+}
+
+/**************************************************************************************************
+ * @fn          osalMemSegAlloc
+ *
+ * @brief       Allocate a block with the segregated-fit allocator.
+ *              Ints must be disabled.
+ *
+ * input parameters
+ *
+ * @param size - the size of the block, including the header.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      The header of the block, NULL if there is not enough memory.
+ */
+static osalMemHdr_t *osalMemSegAlloc(uint16 size)
+{
+  osalMemHdr_t *hdr = osalMemSegFind(size);
+
+  if ((hdr == NULL) && osalMemSegMerge())
+  {
+    hdr = osalMemSegFind(size);
+  }
+
+  if (hdr != NULL)
+  {
+    hdr->hdr.inUse = TRUE;
+
+#if ( OSALMEM_METRICS )
+    blkFree--;
+    memAlo += hdr->hdr.len;
+    if ( memMax < memAlo )
+    {
+      memMax = memAlo;
+    }
+#endif
+  }
+
+  return hdr;
+}
+
+/**************************************************************************************************
+ * @fn          osalMemSegFree
+ *
+ * @brief       Free a block allocated with the segregated-fit allocator. A block at the front of the
+ *              wilderness is given back to it, any other block goes back on its free list.
+ *              Ints must be disabled.
+ *
+ * input parameters
+ *
+ * @param hdr - the header of the block.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ */
+static void osalMemSegFree(osalMemHdr_t *hdr)
+{
+#if ( OSALMEM_METRICS )
+  memAlo -= hdr->hdr.len;
+#endif
+
+  if ((osalMemHdr_t *)((uint8 *)hdr + hdr->hdr.len) == segTop)
+  {
+    hdr->hdr.inUse = FALSE;
+    segTop = hdr;
+
+#if ( OSALMEM_METRICS )
+    blkCnt--;
+#endif
+  }
+  else
+  {
+    osalMemSegPut(hdr);
+
+#if ( OSALMEM_METRICS )
+    blkFree++;
+#endif
+  }
 }
+#endif
 
 #if OSALMEM_METRICS
 /*********************************************************************
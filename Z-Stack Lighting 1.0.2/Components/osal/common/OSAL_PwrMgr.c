@@ -47,6 +47,9 @@
 #include "OSAL_Tasks.h"
 #include "OSAL_Timers.h"
 #include "OSAL_PwrMgr.h"
+#if OSAL_PWRMGR_WAKE_STATS
+#include "OSAL_Clock.h"
+#endif
 
 /*********************************************************************
  * MACROS
@@ -80,6 +83,10 @@ pwrmgr_attribute_t pwrmgr_attribute;
  * LOCAL VARIABLES
  */
 
+#if OSAL_PWRMGR_WAKE_STATS
+// Wakeup counts, one per task indexed by task ID, then the total
+static uint16 *pwrmgrWakeCnt;
+#endif
 /*********************************************************************
  * LOCAL FUNCTION PROTOTYPES
  */
@@ -101,6 +108,11 @@ void osal_pwrmgr_init( void )
 {
   pwrmgr_attribute.pwrmgr_device = PWRMGR_ALWAYS_ON; // Default to no power conservation.
   pwrmgr_attribute.pwrmgr_task_state = 0;            // Cleared.  All set to conserve
+
+#if OSAL_PWRMGR_WAKE_STATS
+  pwrmgrWakeCnt = osal_mem_alloc( sizeof( uint16 ) * (tasksCnt + 1) );
+  osal_pwrmgr_wake_reset();
+#endif
 }
 
 /*********************************************************************
@@ -184,10 +196,84 @@ void osal_pwrmgr_powerconserve( void )
 
       // Put the processor into sleep mode
       OSAL_SET_CPU_INTO_SLEEP( next );
+
+#if OSAL_PWRMGR_WAKE_STATS
+      if ( pwrmgrWakeCnt != NULL )
+      {
+        uint8 idx;
+
+#ifndef HAL_BOARD_CC2538
+        // Let the timers that expired during the sleep set their events
+        osalTimeUpdate();
+#endif
+
+        for ( idx = 0; idx < tasksCnt; idx++ )
+        {
+          if ( tasksEvents[idx] && (pwrmgrWakeCnt[idx] != 0xFFFF) )
+          {
+            pwrmgrWakeCnt[idx]++;
+          }
+        }
+
+        // Every wakeup costs power, also those where no task had work
+        if ( pwrmgrWakeCnt[tasksCnt] != 0xFFFF )
+        {
+          pwrmgrWakeCnt[tasksCnt]++;
+        }
+      }
+#endif
     }
   }
 }
 #endif /* POWER_SAVING */
 
+#if OSAL_PWRMGR_WAKE_STATS
+/*********************************************************************
+ * @fn      osal_pwrmgr_wake_cnt
+ *
+ * @brief   Return the number of wakeups from sleep after which a task
+ *          had events to process. A wakeup that gives several tasks
+ *          something to do counts for each of them. The total counts
+ *          every wakeup, including those after which no task had
+ *          events. The counts stop at 0xFFFF.
+ *
+ * @param   task_id - task to get the count of, TASK_NO_TASK for the
+ *          total.
+ *
+ * @return  number of wakeups
+ */
+uint16 osal_pwrmgr_wake_cnt( uint8 task_id )
+{
+  if ( pwrmgrWakeCnt == NULL )
+  {
+    return ( 0 );
+  }
+
+  if ( task_id >= tasksCnt )
+  {
+    task_id = tasksCnt;
+  }
+
+  return ( pwrmgrWakeCnt[task_id] );
+}
+
+/*********************************************************************
+ * @fn      osal_pwrmgr_wake_reset
+ *
+ * @brief   Clear the wakeup counts.
+ *
+ * @param   none.
+ *
+ * @return  none.
+ */
+void osal_pwrmgr_wake_reset( void )
+{
+  if ( pwrmgrWakeCnt != NULL )
+  {
+    osal_memset( pwrmgrWakeCnt, 0, (sizeof( uint16 ) * (tasksCnt + 1)) );
+  }
+}
+#endif
+
 /*********************************************************************
 *********************************************************************/
@@ -65,6 +65,8 @@ typedef union {
   uint8 time8[4];
 } osalTime_t;
 
+// Timers are kept sorted by expiry. Each timer's timeout is relative to the
+// timer before it in the list, so only the head has to be updated per tick.
 typedef struct
 {
   void   *next;
@@ -72,8 +74,21 @@ typedef struct
   uint16 event_flag;
   uint8  task_id;
   uint32 reloadTimeout;
+#if OSAL_TIMERS_SLACK
+  uint16 slack;  // Milliseconds the timer may expire late
+#endif
 } osalTimerRec_t;
 
+#if OSAL_TIMERS_SLACK && OSAL_TIMERS_SLACK_DEFAULTS
+// Slack of the timers started without one, set by osal_set_timer_slack()
+typedef struct
+{
+  uint16 event_flag;
+  uint16 slack;
+  uint8  task_id;
+} osalTimerSlack_t;
+#endif
+
 /*********************************************************************
  * GLOBAL VARIABLES
  */
@@ -94,12 +109,40 @@ osalTimerRec_t *timerHead;
 // Milliseconds since last reboot
 static uint32 osal_systemClock;
 
+#if OSAL_TIMERS_POOL_SIZE
+// Timer records that are not taken from the heap
+static osalTimerRec_t osalTimerPool[OSAL_TIMERS_POOL_SIZE];
+
+// Free pool records, linked through next
+static osalTimerRec_t *osalTimerFree;
+#endif
+
+#if OSALMEM_METRICS
+static uint8  timerPoolCnt;  // Current cnt of pool records in use.
+static uint8  timerPoolMax;  // Max cnt of pool records ever in use at once.
+static uint16 timerHeapCnt;  // Cnt of records taken from the heap with the pool empty.
+#endif
+
+#if OSAL_TIMERS_SLACK && OSAL_TIMERS_SLACK_DEFAULTS
+static osalTimerSlack_t osalTimerSlack[OSAL_TIMERS_SLACK_DEFAULTS];
+static uint8 osalTimerSlackCnt;
+#endif
+
 /*********************************************************************
  * LOCAL FUNCTION PROTOTYPES
  */
 osalTimerRec_t  *osalAddTimer( uint8 task_id, uint16 event_flag, uint32 timeout );
-osalTimerRec_t *osalFindTimer( uint8 task_id, uint16 event_flag );
-void osalDeleteTimer( osalTimerRec_t *rmTimer );
+osalTimerRec_t *osalFindTimer( uint8 task_id, uint16 event_flag, osalTimerRec_t **prevTimer );
+void osalInsertTimer( osalTimerRec_t *newTimer, uint32 timeout );
+void osalRemoveTimer( osalTimerRec_t *rmTimer, osalTimerRec_t *prevTimer );
+static osalTimerRec_t *osalAllocTimer( void );
+static void osalFreeTimer( osalTimerRec_t *freeTimer );
+#if OSAL_TIMERS_SLACK
+static uint16 osalDefaultSlack( uint8 task_id, uint16 event_flag );
+#endif
+#if defined( POWER_SAVING ) && OSAL_TIMERS_SLACK
+static uint32 osalSlackTimeout( void );
+#endif
 
 /*********************************************************************
  * FUNCTIONS
@@ -116,7 +159,105 @@ void osalDeleteTimer( osalTimerRec_t *rmTimer );
  */
 void osalTimerInit( void )
 {
+#if OSAL_TIMERS_POOL_SIZE
+  uint8 idx;
+#endif
+
   osal_systemClock = 0;
+
+#if OSAL_TIMERS_SLACK && OSAL_TIMERS_SLACK_DEFAULTS
+  osalTimerSlackCnt = 0;
+#endif
+
+#if OSAL_TIMERS_POOL_SIZE
+  // Put all the pool records on the free list
+  osalTimerFree = NULL;
+  for ( idx = 0; idx < OSAL_TIMERS_POOL_SIZE; idx++ )
+  {
+    osalTimerPool[idx].next = osalTimerFree;
+    osalTimerFree = &osalTimerPool[idx];
+  }
+#endif
+}
+
+/*********************************************************************
+ * @fn      osalAllocTimer
+ *
+ * @brief   Get a timer record from the pool, or from the heap when
+ *          the pool is empty.
+ *          Ints must be disabled.
+ *
+ * @param   none
+ *
+ * @return  osalTimerRec_t * - NULL if none is available
+ */
+static osalTimerRec_t *osalAllocTimer( void )
+{
+  osalTimerRec_t *newTimer;
+
+#if OSAL_TIMERS_POOL_SIZE
+  newTimer = osalTimerFree;
+
+  if ( newTimer )
+  {
+    osalTimerFree = newTimer->next;
+
+#if OSALMEM_METRICS
+    timerPoolCnt++;
+    if ( timerPoolMax < timerPoolCnt )
+    {
+      timerPoolMax = timerPoolCnt;
+    }
+#endif
+
+    return ( newTimer );
+  }
+#endif
+
+  newTimer = osal_mem_alloc( sizeof( osalTimerRec_t ) );
+
+#if OSALMEM_METRICS
+  if ( newTimer )
+  {
+    timerHeapCnt++;
+  }
+#endif
+
+  return ( newTimer );
+}
+
+/*********************************************************************
+ * @fn      osalFreeTimer
+ *
+ * @brief   Return a timer record to the pool or to the heap.
+ *
+ * @param   freeTimer
+ *
+ * @return  none
+ */
+static void osalFreeTimer( osalTimerRec_t *freeTimer )
+{
+#if OSAL_TIMERS_POOL_SIZE
+  halIntState_t intState;
+
+  if ( (freeTimer >= &osalTimerPool[0]) &&
+       (freeTimer < &osalTimerPool[OSAL_TIMERS_POOL_SIZE]) )
+  {
+    HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
+
+    freeTimer->next = osalTimerFree;
+    osalTimerFree = freeTimer;
+
+#if OSALMEM_METRICS
+    timerPoolCnt--;
+#endif
+
+    HAL_EXIT_CRITICAL_SECTION( intState );   // Re-enable interrupts.
+    return;
+  }
+#endif
+
+  osal_mem_free( freeTimer );
 }
 
 /*********************************************************************
@@ -134,57 +275,34 @@ void osalTimerInit( void )
 osalTimerRec_t * osalAddTimer( uint8 task_id, uint16 event_flag, uint32 timeout )
 {
   osalTimerRec_t *newTimer;
-  osalTimerRec_t *srchTimer;
+  osalTimerRec_t *prevTimer;
 
   // Look for an existing timer first
-  newTimer = osalFindTimer( task_id, event_flag );
+  newTimer = osalFindTimer( task_id, event_flag, &prevTimer );
   if ( newTimer )
   {
-    // Timer is found - update it.
-    newTimer->timeout.time32 = timeout;
-
-    return ( newTimer );
+    // Timer is found - take it out so it can be put back at its new place.
+    osalRemoveTimer( newTimer, prevTimer );
   }
   else
   {
     // New Timer
-    newTimer = osal_mem_alloc( sizeof( osalTimerRec_t ) );
-
-    if ( newTimer )
-    {
-      // Fill in new timer
-      newTimer->task_id = task_id;
-      newTimer->event_flag = event_flag;
-      newTimer->timeout.time32 = timeout;
-      newTimer->next = (void *)NULL;
-      newTimer->reloadTimeout = 0;
-
-      // Does the timer list already exist
-      if ( timerHead == NULL )
-      {
-        // Start task list
-        timerHead = newTimer;
-      }
-      else
-      {
-        // Add it to the end of the timer list
-        srchTimer = timerHead;
+    newTimer = osalAllocTimer();
 
-        // Stop at the last record
-        while ( srchTimer->next )
-          srchTimer = srchTimer->next;
-
-        // Add to the list
-        srchTimer->next = newTimer;
-      }
-
-      return ( newTimer );
-    }
-    else
+    if ( newTimer == NULL )
     {
       return ( (osalTimerRec_t *)NULL );
     }
+
+    // Fill in new timer
+    newTimer->task_id = task_id;
+    newTimer->event_flag = event_flag;
+    newTimer->reloadTimeout = 0;
   }
+
+  osalInsertTimer( newTimer, timeout );
+
+  return ( newTimer );
 }
 
 /*********************************************************************
@@ -195,15 +313,17 @@ osalTimerRec_t * osalAddTimer( uint8 task_id, uint16 event_flag, uint32 timeout
  *
  * @param   task_id
  * @param   event_flag
+ * @param   prevTimer - returns the timer before the one found
  *
  * @return  osalTimerRec_t *
  */
-osalTimerRec_t *osalFindTimer( uint8 task_id, uint16 event_flag )
+osalTimerRec_t *osalFindTimer( uint8 task_id, uint16 event_flag, osalTimerRec_t **prevTimer )
 {
   osalTimerRec_t *srchTimer;
 
   // Head of the timer list
   srchTimer = timerHead;
+  *prevTimer = NULL;
 
   // Stop when found or at the end
   while ( srchTimer )
@@ -215,6 +335,7 @@ osalTimerRec_t *osalFindTimer( uint8 task_id, uint16 event_flag )
     }
 
     // Not this one, check another
+    *prevTimer = srchTimer;
     srchTimer = srchTimer->next;
   }
 
@@ -222,24 +343,84 @@ osalTimerRec_t *osalFindTimer( uint8 task_id, uint16 event_flag )
 }
 
 /*********************************************************************
- * @fn      osalDeleteTimer
+ * @fn      osalInsertTimer
+ *
+ * @brief   Insert a timer into the sorted timer list.
+ *          Ints must be disabled.
  *
- * @brief   Delete a timer from a timer list.
+ * @param   newTimer
+ * @param   timeout - milliseconds from now
+ *
+ * @return  none
+ */
+void osalInsertTimer( osalTimerRec_t *newTimer, uint32 timeout )
+{
+  osalTimerRec_t *srchTimer;
+  osalTimerRec_t *prevTimer;
+
+  // Head of the timer list
+  srchTimer = timerHead;
+  prevTimer = (void *)NULL;
+
+  // Skip the timers that expire first - timers with the same expiry
+  // stay in the order they were started.
+  while ( srchTimer && (srchTimer->timeout.time32 <= timeout) )
+  {
+    timeout -= srchTimer->timeout.time32;
+    prevTimer = srchTimer;
+    srchTimer = srchTimer->next;
+  }
+
+  newTimer->timeout.time32 = timeout;
+  newTimer->next = srchTimer;
+
+  if ( srchTimer )
+  {
+    // The following timer now expires relative to the new one
+    srchTimer->timeout.time32 -= timeout;
+  }
+
+  if ( prevTimer == NULL )
+  {
+    timerHead = newTimer;
+  }
+  else
+  {
+    prevTimer->next = newTimer;
+  }
+}
+
+/*********************************************************************
+ * @fn      osalRemoveTimer
+ *
+ * @brief   Take a timer out of the timer list. The caller frees it.
+ *          Ints must be disabled.
  *
- * @param   table
  * @param   rmTimer
+ * @param   prevTimer - timer before rmTimer, NULL if rmTimer is the head
  *
  * @return  none
  */
-void osalDeleteTimer( osalTimerRec_t *rmTimer )
+void osalRemoveTimer( osalTimerRec_t *rmTimer, osalTimerRec_t *prevTimer )
 {
-  // Does the timer list really exist
-  if ( rmTimer )
+  osalTimerRec_t *nextTimer = rmTimer->next;
+
+  if ( nextTimer )
+  {
+    // Hand the remaining time over to the following timer
+    nextTimer->timeout.time32 += rmTimer->timeout.time32;
+  }
+
+  if ( prevTimer == NULL )
+  {
+    timerHead = nextTimer;
+  }
+  else
   {
-    // Clear the event flag and osalTimerUpdate() will delete
-    // the timer from the list.
-    rmTimer->event_flag = 0;
+    prevTimer->next = nextTimer;
   }
+
+  rmTimer->next = (void *)NULL;
 }
 
 /*********************************************************************
@@ -257,6 +438,27 @@ void osalDeleteTimer( osalTimerRec_t *rmTimer )
  * @return  SUCCESS, or NO_TIMER_AVAIL.
  */
 uint8 osal_start_timerEx( uint8 taskID, uint16 event_id, uint32 timeout_value )
+{
+  return ( osal_start_timer_slack( taskID, event_id, timeout_value, 0 ) );
+}
+
+/*********************************************************************
+ * @fn      osal_start_timer_slack
+ *
+ * @brief
+ *
+ *   This function is called to start a timer to expire in n mSecs,
+ *   or up to slack mSecs later when that lets a sleeping device serve
+ *   it in the same wakeup as another timer.
+ *
+ * @param   uint8 taskID - task id to set timer for
+ * @param   uint16 event_id - event to be notified with
+ * @param   uint32 timeout_value - in milliseconds.
+ * @param   uint16 slack - in milliseconds.
+ *
+ * @return  SUCCESS, or NO_TIMER_AVAIL.
+ */
+uint8 osal_start_timer_slack( uint8 taskID, uint16 event_id, uint32 timeout_value, uint16 slack )
 {
   halIntState_t intState;
   osalTimerRec_t *newTimer;
@@ -265,6 +467,14 @@ uint8 osal_start_timerEx( uint8 taskID, uint16 event_id, uint32 timeout_value )
 
   // Add timer
   newTimer = osalAddTimer( taskID, event_id, timeout_value );
+#if OSAL_TIMERS_SLACK
+  if ( newTimer )
+  {
+    newTimer->slack = ( slack != 0 ) ? slack : osalDefaultSlack( taskID, event_id );
+  }
+#else
+  (void)slack;
+#endif
 
   HAL_EXIT_CRITICAL_SECTION( intState );   // Re-enable interrupts.
 
@@ -287,6 +497,27 @@ uint8 osal_start_timerEx( uint8 taskID, uint16 event_id, uint32 timeout_value )
  * @return  SUCCESS, or NO_TIMER_AVAIL.
  */
 uint8 osal_start_reload_timer( uint8 taskID, uint16 event_id, uint32 timeout_value )
+{
+  return ( osal_start_reload_timer_slack( taskID, event_id, timeout_value, 0 ) );
+}
+
+/*********************************************************************
+ * @fn      osal_start_reload_timer_slack
+ *
+ * @brief
+ *
+ *   Same as osal_start_reload_timer(), except that each expiry may be
+ *   up to slack mSecs late. A late expiry delays the following ones
+ *   too, so reload timers served together stay together.
+ *
+ * @param   uint8 taskID - task id to set timer for
+ * @param   uint16 event_id - event to be notified with
+ * @param   uint32 timeout_value - in milliseconds.
+ * @param   uint16 slack - in milliseconds.
+ *
+ * @return  SUCCESS, or NO_TIMER_AVAIL.
+ */
+uint8 osal_start_reload_timer_slack( uint8 taskID, uint16 event_id, uint32 timeout_value, uint16 slack )
 {
   halIntState_t intState;
   osalTimerRec_t *newTimer;
@@ -299,13 +530,128 @@ uint8 osal_start_reload_timer( uint8 taskID, uint16 event_id, uint32 timeout_val
   {
     // Load the reload timeout value
     newTimer->reloadTimeout = timeout_value;
+#if OSAL_TIMERS_SLACK
+    newTimer->slack = ( slack != 0 ) ? slack : osalDefaultSlack( taskID, event_id );
+#endif
   }
+#if !OSAL_TIMERS_SLACK
+  (void)slack;
+#endif
 
   HAL_EXIT_CRITICAL_SECTION( intState );   // Re-enable interrupts.
 
   return ( (newTimer != NULL) ? SUCCESS : NO_TIMER_AVAIL );
 }
 
+/*********************************************************************
+ * @fn      osal_set_timer_slack
+ *
+ * @brief
+ *
+ *   Give a slack to a timer that is started with osal_start_timerEx()
+ *   or osal_start_reload_timer(), by code that does not know about
+ *   slack. The slack applies to the timer if it is running and to each
+ *   later start of it that does not pass a slack. A slack of 0 takes
+ *   it back.
+ *
+ * @param   uint8 task_id - task id of the timer
+ * @param   uint16 event_id - event of the timer
+ * @param   uint16 slack - in milliseconds.
+ *
+ * @return  SUCCESS, or NO_TIMER_AVAIL if OSAL_TIMERS_SLACK_DEFAULTS
+ *          timers already have one.
+ */
+uint8 osal_set_timer_slack( uint8 task_id, uint16 event_id, uint16 slack )
+{
+#if OSAL_TIMERS_SLACK && OSAL_TIMERS_SLACK_DEFAULTS
+  halIntState_t intState;
+  osalTimerRec_t *srchTimer;
+  osalTimerRec_t *prevTimer;
+  uint8 idx;
+  uint8 ret = SUCCESS;
+
+  HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
+
+  for ( idx = 0; idx < osalTimerSlackCnt; idx++ )
+  {
+    if ( (osalTimerSlack[idx].task_id == task_id) &&
+         (osalTimerSlack[idx].event_flag == event_id) )
+    {
+      break;
+    }
+  }
+
+  if ( idx < osalTimerSlackCnt )
+  {
+    osalTimerSlack[idx].slack = slack;
+  }
+  else if ( idx < OSAL_TIMERS_SLACK_DEFAULTS )
+  {
+    osalTimerSlack[idx].task_id = task_id;
+    osalTimerSlack[idx].event_flag = event_id;
+    osalTimerSlack[idx].slack = slack;
+    osalTimerSlackCnt++;
+  }
+  else
+  {
+    ret = NO_TIMER_AVAIL;
+  }
+
+  if ( ret == SUCCESS )
+  {
+    srchTimer = osalFindTimer( task_id, event_id, &prevTimer );
+    if ( srchTimer )
+    {
+      srchTimer->slack = slack;
+    }
+  }
+
+  HAL_EXIT_CRITICAL_SECTION( intState );   // Re-enable interrupts.
+
+  return ( ret );
+#else
+  (void)task_id;
+  (void)event_id;
+  (void)slack;
+
+  return ( SUCCESS );
+#endif
+}
+
+#if OSAL_TIMERS_SLACK
+/*********************************************************************
+ * @fn      osalDefaultSlack
+ *
+ * @brief   Return the slack that osal_set_timer_slack() gave a timer.
+ *          Ints must be disabled.
+ *
+ * @param   task_id - task id of the timer
+ * @param   event_flag - event of the timer
+ *
+ * @return  slack in milliseconds, 0 if it has none
+ */
+static uint16 osalDefaultSlack( uint8 task_id, uint16 event_flag )
+{
+#if OSAL_TIMERS_SLACK_DEFAULTS
+  uint8 idx;
+
+  for ( idx = 0; idx < osalTimerSlackCnt; idx++ )
+  {
+    if ( (osalTimerSlack[idx].task_id == task_id) &&
+         (osalTimerSlack[idx].event_flag == event_flag) )
+    {
+      return ( osalTimerSlack[idx].slack );
+    }
+  }
+#else
+  (void)task_id;
+  (void)event_flag;
+#endif
+
+  return ( 0 );
+}
+#endif
+
 /*********************************************************************
  * @fn      osal_stop_timerEx
  *
@@ -324,18 +670,24 @@ uint8 osal_stop_timerEx( uint8 task_id, uint16 event_id )
 {
   halIntState_t intState;
   osalTimerRec_t *foundTimer;
+  osalTimerRec_t *prevTimer;
 
   HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
 
   // Find the timer to stop
-  foundTimer = osalFindTimer( task_id, event_id );
+  foundTimer = osalFindTimer( task_id, event_id, &prevTimer );
   if ( foundTimer )
   {
-    osalDeleteTimer( foundTimer );
+    osalRemoveTimer( foundTimer, prevTimer );
   }
 
   HAL_EXIT_CRITICAL_SECTION( intState );   // Re-enable interrupts.
 
+  if ( foundTimer )
+  {
+    osalFreeTimer( foundTimer );
+  }
+
   return ( (foundTimer != NULL) ? SUCCESS : INVALID_EVENT_ID );
 }
 
@@ -357,11 +709,20 @@ uint32 osal_get_timeoutEx( uint8 task_id, uint16 event_id )
 
   HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
 
-  tmr = osalFindTimer( task_id, event_id );
+  // Add up the timeouts of all the timers up to the one asked for
+  for ( tmr = timerHead; tmr != NULL; tmr = tmr->next )
+  {
+    rtrn += tmr->timeout.time32;
 
-  if ( tmr )
+    if ( tmr->event_flag == event_id && tmr->task_id == task_id )
+    {
+      break;
+    }
+  }
+
+  if ( tmr == NULL )
   {
-    rtrn = tmr->timeout.time32;
+    rtrn = 0;
   }
 
   HAL_EXIT_CRITICAL_SECTION( intState );   // Re-enable interrupts.
@@ -406,6 +767,10 @@ uint8 osal_timer_num_active( void )
  *
  * @brief   Update the timer structures for a timer tick.
  *
+ *          Only the timers at the head of the list can have expired,
+ *          so the cost depends on the number of expired timers and not
+ *          on the number of running timers.
+ *
  * @param   none
  *
  * @return  none
@@ -414,115 +779,62 @@ void osalTimerUpdate( uint32 updateTime )
 {
   halIntState_t intState;
   osalTimerRec_t *srchTimer;
-  osalTimerRec_t *prevTimer;
-
-  osalTime_t timeUnion;
-  timeUnion.time32 = updateTime;
+  osalTimerRec_t *freeTimer;
 
   HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
   // Update the system time
   osal_systemClock += updateTime;
   HAL_EXIT_CRITICAL_SECTION( intState );   // Re-enable interrupts.
 
-  // Look for open timer slot
-  if ( timerHead != NULL )
+  do
   {
-    // Add it to the end of the timer list
-    srchTimer = timerHead;
-    prevTimer = (void *)NULL;
+    freeTimer = NULL;
 
-    // Look for open timer slot
-    while ( srchTimer )
-    {
-      osalTimerRec_t *freeTimer = NULL;
+    HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
 
-      HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
+    srchTimer = timerHead;
 
-      // To minimize time in this critical section, avoid 32-bit math
-      if ((timeUnion.time16[1] == 0) && (timeUnion.time8[1] == 0))
+    if ( srchTimer != NULL )
+    {
+      if ( srchTimer->timeout.time32 > updateTime )
       {
-        // If upper 24 bits are zero, check lower 8 bits for roll over
-        if (srchTimer->timeout.time8[0] >= timeUnion.time8[0])
-        {
-          // 8-bit math
-          srchTimer->timeout.time8[0] -= timeUnion.time8[0];
-        }
-        else
-        {
-          // 32-bit math
-          if (srchTimer->timeout.time32 > timeUnion.time32)
-          {
-            srchTimer->timeout.time32 -= timeUnion.time32;
-          }
-          else
-          {
-            srchTimer->timeout.time32 = 0;
-          }
-        }
+        // Not expired - the rest of the list is relative to this timer
+        srchTimer->timeout.time32 -= updateTime;
+        srchTimer = NULL;
       }
       else
       {
-          // 32-bit math
-        if (srchTimer->timeout.time32 > timeUnion.time32)
-        {
-          srchTimer->timeout.time32 -= timeUnion.time32;
-        }
-        else
-        {
-          srchTimer->timeout.time32 = 0;
-        }
-      }
+        // Take out of list, what is left of the update applies to the next
+        updateTime -= srchTimer->timeout.time32;
+        srchTimer->timeout.time32 = 0;
+        timerHead = srchTimer->next;
+        srchTimer->next = (void *)NULL;
 
-      // Check for reloading
-      if ( (srchTimer->timeout.time16[0] == 0) && (srchTimer->timeout.time16[1] == 0) &&
-           (srchTimer->reloadTimeout) && (srchTimer->event_flag) )
-      {
         // Notify the task of a timeout
         osal_set_event( srchTimer->task_id, srchTimer->event_flag );
 
-        // Reload the timer timeout value
-        srchTimer->timeout.time32 = srchTimer->reloadTimeout;
-      }
-
-      // When timeout or delete (event_flag == 0)
-      if ( ((srchTimer->timeout.time16[0] == 0) && (srchTimer->timeout.time16[1] == 0)) ||
-            (srchTimer->event_flag == 0) )
-      {
-        // Take out of list
-        if ( prevTimer == NULL )
+        // Check for reloading
+        if ( srchTimer->reloadTimeout )
         {
-          timerHead = srchTimer->next;
+          // Reload relative to the end of this update, so that it does not
+          // expire again before the next one.
+          osalInsertTimer( srchTimer, srchTimer->reloadTimeout + updateTime );
         }
         else
         {
-          prevTimer->next = srchTimer->next;
+          // Setup to free memory
+          freeTimer = srchTimer;
         }
-
-        // Setup to free memory
-        freeTimer = srchTimer;
-
-        // Next
-        srchTimer = srchTimer->next;
-      }
-      else
-      {
-        // Get next
-        prevTimer = srchTimer;
-        srchTimer = srchTimer->next;
       }
+    }
 
-      HAL_EXIT_CRITICAL_SECTION( intState );   // Re-enable interrupts.
+    HAL_EXIT_CRITICAL_SECTION( intState );   // Re-enable interrupts.
 
-      if ( freeTimer )
-      {
-        if ( (freeTimer->timeout.time16[0] == 0) && (freeTimer->timeout.time16[1] == 0) )
-        {
-          osal_set_event( freeTimer->task_id, freeTimer->event_flag );
-        }
-        osal_mem_free( freeTimer );
-      }
+    if ( freeTimer )
+    {
+      osalFreeTimer( freeTimer );
     }
-  }
+  } while ( srchTimer != NULL );
 }
 
 #ifdef POWER_SAVING
@@ -556,8 +868,9 @@ void osal_adjust_timers( void )
  *
  * @brief
  *
- *   Search timer table to return the lowest timeout value. If the
- *   timer list is empty, then the returned timeout will be zero.
+ *   Return the lowest timeout value, which is the one of the timer at
+ *   the head of the sorted timer list. If the timer list is empty, then
+ *   the returned timeout will be zero.
  *
  * @param   none
  *
@@ -566,23 +879,18 @@ void osal_adjust_timers( void )
 uint32 osal_next_timeout( void )
 {
   uint32 nextTimeout;
-  osalTimerRec_t *srchTimer;
 
   if ( timerHead != NULL )
   {
-    // Head of the timer list
-    srchTimer = timerHead;
-    nextTimeout = OSAL_TIMERS_MAX_TIMEOUT;
+#if OSAL_TIMERS_SLACK
+    nextTimeout = osalSlackTimeout();
+#else
+    nextTimeout = timerHead->timeout.time32;
+#endif
 
-    // Look for the next timeout timer
-    while ( srchTimer != NULL )
+    if ( nextTimeout > OSAL_TIMERS_MAX_TIMEOUT )
     {
-      if (srchTimer->timeout.time32 < nextTimeout)
-      {
-        nextTimeout = srchTimer->timeout.time32;
-      }
-      // Check next timer
-      srchTimer = srchTimer->next;
+      nextTimeout = OSAL_TIMERS_MAX_TIMEOUT;
     }
   }
   else
@@ -593,6 +901,48 @@ uint32 osal_next_timeout( void )
 
   return ( nextTimeout );
 }
+
+#if OSAL_TIMERS_SLACK
+/*********************************************************************
+ * @fn      osalSlackTimeout
+ *
+ * @brief
+ *
+ *   Return the time to sleep for so that as many timers as possible
+ *   expire in one wakeup: the latest expiry that is still within the
+ *   slack of all the timers before it. Timers without slack stop the
+ *   search. The timer list must not be empty.
+ *
+ * @param   none
+ *
+ * @return  milliseconds until the wakeup
+ *********************************************************************/
+static uint32 osalSlackTimeout( void )
+{
+  osalTimerRec_t *srchTimer = timerHead;
+  uint32 wakeup = srchTimer->timeout.time32;
+  uint16 budget = srchTimer->slack;
+
+  // Each timeout is relative to the timer before it
+  while ( budget && ((srchTimer = srchTimer->next) != NULL) )
+  {
+    if ( srchTimer->timeout.time32 > budget )
+    {
+      break;
+    }
+
+    wakeup += srchTimer->timeout.time32;
+    budget -= (uint16)srchTimer->timeout.time32;
+
+    if ( budget > srchTimer->slack )
+    {
+      budget = srchTimer->slack;
+    }
+  }
+
+  return ( wakeup );
+}
+#endif
 #endif // POWER_SAVING
 
 /*********************************************************************
@@ -609,5 +959,52 @@ uint32 osal_GetSystemClock( void )
   return ( osal_systemClock );
 }
 
+#if OSALMEM_METRICS
+/*********************************************************************
+ * @fn      osal_timer_pool_max
+ *
+ * @brief   Return the maximum number of pool timer records ever
+ *          used at once.
+ *
+ * @param   none
+ *
+ * @return  Maximum number of pool records ever used at once.
+ */
+uint8 osal_timer_pool_max( void )
+{
+  return timerPoolMax;
+}
+
+/*********************************************************************
+ * @fn      osal_timer_pool_cnt
+ *
+ * @brief   Return the current number of pool timer records in use.
+ *
+ * @param   none
+ *
+ * @return  Current number of pool records in use.
+ */
+uint8 osal_timer_pool_cnt( void )
+{
+  return timerPoolCnt;
+}
+
+/*********************************************************************
+ * @fn      osal_timer_heap_cnt
+ *
+ * @brief   Return the number of timer records allocated from the heap
+ *          because the pool was empty. A non-zero value means that
+ *          OSAL_TIMERS_POOL_SIZE is too small for the application.
+ *
+ * @param   none
+ *
+ * @return  Number of timer records taken from the heap.
+ */
+uint16 osal_timer_heap_cnt( void )
+{
+  return timerHeapCnt;
+}
+#endif
+
 /*********************************************************************
 *********************************************************************/
@@ -79,6 +79,10 @@ extern "C"
 
 #define OSAL_MSG_ID(msg_ptr)      ((osal_msg_hdr_t *) (msg_ptr) - 1)->dest_id
 
+#define OSAL_MSG_PRIO(msg_ptr)      ((osal_msg_hdr_t *) (msg_ptr) - 1)->priority
+
+#define OSAL_MSG_REFS(msg_ptr)      ((osal_msg_hdr_t *) (msg_ptr) - 1)->refCnt
+
 /*********************************************************************
  * CONSTANTS
  */
@@ -86,11 +90,26 @@ extern "C"
 /*** Interrupts ***/
 #define INTS_ALL    0xFF
 
+/*** Message priorities ***/
+#define OSAL_MSG_PRIO_NORMAL    0x00  // Queued in order behind urgent messages
+#define OSAL_MSG_PRIO_URGENT    0x01  // Received, and its task run, ahead of normal messages
+
+/*** Scheduler statistics ***/
+// Set to TRUE to measure the run time and dispatch latency of the tasks
+#if !defined ( OSAL_SCHED_STATS )
+  #define OSAL_SCHED_STATS  FALSE
+#endif
+
 /*********************************************************************
  * TYPEDEFS
  */
 typedef struct
 {
+  // Keep the new fields in front: the libraries access the others at
+  // a fixed offset back from the message data.
+  uint8  *ref;      // Message this one holds a reference to, NULL if none
+  uint8  refCnt;    // Number of holders, the buffer is freed by the last one
+  uint8  priority;
   void   *next;
   uint16 len;
   uint8  dest_id;
@@ -104,6 +123,26 @@ typedef struct
 
 typedef void * osal_msg_q_t;
 
+// Part of a message buffer, kept alive by the reference the slice holds
+typedef struct
+{
+  uint8  *msg;   // Message buffer holding the bytes
+  uint8  *data;  // First byte of the slice
+  uint16 len;    // Number of bytes in the slice
+} osalMsgSlice_t;
+
+#if ( OSAL_SCHED_STATS )
+// Scheduler statistics of a task or of one event of a task, in ticks of OSAL_SCHED_TIME()
+typedef struct
+{
+  uint32 runCnt;     // Number of runs of the event handler
+  uint32 runTotal;   // Total run time
+  uint16 runMax;     // Longest single run
+  uint32 waitTotal;  // Total time from the first event set to the run
+  uint16 waitMax;    // Longest time from the first event set to the run
+} osalSchedStats_t;
+#endif
+
 /*********************************************************************
  * GLOBAL VARIABLES
  */
@@ -124,6 +163,26 @@ typedef void * osal_msg_q_t;
    */
   extern uint8 osal_msg_deallocate( uint8 *msg_ptr );
 
+  /*
+   * Take one more reference to a Task Message
+   */
+  extern uint8 *osal_msg_retain( uint8 *msg_ptr );
+
+  /*
+   * Make a Task Message hold a reference to another one until it is deallocated
+   */
+  extern uint8 osal_msg_attach( uint8 *msg_ptr, uint8 *ref_ptr );
+
+  /*
+   * Reference a part of a Task Message without copying it
+   */
+  extern uint8 osal_msg_slice( osalMsgSlice_t *pSlice, uint8 *msg_ptr, uint8 *data, uint16 len );
+
+  /*
+   * Release the reference held by a slice
+   */
+  extern void osal_msg_slice_release( osalMsgSlice_t *pSlice );
+
   /*
    * Send a Task Message
    */
@@ -228,6 +287,28 @@ typedef void * osal_msg_q_t;
    */
   extern uint8 osal_self( void );
 
+#if ( OSAL_SCHED_STATS )
+  /*
+   * Get the scheduler statistics of a task
+   */
+  extern uint8 osal_sched_stats_get( uint8 task_id, osalSchedStats_t *pStats );
+
+  /*
+   * Get the scheduler statistics of one event of the watched task
+   */
+  extern uint8 osal_sched_event_stats_get( uint8 event_bit, osalSchedStats_t *pStats );
+
+  /*
+   * Collect per event statistics for a task, returns the task watched so far
+   */
+  extern uint8 osal_sched_stats_watch( uint8 task_id );
+
+  /*
+   * Clear all the scheduler statistics
+   */
+  extern void osal_sched_stats_reset( void );
+#endif
+
 
 /*** Helper Functions ***/
 
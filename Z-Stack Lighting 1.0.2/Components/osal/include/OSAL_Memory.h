@@ -58,6 +58,22 @@ extern "C"
   #define OSALMEM_METRICS  FALSE
 #endif
 
+/*
+ * Set to TRUE to keep a trace of the last OSALMEM_TRACE_CNT allocations and frees.
+ * Requires OSALMEM_METRICS.
+ */
+#if !defined ( OSALMEM_TRACE )
+  #define OSALMEM_TRACE  FALSE
+#endif
+
+#if !defined ( OSALMEM_TRACE_CNT )
+  #define OSALMEM_TRACE_CNT  16
+#endif
+
+// Heap trace record operations
+#define OSALMEM_TRACE_ALLOC  'A'
+#define OSALMEM_TRACE_FREE   'F'
+
 /*********************************************************************
  * MACROS
  */
@@ -68,6 +84,20 @@ extern "C"
  * TYPEDEFS
  */
 
+#if ( OSALMEM_TRACE )
+// Heap trace record
+typedef struct
+{
+  const char *fname;  // File of the caller, NULL when not known (i.e. called from a library)
+  uint16 lnum;        // Line of the caller
+  uint32 time;        // System clock at the time of the call
+  uint16 size;        // Bytes asked for by an allocation or held by a freed block
+  uint16 offset;      // Offset of the block in the heap, 0xFFFF for a failed allocation
+  uint16 blkFree;     // Number of free blocks after the call
+  uint8  op;          // OSALMEM_TRACE_ALLOC or OSALMEM_TRACE_FREE
+} osalMemTrace_t;
+#endif
+
 /*********************************************************************
  * GLOBAL VARIABLES
  */
@@ -89,7 +119,7 @@ extern "C"
  /*
   * Allocate a block of memory.
   */
-#ifdef DPRINTF_OSALHEAPTRACE
+#if defined ( DPRINTF_OSALHEAPTRACE ) || ( OSALMEM_TRACE )
   void *osal_mem_alloc_dbg( uint16 size, const char *fname, unsigned lnum );
 #define osal_mem_alloc(_size ) osal_mem_alloc_dbg(_size, __FILE__, __LINE__)
 #else /* DPRINTF_OSALHEAPTRACE */
@@ -99,7 +129,7 @@ extern "C"
  /*
   * Free a block of memory.
   */
-#ifdef DPRINTF_OSALHEAPTRACE
+#if defined ( DPRINTF_OSALHEAPTRACE ) || ( OSALMEM_TRACE )
   void osal_mem_free_dbg( void *ptr, const char *fname, unsigned lnum );
 #define osal_mem_free(_ptr ) osal_mem_free_dbg(_ptr, __FILE__, __LINE__)
 #else /* DPRINTF_OSALHEAPTRACE */
@@ -128,6 +158,23 @@ extern "C"
   uint16 osal_heap_mem_used( void );
 #endif
 
+#if ( OSALMEM_TRACE )
+ /*
+  * Return the number of heap trace records ever written.
+  */
+  uint16 osal_mem_trace_seq( void );
+
+ /*
+  * Copy a heap trace record if it is still held in the trace.
+  */
+  uint8 osal_mem_trace_get( uint16 seq, osalMemTrace_t *pRec );
+
+ /*
+  * Stop or restart writing heap trace records.
+  */
+  void osal_mem_trace_pause( uint8 pause );
+#endif
+
 #if defined (ZTOOL_P1) || defined (ZTOOL_P2)
  /*
   * Return the highest number of bytes ever used in the heap.
@@ -55,14 +55,54 @@ extern "C"
  * CONSTANTS
  */
 
+// Set to TRUE to keep NV write statistics and project the NV lifetime from them
+#if !defined ( OSAL_NV_STATS )
+  #define OSAL_NV_STATS  FALSE
+#endif
+
+// osalNvStats_t lifeHours before any page has been erased
+#define OSAL_NV_LIFE_UNKNOWN  0xFFFFFFFF
+
+// The NV task, added last to the task table, runs these options
+#if defined ( OSAL_NV_COMPACT_TASK ) || defined ( OSAL_NV_CACHE )
+  #define OSAL_NV_TASK
+#endif
+
 /*********************************************************************
  * MACROS
  */
 
+// Write the changes held in the NV write cache before a reset
+#if defined ( OSAL_NV_CACHE )
+  #define OSAL_NV_FLUSH()  (void)osal_nv_flush()
+#else
+  #define OSAL_NV_FLUSH()
+#endif
+
 /*********************************************************************
  * TYPEDEFS
  */
 
+#if ( OSAL_NV_STATS )
+// NV write statistics since osal_nv_init() or osal_nv_stats_reset()
+typedef struct
+{
+  uint32 bytes;         // Flash bytes written, including page compactions
+  uint32 bytesPerHour;  // Flash bytes written per hour
+  uint32 lifeHours;     // Projected hours until the most erased page reaches its rated endurance
+  uint16 erases;        // Page erases
+  uint16 eraseMax;      // Erase count of the most erased page, kept across resets
+} osalNvStats_t;
+
+// Erase count and space usage of an NV page
+typedef struct
+{
+  uint16 erases;  // Erase count, kept across resets
+  uint16 free;    // Bytes free at the end of the page
+  uint16 lost;    // Bytes of deleted or old item copies, recovered by compacting the page
+} osalNvPageStats_t;
+#endif
+
 /*********************************************************************
  * GLOBAL VARIABLES
  */
@@ -101,6 +141,67 @@ extern uint16 osal_nv_item_len( uint16 id );
  */
 extern uint8 osal_nv_delete( uint16 id, uint16 len );
 
+/*
+ * Start a transaction of NV writes.
+ */
+extern void osal_nv_txn_begin( void );
+
+/*
+ * Add a write to the open transaction - 'buf' must stay valid until the commit.
+ */
+extern uint8 osal_nv_txn_stage( uint16 id, uint16 offset, uint16 len, void *buf );
+
+/*
+ * Write all of the staged items atomically and close the transaction.
+ */
+extern uint8 osal_nv_txn_commit( void );
+
+#if defined ( OSAL_NV_TASK )
+/*
+ * Initialize the NV task.
+ */
+extern void osal_nv_task_init( uint8 task_id );
+
+/*
+ * NV task event processor.
+ */
+extern uint16 osal_nv_event_loop( uint8 task_id, uint16 events );
+#endif
+
+#if defined ( OSAL_NV_CACHE )
+/*
+ * Keep an NV item in the write cache.
+ */
+extern uint8 osal_nv_cache_add( uint16 id );
+
+/*
+ * Write the changes held in the write cache to NV.
+ */
+extern uint8 osal_nv_flush( void );
+#endif
+
+#if ( OSAL_NV_STATS )
+/*
+ * Get the NV write statistics and projected lifetime
+ */
+extern void osal_nv_stats_get( osalNvStats_t *pStats );
+
+/*
+ * Get the erase count and space usage of an NV page
+ */
+extern uint8 osal_nv_page_stats_get( uint8 idx, osalNvPageStats_t *pStats );
+
+/*
+ * Get one of the items written the most
+ */
+extern uint8 osal_nv_item_stats_get( uint8 idx, uint16 *pId, uint32 *pWrites );
+
+/*
+ * Clear the NV write statistics
+ */
+extern void osal_nv_stats_reset( void );
+#endif
+
 /*********************************************************************
 *********************************************************************/
 
@@ -81,6 +81,12 @@ typedef struct
 #define PWRMGR_CONSERVE 0
 #define PWRMGR_HOLD     1
 
+/* Set to TRUE to count the wakeups from sleep: all of them, and for
+ * each task the ones after which the task had events to process.
+ */
+#if !defined ( OSAL_PWRMGR_WAKE_STATS )
+  #define OSAL_PWRMGR_WAKE_STATS  FALSE
+#endif
 
 /*********************************************************************
  * GLOBAL VARIABLES
@@ -129,6 +135,19 @@ extern pwrmgr_attribute_t pwrmgr_attribute;
    */
   extern void osal_pwrmgr_powerconserve( void );
 
+#if ( OSAL_PWRMGR_WAKE_STATS )
+  /*
+   * Number of wakeups from sleep - all of them with TASK_NO_TASK, else
+   * the ones after which the task had events to process.
+   */
+  extern uint16 osal_pwrmgr_wake_cnt( uint8 task_id );
+
+  /*
+   * Clear the wakeup counts.
+   */
+  extern void osal_pwrmgr_wake_reset( void );
+#endif
+
 /*********************************************************************
 *********************************************************************/
 
@@ -60,6 +60,38 @@ extern "C"
  */
  #define OSAL_TIMERS_MAX_TIMEOUT 0x28f5c28e /* unit is ms*/
 
+/*
+ * Number of timer records allocated statically. Timers above this
+ * number are allocated from the heap. The default 0 uses the heap only;
+ * a project sets it to the timers it keeps running, which
+ * osal_timer_pool_max() and osal_timer_heap_cnt() help to find.
+ */
+#if !defined ( OSAL_TIMERS_POOL_SIZE )
+  #define OSAL_TIMERS_POOL_SIZE  0
+#endif
+
+/*
+ * Let timers started with a slack expire up to that many milliseconds
+ * late, so that a sleeping device serves several of them in a single
+ * wakeup. It only changes how long the device sleeps.
+ */
+#if !defined ( OSAL_TIMERS_SLACK )
+  #if defined ( POWER_SAVING )
+    #define OSAL_TIMERS_SLACK  TRUE
+  #else
+    #define OSAL_TIMERS_SLACK  FALSE
+  #endif
+#endif
+
+/*
+ * Number of timers that osal_set_timer_slack() can give a slack to.
+ * This is for timers that are started by code that does not pass a
+ * slack itself, e.g. the poll timer of the NWK library.
+ */
+#if !defined ( OSAL_TIMERS_SLACK_DEFAULTS )
+  #define OSAL_TIMERS_SLACK_DEFAULTS  4
+#endif
+
 /*********************************************************************
  * TYPEDEFS
  */
@@ -87,6 +119,21 @@ extern "C"
    */
   extern uint8 osal_start_reload_timer( uint8 taskID, uint16 event_id, uint32 timeout_value );
 
+  /*
+   * Set a Timer that may expire up to slack milliseconds late.
+   */
+  extern uint8 osal_start_timer_slack( uint8 task_id, uint16 event_id, uint32 timeout_value, uint16 slack );
+
+  /*
+   * Set a timer that reloads itself and may expire up to slack milliseconds late.
+   */
+  extern uint8 osal_start_reload_timer_slack( uint8 taskID, uint16 event_id, uint32 timeout_value, uint16 slack );
+
+  /*
+   * Set the slack of a timer that is started without one.
+   */
+  extern uint8 osal_set_timer_slack( uint8 task_id, uint16 event_id, uint16 slack );
+
   /*
    * Stop a Timer
    */
@@ -136,6 +183,23 @@ extern "C"
    */
   extern uint32 osal_next_timeout( void );
 
+#if ( OSALMEM_METRICS )
+  /*
+   * Return the maximum number of pool timer records ever used at once.
+   */
+  extern uint8 osal_timer_pool_max( void );
+
+  /*
+   * Return the current number of pool timer records in use.
+   */
+  extern uint8 osal_timer_pool_cnt( void );
+
+  /*
+   * Return the number of timer records allocated from the heap because the pool was empty.
+   */
+  extern uint16 osal_timer_heap_cnt( void );
+#endif
+
 /*********************************************************************
 *********************************************************************/
 
@@ -191,6 +191,7 @@ extern "C"
 #define ZCD_NV_MIN_GRP_IDS                0x0096
 #define ZCD_NV_MAX_GRP_IDS                0x0097
 #define ZCD_NV_OTA_BLOCK_REQ_DELAY        0x0098
+#define ZCD_NV_REPORT_CFG_TABLE           0x0099
 
 // Non-standard NV item IDs
 #define ZCD_NV_SAPI_ENDPOINT              0x00A1
@@ -41,6 +41,27 @@
   Notes:
     - A trick buried deep in initPage() requires that the MSB of the NV Item Id
       is to be reserved for use by this module.
+    - The page and offset of the active copy of each item are kept in a RAM
+      index sorted by item Id, built once by initNV() and kept current on every
+      item write, zero and page compaction. findItem() only walks the NV pages
+      when the index has overflowed or when looking for an "old" source copy.
+    - Item Id OSAL_NV_TXN_ID is reserved for the record that precedes the items
+      of an osal_nv_txn_commit(); all of them are written to the same page and
+      none of them are valid until the record checksum is written.
+    - With OSAL_NV_COMPACT_TASK defined, the osal_nv_event_loop() task compacts
+      a page into the reserve page a few items per event whenever free space
+      runs low, instead of a write doing it all at once. Until the compaction
+      is finished, the moved copies are only known to the task: the index and
+      scanItem() still use the copies on the page being compacted, and writes
+      go to the other pages.
+    - With OSAL_NV_CACHE defined, the items added by osal_nv_cache_add() are
+      kept in RAM: osal_nv_write() only updates the RAM copy and the task writes
+      it to NV once, OSAL_NV_CACHE_DEADLINE ms after the first change. Once Vdd
+      is below OSAL_NV_CACHE_VDD, a margin above VDD_MIN_NV, a write flushes the
+      cache at once. The flush checks Vdd once and is retried after another
+      deadline if it is too low, and SystemReset() flushes the cache first.
+      Each cached item keeps a RAM copy in the heap, so only items of up to
+      OSAL_NV_CACHE_ITEM_MAX bytes can be added.
 ******************************************************************************/
 
 /*********************************************************************
@@ -52,6 +73,14 @@
 #include "hal_types.h"
 #include "OSAL_Nv.h"
 #include "ZComDef.h"
+#if defined OSAL_NV_TASK
+#include "OSAL.h"
+#include "OSAL_Tasks.h"
+#include "OSAL_Timers.h"
+#endif
+#if OSAL_NV_STATS
+#include "OSAL_Timers.h"
+#endif
 
 /*********************************************************************
  * CONSTANTS
@@ -79,12 +108,80 @@
 
 #define OSAL_NV_PAGE_HDR_OFFSET 0
 
-#define OSAL_NV_MAX_HOT         3
-static const uint16 hotIds[OSAL_NV_MAX_HOT] = {
-  ZCD_NV_NWKKEY,
-  ZCD_NV_NWK_ACTIVE_KEY_INFO,
-  ZCD_NV_NWK_ALTERN_KEY_INFO,
-};
+/* Maximum number of items in the RAM index; any items beyond this are found by walking the pages.
+ * Each entry takes 5 bytes of XDATA. The default fits the ZLL sample projects, which create about
+ * 30 items each; a project with more or fewer items sets its own size. 0 leaves the index out, and
+ * every lookup walks the pages.
+ */
+#if !defined OSAL_NV_INDEX_SIZE
+#define OSAL_NV_INDEX_SIZE      32
+#endif
+
+#if (OSAL_NV_INDEX_SIZE > 255)
+#error OSAL_NV_INDEX_SIZE must be in the range 0 to 255.
+#endif
+
+// State of the RAM index.
+#define OSAL_NV_IDX_OFF         0  // Not built yet - findItem() must walk the pages.
+#define OSAL_NV_IDX_ALL         1  // Holds every item - an index miss means the item does not exist.
+#define OSAL_NV_IDX_SOME        2  // Overflowed - an index miss must walk the pages.
+
+// Maximum number of osal_nv_txn_stage() calls per transaction.
+#if !defined OSAL_NV_TXN_MAX
+#define OSAL_NV_TXN_MAX         8
+#endif
+
+// Zero-length item written before the items of a transaction; its checksum is the commit word.
+#define OSAL_NV_TXN_ID          0x7FFF
+
+// A background compaction starts when no page has this many bytes free.
+#if !defined OSAL_NV_COMPACT_FREE
+#define OSAL_NV_COMPACT_FREE   (OSAL_NV_PAGE_SIZE / 4)
+#endif
+
+// Maximum number of items moved by the background compaction per event.
+#if !defined OSAL_NV_COMPACT_ITEMS
+#define OSAL_NV_COMPACT_ITEMS   1
+#endif
+
+// Number of items that can be added to the write cache.
+#if !defined OSAL_NV_CACHE_SIZE
+#define OSAL_NV_CACHE_SIZE      4
+#endif
+
+// Longest time in milliseconds that a change to a cached item is held back from NV.
+#if !defined OSAL_NV_CACHE_DEADLINE
+#define OSAL_NV_CACHE_DEADLINE  5000
+#endif
+
+// Longest item that can be added to the write cache, which keeps a copy of it in the heap.
+#if !defined OSAL_NV_CACHE_ITEM_MAX
+#define OSAL_NV_CACHE_ITEM_MAX  64
+#endif
+
+// Below this Vdd, changes to cached items are written at once, while Vdd is still above VDD_MIN_NV.
+#if !defined OSAL_NV_CACHE_VDD
+#define OSAL_NV_CACHE_VDD      (VDD_MIN_NV+4)
+#endif
+
+// OSAL_NV_TASK events.
+#define OSAL_NV_COMPACT_EVT     0x0001
+#define OSAL_NV_FLUSH_EVT       0x0002
+
+// Rated program/erase cycles of a Flash page, used to project the NV lifetime.
+#if !defined OSAL_NV_PAGE_ENDURANCE
+#define OSAL_NV_PAGE_ENDURANCE  20000
+#endif
+
+// Number of items with the most writes counted by the OSAL_NV_STATS.
+#if !defined OSAL_NV_STATS_ITEMS
+#define OSAL_NV_STATS_ITEMS     8
+#endif
+
+// One in this many item writes is counted by the OSAL_NV_STATS.
+#if !defined OSAL_NV_STATS_SAMPLE
+#define OSAL_NV_STATS_SAMPLE    4
+#endif
 
 /*********************************************************************
  * MACROS
@@ -102,6 +199,25 @@ static const uint16 hotIds[OSAL_NV_MAX_HOT] = {
              ((uint16)(65536UL - OSAL_NV_WORD_SIZE))                     : \
   (((((LEN) + OSAL_NV_WORD_SIZE - 1) / OSAL_NV_WORD_SIZE) * OSAL_NV_WORD_SIZE) + OSAL_NV_HDR_SIZE))
 
+#if defined OSAL_NV_COMPACT_TASK
+#define OSAL_NV_COMPACT_PG       nvComPg
+#define OSAL_NV_COMPACT_CHECK()  compactCheck()
+// TRUE if pgRes holds copies made by, or the old page left by, a background compaction.
+#define OSAL_NV_RES_BUSY()       ((nvComPg != OSAL_NV_PAGE_NULL) || nvResDirty)
+#else
+#define OSAL_NV_COMPACT_PG       OSAL_NV_PAGE_NULL
+#define OSAL_NV_COMPACT_CHECK()
+#define OSAL_NV_RES_BUSY()       FALSE
+#endif
+
+#if OSAL_NV_STATS
+#define OSAL_NV_STATS_WRITE( CNT )  (nvStatBytes += (uint32)(CNT) * OSAL_NV_WORD_SIZE)
+#define OSAL_NV_STATS_ITEM( ID )    statItem( (ID) )
+#else
+#define OSAL_NV_STATS_WRITE( CNT )
+#define OSAL_NV_STATS_ITEM( ID )
+#endif
+
 #define COMPACT_PAGE_CLEANUP( COM_PG ) st ( \
   /* In order to recover from a page compaction that is interrupted,\
    * the logic in osal_nv_init() depends upon the following order:\
@@ -151,6 +267,42 @@ typedef struct
 #define OSAL_NV_PAGE_HDR_SIZE  8
 #define OSAL_NV_PAGE_HDR_HALF (OSAL_NV_PAGE_HDR_SIZE / 2)
 
+#if OSAL_NV_INDEX_SIZE
+typedef struct
+{
+  uint16 id;
+  uint16 off;   // Offset of the item data, as returned by findItem().
+  uint8  pg;
+} osalNvIdx_t;
+#endif
+
+typedef struct
+{
+  uint8 *buf;
+  uint16 id;
+  uint16 ndx;
+  uint16 len;
+  // Only used in the first entry staged for each item Id.
+  uint16 itemLen;
+  uint16 srcOff;  // Data offset of the current copy of the item.
+  uint16 dstOff;  // Data offset of the new copy; OSAL_NV_ITEM_NULL if the item is unchanged.
+  uint8  srcPg;
+} osalNvTxn_t;
+
+typedef struct
+{
+  uint16 id;
+  uint16 cnt;   // Sampled writes.
+} osalNvStatItem_t;
+
+typedef struct
+{
+  uint8 *buf;   // RAM copy of the item; NULL if the entry is free.
+  uint16 id;
+  uint16 len;
+  uint8 dirty;  // TRUE if the RAM copy has changes not yet written to NV.
+} osalNvCache_t;
+
 typedef enum
 {
   eNvXfer,
@@ -192,9 +344,44 @@ static uint8 pgRes;  // Page reserved for item compacting transfer.
 // Saving ~100 code bytes to move a uint8* parameter/return value from findItem() to a global.
 static uint8 findPg;
 
-// NV page and offsets for hot items.
-static uint8 hotPg[OSAL_NV_MAX_HOT];
-static uint16 hotOff[OSAL_NV_MAX_HOT];
+#if OSAL_NV_INDEX_SIZE
+// RAM index of the active items, sorted by item Id.
+static osalNvIdx_t nvIdx[OSAL_NV_INDEX_SIZE];
+static uint8 nvIdxCnt;
+static uint8 nvIdxState;
+#endif
+
+// Writes staged since osal_nv_txn_begin().
+static osalNvTxn_t nvTxn[OSAL_NV_TXN_MAX];
+static uint8 nvTxnCnt;
+static uint8 nvTxnOpen;
+
+#if defined OSAL_NV_TASK
+static uint8 nvTaskId = TASK_NO_TASK;
+#endif
+
+#if defined OSAL_NV_COMPACT_TASK
+// Page being compacted into pgRes by the task, or OSAL_NV_PAGE_NULL.
+static uint8 nvComPg;
+// Offset of the next item header to move from nvComPg.
+static uint16 nvComOff;
+// TRUE if pgRes is a compacted page which the task has yet to erase.
+static uint8 nvResDirty;
+#endif
+
+#if defined OSAL_NV_CACHE
+static osalNvCache_t nvCache[OSAL_NV_CACHE_SIZE];
+// TRUE if a cached item has changed since the last flush, i.e. the flush timer is running.
+static uint8 nvCacheDirty;
+#endif
+
+#if OSAL_NV_STATS
+static uint32 nvStatStart;  // osal_GetSystemClock() when the statistics were cleared.
+static uint32 nvStatBytes;
+static uint16 nvStatErases;
+static uint8 nvStatSample;
+static osalNvStatItem_t nvStatItem[OSAL_NV_STATS_ITEMS];
+#endif
 
 /*********************************************************************
  * LOCAL FUNCTIONS
@@ -208,6 +395,7 @@ static void   erasePage( uint8 pg );
 static uint8  compactPage( uint8 srcPg, uint16 skipId );
 
 static uint16 findItem( uint16 id );
+static uint16 scanItem( uint16 id );
 static uint8  initItem( uint8 flag, uint16 id, uint16 len, void *buf );
 static void   setItem( uint8 pg, uint16 offset, eNvHdrEnum stat );
 static uint16 setChk( uint8 pg, uint16 offset, uint16 chk );
@@ -222,8 +410,43 @@ static void   writeBuf( uint8 pg, uint16 offset, uint16 len, uint8 *buf );
 static void   xferBuf( uint8 srcPg, uint16 srcOff, uint8 dstPg, uint16 dstOff, uint16 len );
 
 static uint8  writeItem( uint8 pg, uint16 id, uint16 len, void *buf, uint8 flag );
-static uint8  hotItem(uint16 id);
-static void   hotItemUpdate(uint8 pg, uint16 off, uint16 id);
+
+#if OSAL_NV_INDEX_SIZE
+static void   idxInit( void );
+static uint8  idxFind( uint16 id );
+static void   idxUpdate( uint8 pg, uint16 off, uint16 id );
+static void   idxRemove( uint8 pg, uint16 off, uint16 id );
+#else
+#define idxInit()
+#define idxUpdate( pg, off, id )
+#define idxRemove( pg, off, id )
+#endif
+
+static void   initTxn( void );
+static uint8  txnLead( uint8 idx );
+static uint8  txnPage( uint16 sz );
+static uint8  txnItem( uint8 lead, uint8 pg );
+
+static uint8  freePage( uint16 sz );
+
+#if defined OSAL_NV_COMPACT_TASK
+static void   compactCheck( void );
+static uint8  compactNeeded( void );
+static uint8  compactStart( void );
+static uint8  compactItem( void );
+static void   compactDone( void );
+static void   compactFinish( void );
+#endif
+
+static uint16 eraseCnt( uint8 pg );
+static uint8  writeNV( uint16 id, uint16 ndx, uint16 len, void *buf );
+#if defined OSAL_NV_CACHE
+static osalNvCache_t *cacheFind( uint16 id );
+static uint8  cacheWrite( osalNvCache_t *pCache, uint16 ndx, uint16 len, void *buf );
+#endif
+#if OSAL_NV_STATS
+static void   statItem( uint16 id );
+#endif
 
 /*********************************************************************
  * @fn      initNV
@@ -242,6 +465,14 @@ static uint8 initNV( void )
   uint8 pg;
 
   pgRes = OSAL_NV_PAGE_NULL;
+#if OSAL_NV_INDEX_SIZE
+  nvIdxState = OSAL_NV_IDX_OFF;
+  nvIdxCnt = 0;
+#endif
+#if defined OSAL_NV_COMPACT_TASK
+  nvComPg = OSAL_NV_PAGE_NULL;
+  nvResDirty = FALSE;
+#endif
 
   for ( pg = OSAL_NV_PAGE_BEG; pg <= OSAL_NV_PAGE_END; pg++ )
   {
@@ -289,6 +520,9 @@ static uint8 initNV( void )
   {
     erasePage( pgRes );  // The last page erase could have been interrupted by a power-cycle.
   }
+
+  // Must precede initPage(), which would zero the uncommitted record but keep its items.
+  initTxn();
   /* else if there is no reserve page, COMPACT_PAGE_CLEANUP() must have succeeded to put the old
    * reserve page (i.e. the target of the compacted items) into use but got interrupted by a reset
    * while trying to erase the page to be compacted. Such a page should only contain duplicate items
@@ -341,6 +575,8 @@ static uint8 initNV( void )
     erasePage( pgRes );  // The last page erase had been interrupted by a power-cycle.
   }
 
+  idxInit();
+
   return TRUE;
 }
 
@@ -494,10 +730,45 @@ static uint16 initPage( uint8 pg, uint16 id, uint8 findDups )
  */
 static void erasePage( uint8 pg )
 {
+  osalNvPgHdr_t pgHdr;
+#if OSAL_NV_INDEX_SIZE
+  uint8 idx;
+#endif
+
+  pgHdr.spare = eraseCnt( pg );
+  if ( pgHdr.spare < (OSAL_NV_ERASED_ID - 1) )
+  {
+    pgHdr.spare++;
+  }
+  pgHdr.xfer = OSAL_NV_ERASED_ID;
+
   HalFlashErase(pg);
+#if OSAL_NV_STATS
+  nvStatErases++;
+#endif
+
+  // Keep the erase count in the spare member of the page header, sharing the Flash-WORD with xfer.
+  writeWord( pg, OSAL_NV_PG_XFER, (uint8 *)(&pgHdr.xfer) );
 
   pgOff[pg - OSAL_NV_PAGE_BEG] = OSAL_NV_PAGE_HDR_SIZE;
   pgLost[pg - OSAL_NV_PAGE_BEG] = 0;
+
+#if OSAL_NV_INDEX_SIZE
+  /* Only an aborted compaction erases a page still referenced by the index (the items transferred
+   * to it are still valid on their source page), so rebuild the index from the pages as they are now.
+   */
+  if ( nvIdxState != OSAL_NV_IDX_OFF )
+  {
+    for ( idx = 0; idx < nvIdxCnt; idx++ )
+    {
+      if ( nvIdx[idx].pg == pg )
+      {
+        idxInit();
+        break;
+      }
+    }
+  }
+#endif
 }
 
 /*********************************************************************
@@ -535,6 +806,13 @@ static uint8 compactPage( uint8 srcPg, uint16 skipId )
   // To minimize code size, only check for a clean page here where it's absolutely required.
   for (srcOff = 0; srcOff < OSAL_NV_PAGE_SIZE; srcOff++)
   {
+    // The page header spare member holds the erase count.
+    if (srcOff == OSAL_NV_PG_SPARE)
+    {
+      srcOff += OSAL_NV_HDR_ITEM - 1;
+      continue;
+    }
+
     HalFlashRead(pgRes, srcOff, &rtrn, 1);
     if (rtrn != OSAL_NV_ERASED)
     {
@@ -600,7 +878,7 @@ static uint8 compactPage( uint8 srcPg, uint16 skipId )
             }
             else
             {
-              hotItemUpdate(pgRes, dstOff, hdr.id);
+              idxUpdate(pgRes, dstOff, hdr.id);
             }
           }
           else
@@ -648,12 +926,50 @@ static uint8 compactPage( uint8 srcPg, uint16 skipId )
  *
  */
 static uint16 findItem( uint16 id )
+{
+#if OSAL_NV_INDEX_SIZE
+  if ( (nvIdxState != OSAL_NV_IDX_OFF) && ((id & OSAL_NV_SOURCE_ID) == 0) )
+  {
+    uint8 idx = idxFind( id );
+
+    if ( (idx < nvIdxCnt) && (nvIdx[idx].id == id) )
+    {
+      findPg = nvIdx[idx].pg;
+      return nvIdx[idx].off;
+    }
+    else if ( nvIdxState == OSAL_NV_IDX_ALL )
+    {
+      findPg = OSAL_NV_PAGE_NULL;
+      return OSAL_NV_ITEM_NULL;
+    }
+  }
+#endif
+
+  return scanItem( id );
+}
+
+/*********************************************************************
+ * @fn      scanItem
+ *
+ * @brief   Find an item Id by walking the NV pages.
+ *
+ * @param   id - Valid NV item Id, with OSAL_NV_SOURCE_ID set to find the "old" copy.
+ *
+ * @return  Same as findItem().
+ */
+static uint16 scanItem( uint16 id )
 {
   uint16 off;
   uint8 pg;
 
   for ( pg = OSAL_NV_PAGE_BEG; pg <= OSAL_NV_PAGE_END; pg++ )
   {
+    // Skip the copies made so far by, or the old page left by, a background compaction.
+    if ( (pg == pgRes) && OSAL_NV_RES_BUSY() )
+    {
+      continue;
+    }
+
     if ( (off = initPage( pg, id, FALSE )) != OSAL_NV_ITEM_NULL )
     {
       findPg = pg;
@@ -664,7 +980,7 @@ static uint16 findItem( uint16 id )
   // Now attempt to find the item as the "old" item of a failed/interrupted NV write.
   if ( (id & OSAL_NV_SOURCE_ID) == 0 )
   {
-    return findItem( id | OSAL_NV_SOURCE_ID );
+    return scanItem( id | OSAL_NV_SOURCE_ID );
   }
   else
   {
@@ -696,7 +1012,26 @@ static uint8 initItem( uint8 flag, uint16 id, uint16 len, void *buf )
   uint16 sz = OSAL_NV_ITEM_SIZE( len );
   uint8 rtrn = OSAL_NV_PAGE_NULL;
   uint8 cnt = OSAL_NV_PAGES_USED;
-  uint8 pg = pgRes+1;  // Set to 1 after the reserve page to even wear across all available pages.
+  uint8 pg;
+
+#if defined OSAL_NV_COMPACT_TASK
+  /* Leave the compaction to the background task if any page has room as it is; otherwise the
+   * compaction in progress, if any, has to be finished before pgRes can be used here.
+   */
+  if ( (pg = freePage( sz )) != OSAL_NV_PAGE_NULL )
+  {
+    return ( writeItem( pg, id, len, buf, flag ) ? pg : OSAL_NV_PAGE_NULL );
+  }
+
+  compactFinish();
+
+  if ( (pg = freePage( sz )) != OSAL_NV_PAGE_NULL )
+  {
+    return ( writeItem( pg, id, len, buf, flag ) ? pg : OSAL_NV_PAGE_NULL );
+  }
+#endif
+
+  pg = pgRes+1;  // Set to 1 after the reserve page to even wear across all available pages.
 
   do {
     if (pg >= OSAL_NV_PAGE_BEG+OSAL_NV_PAGES_USED)
@@ -801,6 +1136,7 @@ static void setItem( uint8 pg, uint16 offset, eNvHdrEnum stat )
   {
     uint16 sz = ((hdr.len + (OSAL_NV_WORD_SIZE-1)) / OSAL_NV_WORD_SIZE) * OSAL_NV_WORD_SIZE +
                                                                           OSAL_NV_HDR_SIZE;
+    idxRemove( pg, offset + OSAL_NV_HDR_SIZE, hdr.id );
     hdr.id = 0;
     writeWord( pg, offset, (uint8 *)(&hdr) );
     pgLost[pg-OSAL_NV_PAGE_BEG] += sz;
@@ -915,6 +1251,7 @@ static void writeWord( uint8 pg, uint16 offset, uint8 *buf )
           ((uint16)pg * (HAL_FLASH_PAGE_SIZE / HAL_FLASH_WORD_SIZE));
 
   HalFlashWrite(offset, buf, 1);
+  OSAL_NV_STATS_WRITE( 1 );
 }
 
 /*********************************************************************
@@ -934,6 +1271,7 @@ static void writeWordM( uint8 pg, uint16 offset, uint8 *buf, uint16 cnt )
   offset = (offset / HAL_FLASH_WORD_SIZE) +
           ((uint16)pg * (HAL_FLASH_PAGE_SIZE / HAL_FLASH_WORD_SIZE));
   HalFlashWrite(offset, buf, cnt);
+  OSAL_NV_STATS_WRITE( cnt );
 }
 
 /*********************************************************************
@@ -1108,7 +1446,7 @@ static uint8 writeItem( uint8 pg, uint16 id, uint16 len, void *buf, uint8 flag )
       {
         if ( hdr.chk == setChk( pg, offset, hdr.chk ) )
         {
-          hotItemUpdate(pg, offset, hdr.id);
+          idxUpdate(pg, offset, hdr.id);
           rtrn = TRUE;
         }
       }
@@ -1136,367 +1474,1806 @@ static uint8 writeItem( uint8 pg, uint16 id, uint16 len, void *buf, uint8 flag )
   return rtrn;
 }
 
+#if OSAL_NV_INDEX_SIZE
+/*********************************************************************
+ * @fn      idxInit
+ *
+ * @brief   Build the RAM index by walking the item headers of all NV pages.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+static void idxInit( void )
+{
+  uint8 pg;
+
+  nvIdxCnt = 0;
+  nvIdxState = OSAL_NV_IDX_ALL;
+
+  for ( pg = OSAL_NV_PAGE_BEG; pg <= OSAL_NV_PAGE_END; pg++ )
+  {
+    uint16 offset = OSAL_NV_PAGE_HDR_SIZE;
+
+    // Skip the copies made so far by, or the old page left by, a background compaction.
+    if ( (pg == pgRes) && OSAL_NV_RES_BUSY() )
+    {
+      continue;
+    }
+
+    while ( offset < (OSAL_NV_PAGE_SIZE - OSAL_NV_HDR_SIZE) )
+    {
+      osalNvHdr_t hdr;
+      uint16 sz;
+
+      HalFlashRead(pg, offset, (uint8 *)(&hdr), OSAL_NV_HDR_SIZE);
+
+      if ( hdr.id == OSAL_NV_ERASED_ID )
+      {
+        break;
+      }
+
+      sz = OSAL_NV_DATA_SIZE( hdr.len );
+
+      if ( sz > (OSAL_NV_PAGE_SIZE - OSAL_NV_HDR_SIZE - offset) )
+      {
+        break;
+      }
+
+      offset += OSAL_NV_HDR_SIZE;
+
+      if ( hdr.id != OSAL_NV_ZEROED_ID )
+      {
+        /* Same precedence as scanItem(): the new copy of an item always wins, whereas the "old"
+         * source copy of an interrupted write is only used if there is no new copy.
+         */
+        if ( hdr.stat == OSAL_NV_ERASED_ID )
+        {
+          idxUpdate( pg, offset, hdr.id );
+        }
+        else
+        {
+          uint8 idx = idxFind( hdr.id );
+
+          if ( (idx == nvIdxCnt) || (nvIdx[idx].id != hdr.id) )
+          {
+            idxUpdate( pg, offset, hdr.id );
+          }
+        }
+      }
+
+      offset += sz;
+    }
+  }
+}
+
 /*********************************************************************
- * @fn      hotItem
+ * @fn      idxFind
  *
- * @brief   Look for the parameter 'id' in the hot items array.
+ * @brief   Binary search of the RAM index.
  *
  * @param   id - A valid NV item Id.
  *
- * @return  A valid index into the hot items if the item is hot; OSAL_NV_MAX_HOT if not.
+ * @return  The index of the entry for 'id' if it is in the RAM index;
+ *          otherwise the index at which it would be inserted.
  */
-static uint8 hotItem(uint16 id)
+static uint8 idxFind( uint16 id )
 {
-  uint8 hotIdx;
+  uint8 lo = 0;
+  uint8 hi = nvIdxCnt;
 
-  for (hotIdx = 0; hotIdx < OSAL_NV_MAX_HOT; hotIdx++)
+  while ( lo < hi )
   {
-    if (hotIds[hotIdx] == id)
+    uint8 mid = (uint8)(((uint16)lo + hi) / 2);
+
+    if ( nvIdx[mid].id < id )
     {
-      break;
+      lo = mid + 1;
+    }
+    else
+    {
+      hi = mid;
     }
   }
 
-  return hotIdx;
+  return lo;
 }
 
 /*********************************************************************
- * @fn      hotItemUpdate
+ * @fn      idxUpdate
  *
- * @brief   If the parameter 'id' is a hot item, update the corresponding hot item data.
+ * @brief   Set the page and offset of an item in the RAM index, adding the item if necessary.
  *
- * @param   pg - The new NV page corresponding to the hot item.
- * @param   off - The new NV page offset corresponding to the hot item.
+ * @param   pg - The new NV page of the item.
+ * @param   off - The new NV page offset of the item data.
  * @param   id - A valid NV item Id.
  *
  * @return  none
  */
-static void hotItemUpdate(uint8 pg, uint16 off, uint16 id)
+static void idxUpdate( uint8 pg, uint16 off, uint16 id )
 {
-  uint8 hotIdx = hotItem(id);
+  uint8 idx, cnt;
+
+  if ( nvIdxState == OSAL_NV_IDX_OFF )
+  {
+    return;
+  }
 
-  if (hotIdx < OSAL_NV_MAX_HOT)
+  idx = idxFind( id );
+
+  if ( (idx == nvIdxCnt) || (nvIdx[idx].id != id) )
   {
+    if ( nvIdxCnt == OSAL_NV_INDEX_SIZE )
+    {
+      nvIdxState = OSAL_NV_IDX_SOME;
+      return;
+    }
+
+    for ( cnt = nvIdxCnt; cnt > idx; cnt-- )
     {
-      hotPg[hotIdx] = pg;
-      hotOff[hotIdx] = off;
+      nvIdx[cnt] = nvIdx[cnt-1];
     }
+    nvIdxCnt++;
+    nvIdx[idx].id = id;
   }
+
+  nvIdx[idx].pg = pg;
+  nvIdx[idx].off = off;
 }
 
 /*********************************************************************
- * @fn      osal_nv_init
+ * @fn      idxRemove
  *
- * @brief   Initialize NV service.
+ * @brief   Remove an item from the RAM index if the index refers to the given copy of the item.
  *
- * @param   p - Not used.
+ * @param   pg - The NV page of the copy being zeroed.
+ * @param   off - The NV page offset of the data of the copy being zeroed.
+ * @param   id - A valid NV item Id.
  *
  * @return  none
  */
-void osal_nv_init( void *p )
+static void idxRemove( uint8 pg, uint16 off, uint16 id )
 {
-  (void)p;  // Suppress Lint warning.
-  (void)initNV();  // Always returns TRUE after pages have been erased.
+  uint8 idx = idxFind( id );
+
+  if ( (idx < nvIdxCnt) && (nvIdx[idx].id == id) &&
+       (nvIdx[idx].pg == pg) && (nvIdx[idx].off == off) )
+  {
+    nvIdxCnt--;
+
+    for ( ; idx < nvIdxCnt; idx++ )
+    {
+      nvIdx[idx] = nvIdx[idx+1];
+    }
+  }
 }
+#endif
 
 /*********************************************************************
- * @fn      osal_nv_item_init
+ * @fn      initTxn
  *
- * @brief   If the NV item does not already exist, it is created and
- *          initialized with the data passed to the function, if any.
- *          This function must be called before calling osal_nv_read() or
- *          osal_nv_write().
+ * @brief   Finish the transaction interrupted by a reset, if any: the items following an
+ *          uncommitted transaction record are zeroed, leaving the "old" source copies in use.
+ *          The "old" copies of the items of a committed transaction are zeroed as duplicates
+ *          by initNV().
  *
- * @param   id  - Valid NV item Id.
- * @param   len - Item length.
- * @param  *buf - Pointer to item initalization data. Set to NULL if none.
+ * @param   none
  *
- * @return  NV_ITEM_UNINIT - Id did not exist and was created successfully.
- *          SUCCESS        - Id already existed, no action taken.
- *          NV_OPER_FAILED - Failure to find or create Id.
+ * @return  none
  */
-uint8 osal_nv_item_init( uint16 id, uint16 len, void *buf )
+static void initTxn( void )
 {
-  uint16 offset;
+  uint8 pg;
 
-  if ( !OSAL_NV_CHECK_BUS_VOLTAGE )
-  {
-    return NV_OPER_FAILED;
-  }
-  else if ((offset = findItem(id)) != OSAL_NV_ITEM_NULL)
+  for ( pg = OSAL_NV_PAGE_BEG; pg <= OSAL_NV_PAGE_END; pg++ )
   {
-    // Re-populate the NV hot item data if the corresponding items are already established.
-    hotItemUpdate(findPg, offset, id);
+    uint16 offset = OSAL_NV_PAGE_HDR_SIZE;
+    uint16 txnOff = OSAL_NV_ITEM_NULL;
 
-    return SUCCESS;
-  }
-  else if ( initItem( TRUE, id, len, buf ) != OSAL_NV_PAGE_NULL )
-  {
-    return NV_ITEM_UNINIT;
-  }
-  else
-  {
-    return NV_OPER_FAILED;
+    while ( offset < (OSAL_NV_PAGE_SIZE - OSAL_NV_HDR_SIZE) )
+    {
+      osalNvHdr_t hdr;
+      uint16 sz;
+
+      HalFlashRead(pg, offset, (uint8 *)(&hdr), OSAL_NV_HDR_SIZE);
+
+      if ( hdr.id == OSAL_NV_ERASED_ID )
+      {
+        break;
+      }
+
+      sz = OSAL_NV_DATA_SIZE( hdr.len );
+
+      if ( sz > (OSAL_NV_PAGE_SIZE - OSAL_NV_HDR_SIZE - offset) )
+      {
+        break;
+      }
+
+      offset += OSAL_NV_HDR_SIZE;
+
+      if ( hdr.id == OSAL_NV_TXN_ID )
+      {
+        if ( hdr.chk == OSAL_NV_ZEROED_ID )
+        {
+          setItem( pg, offset, eNvZero );  // Committed.
+        }
+        else
+        {
+          txnOff = offset;
+        }
+      }
+      else if ( (txnOff != OSAL_NV_ITEM_NULL) && (hdr.id != OSAL_NV_ZEROED_ID) )
+      {
+        setItem( pg, offset, eNvZero );  // Roll back the new copy of an uncommitted item.
+      }
+
+      offset += sz;
+    }
+
+    // The record is zeroed last so that an interrupted roll back is finished on the next reset.
+    if ( txnOff != OSAL_NV_ITEM_NULL )
+    {
+      setItem( pg, txnOff, eNvZero );
+    }
   }
 }
 
 /*********************************************************************
- * @fn      osal_nv_item_len
+ * @fn      txnLead
  *
- * @brief   Get the data length of the item stored in NV memory.
+ * @brief   Find the first staged write to the same item as the one at 'idx'.
  *
- * @param   id  - Valid NV item Id.
+ * @param   idx - A valid index into the staged writes.
  *
- * @return  Item length, if found; zero otherwise.
+ * @return  The index of the first staged write to the item.
  */
-uint16 osal_nv_item_len( uint16 id )
+static uint8 txnLead( uint8 idx )
 {
-  osalNvHdr_t hdr;
-  uint16 offset;
-  uint8 hotIdx;
+  uint8 lead;
 
-  if ((hotIdx = hotItem(id)) < OSAL_NV_MAX_HOT)
-  {
-    findPg = hotPg[hotIdx];
-    offset = hotOff[hotIdx];
-  }
-  else if ((offset = findItem(id)) == OSAL_NV_ITEM_NULL)
+  for ( lead = 0; lead < idx; lead++ )
   {
-    return 0;
+    if ( nvTxn[lead].id == nvTxn[idx].id )
+    {
+      break;
+    }
   }
 
-  HalFlashRead(findPg, (offset - OSAL_NV_HDR_SIZE), (uint8 *)(&hdr), OSAL_NV_HDR_SIZE);
-  return hdr.len;
+  return lead;
 }
 
 /*********************************************************************
- * @fn      osal_nv_write
+ * @fn      txnPage
  *
- * @brief   Write a data item to NV. Function can write an entire item to NV or
- *          an element of an item by indexing into the item with an offset.
+ * @brief   Find a page with room for all of the items of a transaction, compacting one page
+ *          if that is the only way to make enough room.
  *
- * @param   id  - Valid NV item Id.
- * @param   ndx - Index offset into item
- * @param   len - Length of data to write.
- * @param  *buf - Data to write.
+ * @param   sz - Total size of the transaction record and the items.
  *
- * @return  SUCCESS if successful, NV_ITEM_UNINIT if item did not
- *          exist in NV and offset is non-zero, NV_OPER_FAILED if failure.
+ * @return  The OSAL Nv page number if the space is available; OSAL_NV_PAGE_NULL otherwise.
  */
-uint8 osal_nv_write( uint16 id, uint16 ndx, uint16 len, void *buf )
+static uint8 txnPage( uint16 sz )
 {
-  uint8 rtrn = SUCCESS;
+  osalNvPgHdr_t pgHdr;
+  uint8 cnt, pg, dstPg;
+  uint8 comPg = OSAL_NV_PAGE_NULL;
 
-  if ( !OSAL_NV_CHECK_BUS_VOLTAGE )
+  // Only compact if no page has enough room as it is - the items can't be split across pages.
+  if ( (pg = freePage( sz )) != OSAL_NV_PAGE_NULL )
   {
-    return NV_OPER_FAILED;
+    return pg;
   }
-  else if ( len != 0 )
+
+#if defined OSAL_NV_COMPACT_TASK
+  compactFinish();
+
+  if ( (pg = freePage( sz )) != OSAL_NV_PAGE_NULL )
   {
-    osalNvHdr_t hdr;
-    uint16 origOff, srcOff;
-    uint16 cnt, chk;
-    uint8 *ptr, srcPg;
+    return pg;
+  }
+#endif
 
-    origOff = srcOff = findItem( id );
-    srcPg = findPg;
-    if ( srcOff == OSAL_NV_ITEM_NULL )
+  // Set to 1 after the reserve page to even wear across all available pages.
+  for ( cnt = 0, pg = pgRes+1; cnt < OSAL_NV_PAGES_USED; cnt++, pg++ )
+  {
+    if (pg >= OSAL_NV_PAGE_BEG+OSAL_NV_PAGES_USED)
     {
-      return NV_ITEM_UNINIT;
+      pg = OSAL_NV_PAGE_BEG;
     }
-
-    HalFlashRead(srcPg, (srcOff - OSAL_NV_HDR_SIZE), (uint8 *)(&hdr), OSAL_NV_HDR_SIZE);
-    if ( hdr.len < (ndx + len) )
+    if ( pg != pgRes )
     {
-      return NV_OPER_FAILED;
-    }
-
-    srcOff += ndx;
+      uint8 idx = pg - OSAL_NV_PAGE_BEG;
+      if ( sz <= (OSAL_NV_PAGE_SIZE - pgOff[idx] + pgLost[idx]) )
+      {
+        comPg = pg;
+        break;
+      }
+    }
+  }
+
+  if ( comPg == OSAL_NV_PAGE_NULL )
+  {
+    return OSAL_NV_PAGE_NULL;
+  }
+
+  /* Prevent excessive re-writes to page header caused by numerous, rapid, & successive
+   * OSAL_Nv interruptions caused by resets.
+   */
+  HalFlashRead(comPg, OSAL_NV_PAGE_HDR_OFFSET, (uint8 *)(&pgHdr), OSAL_NV_PAGE_HDR_SIZE);
+  if ( pgHdr.xfer == OSAL_NV_ERASED_ID )
+  {
+    // Mark the old page as being in process of compaction.
+    uint16 xfer = OSAL_NV_ZEROED_ID;
+    writeWordH( comPg, OSAL_NV_PG_XFER, (uint8*)(&xfer) );
+  }
+
+  /* The compaction is finished before anything of the transaction is written, so that it does not
+   * need to know about the transaction at all; the items are then written to what had been the
+   * reserved page.
+   */
+  dstPg = pgRes;
+  if ( !compactPage( comPg, OSAL_NV_ITEM_NULL ) ||
+       (sz > (OSAL_NV_PAGE_SIZE - pgOff[dstPg - OSAL_NV_PAGE_BEG])) )
+  {
+    return OSAL_NV_PAGE_NULL;
+  }
+
+  return dstPg;
+}
+
+/*********************************************************************
+ * @fn      freePage
+ *
+ * @brief   Find a page with room for 'sz' bytes without compacting it.
+ *
+ * @param   sz - Byte count of the item(s) to write.
+ *
+ * @return  The OSAL Nv page number if found; OSAL_NV_PAGE_NULL otherwise.
+ */
+static uint8 freePage( uint16 sz )
+{
+  uint8 cnt;
+  uint8 pg = pgRes+1;  // Set to 1 after the reserve page to even wear across all available pages.
+
+  for ( cnt = 0; cnt < OSAL_NV_PAGES_USED; cnt++, pg++ )
+  {
+    if (pg >= OSAL_NV_PAGE_BEG+OSAL_NV_PAGES_USED)
+    {
+      pg = OSAL_NV_PAGE_BEG;
+    }
+    if ( (pg != pgRes) && (pg != OSAL_NV_COMPACT_PG) &&
+         (sz <= (OSAL_NV_PAGE_SIZE - pgOff[pg - OSAL_NV_PAGE_BEG])) )
+    {
+      return pg;
+    }
+  }
+
+  return OSAL_NV_PAGE_NULL;
+}
+
+#if defined OSAL_NV_COMPACT_TASK
+/*********************************************************************
+ * @fn      compactCheck
+ *
+ * @brief   Kick the background compaction task if a page needs to be compacted.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+static void compactCheck( void )
+{
+  if ( (nvTaskId != TASK_NO_TASK) &&
+       ((nvComPg != OSAL_NV_PAGE_NULL) || nvResDirty || (compactNeeded() != OSAL_NV_PAGE_NULL)) )
+  {
+    osal_set_event( nvTaskId, OSAL_NV_COMPACT_EVT );
+  }
+}
+
+/*********************************************************************
+ * @fn      compactNeeded
+ *
+ * @brief   Choose the page to compact in the background: once no page has OSAL_NV_COMPACT_FREE
+ *          bytes free, the page with the most lost bytes, if it will recover at least as many.
+ *
+ * @param   none
+ *
+ * @return  The OSAL Nv page number to compact; OSAL_NV_PAGE_NULL if none.
+ */
+static uint8 compactNeeded( void )
+{
+  uint16 lost = OSAL_NV_COMPACT_FREE - 1;
+  uint8 comPg = OSAL_NV_PAGE_NULL;
+  uint8 pg;
+
+  for ( pg = OSAL_NV_PAGE_BEG; pg <= OSAL_NV_PAGE_END; pg++ )
+  {
+    if ( pg != pgRes )
+    {
+      uint8 idx = pg - OSAL_NV_PAGE_BEG;
+
+      if ( (OSAL_NV_PAGE_SIZE - pgOff[idx]) >= OSAL_NV_COMPACT_FREE )
+      {
+        return OSAL_NV_PAGE_NULL;
+      }
+      else if ( pgLost[idx] > lost )
+      {
+        lost = pgLost[idx];
+        comPg = pg;
+      }
+    }
+  }
+
+  return comPg;
+}
+
+/*********************************************************************
+ * @fn      compactStart
+ *
+ * @brief   Start the background compaction of the page chosen by compactNeeded().
+ *
+ * @param   none
+ *
+ * @return  TRUE if there is more work for the task; FALSE otherwise.
+ */
+static uint8 compactStart( void )
+{
+  osalNvPgHdr_t pgHdr;
+  uint16 off;
+  uint8 pg = compactNeeded();
+
+  if ( pg == OSAL_NV_PAGE_NULL )
+  {
+    return FALSE;
+  }
+
+  // The page header spare member holds the erase count.
+  HalFlashRead(pgRes, OSAL_NV_PAGE_HDR_OFFSET, (uint8 *)(&pgHdr), OSAL_NV_PAGE_HDR_SIZE);
+  if ( (pgHdr.active != OSAL_NV_ERASED_ID) || (pgHdr.inUse != OSAL_NV_ERASED_ID) ||
+       (pgHdr.xfer != OSAL_NV_ERASED_ID) )
+  {
+    erasePage( pgRes );  // The compaction starts on the next event.
+    return TRUE;
+  }
+
+  for ( off = OSAL_NV_PAGE_HDR_SIZE; off < OSAL_NV_PAGE_SIZE; off += OSAL_NV_WORD_SIZE )
+  {
+    uint8 tmp[OSAL_NV_WORD_SIZE];
+    uint8 cnt;
+
+    HalFlashRead(pgRes, off, tmp, OSAL_NV_WORD_SIZE);
+    for ( cnt = 0; cnt < OSAL_NV_WORD_SIZE; cnt++ )
+    {
+      if ( tmp[cnt] != OSAL_NV_ERASED )
+      {
+        erasePage( pgRes );
+        return TRUE;
+      }
+    }
+  }
+
+  nvComPg = pg;
+  nvComOff = OSAL_NV_PAGE_HDR_SIZE;
+
+  return TRUE;
+}
+
+/*********************************************************************
+ * @fn      compactItem
+ *
+ * @brief   Copy the next item of the page being compacted in the background to pgRes, if it
+ *          is the copy in use, and finish the compaction at the end of the page.
+ *
+ * @param   none
+ *
+ * @return  TRUE if there are more items to copy; FALSE if the compaction is finished or failed.
+ */
+static uint8 compactItem( void )
+{
+  osalNvHdr_t hdr;
+  uint16 srcOff = nvComOff;
+  uint16 sz;
+
+  if ( srcOff < (OSAL_NV_PAGE_SIZE - OSAL_NV_HDR_SIZE) )
+  {
+    HalFlashRead(nvComPg, srcOff, (uint8 *)(&hdr), OSAL_NV_HDR_SIZE);
+    sz = OSAL_NV_DATA_SIZE( hdr.len );
+  }
+  else
+  {
+    hdr.id = OSAL_NV_ERASED_ID;
+    sz = 0;
+  }
+
+  if ( (hdr.id == OSAL_NV_ERASED_ID) || (sz > (OSAL_NV_PAGE_SIZE - OSAL_NV_HDR_SIZE - srcOff)) )
+  {
+    compactDone();
+    return FALSE;
+  }
+
+  srcOff += OSAL_NV_HDR_SIZE;
+  nvComOff = srcOff + sz;
+
+  // Old copies left by an interrupted write are dropped if the item has been written since.
+  if ( (hdr.id != OSAL_NV_ZEROED_ID) && (findItem( hdr.id ) == srcOff) && (findPg == nvComPg) &&
+       (hdr.chk == calcChkF( nvComPg, srcOff, hdr.len )) )
+  {
+    uint16 dstOff = pgOff[pgRes - OSAL_NV_PAGE_BEG];
+    uint8 rtrn = FALSE;
+
+    if ( (sz <= (OSAL_NV_PAGE_SIZE - OSAL_NV_HDR_SIZE - dstOff)) &&
+         writeItem( pgRes, hdr.id, hdr.len, NULL, FALSE ) )
+    {
+      dstOff += OSAL_NV_HDR_SIZE;
+      xferBuf( nvComPg, srcOff, pgRes, dstOff, sz );
+
+      if ( (hdr.chk == calcChkF( pgRes, dstOff, hdr.len )) &&
+           (hdr.chk == setChk( pgRes, dstOff, hdr.chk )) )
+      {
+        rtrn = TRUE;
+      }
+    }
+
+    if ( rtrn == FALSE )
+    {
+      // Give up until the next write finds that a compaction is needed.
+      nvComPg = OSAL_NV_PAGE_NULL;
+      erasePage( pgRes );
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+/*********************************************************************
+ * @fn      compactDone
+ *
+ * @brief   Switch over to the compacted page once all items have been copied to it. The old page
+ *          becomes pgRes, which the task erases on the next event.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+static void compactDone( void )
+{
+  osalNvPgHdr_t pgHdr;
+  uint16 offset;
+  uint8 pg = nvComPg;
+
+  /* Point the index at the copies; a copy is zeroed instead if its item has been written to
+   * another page or deleted since it was copied.
+   */
+  for ( offset = OSAL_NV_PAGE_HDR_SIZE; offset < pgOff[pgRes - OSAL_NV_PAGE_BEG]; )
+  {
+    osalNvHdr_t hdr;
+
+    HalFlashRead(pgRes, offset, (uint8 *)(&hdr), OSAL_NV_HDR_SIZE);
+    offset += OSAL_NV_HDR_SIZE;
+
+    if ( hdr.id != OSAL_NV_ZEROED_ID )
+    {
+      if ( (findItem( hdr.id ) != OSAL_NV_ITEM_NULL) && (findPg == pg) )
+      {
+        idxUpdate( pgRes, offset, hdr.id );
+      }
+      else
+      {
+        setItem( pgRes, offset, eNvZero );
+      }
+    }
+
+    offset += OSAL_NV_DATA_SIZE( hdr.len );
+  }
+
+  // Same page and item states as a compactPage() from initItem() when the old page is erased.
+  HalFlashRead(pg, OSAL_NV_PAGE_HDR_OFFSET, (uint8 *)(&pgHdr), OSAL_NV_PAGE_HDR_SIZE);
+  if ( pgHdr.xfer == OSAL_NV_ERASED_ID )
+  {
+    offset = OSAL_NV_ZEROED_ID;
+    writeWordH( pg, OSAL_NV_PG_XFER, (uint8*)(&offset) );
+  }
+
+  for ( offset = OSAL_NV_PAGE_HDR_SIZE; offset < pgOff[pg - OSAL_NV_PAGE_BEG]; )
+  {
+    osalNvHdr_t hdr;
+
+    HalFlashRead(pg, offset, (uint8 *)(&hdr), OSAL_NV_HDR_SIZE);
+    offset += OSAL_NV_HDR_SIZE;
+
+    if ( (hdr.id != OSAL_NV_ZEROED_ID) && (hdr.stat == OSAL_NV_ERASED_ID) )
+    {
+      setItem( pg, offset, eNvXfer );
+    }
+
+    offset += OSAL_NV_DATA_SIZE( hdr.len );
+  }
+
+  setPageUse( pgRes, TRUE );
+  pgRes = pg;
+  nvComPg = OSAL_NV_PAGE_NULL;
+  nvResDirty = TRUE;
+}
+
+/*********************************************************************
+ * @fn      compactFinish
+ *
+ * @brief   Finish the background compaction in progress, if any, all at once.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+static void compactFinish( void )
+{
+  while ( (nvComPg != OSAL_NV_PAGE_NULL) && compactItem() );
+
+  if ( nvResDirty )
+  {
+    nvResDirty = FALSE;
+    erasePage( pgRes );
+  }
+}
+#endif
+
+/*********************************************************************
+ * @fn      eraseCnt
+ *
+ * @brief   Get the erase count kept in the page header. A page without one (e.g. the last erase
+ *          was interrupted by a reset) is taken to be as worn as the most erased page.
+ *
+ * @param   pg - Valid NV page.
+ *
+ * @return  The number of times the page has been erased.
+ */
+static uint16 eraseCnt( uint8 pg )
+{
+  uint16 cnt, max = 0;
+
+  HalFlashRead(pg, OSAL_NV_PG_SPARE, (uint8 *)(&cnt), sizeof( cnt ));
+
+  if ( cnt == OSAL_NV_ERASED_ID )
+  {
+    for ( pg = OSAL_NV_PAGE_BEG; pg <= OSAL_NV_PAGE_END; pg++ )
+    {
+      HalFlashRead(pg, OSAL_NV_PG_SPARE, (uint8 *)(&cnt), sizeof( cnt ));
+
+      if ( (cnt != OSAL_NV_ERASED_ID) && (cnt > max) )
+      {
+        max = cnt;
+      }
+    }
+
+    cnt = max;
+  }
+
+  return cnt;
+}
+
+#if OSAL_NV_STATS
+/*********************************************************************
+ * @fn      statItem
+ *
+ * @brief   Count a sample of the item writes. Once the table is full, the item with the fewest
+ *          writes is replaced, taking over its count, so that the heavy writers are kept.
+ *
+ * @param   id - Valid NV item Id.
+ *
+ * @return  none
+ */
+static void statItem( uint16 id )
+{
+  uint8 idx, min = 0;
+
+  if ( ++nvStatSample < OSAL_NV_STATS_SAMPLE )
+  {
+    return;
+  }
+  nvStatSample = 0;
+
+  for ( idx = 0; idx < OSAL_NV_STATS_ITEMS; idx++ )
+  {
+    if ( (nvStatItem[idx].id == id) || (nvStatItem[idx].cnt == 0) )
+    {
+      min = idx;
+      break;
+    }
+    else if ( nvStatItem[idx].cnt < nvStatItem[min].cnt )
+    {
+      min = idx;
+    }
+  }
+
+  nvStatItem[min].id = id;
+  if ( nvStatItem[min].cnt < OSAL_NV_ERASED_ID )
+  {
+    nvStatItem[min].cnt++;
+  }
+}
+#endif
+
+#if defined OSAL_NV_CACHE
+/*********************************************************************
+ * @fn      cacheFind
+ *
+ * @brief   Find the write cache entry of an item.
+ *
+ * @param   id - Valid NV item Id.
+ *
+ * @return  Pointer to the entry if the item is cached; NULL otherwise.
+ */
+static osalNvCache_t *cacheFind( uint16 id )
+{
+  uint8 idx;
+
+  for ( idx = 0; idx < OSAL_NV_CACHE_SIZE; idx++ )
+  {
+    if ( (nvCache[idx].buf != NULL) && (nvCache[idx].id == id) )
+    {
+      return nvCache + idx;
+    }
+  }
+
+  return NULL;
+}
+
+/*********************************************************************
+ * @fn      cacheWrite
+ *
+ * @brief   Write to the RAM copy of a cached item and start the flush deadline on its first
+ *          change, unless the write has to go to NV now.
+ *
+ * @param   pCache - Pointer to the entry of the item.
+ * @param   ndx - Index offset into item
+ * @param   len - Length of data to write.
+ * @param  *buf - Data to write.
+ *
+ * @return  Same as osal_nv_write().
+ */
+static uint8 cacheWrite( osalNvCache_t *pCache, uint16 ndx, uint16 len, void *buf )
+{
+  if ( pCache->len < (ndx + len) )
+  {
+    return NV_OPER_FAILED;
+  }
+
+  if ( !osal_memcmp( pCache->buf+ndx, buf, len ) )
+  {
+    (void)osal_memcpy( pCache->buf+ndx, buf, len );
+    pCache->dirty = TRUE;
+
+    if ( !nvCacheDirty && (nvTaskId != TASK_NO_TASK) )
+    {
+      osal_start_timerEx( nvTaskId, OSAL_NV_FLUSH_EVT, OSAL_NV_CACHE_DEADLINE );
+    }
+    nvCacheDirty = TRUE;
+  }
+
+  // Nothing is held back without a task to flush it.
+  if ( nvTaskId == TASK_NO_TASK )
+  {
+    return osal_nv_flush();
+  }
+
+  // Nor once Vdd may not last until the deadline. Below VDD_MIN_NV the flush fails, and the task
+  // tries again after the deadline.
+  if ( !HalAdcCheckVdd( OSAL_NV_CACHE_VDD ) )
+  {
+    (void)osal_nv_flush();
+  }
+
+  return SUCCESS;
+}
+#endif
+
+/*********************************************************************
+ * @fn      txnItem
+ *
+ * @brief   Write the new copy of an item of a transaction: the current data with all of the
+ *          staged writes to the item applied, one Flash-WORD at a time.
+ *
+ * @param   lead - Index of the first staged write to the item.
+ * @param   pg - Valid NV page of the transaction.
+ *
+ * @return  TRUE if the new copy is written and its checksum verified; FALSE otherwise.
+ */
+static uint8 txnItem( uint8 lead, uint8 pg )
+{
+  osalNvTxn_t *pLead = nvTxn + lead;
+  osalNvHdr_t hdr;
+  uint16 cnt, sz;
+  uint16 chk = 0;
+
+  // The current copy may have been moved by the compaction in txnPage().
+  pLead->srcOff = findItem( pLead->id );
+  pLead->srcPg = findPg;
+
+  /* Prevent excessive re-writes to item header caused by numerous, rapid, & successive
+   * OSAL_Nv interruptions caused by resets.
+   */
+  HalFlashRead(pLead->srcPg, (pLead->srcOff - OSAL_NV_HDR_SIZE), (uint8 *)(&hdr), OSAL_NV_HDR_SIZE);
+  if ( hdr.stat == OSAL_NV_ERASED_ID )
+  {
+    setItem( pLead->srcPg, pLead->srcOff, eNvXfer );
+  }
+
+  pLead->dstOff = pgOff[pg - OSAL_NV_PAGE_BEG] + OSAL_NV_HDR_SIZE;
+  if ( !writeItem( pg, pLead->id, pLead->itemLen, NULL, FALSE ) )
+  {
+    return FALSE;
+  }
+
+  // The erased padding of the last Flash-WORD is copied with the old data, as by xferBuf().
+  sz = OSAL_NV_DATA_SIZE( pLead->itemLen );
+
+  for ( cnt = 0; cnt < sz; cnt += OSAL_NV_WORD_SIZE )
+  {
+    uint8 tmp[OSAL_NV_WORD_SIZE];
+    uint8 idx;
+
+    HalFlashRead(pLead->srcPg, pLead->srcOff + cnt, tmp, OSAL_NV_WORD_SIZE);
+
+    // Later stages to the same item overwrite earlier ones.
+    for ( idx = lead; idx < nvTxnCnt; idx++ )
+    {
+      osalNvTxn_t *pTxn = nvTxn + idx;
+
+      if ( pTxn->id == pLead->id )
+      {
+        uint8 pos;
+
+        for ( pos = 0; pos < OSAL_NV_WORD_SIZE; pos++ )
+        {
+          if ( ((cnt + pos) >= pTxn->ndx) && ((cnt + pos) < (pTxn->ndx + pTxn->len)) )
+          {
+            tmp[pos] = pTxn->buf[cnt + pos - pTxn->ndx];
+          }
+        }
+      }
+    }
+
+    for ( idx = 0; idx < OSAL_NV_WORD_SIZE; idx++ )
+    {
+      chk += tmp[idx];
+    }
+
+    writeWord( pg, pLead->dstOff + cnt, tmp );
+  }
+
+  return ( (chk == calcChkF( pg, pLead->dstOff, pLead->itemLen )) &&
+           (chk == setChk( pg, pLead->dstOff, chk )) );
+}
+
+/*********************************************************************
+ * @fn      osal_nv_init
+ *
+ * @brief   Initialize NV service.
+ *
+ * @param   p - Not used.
+ *
+ * @return  none
+ */
+void osal_nv_init( void *p )
+{
+  (void)p;  // Suppress Lint warning.
+#if OSAL_NV_STATS
+  osal_nv_stats_reset();
+#endif
+  (void)initNV();  // Always returns TRUE after pages have been erased.
+}
+
+/*********************************************************************
+ * @fn      osal_nv_item_init
+ *
+ * @brief   If the NV item does not already exist, it is created and
+ *          initialized with the data passed to the function, if any.
+ *          This function must be called before calling osal_nv_read() or
+ *          osal_nv_write().
+ *
+ * @param   id  - Valid NV item Id.
+ * @param   len - Item length.
+ * @param  *buf - Pointer to item initalization data. Set to NULL if none.
+ *
+ * @return  NV_ITEM_UNINIT - Id did not exist and was created successfully.
+ *          SUCCESS        - Id already existed, no action taken.
+ *          NV_OPER_FAILED - Failure to find or create Id.
+ */
+uint8 osal_nv_item_init( uint16 id, uint16 len, void *buf )
+{
+  if ( !OSAL_NV_CHECK_BUS_VOLTAGE )
+  {
+    return NV_OPER_FAILED;
+  }
+  else if (findItem(id) != OSAL_NV_ITEM_NULL)
+  {
+    return SUCCESS;
+  }
+  else if ( initItem( TRUE, id, len, buf ) != OSAL_NV_PAGE_NULL )
+  {
+    OSAL_NV_COMPACT_CHECK();
+    return NV_ITEM_UNINIT;
+  }
+  else
+  {
+    return NV_OPER_FAILED;
+  }
+}
+
+/*********************************************************************
+ * @fn      osal_nv_item_len
+ *
+ * @brief   Get the data length of the item stored in NV memory.
+ *
+ * @param   id  - Valid NV item Id.
+ *
+ * @return  Item length, if found; zero otherwise.
+ */
+uint16 osal_nv_item_len( uint16 id )
+{
+  osalNvHdr_t hdr;
+  uint16 offset;
+
+  if ((offset = findItem(id)) == OSAL_NV_ITEM_NULL)
+  {
+    return 0;
+  }
+
+  HalFlashRead(findPg, (offset - OSAL_NV_HDR_SIZE), (uint8 *)(&hdr), OSAL_NV_HDR_SIZE);
+  return hdr.len;
+}
+
+/*********************************************************************
+ * @fn      writeNV
+ *
+ * @brief   Write a data item to NV, bypassing the write cache. Function can write an entire
+ *          item to NV or an element of an item by indexing into the item with an offset.
+ *
+ * @param   id  - Valid NV item Id.
+ * @param   ndx - Index offset into item
+ * @param   len - Length of data to write.
+ * @param  *buf - Data to write.
+ *
+ * @return  SUCCESS if successful, NV_ITEM_UNINIT if item did not
+ *          exist in NV and offset is non-zero, NV_OPER_FAILED if failure.
+ */
+static uint8 writeNV( uint16 id, uint16 ndx, uint16 len, void *buf )
+{
+  uint8 rtrn = SUCCESS;
+
+  if ( !OSAL_NV_CHECK_BUS_VOLTAGE )
+  {
+    return NV_OPER_FAILED;
+  }
+  else if ( len != 0 )
+  {
+    osalNvHdr_t hdr;
+    uint16 origOff, srcOff;
+    uint16 cnt, chk;
+    uint8 *ptr, srcPg;
+
+    origOff = srcOff = findItem( id );
+    srcPg = findPg;
+    if ( srcOff == OSAL_NV_ITEM_NULL )
+    {
+      return NV_ITEM_UNINIT;
+    }
+
+    HalFlashRead(srcPg, (srcOff - OSAL_NV_HDR_SIZE), (uint8 *)(&hdr), OSAL_NV_HDR_SIZE);
+    if ( hdr.len < (ndx + len) )
+    {
+      return NV_OPER_FAILED;
+    }
+
+#if defined OSAL_NV_COMPACT_TASK
+    /* If no page has room, initItem() must finish the background compaction, which can move
+     * the item, so finish it before the item is used as the source of the write.
+     */
+    if ( OSAL_NV_RES_BUSY() && (freePage( OSAL_NV_ITEM_SIZE( hdr.len ) ) == OSAL_NV_PAGE_NULL) )
+    {
+      compactFinish();
+      origOff = srcOff = findItem( id );
+      srcPg = findPg;
+      HalFlashRead(srcPg, (srcOff - OSAL_NV_HDR_SIZE), (uint8 *)(&hdr), OSAL_NV_HDR_SIZE);
+    }
+#endif
+
+    srcOff += ndx;
     ptr = buf;
     cnt = len;
     chk = 0;
     while ( cnt-- )
     {
-      uint8 tmp;
-      HalFlashRead(srcPg, srcOff, &tmp, 1);
-      if ( tmp != *ptr )
+      uint8 tmp;
+      HalFlashRead(srcPg, srcOff, &tmp, 1);
+      if ( tmp != *ptr )
+      {
+        chk = 1;  // Mark that at least one byte is different.
+        // Calculate expected checksum after transferring old data and writing new data.
+        hdr.chk -= tmp;
+        hdr.chk += *ptr;
+      }
+      srcOff++;
+      ptr++;
+    }
+
+    if ( chk != 0 )  // If the buffer to write is different in one or more bytes.
+    {
+      uint8 comPg = OSAL_NV_PAGE_NULL;
+      uint8 dstPg = initItem( FALSE, id, hdr.len, &comPg );
+
+      if ( dstPg != OSAL_NV_PAGE_NULL )
+      {
+        uint16 tmp = OSAL_NV_DATA_SIZE( hdr.len );
+        uint16 dstOff = pgOff[dstPg-OSAL_NV_PAGE_BEG] - tmp;
+        srcOff = origOff;
+
+        /* Prevent excessive re-writes to item header caused by numerous, rapid, & successive
+         * OSAL_Nv interruptions caused by resets.
+         */
+        if ( hdr.stat == OSAL_NV_ERASED_ID )
+        {
+          setItem( srcPg, srcOff, eNvXfer );
+        }
+
+        xferBuf( srcPg, srcOff, dstPg, dstOff, ndx );
+        srcOff += ndx;
+        dstOff += ndx;
+
+        writeBuf( dstPg, dstOff, len, buf );
+        srcOff += len;
+        dstOff += len;
+
+        xferBuf( srcPg, srcOff, dstPg, dstOff, (hdr.len-ndx-len) );
+
+        // Calculate and write the new checksum.
+        dstOff = pgOff[dstPg-OSAL_NV_PAGE_BEG] - tmp;
+
+        if ( hdr.chk == calcChkF( dstPg, dstOff, hdr.len ) )
+        {
+          if ( hdr.chk != setChk( dstPg, dstOff, hdr.chk ) )
+          {
+            rtrn = NV_OPER_FAILED;
+          }
+          else
+          {
+            idxUpdate(dstPg, dstOff, hdr.id);
+            OSAL_NV_STATS_ITEM( hdr.id );
+          }
+        }
+        else
+        {
+          rtrn = NV_OPER_FAILED;
+        }
+      }
+      else
+      {
+        rtrn = NV_OPER_FAILED;
+      }
+
+      if ( comPg != OSAL_NV_PAGE_NULL )
+      {
+        /* Even though the page compaction succeeded, if the new item is coming from the compacted
+         * page and writing the new value failed, then the compaction must be aborted.
+         */
+        if ( (srcPg == comPg) && (rtrn == NV_OPER_FAILED) )
+        {
+          erasePage( pgRes );
+        }
+        else
+        {
+          COMPACT_PAGE_CLEANUP( comPg );
+        }
+      }
+
+      /* Zero of the old item must wait until after compact page cleanup has finished - if the item
+       * is zeroed before and cleanup is interrupted by a power-cycle, the new item can be lost.
+       */
+      if ( (srcPg != comPg) && (rtrn != NV_OPER_FAILED) )
+      {
+        setItem( srcPg, origOff, eNvZero );
+      }
+
+      OSAL_NV_COMPACT_CHECK();
+    }
+  }
+
+  return rtrn;
+}
+
+/*********************************************************************
+ * @fn      osal_nv_write
+ *
+ * @brief   Write a data item to NV. Function can write an entire item to NV or
+ *          an element of an item by indexing into the item with an offset.
+ *
+ * @param   id  - Valid NV item Id.
+ * @param   ndx - Index offset into item
+ * @param   len - Length of data to write.
+ * @param  *buf - Data to write.
+ *
+ * @return  SUCCESS if successful, NV_ITEM_UNINIT if item did not
+ *          exist in NV and offset is non-zero, NV_OPER_FAILED if failure.
+ */
+uint8 osal_nv_write( uint16 id, uint16 ndx, uint16 len, void *buf )
+{
+#if defined OSAL_NV_CACHE
+  osalNvCache_t *pCache = cacheFind( id );
+
+  if ( pCache != NULL )
+  {
+    return cacheWrite( pCache, ndx, len, buf );
+  }
+#endif
+
+  return writeNV( id, ndx, len, buf );
+}
+
+/*********************************************************************
+ * @fn      osal_nv_read
+ *
+ * @brief   Read data from NV. This function can be used to read an entire item from NV or
+ *          an element of an item by indexing into the item with an offset.
+ *          Read data is copied into *buf.
+ *
+ * @param   id  - Valid NV item Id.
+ * @param   ndx - Index offset into item
+ * @param   len - Length of data to read.
+ * @param  *buf - Data is read into this buffer.
+ *
+ * @return  SUCCESS if NV data was copied to the parameter 'buf'.
+ *          Otherwise, NV_OPER_FAILED for failure.
+ */
+uint8 osal_nv_read( uint16 id, uint16 ndx, uint16 len, void *buf )
+{
+  uint16 offset;
+#if defined OSAL_NV_CACHE
+  osalNvCache_t *pCache = cacheFind( id );
+
+  if ( pCache != NULL )
+  {
+    if ( pCache->len < (ndx + len) )
+    {
+      return NV_OPER_FAILED;
+    }
+
+    (void)osal_memcpy( buf, pCache->buf+ndx, len );
+    return SUCCESS;
+  }
+#endif
+
+  if ((offset = findItem(id)) == OSAL_NV_ITEM_NULL)
+  {
+    return NV_OPER_FAILED;
+  }
+  else
+  {
+    HalFlashRead(findPg, offset+ndx, buf, len);
+    return SUCCESS;
+  }
+}
+
+/*********************************************************************
+ * @fn      osal_nv_delete
+ *
+ * @brief   Delete item from NV. This function will fail if the length
+ *          parameter does not match the length of the item in NV.
+ *
+ * @param   id  - Valid NV item Id.
+ * @param   len - Length of item to delete.
+ *
+ * @return  SUCCESS if item was deleted,
+ *          NV_ITEM_UNINIT if item did not exist in NV,
+ *          NV_BAD_ITEM_LEN if length parameter not correct,
+ *          NV_OPER_FAILED if attempted deletion failed.
+ */
+uint8 osal_nv_delete( uint16 id, uint16 len )
+{
+  uint16 length;
+  uint16 offset;
+
+  offset = findItem( id );
+  if ( offset == OSAL_NV_ITEM_NULL )
+  {
+    // NV item does not exist
+    return NV_ITEM_UNINIT;
+  }
+
+  length = osal_nv_item_len( id );
+  if ( length != len )
+  {
+    // NV item has different length
+    return NV_BAD_ITEM_LEN;
+  }
+
+#if defined OSAL_NV_CACHE
+  {
+    // Any changes not yet written are deleted along with the item.
+    osalNvCache_t *pCache = cacheFind( id );
+
+    if ( pCache != NULL )
+    {
+      osal_mem_free( pCache->buf );
+      pCache->buf = NULL;
+    }
+  }
+#endif
+
+  // Set item header ID to zero to 'delete' the item
+  setItem( findPg, offset, eNvZero );
+  OSAL_NV_COMPACT_CHECK();
+
+  // Verify that item has been removed
+  offset = findItem( id );
+  if ( offset != OSAL_NV_ITEM_NULL )
+  {
+    // Still there
+    return NV_OPER_FAILED;
+  }
+  else
+  {
+    // Yes, it's gone
+    return SUCCESS;
+  }
+}
+
+/*********************************************************************
+ * @fn      osal_nv_txn_begin
+ *
+ * @brief   Start a transaction of NV writes, discarding any writes staged but not committed.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void osal_nv_txn_begin( void )
+{
+  nvTxnCnt = 0;
+  nvTxnOpen = TRUE;
+}
+
+/*********************************************************************
+ * @fn      osal_nv_txn_stage
+ *
+ * @brief   Add a write to the transaction started by osal_nv_txn_begin(). Nothing is written
+ *          to NV until osal_nv_txn_commit(), so the data must stay valid until then.
+ *          The same item may be staged more than once; later writes overlay earlier ones.
+ *
+ * @param   id  - Valid NV item Id.
+ * @param   ndx - Index offset into item
+ * @param   len - Length of data to write.
+ * @param  *buf - Data to write.
+ *
+ * @return  SUCCESS if the write is staged, NV_OPER_FAILED if no transaction is open or
+ *          OSAL_NV_TXN_MAX writes are already staged.
+ */
+uint8 osal_nv_txn_stage( uint16 id, uint16 ndx, uint16 len, void *buf )
+{
+  osalNvTxn_t *pTxn;
+
+  if ( !nvTxnOpen || (nvTxnCnt >= OSAL_NV_TXN_MAX) )
+  {
+    return NV_OPER_FAILED;
+  }
+  else if ( len == 0 )
+  {
+    return SUCCESS;
+  }
+
+  pTxn = nvTxn + nvTxnCnt++;
+  pTxn->buf = buf;
+  pTxn->id = id;
+  pTxn->ndx = ndx;
+  pTxn->len = len;
+
+  return SUCCESS;
+}
+
+/*********************************************************************
+ * @fn      osal_nv_txn_commit
+ *
+ * @brief   Write all of the items staged since osal_nv_txn_begin() so that, even across a reset,
+ *          either all of them or none of them are updated. The new copies of the items that
+ *          change are appended to one page after a transaction record, compacting at most one
+ *          page beforehand, and are committed together by the write of the record checksum.
+ *          The transaction is closed whatever the result.
+ *
+ * @param   none
+ *
+ * @return  SUCCESS if all items were written (or none of them change),
+ *          NV_ITEM_UNINIT if an item does not exist in NV,
+ *          NV_OPER_FAILED if a write is beyond the item length, if the items do not fit
+ *          together in one page or on failure; no item is updated in any of these cases.
+ */
+uint8 osal_nv_txn_commit( void )
+{
+  uint16 sz = OSAL_NV_ITEM_SIZE( 0 );  // The transaction record.
+  uint16 txnOff;
+  uint8 idx, pg;
+  uint8 rtrn = SUCCESS;
+
+  if ( !nvTxnOpen )
+  {
+    return NV_OPER_FAILED;
+  }
+
+  nvTxnOpen = FALSE;
+
+  if ( !OSAL_NV_CHECK_BUS_VOLTAGE )
+  {
+    return NV_OPER_FAILED;
+  }
+
+#if defined OSAL_NV_CACHE
+  // The staged writes are applied to the copies in NV, so these must be up to date.
+  if ( osal_nv_flush() != SUCCESS )
+  {
+    return NV_OPER_FAILED;
+  }
+#endif
+
+  // Verify all of the staged writes and find the items that actually change.
+  for ( idx = 0; idx < nvTxnCnt; idx++ )
+  {
+    osalNvTxn_t *pTxn = nvTxn + idx;
+    osalNvTxn_t *pLead = nvTxn + txnLead( idx );
+    uint16 cnt, off;
+    uint8 *ptr;
+
+    if ( pLead == pTxn )
+    {
+      osalNvHdr_t hdr;
+
+      if ( (pTxn->srcOff = findItem( pTxn->id )) == OSAL_NV_ITEM_NULL )
       {
-        chk = 1;  // Mark that at least one byte is different.
-        // Calculate expected checksum after transferring old data and writing new data.
-        hdr.chk -= tmp;
-        hdr.chk += *ptr;
+        return NV_ITEM_UNINIT;
       }
-      srcOff++;
-      ptr++;
+
+      pTxn->srcPg = findPg;
+      pTxn->dstOff = OSAL_NV_ITEM_NULL;
+
+      HalFlashRead(pTxn->srcPg, (pTxn->srcOff - OSAL_NV_HDR_SIZE), (uint8 *)(&hdr), OSAL_NV_HDR_SIZE);
+      pTxn->itemLen = hdr.len;
+    }
+    else
+    {
+      pTxn->dstOff = OSAL_NV_ITEM_NULL;
+    }
+
+    if ( pLead->itemLen < (pTxn->ndx + pTxn->len) )
+    {
+      return NV_OPER_FAILED;
+    }
+
+    if ( pLead->dstOff == OSAL_NV_ITEM_NULL )
+    {
+      off = pLead->srcOff + pTxn->ndx;
+      ptr = pTxn->buf;
+
+      for ( cnt = pTxn->len; cnt != 0; cnt-- )
+      {
+        uint8 tmp;
+
+        HalFlashRead(pLead->srcPg, off++, &tmp, 1);
+        if ( tmp != *ptr++ )
+        {
+          pLead->dstOff = OSAL_NV_ERASED_ID;  // Mark that the item has to be re-written.
+          sz += OSAL_NV_ITEM_SIZE( pLead->itemLen );
+          break;
+        }
+      }
+    }
+  }
+
+  if ( sz == OSAL_NV_ITEM_SIZE( 0 ) )
+  {
+    return SUCCESS;
+  }
+  else if ( (sz > (OSAL_NV_PAGE_SIZE - OSAL_NV_PAGE_HDR_SIZE)) ||
+            ((pg = txnPage( sz )) == OSAL_NV_PAGE_NULL) )
+  {
+    return NV_OPER_FAILED;
+  }
+
+  /* Everything following an uncommitted transaction record on its page is zeroed by initTxn() on
+   * a reset, so the record is written first.
+   */
+  txnOff = pgOff[pg - OSAL_NV_PAGE_BEG] + OSAL_NV_HDR_SIZE;
+  if ( !writeItem( pg, OSAL_NV_TXN_ID, 0, NULL, FALSE ) )
+  {
+    setItem( pg, txnOff, eNvZero );
+    return NV_OPER_FAILED;
+  }
+
+  for ( idx = 0; idx < nvTxnCnt; idx++ )
+  {
+    if ( (nvTxn[idx].dstOff != OSAL_NV_ITEM_NULL) && !txnItem( idx, pg ) )
+    {
+      rtrn = NV_OPER_FAILED;
+      break;
     }
+  }
+
+  // The checksum of the zero-length record is zero: writing it commits all of the items.
+  if ( (rtrn == SUCCESS) && (setChk( pg, txnOff, OSAL_NV_ZEROED_ID ) != OSAL_NV_ZEROED_ID) )
+  {
+    rtrn = NV_OPER_FAILED;
+  }
+
+  for ( idx = 0; idx < nvTxnCnt; idx++ )
+  {
+    osalNvTxn_t *pTxn = nvTxn + idx;
 
-    if ( chk != 0 )  // If the buffer to write is different in one or more bytes.
+    if ( (pTxn->dstOff == OSAL_NV_ITEM_NULL) || (pTxn->dstOff == OSAL_NV_ERASED_ID) )
     {
-      uint8 comPg = OSAL_NV_PAGE_NULL;
-      uint8 dstPg = initItem( FALSE, id, hdr.len, &comPg );
+      continue;  // Unchanged, not the first write to the item, or not reached before a failure.
+    }
 
-      if ( dstPg != OSAL_NV_PAGE_NULL )
+    if ( rtrn == SUCCESS )
+    {
+      idxUpdate( pg, pTxn->dstOff, pTxn->id );
+      setItem( pTxn->srcPg, pTxn->srcOff, eNvZero );
+      OSAL_NV_STATS_ITEM( pTxn->id );
+#if defined OSAL_NV_CACHE
       {
-        uint16 tmp = OSAL_NV_DATA_SIZE( hdr.len );
-        uint16 dstOff = pgOff[dstPg-OSAL_NV_PAGE_BEG] - tmp;
-        srcOff = origOff;
+        osalNvCache_t *pCache = cacheFind( pTxn->id );
 
-        /* Prevent excessive re-writes to item header caused by numerous, rapid, & successive
-         * OSAL_Nv interruptions caused by resets.
-         */
-        if ( hdr.stat == OSAL_NV_ERASED_ID )
+        if ( pCache != NULL )
         {
-          setItem( srcPg, srcOff, eNvXfer );
+          HalFlashRead(pg, pTxn->dstOff, pCache->buf, pCache->len);
         }
+      }
+#endif
+    }
+    else
+    {
+      setItem( pg, pTxn->dstOff, eNvZero );
+    }
+  }
 
-        xferBuf( srcPg, srcOff, dstPg, dstOff, ndx );
-        srcOff += ndx;
-        dstOff += ndx;
+  setItem( pg, txnOff, eNvZero );
+  OSAL_NV_COMPACT_CHECK();
 
-        writeBuf( dstPg, dstOff, len, buf );
-        srcOff += len;
-        dstOff += len;
+  return rtrn;
+}
 
-        xferBuf( srcPg, srcOff, dstPg, dstOff, (hdr.len-ndx-len) );
+#if defined OSAL_NV_TASK
+/*********************************************************************
+ * @fn      osal_nv_task_init
+ *
+ * @brief   Initialize the NV task, which compacts NV pages in the background and flushes the
+ *          NV write cache.
+ *
+ * @param   task_id - The OSAL task Id assigned to the task.
+ *
+ * @return  none
+ */
+void osal_nv_task_init( uint8 task_id )
+{
+  nvTaskId = task_id;
+  OSAL_NV_COMPACT_CHECK();
+}
 
-        // Calculate and write the new checksum.
-        dstOff = pgOff[dstPg-OSAL_NV_PAGE_BEG] - tmp;
+/*********************************************************************
+ * @fn      osal_nv_event_loop
+ *
+ * @brief   NV task event processor. Each background compaction event erases a page or moves
+ *          up to OSAL_NV_COMPACT_ITEMS items and re-posts itself until the page is done.
+ *
+ * @param   task_id - The OSAL task Id.
+ * @param   events - The events bit map.
+ *
+ * @return  Unprocessed events.
+ */
+uint16 osal_nv_event_loop( uint8 task_id, uint16 events )
+{
+#if defined OSAL_NV_CACHE
+  if ( events & OSAL_NV_FLUSH_EVT )
+  {
+    if ( osal_nv_flush() != SUCCESS )
+    {
+      // Try again after another deadline, e.g. once Vdd has recovered.
+      osal_start_timerEx( task_id, OSAL_NV_FLUSH_EVT, OSAL_NV_CACHE_DEADLINE );
+    }
 
-        if ( hdr.chk == calcChkF( dstPg, dstOff, hdr.len ) )
-        {
-          if ( hdr.chk != setChk( dstPg, dstOff, hdr.chk ) )
-          {
-            rtrn = NV_OPER_FAILED;
-          }
-          else
-          {
-            hotItemUpdate(dstPg, dstOff, hdr.id);
-          }
-        }
-        else
-        {
-          rtrn = NV_OPER_FAILED;
-        }
-      }
-      else
-      {
-        rtrn = NV_OPER_FAILED;
-      }
+    return ( events ^ OSAL_NV_FLUSH_EVT );
+  }
+#endif
 
-      if ( comPg != OSAL_NV_PAGE_NULL )
-      {
-        /* Even though the page compaction succeeded, if the new item is coming from the compacted
-         * page and writing the new value failed, then the compaction must be aborted.
-         */
-        if ( (srcPg == comPg) && (rtrn == NV_OPER_FAILED) )
-        {
-          erasePage( pgRes );
-        }
-        else
-        {
-          COMPACT_PAGE_CLEANUP( comPg );
-        }
-      }
+#if defined OSAL_NV_COMPACT_TASK
+  if ( events & OSAL_NV_COMPACT_EVT )
+  {
+    uint8 more;
 
-      /* Zero of the old item must wait until after compact page cleanup has finished - if the item
-       * is zeroed before and cleanup is interrupted by a power-cycle, the new item can be lost.
-       */
-      if ( (srcPg != comPg) && (rtrn != NV_OPER_FAILED) )
-      {
-        setItem( srcPg, origOff, eNvZero );
-      }
+    if ( !OSAL_NV_CHECK_BUS_VOLTAGE )
+    {
+      more = FALSE;  // Resume after the next write.
+    }
+    else if ( nvResDirty )
+    {
+      nvResDirty = FALSE;
+      erasePage( pgRes );
+      more = (compactNeeded() != OSAL_NV_PAGE_NULL);
+    }
+    else if ( nvComPg != OSAL_NV_PAGE_NULL )
+    {
+      uint8 cnt = OSAL_NV_COMPACT_ITEMS;
+
+      while ( (more = compactItem()) && --cnt );
+      more |= nvResDirty;
+    }
+    else
+    {
+      more = compactStart();
+    }
+
+    if ( more )
+    {
+      osal_set_event( task_id, OSAL_NV_COMPACT_EVT );
     }
+
+    return ( events ^ OSAL_NV_COMPACT_EVT );
   }
+#endif
 
-  return rtrn;
+  return 0;
 }
+#endif
 
+#if defined OSAL_NV_CACHE
 /*********************************************************************
- * @fn      osal_nv_read
+ * @fn      osal_nv_cache_add
  *
- * @brief   Read data from NV. This function can be used to read an entire item from NV or
- *          an element of an item by indexing into the item with an offset.
- *          Read data is copied into *buf.
+ * @brief   Keep an NV item in the write cache from now on. Writes to the item only update its
+ *          RAM copy, which is written to NV at most OSAL_NV_CACHE_DEADLINE ms after a change.
+ *          Without the NV task registered, writes to the item still go straight to NV.
  *
  * @param   id  - Valid NV item Id.
- * @param   ndx - Index offset into item
- * @param   len - Length of data to read.
- * @param  *buf - Data is read into this buffer.
  *
- * @return  SUCCESS if NV data was copied to the parameter 'buf'.
- *          Otherwise, NV_OPER_FAILED for failure.
+ * @return  SUCCESS if the item is cached, NV_ITEM_UNINIT if it does not exist in NV,
+ *          NV_OPER_FAILED if it is longer than OSAL_NV_CACHE_ITEM_MAX, the cache is full or
+ *          out of memory.
  */
-uint8 osal_nv_read( uint16 id, uint16 ndx, uint16 len, void *buf )
+uint8 osal_nv_cache_add( uint16 id )
 {
-  uint16 offset;
-  uint8 hotIdx;
+  osalNvCache_t *pCache = NULL;
+  uint16 len, offset;
+  uint8 idx;
 
-  if ((hotIdx = hotItem(id)) < OSAL_NV_MAX_HOT)
+  if ( cacheFind( id ) != NULL )
   {
-    HalFlashRead(hotPg[hotIdx], hotOff[hotIdx]+ndx, buf, len);
     return SUCCESS;
   }
 
-  if ((offset = findItem(id)) == OSAL_NV_ITEM_NULL)
+  len = osal_nv_item_len( id );
+  if ( (offset = findItem( id )) == OSAL_NV_ITEM_NULL )
+  {
+    return NV_ITEM_UNINIT;
+  }
+
+  if ( len > OSAL_NV_CACHE_ITEM_MAX )
   {
     return NV_OPER_FAILED;
   }
-  else
+
+  for ( idx = 0; idx < OSAL_NV_CACHE_SIZE; idx++ )
+  {
+    if ( nvCache[idx].buf == NULL )
+    {
+      pCache = nvCache + idx;
+      break;
+    }
+  }
+
+  if ( (pCache == NULL) || ((pCache->buf = osal_mem_alloc( len )) == NULL) )
+  {
+    return NV_OPER_FAILED;
+  }
+
+  HalFlashRead(findPg, offset, pCache->buf, len);
+  pCache->id = id;
+  pCache->len = len;
+  pCache->dirty = FALSE;
+
+  return SUCCESS;
+}
+
+/*********************************************************************
+ * @fn      osal_nv_flush
+ *
+ * @brief   Write the changes to all of the cached items to NV now.
+ *
+ * @param   none
+ *
+ * @return  SUCCESS if all of the changes are in NV, NV_OPER_FAILED otherwise.
+ */
+uint8 osal_nv_flush( void )
+{
+  uint8 rtrn = SUCCESS;
+  uint8 idx;
+
+  if ( !nvCacheDirty )
   {
-    HalFlashRead(findPg, offset+ndx, buf, len);
     return SUCCESS;
   }
+
+  // Write all of the changes or none of them.
+  if ( !OSAL_NV_CHECK_BUS_VOLTAGE )
+  {
+    return NV_OPER_FAILED;
+  }
+
+  for ( idx = 0; idx < OSAL_NV_CACHE_SIZE; idx++ )
+  {
+    osalNvCache_t *pCache = nvCache + idx;
+
+    if ( (pCache->buf != NULL) && pCache->dirty )
+    {
+      if ( writeNV( pCache->id, 0, pCache->len, pCache->buf ) == SUCCESS )
+      {
+        pCache->dirty = FALSE;
+      }
+      else
+      {
+        rtrn = NV_OPER_FAILED;
+      }
+    }
+  }
+
+  if ( rtrn == SUCCESS )
+  {
+    nvCacheDirty = FALSE;
+    (void)osal_stop_timerEx( nvTaskId, OSAL_NV_FLUSH_EVT );
+  }
+
+  return rtrn;
 }
+#endif
 
+#if OSAL_NV_STATS
 /*********************************************************************
- * @fn      osal_nv_delete
+ * @fn      osal_nv_stats_get
  *
- * @brief   Delete item from NV. This function will fail if the length
- *          parameter does not match the length of the item in NV.
+ * @brief   Get the NV write statistics since osal_nv_init() or osal_nv_stats_reset(), and the
+ *          lifetime they project for the NV pages.
  *
- * @param   id  - Valid NV item Id.
- * @param   len - Length of item to delete.
+ * @param   pStats - Pointer to the statistics to fill in.
  *
- * @return  SUCCESS if item was deleted,
- *          NV_ITEM_UNINIT if item did not exist in NV,
- *          NV_BAD_ITEM_LEN if length parameter not correct,
- *          NV_OPER_FAILED if attempted deletion failed.
+ * @return  none
  */
-uint8 osal_nv_delete( uint16 id, uint16 len )
+void osal_nv_stats_get( osalNvStats_t *pStats )
 {
-  uint16 length;
-  uint16 offset;
+  uint32 secs = (osal_GetSystemClock() - nvStatStart) / 1000;
+  uint16 max = 0;
+  uint8 pg;
 
-  offset = findItem( id );
-  if ( offset == OSAL_NV_ITEM_NULL )
+  for ( pg = OSAL_NV_PAGE_BEG; pg <= OSAL_NV_PAGE_END; pg++ )
   {
-    // NV item does not exist
-    return NV_ITEM_UNINIT;
+    uint16 cnt = eraseCnt( pg );
+
+    if ( cnt > max )
+    {
+      max = cnt;
+    }
   }
 
-  length = osal_nv_item_len( id );
-  if ( length != len )
+  pStats->bytes = nvStatBytes;
+  pStats->erases = nvStatErases;
+  pStats->eraseMax = max;
+  pStats->bytesPerHour = 0;
+  pStats->lifeHours = OSAL_NV_LIFE_UNKNOWN;
+
+  if ( secs != 0 )
   {
-    // NV item has different length
-    return NV_BAD_ITEM_LEN;
+    if ( nvStatBytes < (0xFFFFFFFFUL / 3600) )
+    {
+      pStats->bytesPerHour = nvStatBytes * 3600 / secs;
+    }
+    else
+    {
+      pStats->bytesPerHour = nvStatBytes / secs * 3600;
+    }
+
+    /* Hours until the most erased page reaches OSAL_NV_PAGE_ENDURANCE if the pages keep being
+     * erased in turn, as the reserve page moves on, at the rate seen so far.
+     */
+    if ( nvStatErases != 0 )
+    {
+      uint32 cycles = 0;
+
+      if ( max < OSAL_NV_PAGE_ENDURANCE )
+      {
+        cycles = (uint32)(OSAL_NV_PAGE_ENDURANCE - max) * OSAL_NV_PAGES_USED;
+      }
+
+      secs /= nvStatErases;
+      if ( secs < 3600 )
+      {
+        pStats->lifeHours = cycles * secs / 3600;
+      }
+      else
+      {
+        pStats->lifeHours = cycles * (secs / 3600);
+      }
+    }
   }
+}
 
-  // Set item header ID to zero to 'delete' the item
-  setItem( findPg, offset, eNvZero );
+/*********************************************************************
+ * @fn      osal_nv_page_stats_get
+ *
+ * @brief   Get the erase count and space usage of an NV page.
+ *
+ * @param   idx - Index of the NV page, from zero.
+ * @param   pStats - Pointer to the statistics to fill in.
+ *
+ * @return  SUCCESS if the page exists, NV_OPER_FAILED otherwise.
+ */
+uint8 osal_nv_page_stats_get( uint8 idx, osalNvPageStats_t *pStats )
+{
+  if ( idx >= OSAL_NV_PAGES_USED )
+  {
+    return NV_OPER_FAILED;
+  }
 
-  // Verify that item has been removed
-  offset = findItem( id );
-  if ( offset != OSAL_NV_ITEM_NULL )
+  pStats->erases = eraseCnt( idx + OSAL_NV_PAGE_BEG );
+  pStats->free = OSAL_NV_PAGE_SIZE - pgOff[idx];
+  pStats->lost = pgLost[idx];
+
+  return SUCCESS;
+}
+
+/*********************************************************************
+ * @fn      osal_nv_item_stats_get
+ *
+ * @brief   Get one of the items written the most, as estimated from the sampled writes. An item
+ *          that took over the table entry of another one also took over its count, so the
+ *          estimate is an upper bound.
+ *
+ * @param   idx - Index into the items counted, from zero.
+ * @param   pId - Pointer to the item Id to fill in.
+ * @param   pWrites - Pointer to the estimated number of writes to fill in.
+ *
+ * @return  SUCCESS if an item is counted at 'idx', NV_OPER_FAILED otherwise.
+ */
+uint8 osal_nv_item_stats_get( uint8 idx, uint16 *pId, uint32 *pWrites )
+{
+  if ( (idx >= OSAL_NV_STATS_ITEMS) || (nvStatItem[idx].cnt == 0) )
   {
-    // Still there
     return NV_OPER_FAILED;
   }
-  else
+
+  *pId = nvStatItem[idx].id;
+  *pWrites = (uint32)nvStatItem[idx].cnt * OSAL_NV_STATS_SAMPLE;
+
+  return SUCCESS;
+}
+
+/*********************************************************************
+ * @fn      osal_nv_stats_reset
+ *
+ * @brief   Clear the NV write statistics. The page erase counts are kept.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void osal_nv_stats_reset( void )
+{
+  uint8 idx;
+
+  nvStatStart = osal_GetSystemClock();
+  nvStatBytes = 0;
+  nvStatErases = 0;
+  nvStatSample = 0;
+
+  for ( idx = 0; idx < OSAL_NV_STATS_ITEMS; idx++ )
   {
-    // Yes, it's gone
-    return SUCCESS;
+    nvStatItem[idx].id = OSAL_NV_ITEM_NULL;
+    nvStatItem[idx].cnt = 0;
   }
 }
+#endif
 
 /*********************************************************************
  */
@@ -100,7 +100,7 @@ epList_t *epList;
 
 static void afBuildMSGIncoming( aps_FrameFormat_t *aff, endPointDesc_t *epDesc,
                 zAddrType_t *SrcAddress, uint16 SrcPanId, NLDE_Signal_t *sig,
-                uint8 nwkSeqNum, uint8 SecurityUse, uint32 timestamp );
+                uint8 nwkSeqNum, uint8 SecurityUse, uint32 timestamp, uint8 **ppShare );
 
 static epList_t *afFindEndPointDescList( uint8 EndPoint );
 
@@ -262,6 +262,9 @@ void afDataConfirm( uint8 endPoint, uint8 transID, ZStatus_t status )
     msgPtr->endpoint = endPoint;
     msgPtr->transID = transID;
 
+    // The sender is waiting on the confirm, don't queue it behind traffic
+    OSAL_MSG_PRIO( (uint8 *)msgPtr ) = OSAL_MSG_PRIO_URGENT;
+
 #if defined ( MT_AF_CB_FUNC )
     /* If MT has subscribed for this callback, don't send as a message. */
     if ( AFCB_CHECK(CB_ID_AF_DATA_CNF,*(epDesc->task_id)) )
@@ -354,6 +357,7 @@ void afIncomingData( aps_FrameFormat_t *aff, zAddrType_t *SrcAddress, uint16 Src
 {
   endPointDesc_t *epDesc = NULL;
   epList_t *pList = epList;
+  uint8 *pShare = NULL;  // Message holding the data, for the other endpoints
 #if !defined ( APS_NO_GROUPS )
   uint8 grpEp = APS_GROUPS_EP_NOT_FOUND;
 #endif
@@ -422,7 +426,7 @@ void afIncomingData( aps_FrameFormat_t *aff, zAddrType_t *SrcAddress, uint16 Src
       aff->DstEndPoint = epDesc->endPoint;
 
       afBuildMSGIncoming( aff, epDesc, SrcAddress, SrcPanId, sig,
-                         nwkSeqNum, SecurityUse, timestamp );
+                         nwkSeqNum, SecurityUse, timestamp, &pShare );
 
       // Restore with original endpoint
       aff->DstEndPoint = endpoint;
@@ -434,15 +438,15 @@ void afIncomingData( aps_FrameFormat_t *aff, zAddrType_t *SrcAddress, uint16 Src
       // Find the next endpoint for this group
       grpEp = aps_FindGroupForEndpoint( aff->GroupID, grpEp );
       if ( grpEp == APS_GROUPS_EP_NOT_FOUND )
-        return;   // No endpoint found
+        break;    // No endpoint found
 
       epDesc = afFindEndPointDesc( grpEp );
       if ( epDesc == NULL )
-        return;   // Endpoint descriptor not found
+        break;    // Endpoint descriptor not found
 
       pList = afFindEndPointDescList( epDesc->endPoint );
 #else
-      return;
+      break;
 #endif
     }
     else if ( aff->DstEndPoint == AF_BROADCAST_ENDPOINT )
@@ -456,24 +460,40 @@ void afIncomingData( aps_FrameFormat_t *aff, zAddrType_t *SrcAddress, uint16 Src
     else
       epDesc = NULL;
   }
+
+  // Give back the reference kept while delivering
+  if ( pShare != NULL )
+  {
+    osal_msg_deallocate( pShare );
+  }
 }
 
 /*********************************************************************
  * @fn          afBuildMSGIncoming
  *
- * @brief       Build the message for the app
+ * @brief       Build the message for the app. The data is copied into
+ *              the first message only, the messages for the other
+ *              endpoints point to it and hold a reference to it.
  *
- * @param
+ * @param       ppShare - message holding the data, NULL before the
+ *                        first message; keeps a reference the caller
+ *                        gives back
  *
- * @return      pointer to next in data buffer
+ * @return      none
  */
 static void afBuildMSGIncoming( aps_FrameFormat_t *aff, endPointDesc_t *epDesc,
                  zAddrType_t *SrcAddress, uint16 SrcPanId, NLDE_Signal_t *sig,
-                 uint8 nwkSeqNum, uint8 SecurityUse, uint32 timestamp )
+                 uint8 nwkSeqNum, uint8 SecurityUse, uint32 timestamp, uint8 **ppShare )
 {
   afIncomingMSGPacket_t *MSGpkt;
-  const uint8 len = sizeof( afIncomingMSGPacket_t ) + aff->asduLength;
+  uint8 len = sizeof( afIncomingMSGPacket_t );
   uint8 *asdu = aff->asdu;
+
+  if ( *ppShare == NULL )
+  {
+    len += aff->asduLength;
+  }
+
   MSGpkt = (afIncomingMSGPacket_t *)osal_msg_allocate( len );
 
   if ( MSGpkt == NULL )
@@ -500,15 +520,35 @@ static void afBuildMSGIncoming( aps_FrameFormat_t *aff, endPointDesc_t *epDesc,
   MSGpkt->cmd.TransSeqNumber = 0;
   MSGpkt->cmd.DataLength = aff->asduLength;
 
-  if ( MSGpkt->cmd.DataLength )
+  if ( MSGpkt->cmd.DataLength == 0 )
+  {
+    MSGpkt->cmd.Data = NULL;
+  }
+  else if ( *ppShare != NULL )
+  {
+    MSGpkt->cmd.Data = ((afIncomingMSGPacket_t *)*ppShare)->cmd.Data;
+    if ( osal_msg_attach( (uint8 *)MSGpkt, *ppShare ) != SUCCESS )
+    {
+      osal_msg_deallocate( (uint8 *)MSGpkt );
+      return;
+    }
+  }
+  else
   {
     MSGpkt->cmd.Data = (uint8 *)(MSGpkt + 1);
     osal_memcpy( MSGpkt->cmd.Data, asdu, MSGpkt->cmd.DataLength );
+
+    // Keep the data for the next endpoints, whatever this one does with it
+    *ppShare = osal_msg_retain( (uint8 *)MSGpkt );
   }
-  else
+
+#if defined ( INTER_PAN )
+  // Inter-PAN frames (ZLL touchlink) are answered within a scan period
+  if ( StubAPS_InterPan( SrcPanId, aff->SrcEndPoint ) )
   {
-    MSGpkt->cmd.Data = NULL;
+    OSAL_MSG_PRIO( (uint8 *)MSGpkt ) = OSAL_MSG_PRIO_URGENT;
   }
+#endif
 
 #if defined ( MT_AF_CB_FUNC )
   // If ZDO or SAPI have registered for this endpoint, dont intercept it here
@@ -88,6 +88,23 @@
 /*********************************************************************
  * CONSTANTS
  */
+#if !defined ( ZCL_STANDALONE )
+// ZCL task event that delivers the attribute change notifications
+#define ZCL_ATTR_CHANGE_EVT           0x0002
+#endif
+
+#if defined ( ZCL_REPORT ) && ZCL_REPORTING
+// ZCL task event that sends the due attribute reports
+#define ZCL_REPORT_EVT                0x0001
+
+// Longest attribute value checked for a reportable change. Longer values
+// are only reported when their maximum reporting interval expires.
+#define ZCL_REPORT_VALUE_LEN          8
+
+// Reporting state flags
+#define ZCL_REPORT_CHANGED            0x01  // Reportable change since the last report
+#define ZCL_REPORT_DUE                0x02  // Goes into the reports being sent
+#endif
 
 /*********************************************************************
  * TYPEDEFS
@@ -109,6 +126,15 @@ typedef struct zclCmdRecsList
   CONST zclCommandRec_t *pCmdRecs;
 } zclCmdRecsList_t;
 
+#if ZCL_ATTR_INDEX
+// Cluster in an attribute record index
+typedef struct
+{
+  uint16 clusterID;
+  uint8  first;     // Index position of the cluster's first attribute
+} zclAttrIdxCluster_t;
+#endif
+
 // Attribute record list item
 typedef struct zclAttrRecsList
 {
@@ -116,8 +142,15 @@ typedef struct zclAttrRecsList
   uint8                  endpoint;      // Used to link it into the endpoint descriptor
   zclReadWriteCB_t       pfnReadWriteCB;// Read or Write attribute value callback function
   zclAuthorizeCB_t       pfnAuthorizeCB;// Authorize Read or Write operation
+  zclAttrChangeCB_t      pfnAttrChangeCB;// Attribute value change callback function
   uint8                  numAttributes; // Number of the following records
   CONST zclAttrRec_t     *attrs;        // attribute records
+  uint8                  *dirty;        // Changed attrs, one bit each, NULL if changes aren't deferred
+#if ZCL_ATTR_INDEX
+  uint8                  *index;        // attrs positions by cluster and attribute ID, NULL if none
+  zclAttrIdxCluster_t    *clusters;     // Clusters in the index, in ascending order
+  uint8                  numClusters;   // Number of clusters in the index
+#endif
 } zclAttrRecsList;
 
 // Cluster option list item
@@ -132,12 +165,53 @@ typedef struct zclClusterOptionList
 typedef void *(*zclParseInProfileCmd_t)( zclParseCmd_t *pCmd );
 typedef uint8 (*zclProcessInProfileCmd_t)( zclIncoming_t *pInMsg );
 
+// Commands without a parse function are processed in place from the
+// received payload
 typedef struct
 {
   zclParseInProfileCmd_t   pfnParseInProfile;
   zclProcessInProfileCmd_t pfnProcessInProfile;
 } zclCmdItems_t;
 
+// Outgoing frame, serialized in place
+typedef struct
+{
+  endPointDesc_t *epDesc;
+  afAddrType_t   *dstAddr;
+  uint16         clusterID;
+  uint8          options;
+  uint8          hdrLen;      // Length of the ZCL header
+  uint8          newSeqNum;   // TRUE if each further frame takes the next zcl_SeqNum
+  uint8          *buf;        // ZCL header and payload
+  uint8          *pData;      // Where the payload continues
+  uint8          *pEnd;       // End of the buffer
+} zclFrame_t;
+
+#if defined ( ZCL_REPORT ) && ZCL_REPORTING
+// Attribute reporting configuration, as kept in NV
+typedef struct
+{
+  uint8  endpoint;      // Reporting endpoint, 0 if the entry is free
+  uint16 clusterID;
+  uint16 attrID;
+  uint8  dataType;
+  uint8  dstAddrMode;   // afAddrNotPresent to report to the bound devices
+  uint16 dstAddr;       // Short address or group ID
+  uint8  dstEP;
+  uint16 minReportInt;  // Seconds
+  uint16 maxReportInt;  // Seconds, 0 to report changes only
+  uint8  reportableChange[ZCL_REPORT_VALUE_LEN]; // Analog data types only
+} zclReportCfg_t;
+
+// Reporting state of a configuration
+typedef struct
+{
+  uint32 lastReport;                      // Report clock of the last report
+  uint8  lastValue[ZCL_REPORT_VALUE_LEN]; // Last reported value, over the air format
+  uint8  flags;
+} zclReportState_t;
+#endif
+
 
 /*********************************************************************
  * GLOBAL VARIABLES
@@ -180,12 +254,25 @@ static uint8 zcl_TransID = 0;  // This is the unique message ID (counter)
 
 static afIncomingMSGPacket_t *rawAFMsg = (afIncomingMSGPacket_t *)NULL;
 
+#if defined ( ZCL_REPORT ) && ZCL_REPORTING
+static zclReportCfg_t zclReportCfgs[ZCL_MAX_REPORT_CFGS];
+static zclReportState_t zclReportStates[ZCL_MAX_REPORT_CFGS];
+#endif
+
 /*********************************************************************
  * LOCAL FUNCTIONS
  */
 void zcl_ProcessMessageMSG( afIncomingMSGPacket_t *pkt );  // Not static for ZNP build.
 static uint8 *zclBuildHdr( zclFrameHdr_t *hdr, uint8 *pData );
 static uint8 zclCalcHdrSize( zclFrameHdr_t *hdr );
+static ZStatus_t zclFrameStart( zclFrame_t *pFrame, uint8 srcEP, afAddrType_t *destAddr,
+                                uint16 clusterID, uint8 cmd, uint8 specific, uint8 direction,
+                                uint8 disableDefaultRsp, uint16 manuCode, uint8 seqNum,
+                                uint16 payloadLen, uint8 limitToMTU );
+#if defined ( ZCL_READ ) || defined ( ZCL_REPORT )
+static ZStatus_t zclFrameRoom( zclFrame_t *pFrame, uint16 len );
+#endif
+static ZStatus_t zclFrameSend( zclFrame_t *pFrame );
 static zclLibPlugin_t *zclFindPlugin( uint16 clusterID, uint16 profileID );
 
 #if defined ( ZCL_DISCOVER )
@@ -193,6 +280,15 @@ static zclLibPlugin_t *zclFindPlugin( uint16 clusterID, uint16 profileID );
 #endif
 
 static zclAttrRecsList *zclFindAttrRecsList( uint8 endpoint );
+static uint8 zclFindAttrPos( zclAttrRecsList *pRec, uint16 clusterID, uint16 attrId );
+static void zclAttrChangeNotify( zclAttrRecsList *pRec, uint8 pos );
+#if !defined ( ZCL_STANDALONE )
+static void zclAttrChangeProcess( void );
+#endif
+#if ZCL_ATTR_INDEX
+static void zclBuildAttrIndex( zclAttrRecsList *pRec );
+static uint8 zclFindAttrIndex( zclAttrRecsList *pRec, uint16 clusterID, uint16 attrId, uint8 *pEnd );
+#endif
 static zclOptionRec_t *zclFindClusterOption( uint8 endpoint, uint16 clusterID );
 static uint8 zclGetClusterOption( uint8 endpoint, uint16 clusterID );
 static void zclSetSecurityOption( uint8 endpoint, uint16 clusterID, uint8 enable );
@@ -212,6 +308,13 @@ static ZStatus_t zclReadAttrDataUsingCB( uint8 endpoint, uint16 clusterId, uint1
 static ZStatus_t zclAuthorizeRead( uint8 endpoint, afAddrType_t *srcAddr, zclAttrRec_t *pAttr );
 static void *zclParseInReadRspCmd( zclParseCmd_t *pCmd );
 static uint8 zclProcessInReadCmd( zclIncoming_t *pInMsg );
+static void zclReadAttrStatus( zclIncoming_t *pInMsg, uint16 attrID, uint8 authorize,
+                               zclReadRspStatus_t *statusRec );
+static uint16 zclReadRspStatusLen( uint8 srcEP, uint16 clusterID, zclReadRspStatus_t *statusRec );
+static uint8 *zclSerializeReadRspStatus( uint8 srcEP, uint16 clusterID,
+                                         zclReadRspStatus_t *statusRec, uint8 *pBuf );
+static ZStatus_t zclFrameAddReadRspStatus( zclFrame_t *pFrame, uint8 srcEP, uint16 clusterID,
+                                           zclReadRspStatus_t *statusRec );
 #endif // ZCL_READ
 
 #ifdef ZCL_WRITE
@@ -228,6 +331,25 @@ static uint8 zclProcessInWriteUndividedCmd( zclIncoming_t *pInMsg );
 #ifdef ZCL_REPORT
 static void *zclParseInConfigReportRspCmd( zclParseCmd_t *pCmd );
 static void *zclParseInReadReportCfgRspCmd( zclParseCmd_t *pCmd );
+static void *zclParseReportCmd( zclParseCmd_t *pCmd, uint8 copy );
+#if ZCL_REPORT_ZERO_COPY
+static void *zclParseInReportCmdRef( zclParseCmd_t *pCmd );
+#endif
+#if ZCL_REPORTING
+static void zclReportInitNV( void );
+static void zclReportWriteNV( uint8 idx );
+static uint32 zclReportClock( void );
+static uint8 zclReportFindCfg( zclReportCfg_t *pKey );
+static uint8 zclReportSameDst( zclReportCfg_t *pCfg, zclReportCfg_t *pKey );
+static uint8 zclReportChanged( uint8 idx, zclAttrRec_t *pAttr );
+static uint8 zclReportExceeds( uint8 dataType, uint8 *pNew, uint8 *pOld, uint8 *pChange, uint8 len );
+static void zclReportProcess( void );
+static void zclReportSend( uint8 idx, uint32 now );
+static void zclReportSchedule( uint32 now );
+static void zclReportAttrChanged( uint8 endpoint, uint16 clusterID, uint16 attrID );
+static uint8 zclProcessInConfigReportCmd( zclIncoming_t *pInMsg );
+static uint8 zclProcessInReadReportCfgCmd( zclIncoming_t *pInMsg );
+#endif
 #endif // ZCL_REPORT
 
 static void *zclParseInDefaultRspCmd( zclParseCmd_t *pCmd );
@@ -251,7 +373,7 @@ static void zclProcessInDiscAttrsExtCmd( zclIncoming_t *pInMsg, zclDiscoverAttrs
 static CONST zclCmdItems_t zclCmdTable[] =
 {
 #ifdef ZCL_READ
-  /* ZCL_CMD_READ */                { zclParseInReadCmd,             zclProcessInReadCmd             },
+  /* ZCL_CMD_READ */                { (zclParseInProfileCmd_t)NULL,  zclProcessInReadCmd             },
   /* ZCL_CMD_READ_RSP */            { zclParseInReadRspCmd,          zcl_HandleExternal              },
 #else
   /* ZCL_CMD_READ */                { (zclParseInProfileCmd_t)NULL,  (zclProcessInProfileCmd_t)NULL  },
@@ -259,10 +381,10 @@ static CONST zclCmdItems_t zclCmdTable[] =
 #endif // ZCL_READ
 
 #ifdef ZCL_WRITE
-  /* ZCL_CMD_WRITE */               { zclParseInWriteCmd,            zclProcessInWriteCmd            },
+  /* ZCL_CMD_WRITE */               { (zclParseInProfileCmd_t)NULL,  zclProcessInWriteCmd            },
   /* ZCL_CMD_WRITE_UNDIVIDED */     { zclParseInWriteCmd,            zclProcessInWriteUndividedCmd   },
   /* ZCL_CMD_WRITE_RSP */           { zclParseInWriteRspCmd,         zcl_HandleExternal              },
-  /* ZCL_CMD_WRITE_NO_RSP */        { zclParseInWriteCmd,            zclProcessInWriteCmd            },
+  /* ZCL_CMD_WRITE_NO_RSP */        { (zclParseInProfileCmd_t)NULL,  zclProcessInWriteCmd            },
 #else
   /* ZCL_CMD_WRITE */               { (zclParseInProfileCmd_t)NULL,  (zclProcessInProfileCmd_t)NULL  },
   /* ZCL_CMD_WRITE_UNDIVIDED */     { (zclParseInProfileCmd_t)NULL,  (zclProcessInProfileCmd_t)NULL  },
@@ -271,11 +393,21 @@ static CONST zclCmdItems_t zclCmdTable[] =
 #endif // ZCL_WRITE
 
 #ifdef ZCL_REPORT
+#if ZCL_REPORTING
+  /* ZCL_CMD_CONFIG_REPORT */       { zclParseInConfigReportCmd,     zclProcessInConfigReportCmd     },
+  /* ZCL_CMD_CONFIG_REPORT_RSP */   { zclParseInConfigReportRspCmd,  zcl_HandleExternal              },
+  /* ZCL_CMD_READ_REPORT_CFG */     { zclParseInReadReportCfgCmd,    zclProcessInReadReportCfgCmd    },
+#else
   /* ZCL_CMD_CONFIG_REPORT */       { zclParseInConfigReportCmd,     zcl_HandleExternal              },
   /* ZCL_CMD_CONFIG_REPORT_RSP */   { zclParseInConfigReportRspCmd,  zcl_HandleExternal              },
   /* ZCL_CMD_READ_REPORT_CFG */     { zclParseInReadReportCfgCmd,    zcl_HandleExternal              },
+#endif
   /* ZCL_CMD_READ_REPORT_CFG_RSP */ { zclParseInReadReportCfgRspCmd, zcl_HandleExternal              },
+#if ZCL_REPORT_ZERO_COPY
+  /* ZCL_CMD_REPORT */              { zclParseInReportCmdRef,        zcl_HandleExternal              },
+#else
   /* ZCL_CMD_REPORT */              { zclParseInReportCmd,           zcl_HandleExternal              },
+#endif
 #else
   /* ZCL_CMD_CONFIG_REPORT */       { (zclParseInProfileCmd_t)NULL,  (zclProcessInProfileCmd_t)NULL  },
   /* ZCL_CMD_CONFIG_REPORT_RSP */   { (zclParseInProfileCmd_t)NULL,  (zclProcessInProfileCmd_t)NULL  },
@@ -330,6 +462,10 @@ static CONST zclCmdItems_t zclCmdTable[] =
 void zcl_Init( uint8 task_id )
 {
   zcl_TaskID = task_id;
+
+#if defined ( ZCL_REPORT ) && ZCL_REPORTING
+  zclReportInitNV();
+#endif
 }
 #endif
 
@@ -382,6 +518,22 @@ uint16 zcl_event_loop( uint8 task_id, uint16 events )
     return (events ^ SYS_EVENT_MSG);
   }
 
+  if ( events & ZCL_ATTR_CHANGE_EVT )
+  {
+    zclAttrChangeProcess();
+
+    return ( events ^ ZCL_ATTR_CHANGE_EVT );
+  }
+
+#if defined ( ZCL_REPORT ) && ZCL_REPORTING
+  if ( events & ZCL_REPORT_EVT )
+  {
+    zclReportProcess();
+
+    return ( events ^ ZCL_REPORT_EVT );
+  }
+#endif
+
   // Discard unknown events
   return 0;
 }
@@ -443,6 +595,16 @@ uint8 zcl_HandleExternal( zclIncoming_t *pInMsg )
     pCmd->endPoint  = pInMsg->msg->endPoint;
     pCmd->attrCmd   = pInMsg->attrCmd;
 
+#if defined ( ZCL_REPORT ) && ZCL_REPORT_ZERO_COPY
+    // A parsed report points into the received message - keep it
+    if ( zcl_ProfileCmd( pInMsg->hdr.fc.type ) && ( pInMsg->hdr.commandID == ZCL_CMD_REPORT ) &&
+         ( osal_msg_attach( (uint8 *)pCmd, (uint8 *)pInMsg->msg ) != SUCCESS ) )
+    {
+      osal_msg_deallocate( (uint8 *)pCmd );
+      return ( TRUE );
+    }
+#endif
+
     // Application will free the attrCmd buffer
     pInMsg->attrCmd = NULL;
 
@@ -605,8 +767,22 @@ ZStatus_t zcl_registerAttrList( uint8 endpoint, uint8 numAttr, CONST zclAttrRec_
   pNewItem->next = (zclAttrRecsList *)NULL;
   pNewItem->endpoint = endpoint;
   pNewItem->pfnReadWriteCB = NULL;
+  pNewItem->pfnAttrChangeCB = NULL;
   pNewItem->numAttributes = numAttr;
   pNewItem->attrs = newAttrList;
+#if !defined ( ZCL_STANDALONE )
+  // Changes are collected here and delivered once from the ZCL task
+  pNewItem->dirty = zcl_mem_alloc( ( (uint16)numAttr + 7 ) / 8 );
+  if ( pNewItem->dirty != NULL )
+  {
+    zcl_memset( pNewItem->dirty, 0, ( (uint16)numAttr + 7 ) / 8 );
+  }
+#else
+  pNewItem->dirty = NULL;
+#endif
+#if ZCL_ATTR_INDEX
+  zclBuildAttrIndex( pNewItem );
+#endif
 
   // Find spot in list
   if ( attrList == NULL )
@@ -740,6 +916,167 @@ ZStatus_t zcl_registerReadWriteCB( uint8 endpoint, zclReadWriteCB_t pfnReadWrite
   return ( ZFailure );
 }
 
+/*********************************************************************
+ * @fn          zcl_registerAttrChangeCB
+ *
+ * @brief       Register the application's callback function for changes
+ *              of its attribute values. ZCL calls it for the attributes
+ *              written over the air and for the changes reported with
+ *              zcl_SetAttrValue() or zcl_AttrChanged(). Changes are
+ *              delivered from the ZCL task, once however often the
+ *              attribute changed in the meantime.
+ *
+ * @param       endpoint - application's endpoint
+ * @param       pfnAttrChangeCB - function pointer to attribute change routine
+ *
+ * @return      ZSuccess if successful. ZFailure, otherwise.
+ */
+ZStatus_t zcl_registerAttrChangeCB( uint8 endpoint, zclAttrChangeCB_t pfnAttrChangeCB )
+{
+  zclAttrRecsList *pRec = zclFindAttrRecsList( endpoint );
+
+  if ( pRec != NULL )
+  {
+    pRec->pfnAttrChangeCB = pfnAttrChangeCB;
+
+    return ( ZSuccess );
+  }
+
+  return ( ZFailure );
+}
+
+/*********************************************************************
+ * @fn          zcl_SetAttrValue
+ *
+ * @brief       Set the value of a local attribute and tell the ZCL
+ *              consumers (attribute reporting, the application's
+ *              attribute change callback) if it changed. The value is
+ *              checked like a written one: strings can't be longer than
+ *              MAX_UTF8_STRING_LEN and the application's validation
+ *              function must accept it.
+ *
+ * @param       endpoint - application's endpoint
+ * @param       clusterID - cluster ID
+ * @param       attrID - attribute ID
+ * @param       pValue - new value, in the attribute's format
+ *
+ * @return      ZSuccess if OK, ZInvalidParameter if the attribute isn't
+ *              registered or has no data pointer, ZCL_STATUS_INVALID_VALUE
+ *              if the value is rejected
+ */
+ZStatus_t zcl_SetAttrValue( uint8 endpoint, uint16 clusterID, uint16 attrID, void *pValue )
+{
+  zclAttrRec_t attrRec;
+  zclWriteRec_t writeRec;
+  uint8 *pCur;
+  uint8 *pNew = pValue;
+  uint16 maxLen;
+  uint16 len;
+  uint16 i;
+
+  if ( !zclFindAttrRec( endpoint, clusterID, attrID, &attrRec ) ||
+       ( attrRec.attr.dataPtr == NULL ) )
+  {
+    return ( ZInvalidParameter ); // EMBEDDED RETURN
+  }
+
+  pCur = attrRec.attr.dataPtr;
+  len = zclGetAttrDataLength( attrRec.attr.dataType, pNew );
+
+  switch ( attrRec.attr.dataType )
+  {
+    case ZCL_DATATYPE_CHAR_STR:
+    case ZCL_DATATYPE_OCTET_STR:
+      maxLen = MAX_UTF8_STRING_LEN + 1; // + 1 for length field
+      break;
+
+    case ZCL_DATATYPE_LONG_CHAR_STR:
+    case ZCL_DATATYPE_LONG_OCTET_STR:
+      maxLen = MAX_UTF8_STRING_LEN + 2; // + 2 for length field
+      break;
+
+    default:
+      maxLen = len;
+      break;
+  }
+
+  if ( len > maxLen )
+  {
+    return ( ZCL_STATUS_INVALID_VALUE ); // EMBEDDED RETURN
+  }
+
+  writeRec.attrID = attrID;
+  writeRec.dataType = attrRec.attr.dataType;
+  writeRec.attrData = pNew;
+  if ( ( zcl_ValidateAttrDataCB != NULL ) && !zcl_ValidateAttrDataCB( &attrRec, &writeRec ) )
+  {
+    return ( ZCL_STATUS_INVALID_VALUE ); // EMBEDDED RETURN
+  }
+
+  for ( i = 0; i < len; i++ )
+  {
+    if ( pCur[i] != pNew[i] )
+    {
+      break;
+    }
+  }
+
+  if ( i < len )
+  {
+    zcl_memcpy( pCur, pNew, len );
+    zcl_AttrChanged( endpoint, clusterID, attrID );
+  }
+
+  return ( ZSuccess );
+}
+
+/*********************************************************************
+ * @fn          zcl_AttrChanged
+ *
+ * @brief       Tell ZCL that the application has changed the value of
+ *              a local attribute through its data pointer. The change
+ *              is passed on to the reporting engine and to the
+ *              endpoint's change callback.
+ *
+ * @param       endpoint - application's endpoint, AF_BROADCAST_ENDPOINT
+ *                         for all endpoints the attribute is registered on
+ * @param       clusterID - cluster ID
+ * @param       attrID - attribute ID
+ *
+ * @return      none
+ */
+void zcl_AttrChanged( uint8 endpoint, uint16 clusterID, uint16 attrID )
+{
+  zclAttrRecsList *pRec;
+  uint8 pos;
+
+  for ( pRec = attrList; pRec != NULL; pRec = pRec->next )
+  {
+    if ( ( endpoint != AF_BROADCAST_ENDPOINT ) && ( pRec->endpoint != endpoint ) )
+    {
+      continue;
+    }
+
+    pos = zclFindAttrPos( pRec, clusterID, attrID );
+    if ( pos == pRec->numAttributes )
+    {
+      continue;
+    }
+
+#if !defined ( ZCL_STANDALONE )
+    if ( pRec->dirty != NULL )
+    {
+      pRec->dirty[pos >> 3] |= BV( pos & 0x07 );
+      osal_set_event( zcl_TaskID, ZCL_ATTR_CHANGE_EVT );
+    }
+    else
+#endif
+    {
+      zclAttrChangeNotify( pRec, pos );
+    }
+  }
+}
+
 /*********************************************************************
  * @fn      zcl_DeviceOperational
  *
@@ -813,14 +1150,56 @@ ZStatus_t zcl_SendCommand( uint8 srcEP, afAddrType_t *destAddr,
                            uint16 clusterID, uint8 cmd, uint8 specific, uint8 direction,
                            uint8 disableDefaultRsp, uint16 manuCode, uint8 seqNum,
                            uint16 cmdFormatLen, uint8 *cmdFormat )
+{
+  zclFrame_t frame;
+  ZStatus_t status;
+
+  status = zclFrameStart( &frame, srcEP, destAddr, clusterID, cmd, specific, direction,
+                          disableDefaultRsp, manuCode, seqNum, cmdFormatLen, FALSE );
+  if ( status == ZSuccess )
+  {
+    // Fill in the command frame
+    zcl_memcpy( frame.pData, cmdFormat, cmdFormatLen );
+    frame.pData += cmdFormatLen;
+
+    status = zclFrameSend( &frame );
+  }
+
+  return ( status );
+}
+
+/*********************************************************************
+ * @fn      zclFrameStart
+ *
+ * @brief   Allocate an outgoing ZCL frame and fill in its header, so
+ *          that the command payload can be serialized straight into it.
+ *          The frame must be given to zclFrameSend() afterwards.
+ *
+ * @param   pFrame - frame to start
+ * @param   srcEp - source endpoint
+ * @param   destAddr - destination address
+ * @param   clusterID - cluster ID
+ * @param   cmd - command ID
+ * @param   specific - whether the command is Cluster Specific
+ * @param   direction - client/server direction of the command
+ * @param   disableDefaultRsp - disable Default Response command
+ * @param   manuCode - manufacturer code for proprietary extensions to a profile
+ * @param   seqNumber - identification number for the transaction
+ * @param   payloadLen - room to allocate for the command payload
+ * @param   limitToMTU - TRUE to allocate no more than fits in one frame,
+ *                       for payloads that zclFrameRoom() splits
+ *
+ * @return  ZSuccess if OK, pFrame->pData then points to the payload
+ */
+static ZStatus_t zclFrameStart( zclFrame_t *pFrame, uint8 srcEP, afAddrType_t *destAddr,
+                                uint16 clusterID, uint8 cmd, uint8 specific, uint8 direction,
+                                uint8 disableDefaultRsp, uint16 manuCode, uint8 seqNum,
+                                uint16 payloadLen, uint8 limitToMTU )
 {
   endPointDesc_t *epDesc;
   zclFrameHdr_t hdr;
-  uint8 *msgBuf;
   uint16 msgLen;
-  uint8 *pBuf;
   uint8 options;
-  ZStatus_t status;
 
   epDesc = afFindEndPointDesc( srcEP );
   if ( epDesc == NULL )
@@ -906,29 +1285,114 @@ ZStatus_t zcl_SendCommand( uint8 srcEP, afAddrType_t *destAddr,
 
   // calculate the needed buffer size
   msgLen = zclCalcHdrSize( &hdr );
-  msgLen += cmdFormatLen;
+  msgLen += payloadLen;
+
+  if ( limitToMTU )
+  {
+    afDataReqMTU_t mtu;
+    uint8 maxLen;
+
+    mtu.kvp = FALSE;
+    mtu.aps.secure = ( options & AF_EN_SECURITY ) ? TRUE : FALSE;
+    maxLen = afDataReqMTU( &mtu );
+
+    if ( msgLen > maxLen )
+    {
+      msgLen = maxLen;
+    }
+  }
 
   // Allocate the buffer needed
-  msgBuf = zcl_mem_alloc( msgLen );
-  if ( msgBuf != NULL )
+  pFrame->buf = zcl_mem_alloc( msgLen );
+  if ( pFrame->buf == NULL )
   {
-    // Fill in the ZCL Header
-    pBuf = zclBuildHdr( &hdr, msgBuf );
+    return ( ZMemError ); // EMBEDDED RETURN
+  }
 
-    // Fill in the command frame
-    zcl_memcpy( pBuf, cmdFormat, cmdFormatLen );
+  // Fill in the ZCL Header
+  pFrame->pData = zclBuildHdr( &hdr, pFrame->buf );
+  pFrame->hdrLen = (uint8)( pFrame->pData - pFrame->buf );
+  pFrame->pEnd = pFrame->buf + msgLen;
+  pFrame->epDesc = epDesc;
+  pFrame->dstAddr = destAddr;
+  pFrame->clusterID = clusterID;
+  pFrame->options = options;
+  pFrame->newSeqNum = FALSE;
+
+  return ( ZSuccess );
+}
+
+#if defined ( ZCL_READ ) || defined ( ZCL_REPORT )
+/*********************************************************************
+ * @fn      zclFrameRoom
+ *
+ * @brief   Make room in a frame for the next record of its payload.
+ *          If the record doesn't fit, the frame is sent and its buffer
+ *          is reused for another frame. A response keeps the sequence
+ *          number of the request in all its frames; a frame with
+ *          newSeqNum set takes the next zcl_SeqNum instead.
+ *
+ * @param   pFrame - frame being built
+ * @param   len - length of the record
+ *
+ * @return  ZSuccess if there is room, ZBufferFull if the record is
+ *          longer than any frame can hold, otherwise the status of
+ *          sending the full frame
+ */
+static ZStatus_t zclFrameRoom( zclFrame_t *pFrame, uint16 len )
+{
+  uint8 *pPayload = pFrame->buf + pFrame->hdrLen;
+  ZStatus_t status;
 
-    status = AF_DataRequest( destAddr, epDesc, clusterID, msgLen, msgBuf,
-                             &zcl_TransID, options, AF_DEFAULT_RADIUS );
-    zcl_mem_free ( msgBuf );
+  if ( len <= (uint16)( pFrame->pEnd - pFrame->pData ) )
+  {
+    return ( ZSuccess ); // EMBEDDED RETURN
   }
-  else
+
+  if ( len > (uint16)( pFrame->pEnd - pPayload ) )
   {
-    status = ZMemError;
+    return ( ZBufferFull ); // EMBEDDED RETURN
+  }
+
+  status = AF_DataRequest( pFrame->dstAddr, pFrame->epDesc, pFrame->clusterID,
+                           (uint16)( pFrame->pData - pFrame->buf ), pFrame->buf,
+                           &zcl_TransID, pFrame->options, AF_DEFAULT_RADIUS );
+  if ( status == ZSuccess )
+  {
+    // The header ends with the Transaction Sequence Number and Command ID
+    if ( pFrame->newSeqNum )
+    {
+      pPayload[-2] = zcl_SeqNum++;
+    }
+
+    pFrame->pData = pPayload;
   }
 
   return ( status );
 }
+#endif // ZCL_READ || ZCL_REPORT
+
+/*********************************************************************
+ * @fn      zclFrameSend
+ *
+ * @brief   Send a frame started with zclFrameStart() and free it. Only
+ *          the bytes up to pFrame->pData are sent.
+ *
+ * @param   pFrame - frame to send
+ *
+ * @return  ZSuccess if OK
+ */
+static ZStatus_t zclFrameSend( zclFrame_t *pFrame )
+{
+  ZStatus_t status;
+
+  status = AF_DataRequest( pFrame->dstAddr, pFrame->epDesc, pFrame->clusterID,
+                           (uint16)( pFrame->pData - pFrame->buf ), pFrame->buf,
+                           &zcl_TransID, pFrame->options, AF_DEFAULT_RADIUS );
+  zcl_mem_free( pFrame->buf );
+
+  return ( status );
+}
 
 #ifdef ZCL_READ
 /*********************************************************************
@@ -984,7 +1448,9 @@ ZStatus_t zcl_SendRead( uint8 srcEP, afAddrType_t *dstAddr,
 /*********************************************************************
  * @fn      zcl_SendReadRsp
  *
- * @brief   Send a Read Response command.
+ * @brief   Send a Read Response command. Responses longer than the MTU
+ *          are sent as several commands, all with the sequence number
+ *          of the request.
  *
  * @param   srcEP - Application's endpoint
  * @param   dstAddr - destination address
@@ -999,75 +1465,147 @@ ZStatus_t zcl_SendReadRsp( uint8 srcEP, afAddrType_t *dstAddr,
                            uint16 clusterID, zclReadRspCmd_t *readRspCmd,
                            uint8 direction, uint8 disableDefaultRsp, uint8 seqNum )
 {
-  uint8 *buf;
   uint16 len = 0;
+  zclFrame_t frame;
   ZStatus_t status;
   uint8 i;
 
   // calculate the size of the command
   for ( i = 0; i < readRspCmd->numAttr; i++ )
   {
-    zclReadRspStatus_t *statusRec = &(readRspCmd->attrList[i]);
-
-    len += 2 + 1; // Attribute ID + Status
+    len += zclReadRspStatusLen( srcEP, clusterID, &(readRspCmd->attrList[i]) );
+  }
 
-    if ( statusRec->status == ZCL_STATUS_SUCCESS )
+  status = zclFrameStart( &frame, srcEP, dstAddr, clusterID, ZCL_CMD_READ_RSP, FALSE,
+                          direction, disableDefaultRsp, 0, seqNum, len, TRUE );
+  if ( status == ZSuccess )
+  {
+    // Serialize straight into the frame, sending as many frames as the MTU needs
+    for ( i = 0; ( i < readRspCmd->numAttr ) && ( status == ZSuccess ); i++ )
     {
-      len++; // Attribute Data Type length
+      status = zclFrameAddReadRspStatus( &frame, srcEP, clusterID, &(readRspCmd->attrList[i]) );
+    }
 
-      // Attribute Data length
-      if ( statusRec->data != NULL )
-      {
-        len += zclGetAttrDataLength( statusRec->dataType, statusRec->data );
-      }
-      else
-      {
-        len += zclGetAttrDataLengthUsingCB( srcEP, clusterID, statusRec->attrID );
-      }
+    if ( status == ZSuccess )
+    {
+      status = zclFrameSend( &frame );
+    }
+    else
+    {
+      zcl_mem_free( frame.buf );
     }
   }
 
-  buf = zcl_mem_alloc( len );
-  if ( buf != NULL )
+  return ( status );
+}
+
+/*********************************************************************
+ * @fn      zclReadRspStatusLen
+ *
+ * @brief   Get the length of a Read Attribute Status record
+ *
+ * @param   srcEP - Application's endpoint
+ * @param   clusterID - cluster ID
+ * @param   statusRec - read attribute status record
+ *
+ * @return  length of the record in the frame
+ */
+static uint16 zclReadRspStatusLen( uint8 srcEP, uint16 clusterID, zclReadRspStatus_t *statusRec )
+{
+  uint16 len = 2 + 1; // Attribute ID + Status
+
+  if ( statusRec->status == ZCL_STATUS_SUCCESS )
   {
-    // Load the buffer - serially
-    uint8 *pBuf = buf;
+    len++; // Attribute Data Type length
 
-    for ( i = 0; i < readRspCmd->numAttr; i++ )
+    // Attribute Data length
+    if ( statusRec->data != NULL )
     {
-      zclReadRspStatus_t *statusRec = &(readRspCmd->attrList[i]);
+      len += zclGetAttrDataLength( statusRec->dataType, statusRec->data );
+    }
+    else
+    {
+      len += zclGetAttrDataLengthUsingCB( srcEP, clusterID, statusRec->attrID );
+    }
+  }
 
-      *pBuf++ = LO_UINT16( statusRec->attrID );
-      *pBuf++ = HI_UINT16( statusRec->attrID );
-      *pBuf++ = statusRec->status;
+  return ( len );
+}
 
-      if ( statusRec->status == ZCL_STATUS_SUCCESS )
-      {
-        *pBuf++ = statusRec->dataType;
+/*********************************************************************
+ * @fn      zclSerializeReadRspStatus
+ *
+ * @brief   Serialize a Read Attribute Status record
+ *
+ * @param   srcEP - Application's endpoint
+ * @param   clusterID - cluster ID
+ * @param   statusRec - read attribute status record
+ * @param   pBuf - where to put the record
+ *
+ * @return  pointer past the record
+ */
+static uint8 *zclSerializeReadRspStatus( uint8 srcEP, uint16 clusterID,
+                                         zclReadRspStatus_t *statusRec, uint8 *pBuf )
+{
+  *pBuf++ = LO_UINT16( statusRec->attrID );
+  *pBuf++ = HI_UINT16( statusRec->attrID );
+  *pBuf++ = statusRec->status;
 
-        if ( statusRec->data != NULL )
-        {
-          // Copy attribute data to the buffer to be sent out
-          pBuf = zclSerializeData( statusRec->dataType, statusRec->data, pBuf );
-        }
-        else
-        {
-          uint16 dataLen;
+  if ( statusRec->status == ZCL_STATUS_SUCCESS )
+  {
+    *pBuf++ = statusRec->dataType;
 
-          // Read attribute data directly into the buffer to be sent out
-          zclReadAttrDataUsingCB( srcEP, clusterID, statusRec->attrID, pBuf, &dataLen );
-          pBuf += dataLen;
-        }
-      }
-    } // for loop
+    if ( statusRec->data != NULL )
+    {
+      // Copy attribute data to the buffer to be sent out
+      pBuf = zclSerializeData( statusRec->dataType, statusRec->data, pBuf );
+    }
+    else
+    {
+      uint16 dataLen;
 
-    status = zcl_SendCommand( srcEP, dstAddr, clusterID, ZCL_CMD_READ_RSP, FALSE,
-                              direction, disableDefaultRsp, 0, seqNum, len, buf );
-    zcl_mem_free( buf );
+      // Read attribute data directly into the buffer to be sent out
+      zclReadAttrDataUsingCB( srcEP, clusterID, statusRec->attrID, pBuf, &dataLen );
+      pBuf += dataLen;
+    }
   }
-  else
+
+  return ( pBuf );
+}
+
+/*********************************************************************
+ * @fn      zclFrameAddReadRspStatus
+ *
+ * @brief   Add a Read Attribute Status record to a Read Response frame,
+ *          continuing in another frame if it doesn't fit. A value too
+ *          long for any frame is answered with INSUFFICIENT_SPACE.
+ *
+ * @param   pFrame - Read Response frame being built
+ * @param   srcEP - Application's endpoint
+ * @param   clusterID - cluster ID
+ * @param   statusRec - read attribute status record
+ *
+ * @return  ZSuccess if OK
+ */
+static ZStatus_t zclFrameAddReadRspStatus( zclFrame_t *pFrame, uint8 srcEP, uint16 clusterID,
+                                           zclReadRspStatus_t *statusRec )
+{
+  zclReadRspStatus_t spaceRec;
+  ZStatus_t status;
+
+  status = zclFrameRoom( pFrame, zclReadRspStatusLen( srcEP, clusterID, statusRec ) );
+  if ( status == ZBufferFull )
   {
-    status = ZMemError;
+    spaceRec.attrID = statusRec->attrID;
+    spaceRec.status = ZCL_STATUS_INSUFFICIENT_SPACE;
+    statusRec = &spaceRec;
+
+    status = zclFrameRoom( pFrame, zclReadRspStatusLen( srcEP, clusterID, statusRec ) );
+  }
+
+  if ( status == ZSuccess )
+  {
+    pFrame->pData = zclSerializeReadRspStatus( srcEP, clusterID, statusRec, pFrame->pData );
   }
 
   return ( status );
@@ -1486,73 +2024,759 @@ ZStatus_t zcl_SendReadReportCfgRspCmd( uint8 srcEP, afAddrType_t *dstAddr,
   }
   else
   {
-    status = ZMemError;
+    status = ZMemError;
+  }
+
+  return ( status );
+}
+
+/*********************************************************************
+ * @fn      zcl_SendReportCmd
+ *
+ * @brief   Send a Report command. Reports longer than the MTU are sent
+ *          as several commands, the first with seqNum and the others
+ *          with the next sequence numbers of zcl_SeqNum.
+ *
+ * @param   dstAddr - destination address
+ * @param   clusterID - cluster ID
+ * @param   reportCmd - report command to be sent
+ * @param   direction - direction of the command
+ * @param   seqNum - transaction sequence number
+ *
+ * @return  ZSuccess if OK
+ */
+ZStatus_t zcl_SendReportCmd( uint8 srcEP, afAddrType_t *dstAddr,
+                             uint16 clusterID, zclReportCmd_t *reportCmd,
+                             uint8 direction, uint8 disableDefaultRsp, uint8 seqNum )
+{
+  uint16 dataLen = 0;
+  zclFrame_t frame;
+  ZStatus_t status;
+  uint8 i;
+
+  // calculate the size of the command
+  for ( i = 0; i < reportCmd->numAttr; i++ )
+  {
+    zclReport_t *reportRec = &(reportCmd->attrList[i]);
+
+    dataLen += 2 + 1; // Attribute ID + data type
+
+    // Attribute Data
+    dataLen += zclGetAttrDataLength( reportRec->dataType, reportRec->attrData );
+  }
+
+  status = zclFrameStart( &frame, srcEP, dstAddr, clusterID, ZCL_CMD_REPORT, FALSE,
+                          direction, disableDefaultRsp, 0, seqNum, dataLen, TRUE );
+  if ( status == ZSuccess )
+  {
+    // A report is not an answer, so its frames are separate transactions
+    frame.newSeqNum = TRUE;
+
+    // Load the frame - serially
+    for ( i = 0; ( i < reportCmd->numAttr ) && ( status == ZSuccess ); i++ )
+    {
+      zclReport_t *reportRec = &(reportCmd->attrList[i]);
+
+      status = zclFrameRoom( &frame, 2 + 1 + zclGetAttrDataLength( reportRec->dataType,
+                                                                   reportRec->attrData ) );
+      if ( status == ZSuccess )
+      {
+        *frame.pData++ = LO_UINT16( reportRec->attrID );
+        *frame.pData++ = HI_UINT16( reportRec->attrID );
+        *frame.pData++ = reportRec->dataType;
+
+        frame.pData = zclSerializeData( reportRec->dataType, reportRec->attrData, frame.pData );
+      }
+      else if ( status == ZBufferFull )
+      {
+        // Too long for any frame - leave it out
+        status = ZSuccess;
+      }
+    }
+
+    if ( status == ZSuccess )
+    {
+      status = zclFrameSend( &frame );
+    }
+    else
+    {
+      zcl_mem_free( frame.buf );
+    }
+  }
+
+  return ( status );
+}
+
+#if ZCL_REPORTING
+/*********************************************************************
+ * @fn      zcl_ConfigReport
+ *
+ * @brief   Configure the reporting of a local attribute. Reporting
+ *          starts with a report of the current value.
+ *
+ * @param   endpoint - endpoint of the attribute
+ * @param   clusterID - cluster ID
+ * @param   dstAddr - where to send the reports, afAddrNotPresent for
+ *                    the bound devices
+ * @param   cfgReportRec - reporting configuration. A Maximum Reporting
+ *                         Interval of ZCL_REPORTING_OFF stops the reporting.
+ *
+ * @return  ZCL_STATUS_SUCCESS if OK
+ */
+ZStatus_t zcl_ConfigReport( uint8 endpoint, uint16 clusterID, afAddrType_t *dstAddr,
+                            zclCfgReportRec_t *cfgReportRec )
+{
+  zclReportCfg_t cfg;
+  zclAttrRec_t attrRec;
+  uint32 now;
+  uint8 changeLen;
+  uint8 idx;
+
+  if ( dstAddr->addrMode == afAddr64Bit )
+  {
+    return ( ZCL_STATUS_INVALID_VALUE ); // EMBEDDED RETURN
+  }
+
+  if ( !zclFindAttrRec( endpoint, clusterID, cfgReportRec->attrID, &attrRec ) )
+  {
+    return ( ZCL_STATUS_UNSUPPORTED_ATTRIBUTE ); // EMBEDDED RETURN
+  }
+
+  // The engine reports the attribute value straight from its data pointer
+  if ( !( attrRec.attr.accessControl & ACCESS_REPORTABLE ) ||
+       ( attrRec.attr.dataPtr == NULL ) )
+  {
+    return ( ZCL_STATUS_UNREPORTABLE_ATTRIBUTE ); // EMBEDDED RETURN
+  }
+
+  if ( cfgReportRec->dataType != attrRec.attr.dataType )
+  {
+    return ( ZCL_STATUS_INVALID_DATA_TYPE ); // EMBEDDED RETURN
+  }
+
+  if ( ( cfgReportRec->maxReportInt != ZCL_REPORTING_OFF ) &&
+       ( cfgReportRec->maxReportInt != 0 ) &&
+       ( cfgReportRec->minReportInt > cfgReportRec->maxReportInt ) )
+  {
+    return ( ZCL_STATUS_INVALID_VALUE ); // EMBEDDED RETURN
+  }
+
+  zcl_memset( &cfg, 0, sizeof( zclReportCfg_t ) );
+  cfg.endpoint = endpoint;
+  cfg.clusterID = clusterID;
+  cfg.attrID = cfgReportRec->attrID;
+  cfg.dataType = cfgReportRec->dataType;
+  cfg.dstAddrMode = dstAddr->addrMode;
+  if ( dstAddr->addrMode != afAddrNotPresent )
+  {
+    cfg.dstAddr = dstAddr->addr.shortAddr;
+    cfg.dstEP = dstAddr->endPoint;
+  }
+  cfg.minReportInt = cfgReportRec->minReportInt;
+  cfg.maxReportInt = cfgReportRec->maxReportInt;
+
+  idx = zclReportFindCfg( &cfg );
+
+  if ( cfgReportRec->maxReportInt == ZCL_REPORTING_OFF )
+  {
+    if ( idx < ZCL_MAX_REPORT_CFGS )
+    {
+      zclReportCfgs[idx].endpoint = 0;
+      zclReportWriteNV( idx );
+      zclReportSchedule( zclReportClock() );
+    }
+
+    return ( ZCL_STATUS_SUCCESS ); // EMBEDDED RETURN
+  }
+
+  if ( idx == ZCL_MAX_REPORT_CFGS )
+  {
+    // Look for a free entry
+    for ( idx = 0; idx < ZCL_MAX_REPORT_CFGS; idx++ )
+    {
+      if ( zclReportCfgs[idx].endpoint == 0 )
+      {
+        break;
+      }
+    }
+
+    if ( idx == ZCL_MAX_REPORT_CFGS )
+    {
+      return ( ZCL_STATUS_INSUFFICIENT_SPACE ); // EMBEDDED RETURN
+    }
+  }
+
+  if ( zclAnalogDataType( cfg.dataType ) && ( cfgReportRec->reportableChange != NULL ) )
+  {
+    changeLen = zclGetDataTypeLength( cfg.dataType );
+    if ( changeLen <= ZCL_REPORT_VALUE_LEN )
+    {
+      zcl_memcpy( cfg.reportableChange, cfgReportRec->reportableChange, changeLen );
+    }
+  }
+
+  zclReportCfgs[idx] = cfg;
+  zclReportWriteNV( idx );
+
+  // Report the current value as soon as possible
+  now = zclReportClock();
+  zclReportStates[idx].lastReport = now - ( (uint32)cfg.minReportInt * 1000 );
+  zclReportStates[idx].flags = ZCL_REPORT_CHANGED;
+  zclReportSchedule( now );
+
+  return ( ZCL_STATUS_SUCCESS );
+}
+
+/*********************************************************************
+ * @fn      zclReportAttrChanged
+ *
+ * @brief   Tell the reporting engine that the value of a local
+ *          attribute has changed. A reportable change is reported
+ *          when the attribute's Minimum Reporting Interval allows.
+ *          Only called for the changes collected by zcl_AttrChanged().
+ *
+ * @param   endpoint - endpoint of the attribute
+ * @param   clusterID - cluster ID
+ * @param   attrID - attribute ID
+ *
+ * @return  none
+ */
+static void zclReportAttrChanged( uint8 endpoint, uint16 clusterID, uint16 attrID )
+{
+  zclAttrRec_t attrRec;
+  uint8 found = FALSE;
+  uint8 changed = FALSE;
+  uint8 i;
+
+  for ( i = 0; i < ZCL_MAX_REPORT_CFGS; i++ )
+  {
+    if ( ( zclReportCfgs[i].endpoint == endpoint ) &&
+         ( zclReportCfgs[i].clusterID == clusterID ) &&
+         ( zclReportCfgs[i].attrID == attrID ) &&
+         !( zclReportStates[i].flags & ZCL_REPORT_CHANGED ) )
+    {
+      if ( !found )
+      {
+        if ( !zclFindAttrRec( endpoint, clusterID, attrID, &attrRec ) )
+        {
+          return; // EMBEDDED RETURN
+        }
+
+        found = TRUE;
+      }
+
+      if ( zclReportChanged( i, &attrRec ) )
+      {
+        zclReportStates[i].flags |= ZCL_REPORT_CHANGED;
+        changed = TRUE;
+      }
+    }
+  }
+
+  if ( changed )
+  {
+    zclReportSchedule( zclReportClock() );
+  }
+}
+
+/*********************************************************************
+ * @fn      zclReportInitNV
+ *
+ * @brief   Restore the reporting configurations from NV, or write the
+ *          empty table to NV the first time.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+static void zclReportInitNV( void )
+{
+  uint32 now;
+  uint8 i;
+
+  if ( zcl_nv_item_init( ZCD_NV_REPORT_CFG_TABLE, sizeof( zclReportCfgs ), NULL ) == ZSUCCESS )
+  {
+    if ( zcl_nv_read( ZCD_NV_REPORT_CFG_TABLE, 0, sizeof( zclReportCfgs ), zclReportCfgs ) != ZSUCCESS )
+    {
+      zcl_memset( zclReportCfgs, 0, sizeof( zclReportCfgs ) );
+    }
+  }
+  else
+  {
+    zcl_nv_write( ZCD_NV_REPORT_CFG_TABLE, 0, sizeof( zclReportCfgs ), zclReportCfgs );
+  }
+
+  // The last reported values are unknown - report once the Minimum
+  // Reporting Intervals have expired
+  now = zclReportClock();
+  for ( i = 0; i < ZCL_MAX_REPORT_CFGS; i++ )
+  {
+    zclReportStates[i].lastReport = now;
+    zclReportStates[i].flags = ( zclReportCfgs[i].endpoint != 0 ) ? ZCL_REPORT_CHANGED : 0;
+  }
+
+  zclReportSchedule( now );
+}
+
+/*********************************************************************
+ * @fn      zclReportWriteNV
+ *
+ * @brief   Save a reporting configuration in NV
+ *
+ * @param   idx - reporting configuration index
+ *
+ * @return  none
+ */
+static void zclReportWriteNV( uint8 idx )
+{
+  zcl_nv_write( ZCD_NV_REPORT_CFG_TABLE, (uint16)idx * sizeof( zclReportCfg_t ),
+                sizeof( zclReportCfg_t ), &zclReportCfgs[idx] );
+}
+
+/*********************************************************************
+ * @fn      zclReportClock
+ *
+ * @brief   Read the report clock - the OSAL system clock, which the
+ *          intervals are measured against with wrap-around arithmetic
+ *
+ * @param   none
+ *
+ * @return  milliseconds
+ */
+static uint32 zclReportClock( void )
+{
+  return ( osal_GetSystemClock() );
+}
+
+/*********************************************************************
+ * @fn      zclReportFindCfg
+ *
+ * @brief   Find the reporting configuration of an attribute and
+ *          destination
+ *
+ * @param   pKey - endpoint, cluster, attribute and destination
+ *
+ * @return  configuration index, ZCL_MAX_REPORT_CFGS if not found
+ */
+static uint8 zclReportFindCfg( zclReportCfg_t *pKey )
+{
+  uint8 i;
+
+  for ( i = 0; i < ZCL_MAX_REPORT_CFGS; i++ )
+  {
+    if ( ( zclReportCfgs[i].endpoint == pKey->endpoint ) &&
+         ( zclReportCfgs[i].clusterID == pKey->clusterID ) &&
+         ( zclReportCfgs[i].attrID == pKey->attrID ) &&
+         zclReportSameDst( &zclReportCfgs[i], pKey ) )
+    {
+      break;
+    }
+  }
+
+  return ( i );
+}
+
+/*********************************************************************
+ * @fn      zclReportSameDst
+ *
+ * @brief   Check whether a reporting configuration reports from the
+ *          same endpoint and cluster to the same destination
+ *
+ * @param   pCfg - reporting configuration
+ * @param   pKey - endpoint, cluster and destination
+ *
+ * @return  TRUE if the reports can share a frame
+ */
+static uint8 zclReportSameDst( zclReportCfg_t *pCfg, zclReportCfg_t *pKey )
+{
+  return ( ( pCfg->endpoint == pKey->endpoint ) &&
+           ( pCfg->clusterID == pKey->clusterID ) &&
+           ( pCfg->dstAddrMode == pKey->dstAddrMode ) &&
+           ( ( pCfg->dstAddrMode == afAddrNotPresent ) ||
+             ( ( pCfg->dstAddr == pKey->dstAddr ) && ( pCfg->dstEP == pKey->dstEP ) ) ) );
+}
+
+/*********************************************************************
+ * @fn      zclReportChanged
+ *
+ * @brief   Check an attribute for a reportable change since its last
+ *          report: any change for discrete data types, at least the
+ *          Reportable Change for analog ones.
+ *
+ * @param   idx - reporting configuration index
+ * @param   pAttr - attribute record
+ *
+ * @return  TRUE if the attribute has to be reported
+ */
+static uint8 zclReportChanged( uint8 idx, zclAttrRec_t *pAttr )
+{
+  uint8 value[ZCL_REPORT_VALUE_LEN];
+  uint8 change[ZCL_REPORT_VALUE_LEN];
+  uint8 len;
+
+  len = zclGetDataTypeLength( pAttr->attr.dataType );
+  if ( ( len == 0 ) || ( len > ZCL_REPORT_VALUE_LEN ) )
+  {
+    return ( FALSE ); // EMBEDDED RETURN
+  }
+
+  len = (uint8)( zclSerializeData( pAttr->attr.dataType, pAttr->attr.dataPtr, value ) - value );
+  if ( len == 0 )
+  {
+    return ( FALSE ); // EMBEDDED RETURN
+  }
+
+  if ( zclAnalogDataType( pAttr->attr.dataType ) )
+  {
+    zclSerializeData( pAttr->attr.dataType, zclReportCfgs[idx].reportableChange, change );
+
+    return ( zclReportExceeds( pAttr->attr.dataType, value, zclReportStates[idx].lastValue,
+                               change, len ) ); // EMBEDDED RETURN
+  }
+
+  return ( !osal_memcmp( value, zclReportStates[idx].lastValue, len ) );
+}
+
+/*********************************************************************
+ * @fn      zclReportExceeds
+ *
+ * @brief   Check whether an analog value has moved by at least the
+ *          Reportable Change. Integers are compared a byte at a time
+ *          so that all lengths work without 64-bit arithmetic. Values
+ *          without a usable difference (double precision, time of day
+ *          and date) report any change.
+ *
+ * @param   dataType - analog data type
+ * @param   pNew - current value, over the air format
+ * @param   pOld - last reported value, over the air format
+ * @param   pChange - Reportable Change, over the air format
+ * @param   len - length of the values
+ *
+ * @return  TRUE if the value changed by at least the Reportable Change
+ */
+static uint8 zclReportExceeds( uint8 dataType, uint8 *pNew, uint8 *pOld, uint8 *pChange, uint8 len )
+{
+  uint8 a[ZCL_REPORT_VALUE_LEN];
+  uint8 b[ZCL_REPORT_VALUE_LEN];
+  uint8 *pHi;
+  uint8 *pLo;
+  uint16 diff;
+  uint8 borrow;
+  int8 i;
+
+  switch ( dataType )
+  {
+    case ZCL_DATATYPE_SEMI_PREC:
+    case ZCL_DATATYPE_SINGLE_PREC:
+      {
+        float fa;
+        float fb;
+        float fc;
+        uint32 bits[3];
+        uint8 *pVal[3];
+        uint8 n;
+
+        pVal[0] = pNew;
+        pVal[1] = pOld;
+        pVal[2] = pChange;
+        for ( n = 0; n < 3; n++ )
+        {
+          if ( dataType == ZCL_DATATYPE_SINGLE_PREC )
+          {
+            bits[n] = BUILD_UINT32( pVal[n][0], pVal[n][1], pVal[n][2], pVal[n][3] );
+          }
+          else
+          {
+            // Widen the half precision value (subnormals count as zero)
+            uint16 half = BUILD_UINT16( pVal[n][0], pVal[n][1] );
+            uint8 exp = ( half >> 10 ) & 0x1F;
+
+            bits[n] = (uint32)( half & 0x8000 ) << 16;
+            if ( exp == 0x1F )
+            {
+              bits[n] |= 0x7F800000 | ( (uint32)( half & 0x03FF ) << 13 );
+            }
+            else if ( exp != 0 )
+            {
+              bits[n] |= ( (uint32)( exp + 127 - 15 ) << 23 ) | ( (uint32)( half & 0x03FF ) << 13 );
+            }
+          }
+        }
+
+        zcl_memcpy( &fa, &bits[0], sizeof( float ) );
+        zcl_memcpy( &fb, &bits[1], sizeof( float ) );
+        zcl_memcpy( &fc, &bits[2], sizeof( float ) );
+
+        fa -= fb;
+        if ( fa < 0 )
+        {
+          fa = -fa;
+        }
+
+        return ( ( fa > 0 ) && ( fa >= fc ) ); // EMBEDDED RETURN
+      }
+
+    case ZCL_DATATYPE_DOUBLE_PREC:
+    case ZCL_DATATYPE_TOD:
+    case ZCL_DATATYPE_DATE:
+      return ( !osal_memcmp( pNew, pOld, len ) ); // EMBEDDED RETURN
+
+    default:
+      break;
+  }
+
+  // No change, even with a Reportable Change of zero
+  if ( osal_memcmp( pNew, pOld, len ) )
+  {
+    return ( FALSE ); // EMBEDDED RETURN
+  }
+
+  zcl_memcpy( a, pNew, len );
+  zcl_memcpy( b, pOld, len );
+
+  // Flipping the sign bits orders signed values like unsigned ones
+  if ( ( dataType >= ZCL_DATATYPE_INT8 ) && ( dataType <= ZCL_DATATYPE_INT64 ) )
+  {
+    a[len-1] ^= 0x80;
+    b[len-1] ^= 0x80;
+  }
+
+  // Subtract the smaller value from the larger one
+  pHi = a;
+  pLo = b;
+  for ( i = len - 1; i >= 0; i-- )
+  {
+    if ( a[i] != b[i] )
+    {
+      if ( a[i] < b[i] )
+      {
+        pHi = b;
+        pLo = a;
+      }
+      break;
+    }
+  }
+
+  borrow = 0;
+  for ( i = 0; i < (int8)len; i++ )
+  {
+    diff = (uint16)pHi[i] - pLo[i] - borrow;
+    borrow = ( diff > 0xFF ) ? 1 : 0;
+    a[i] = LO_UINT16( diff );
+  }
+
+  // Compare the difference with the Reportable Change
+  for ( i = len - 1; i >= 0; i-- )
+  {
+    if ( a[i] != pChange[i] )
+    {
+      return ( a[i] > pChange[i] ); // EMBEDDED RETURN
+    }
+  }
+
+  return ( TRUE );
+}
+
+/*********************************************************************
+ * @fn      zclReportProcess
+ *
+ * @brief   Send the reports that are due and restart the report timer
+ *          for the next ones.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+static void zclReportProcess( void )
+{
+  zclAttrRec_t attrRec;
+  uint32 now;
+  uint32 elapsed;
+  uint8 i;
+
+  now = zclReportClock();
+
+  for ( i = 0; i < ZCL_MAX_REPORT_CFGS; i++ )
+  {
+    zclReportCfg_t *pCfg = &zclReportCfgs[i];
+    zclReportState_t *pState = &zclReportStates[i];
+
+    if ( ( pCfg->endpoint == 0 ) ||
+         !zclFindAttrRec( pCfg->endpoint, pCfg->clusterID, pCfg->attrID, &attrRec ) )
+    {
+      continue;
+    }
+
+    // Catch the changes nobody told us about
+    if ( !( pState->flags & ZCL_REPORT_CHANGED ) && zclReportChanged( i, &attrRec ) )
+    {
+      pState->flags |= ZCL_REPORT_CHANGED;
+    }
+
+    elapsed = now - pState->lastReport;
+    if ( ( ( pState->flags & ZCL_REPORT_CHANGED ) &&
+           ( elapsed >= (uint32)pCfg->minReportInt * 1000 ) ) ||
+         ( ( pCfg->maxReportInt != 0 ) &&
+           ( elapsed >= (uint32)pCfg->maxReportInt * 1000 ) ) )
+    {
+      pState->flags |= ZCL_REPORT_DUE;
+    }
+  }
+
+  for ( i = 0; i < ZCL_MAX_REPORT_CFGS; i++ )
+  {
+    if ( zclReportStates[i].flags & ZCL_REPORT_DUE )
+    {
+      zclReportSend( i, now );
+    }
   }
 
-  return ( status );
+  zclReportSchedule( now );
 }
 
 /*********************************************************************
- * @fn      zcl_SendReportCmd
+ * @fn      zclReportSend
  *
- * @brief   Send a Report command
+ * @brief   Send the due reports of an endpoint and cluster to one
+ *          destination. zcl_SendReportCmd() splits them into as few
+ *          Report Attributes commands as the MTU allows.
  *
- * @param   dstAddr - destination address
- * @param   clusterID - cluster ID
- * @param   reportCmd - report command to be sent
- * @param   direction - direction of the command
- * @param   seqNum - transaction sequence number
+ * @param   idx - first due reporting configuration of the reports
+ * @param   now - report clock
  *
- * @return  ZSuccess if OK
+ * @return  none
  */
-ZStatus_t zcl_SendReportCmd( uint8 srcEP, afAddrType_t *dstAddr,
-                             uint16 clusterID, zclReportCmd_t *reportCmd,
-                             uint8 direction, uint8 disableDefaultRsp, uint8 seqNum )
+static void zclReportSend( uint8 idx, uint32 now )
 {
-  uint16 dataLen = 0;
-  uint8 *buf;
-  ZStatus_t status;
+  zclReportCfg_t *pKey = &zclReportCfgs[idx];
+  zclReportCmd_t *pReportCmd;
+  zclAttrRec_t attrRec;
+  afAddrType_t dstAddr;
+  uint8 numAttr = 0;
   uint8 i;
 
-  // calculate the size of the command
-  for ( i = 0; i < reportCmd->numAttr; i++ )
+  for ( i = idx; i < ZCL_MAX_REPORT_CFGS; i++ )
   {
-    zclReport_t *reportRec = &(reportCmd->attrList[i]);
+    if ( ( zclReportStates[i].flags & ZCL_REPORT_DUE ) && zclReportSameDst( &zclReportCfgs[i], pKey ) )
+    {
+      numAttr++;
+    }
+  }
 
-    dataLen += 2 + 1; // Attribute ID + data type
+  pReportCmd = (zclReportCmd_t *)zcl_mem_alloc( sizeof( zclReportCmd_t )
+                                                + ( numAttr * sizeof( zclReport_t ) ) );
 
-    // Attribute Data
-    dataLen += zclGetAttrDataLength( reportRec->dataType, reportRec->attrData );
+  dstAddr.addrMode = (afAddrMode_t)pKey->dstAddrMode;
+  dstAddr.addr.shortAddr = pKey->dstAddr;
+  dstAddr.endPoint = pKey->dstEP;
+  dstAddr.panId = 0;
+
+  numAttr = 0;
+  for ( i = idx; i < ZCL_MAX_REPORT_CFGS; i++ )
+  {
+    zclReportCfg_t *pCfg = &zclReportCfgs[i];
+    zclReportState_t *pState = &zclReportStates[i];
+
+    if ( !( pState->flags & ZCL_REPORT_DUE ) || !zclReportSameDst( pCfg, pKey ) )
+    {
+      continue;
+    }
+
+    // Reports that cannot be sent are dropped rather than retried
+    pState->flags &= ~( ZCL_REPORT_DUE | ZCL_REPORT_CHANGED );
+    pState->lastReport = now;
+
+    if ( ( pReportCmd == NULL ) ||
+         !zclFindAttrRec( pCfg->endpoint, pCfg->clusterID, pCfg->attrID, &attrRec ) )
+    {
+      continue;
+    }
+
+    pReportCmd->attrList[numAttr].attrID = attrRec.attr.attrId;
+    pReportCmd->attrList[numAttr].dataType = attrRec.attr.dataType;
+    pReportCmd->attrList[numAttr].attrData = attrRec.attr.dataPtr;
+    numAttr++;
+
+    if ( zclGetDataTypeLength( attrRec.attr.dataType ) <= ZCL_REPORT_VALUE_LEN )
+    {
+      zclSerializeData( attrRec.attr.dataType, attrRec.attr.dataPtr, pState->lastValue );
+    }
   }
 
-  buf = zcl_mem_alloc( dataLen );
-  if ( buf != NULL )
+  if ( pReportCmd != NULL )
   {
-    // Load the buffer - serially
-    uint8 *pBuf = buf;
+    if ( numAttr > 0 )
+    {
+      pReportCmd->numAttr = numAttr;
+      zcl_SendReportCmd( pKey->endpoint, &dstAddr, pKey->clusterID, pReportCmd,
+                         ZCL_FRAME_SERVER_CLIENT_DIR, TRUE, zcl_SeqNum++ );
+    }
+
+    zcl_mem_free( pReportCmd );
+  }
+}
+
+/*********************************************************************
+ * @fn      zclReportSchedule
+ *
+ * @brief   Start the report timer for the configuration whose interval
+ *          expires first: the Minimum Reporting Interval after a
+ *          reportable change, the Maximum Reporting Interval otherwise.
+ *
+ * @param   now - report clock
+ *
+ * @return  none
+ */
+static void zclReportSchedule( uint32 now )
+{
+  uint32 next = 0xFFFFFFFF;
+  uint32 interval;
+  uint32 elapsed;
+  uint8 i;
 
-    for ( i = 0; i < reportCmd->numAttr; i++ )
+  for ( i = 0; i < ZCL_MAX_REPORT_CFGS; i++ )
+  {
+    if ( zclReportCfgs[i].endpoint == 0 )
     {
-      zclReport_t *reportRec = &(reportCmd->attrList[i]);
+      continue;
+    }
 
-      *pBuf++ = LO_UINT16( reportRec->attrID );
-      *pBuf++ = HI_UINT16( reportRec->attrID );
-      *pBuf++ = reportRec->dataType;
+    if ( zclReportStates[i].flags & ZCL_REPORT_CHANGED )
+    {
+      interval = (uint32)zclReportCfgs[i].minReportInt * 1000;
+    }
+    else if ( zclReportCfgs[i].maxReportInt != 0 )
+    {
+      interval = (uint32)zclReportCfgs[i].maxReportInt * 1000;
+    }
+    else
+    {
+      continue;
+    }
 
-      pBuf = zclSerializeData( reportRec->dataType, reportRec->attrData, pBuf );
+    elapsed = now - zclReportStates[i].lastReport;
+    interval = ( elapsed < interval ) ? ( interval - elapsed ) : 0;
+    if ( interval < next )
+    {
+      next = interval;
     }
+  }
 
-    status = zcl_SendCommand( srcEP, dstAddr, clusterID, ZCL_CMD_REPORT, FALSE,
-                              direction, disableDefaultRsp, 0, seqNum, dataLen, buf );
-    zcl_mem_free( buf );
+  if ( next == 0xFFFFFFFF )
+  {
+    osal_stop_timerEx( zcl_TaskID, ZCL_REPORT_EVT );
+  }
+  else if ( next == 0 )
+  {
+    osal_stop_timerEx( zcl_TaskID, ZCL_REPORT_EVT );
+    osal_set_event( zcl_TaskID, ZCL_REPORT_EVT );
   }
   else
   {
-    status = ZMemError;
+    osal_start_timer_slack( zcl_TaskID, ZCL_REPORT_EVT, next, ZCL_REPORT_SLACK );
   }
-
-  return ( status );
 }
+#endif // ZCL_REPORTING
 #endif // ZCL_REPORT
 
 /*********************************************************************
@@ -1985,17 +3209,23 @@ void zcl_ProcessMessageMSG( afIncomingMSGPacket_t *pkt )
       status = ZCL_STATUS_UNSUP_MANU_GENERAL_COMMAND;
     }
     else if ( ( inMsg.hdr.commandID <= ZCL_CMD_MAX ) &&
-              ( zclCmdTable[inMsg.hdr.commandID].pfnParseInProfile != NULL ) )
+              ( ( zclCmdTable[inMsg.hdr.commandID].pfnParseInProfile != NULL ) ||
+                ( zclCmdTable[inMsg.hdr.commandID].pfnProcessInProfile != NULL ) ) )
     {
-      zclParseCmd_t parseCmd;
+      if ( zclCmdTable[inMsg.hdr.commandID].pfnParseInProfile != NULL )
+      {
+        zclParseCmd_t parseCmd;
+
+        parseCmd.endpoint = pkt->endPoint;
+        parseCmd.dataLen = inMsg.pDataLen;
+        parseCmd.pData = inMsg.pData;
 
-      parseCmd.endpoint = pkt->endPoint;
-      parseCmd.dataLen = inMsg.pDataLen;
-      parseCmd.pData = inMsg.pData;
+        // Parse the command, remember that the return value is a pointer to allocated memory
+        inMsg.attrCmd = zclParseCmd( inMsg.hdr.commandID, &parseCmd );
+      }
 
-      // Parse the command, remember that the return value is a pointer to allocated memory
-      inMsg.attrCmd = zclParseCmd( inMsg.hdr.commandID, &parseCmd );
-      if ( (inMsg.attrCmd != NULL) && (zclCmdTable[inMsg.hdr.commandID].pfnProcessInProfile != NULL) )
+      if ( ( (inMsg.attrCmd != NULL) || (zclCmdTable[inMsg.hdr.commandID].pfnParseInProfile == NULL) ) &&
+           (zclCmdTable[inMsg.hdr.commandID].pfnProcessInProfile != NULL) )
       {
         // Process the command
         if ( zclProcessCmd( inMsg.hdr.commandID, &inMsg ) == FALSE )
@@ -2158,6 +3388,24 @@ static uint8 *zclBuildHdr( zclFrameHdr_t *hdr, uint8 *pData )
   return ( pData );
 }
 
+
+/*********************************************************************
+ * @fn      zcl_ParseIterInit
+ *
+ * @brief   Start walking the records of a received command in place
+ *
+ * @param   pIter - iterator to initialize
+ * @param   pData - command payload
+ * @param   dataLen - length of the command payload
+ *
+ * @return  none
+ */
+void zcl_ParseIterInit( zclParseIter_t *pIter, uint8 *pData, uint16 dataLen )
+{
+  pIter->pData = pData;
+  pIter->pEnd = pData + dataLen;
+}
+
 /*********************************************************************
  * @fn      zclCalcHdrSize
  *
@@ -2297,6 +3545,158 @@ static zclAttrRecsList *zclFindAttrRecsList( uint8 endpoint )
   return ( NULL );
 }
 
+#if ZCL_ATTR_INDEX
+/*********************************************************************
+ * @fn      zclBuildAttrIndex
+ *
+ * @brief   Build the index of an attribute record list: the record
+ *          positions sorted by cluster ID and then attribute ID, and
+ *          where each cluster starts in them. Without the heap memory
+ *          for it the list is left without an index and is searched
+ *          record by record.
+ *
+ * @param   pRec - attribute record list
+ *
+ * @return  none
+ */
+static void zclBuildAttrIndex( zclAttrRecsList *pRec )
+{
+  CONST zclAttrRec_t *pAttr;
+  CONST zclAttrRec_t *pPrev;
+  uint8 *index;
+  uint8 numClusters;
+  uint8 x, y;
+
+  pRec->index = NULL;
+  pRec->clusters = NULL;
+  pRec->numClusters = 0;
+
+  if ( pRec->numAttributes == 0 )
+  {
+    return;
+  }
+
+  index = zcl_mem_alloc( pRec->numAttributes );
+  if ( index == NULL )
+  {
+    return;
+  }
+
+  // Insertion sort - stable, so that the first of any duplicate records is
+  // still the one found, and quick on lists that are mostly in order.
+  numClusters = 1;
+  for ( x = 0; x < pRec->numAttributes; x++ )
+  {
+    pAttr = &(pRec->attrs[x]);
+
+    for ( y = x; y > 0; y-- )
+    {
+      pPrev = &(pRec->attrs[index[y-1]]);
+      if ( ( pPrev->clusterID < pAttr->clusterID ) ||
+           ( ( pPrev->clusterID == pAttr->clusterID ) && ( pPrev->attr.attrId <= pAttr->attr.attrId ) ) )
+      {
+        break;
+      }
+      index[y] = index[y-1];
+    }
+    index[y] = x;
+  }
+
+  for ( x = 1; x < pRec->numAttributes; x++ )
+  {
+    if ( pRec->attrs[index[x]].clusterID != pRec->attrs[index[x-1]].clusterID )
+    {
+      numClusters++;
+    }
+  }
+
+  pRec->clusters = zcl_mem_alloc( numClusters * sizeof( zclAttrIdxCluster_t ) );
+  if ( pRec->clusters == NULL )
+  {
+    zcl_mem_free( index );
+    return;
+  }
+
+  for ( x = 0, y = 0; x < pRec->numAttributes; x++ )
+  {
+    if ( ( x == 0 ) || ( pRec->attrs[index[x]].clusterID != pRec->attrs[index[x-1]].clusterID ) )
+    {
+      pRec->clusters[y].clusterID = pRec->attrs[index[x]].clusterID;
+      pRec->clusters[y].first = x;
+      y++;
+    }
+  }
+
+  pRec->numClusters = numClusters;
+  pRec->index = index;
+}
+
+/*********************************************************************
+ * @fn      zclFindAttrIndex
+ *
+ * @brief   Binary search of an attribute record list's index for the
+ *          first attribute of a cluster with an ID of at least attrId.
+ *
+ * @param   pRec - attribute record list with an index
+ * @param   clusterID - cluster ID
+ * @param   attrId - lowest attribute ID looking for
+ * @param   pEnd - index position after the cluster's last attribute
+ *
+ * @return  index position of the attribute, *pEnd if there is none
+ */
+static uint8 zclFindAttrIndex( zclAttrRecsList *pRec, uint16 clusterID, uint16 attrId, uint8 *pEnd )
+{
+  uint8 lo = 0;
+  uint8 hi = pRec->numClusters;
+  uint8 mid;
+
+  while ( lo < hi )
+  {
+    mid = lo + ( ( hi - lo ) >> 1 );
+    if ( pRec->clusters[mid].clusterID < clusterID )
+    {
+      lo = mid + 1;
+    }
+    else
+    {
+      hi = mid;
+    }
+  }
+
+  if ( ( lo == pRec->numClusters ) || ( pRec->clusters[lo].clusterID != clusterID ) )
+  {
+    *pEnd = 0;
+    return ( 0 ); // EMBEDDED RETURN
+  }
+
+  if ( lo + 1 < pRec->numClusters )
+  {
+    hi = pRec->clusters[lo + 1].first;
+  }
+  else
+  {
+    hi = pRec->numAttributes;
+  }
+  lo = pRec->clusters[lo].first;
+  *pEnd = hi;
+
+  while ( lo < hi )
+  {
+    mid = lo + ( ( hi - lo ) >> 1 );
+    if ( pRec->attrs[pRec->index[mid]].attr.attrId < attrId )
+    {
+      lo = mid + 1;
+    }
+    else
+    {
+      hi = mid;
+    }
+  }
+
+  return ( lo );
+}
+#endif // ZCL_ATTR_INDEX
+
 /*********************************************************************
  * @fn      zclFindAttrRec
  *
@@ -2316,20 +3716,131 @@ uint8 zclFindAttrRec( uint8 endpoint, uint16 clusterID, uint16 attrId, zclAttrRe
 
   if ( pRec != NULL )
   {
-    for ( x = 0; x < pRec->numAttributes; x++ )
+    x = zclFindAttrPos( pRec, clusterID, attrId );
+    if ( x < pRec->numAttributes )
     {
-      if ( pRec->attrs[x].clusterID == clusterID && pRec->attrs[x].attr.attrId == attrId )
-      {
-        *pAttr = pRec->attrs[x];
+      *pAttr = pRec->attrs[x];
 
-        return ( TRUE ); // EMBEDDED RETURN
-      }
+      return ( TRUE ); // EMBEDDED RETURN
     }
   }
 
   return ( FALSE );
 }
 
+/*********************************************************************
+ * @fn      zclFindAttrPos
+ *
+ * @brief   Find the position of an attribute in an attribute list
+ *
+ * @param   pRec - attribute list
+ * @param   clusterID - cluster ID
+ * @param   attrId - attribute looking for
+ *
+ * @return  position in pRec->attrs, pRec->numAttributes if not found
+ */
+static uint8 zclFindAttrPos( zclAttrRecsList *pRec, uint16 clusterID, uint16 attrId )
+{
+  uint8 x;
+
+#if ZCL_ATTR_INDEX
+  if ( pRec->index != NULL )
+  {
+    uint8 end;
+
+    x = zclFindAttrIndex( pRec, clusterID, attrId, &end );
+    if ( ( x < end ) && ( pRec->attrs[pRec->index[x]].attr.attrId == attrId ) )
+    {
+      return ( pRec->index[x] ); // EMBEDDED RETURN
+    }
+
+    return ( pRec->numAttributes ); // EMBEDDED RETURN
+  }
+#endif
+
+  for ( x = 0; x < pRec->numAttributes; x++ )
+  {
+    if ( pRec->attrs[x].clusterID == clusterID && pRec->attrs[x].attr.attrId == attrId )
+    {
+      break;
+    }
+  }
+
+  return ( x );
+}
+
+/*********************************************************************
+ * @fn      zclAttrChangeNotify
+ *
+ * @brief   Tell the consumers of attribute changes that an attribute
+ *          has changed
+ *
+ * @param   pRec - attribute list
+ * @param   pos - position of the attribute in pRec->attrs
+ *
+ * @return  none
+ */
+static void zclAttrChangeNotify( zclAttrRecsList *pRec, uint8 pos )
+{
+  CONST zclAttrRec_t *pAttr = &(pRec->attrs[pos]);
+
+#if defined ( ZCL_REPORT ) && ZCL_REPORTING
+  zclReportAttrChanged( pRec->endpoint, pAttr->clusterID, pAttr->attr.attrId );
+#endif
+
+  if ( pRec->pfnAttrChangeCB != NULL )
+  {
+    pRec->pfnAttrChangeCB( pRec->endpoint, pAttr->clusterID, pAttr->attr.attrId );
+  }
+}
+
+#if !defined ( ZCL_STANDALONE )
+/*********************************************************************
+ * @fn      zclAttrChangeProcess
+ *
+ * @brief   Deliver the attribute changes collected since the last call
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+static void zclAttrChangeProcess( void )
+{
+  zclAttrRecsList *pRec;
+  uint8 bits;
+  uint8 pos;
+  uint8 i;
+
+  for ( pRec = attrList; pRec != NULL; pRec = pRec->next )
+  {
+    if ( pRec->dirty == NULL )
+    {
+      continue;
+    }
+
+    for ( i = 0; i < ( (uint16)pRec->numAttributes + 7 ) / 8; i++ )
+    {
+      bits = pRec->dirty[i];
+      if ( bits == 0 )
+      {
+        continue;
+      }
+
+      // Clear first so that changes made by the consumers are kept
+      pRec->dirty[i] = 0;
+
+      for ( pos = i * 8; bits != 0; pos++, bits >>= 1 )
+      {
+        if ( bits & 0x01 )
+        {
+          zclAttrChangeNotify( pRec, pos );
+        }
+      }
+    }
+  }
+}
+#endif // ZCL_STANDALONE
+
 #if defined ( ZCL_READ ) || defined ( ZCL_WRITE )
 /*********************************************************************
  * @fn      zclGetReadWriteCB
@@ -2569,6 +4080,31 @@ static uint8 zclFindNextAttrRec( uint8 endpoint, uint16 clusterID, uint8 directi
 
   if ( pRec != NULL )
   {
+#if ZCL_ATTR_INDEX
+    if ( pRec->index != NULL )
+    {
+      CONST zclAttrRec_t *pFound;
+      uint8 x, end;
+
+      // The cluster's attributes are in ascending order from here on
+      for ( x = zclFindAttrIndex( pRec, clusterID, *attrId, &end ); x < end; x++ )
+      {
+        pFound = &(pRec->attrs[pRec->index[x]]);
+        attrDir = (pFound->attr.accessControl & ACCESS_CLIENT) ? 1 : 0;
+        if ( attrDir == direction )
+        {
+          // return attribute and found attribute ID
+          *pAttr = *pFound;
+          *attrId = pAttr->attr.attrId;
+
+          return ( TRUE ); // EMBEDDED RETURN
+        }
+      }
+
+      return ( FALSE ); // EMBEDDED RETURN
+    }
+#endif
+
     for ( uint16 x = 0; x < pRec->numAttributes; x++ )
     {
       if ( ( pRec->attrs[x].clusterID == clusterID ) &&
@@ -3115,6 +4651,7 @@ static ZStatus_t zclWriteAttrData( uint8 endpoint, afAddrType_t *srcAddr,
         // Write the attribute value
         uint16 len = zclGetAttrDataLength( pAttr->attr.dataType, pWriteRec->attrData );
         zcl_memcpy( pAttr->attr.dataPtr, pWriteRec->attrData, len );
+        zcl_AttrChanged( endpoint, pAttr->clusterID, pAttr->attr.attrId );
 
         status = ZCL_STATUS_SUCCESS;
       }
@@ -3160,6 +4697,10 @@ static ZStatus_t zclWriteAttrDataUsingCB( uint8 endpoint, afAddrType_t *srcAddr,
         // Write the attribute value
         status = (*pfnReadWriteCB)( pAttr->clusterID, pAttr->attr.attrId,
                                     ZCL_OPER_WRITE, pAttrData, NULL );
+        if ( status == ZCL_STATUS_SUCCESS )
+        {
+          zcl_AttrChanged( endpoint, pAttr->clusterID, pAttr->attr.attrId );
+        }
       }
       else
       {
@@ -3237,6 +4778,31 @@ void *zclParseInReadCmd( zclParseCmd_t *pCmd )
   return ( (void *)readCmd );
 }
 
+/*********************************************************************
+ * @fn      zcl_ParseNextAttrID
+ *
+ * @brief   Get the next attribute ID of a received Read Command
+ *
+ * @param   pIter - iterator over the command payload
+ * @param   pAttrID - where to put the attribute ID
+ *
+ * @return  TRUE if there was one. FALSE at the end of the command.
+ */
+uint8 zcl_ParseNextAttrID( zclParseIter_t *pIter, uint16 *pAttrID )
+{
+  uint8 *pBuf = pIter->pData;
+
+  if ( pIter->pEnd - pBuf < 2 )
+  {
+    return ( FALSE ); // EMBEDDED RETURN
+  }
+
+  *pAttrID = BUILD_UINT16( pBuf[0], pBuf[1] );
+  pIter->pData = pBuf + 2;
+
+  return ( TRUE );
+}
+
 /*********************************************************************
  * @fn      zclParseInReadRspCmd
  *
@@ -3413,6 +4979,67 @@ void *zclParseInWriteCmd( zclParseCmd_t *pCmd )
   return ( (void *)writeCmd );
 }
 
+/*********************************************************************
+ * @fn      zcl_ParseNextWriteRec
+ *
+ * @brief   Get the next record of a received Write, Write Undivided or
+ *          Write No Response Command. The attribute data of the record
+ *          is left in the command payload, unaligned.
+ *
+ * @param   pIter - iterator over the command payload
+ * @param   pRec - where to put the record
+ *
+ * @return  TRUE if there was a complete one. FALSE at the end of the
+ *          command.
+ */
+uint8 zcl_ParseNextWriteRec( zclParseIter_t *pIter, zclWriteRec_t *pRec )
+{
+  uint8 *pBuf = pIter->pData;
+  uint16 attrDataLen;
+
+  if ( pIter->pEnd - pBuf < 3 )
+  {
+    return ( FALSE ); // EMBEDDED RETURN
+  }
+
+  pRec->attrID = BUILD_UINT16( pBuf[0], pBuf[1] );
+  pRec->dataType = pBuf[2];
+  pRec->attrData = pBuf + 3;
+
+  // A string starts with its length, which must be in the payload to be read
+  switch ( pRec->dataType )
+  {
+    case ZCL_DATATYPE_CHAR_STR:
+    case ZCL_DATATYPE_OCTET_STR:
+      attrDataLen = 1;
+      break;
+
+    case ZCL_DATATYPE_LONG_CHAR_STR:
+    case ZCL_DATATYPE_LONG_OCTET_STR:
+      attrDataLen = 2;
+      break;
+
+    default:
+      attrDataLen = 0;
+      break;
+  }
+
+  if ( pIter->pEnd - pRec->attrData < attrDataLen )
+  {
+    return ( FALSE ); // EMBEDDED RETURN
+  }
+
+  attrDataLen = zclGetAttrDataLength( pRec->dataType, pRec->attrData );
+  if ( pIter->pEnd - pRec->attrData < attrDataLen )
+  {
+    return ( FALSE ); // EMBEDDED RETURN
+  }
+
+  pIter->pData = pRec->attrData + attrDataLen;
+
+  return ( TRUE );
+}
+
 /*********************************************************************
  * @fn      zclParseInWriteRspCmd
  *
@@ -3509,10 +5136,6 @@ void *zclParseInConfigReportCmd( zclParseCmd_t *pCmd )
 
         dataLen += reportChangeLen;
       }
-      else
-      {
-        pBuf++; // move past reportable change field
-      }
     }
     else
     {
@@ -3786,6 +5409,46 @@ static void *zclParseInReadReportCfgRspCmd( zclParseCmd_t *pCmd )
  * @return  pointer to the parsed command structure
  */
 void *zclParseInReportCmd( zclParseCmd_t *pCmd )
+{
+  return ( zclParseReportCmd( pCmd, TRUE ) );
+}
+
+#if ZCL_REPORT_ZERO_COPY
+/*********************************************************************
+ * @fn      zclParseInReportCmdRef
+ *
+ * @brief   Parse the "Profile" Report Command without copying the
+ *          attribute data - the records point into the incoming data,
+ *          which the caller has to keep for as long as they are used.
+ *
+ *      NOTE: THIS FUNCTION ALLOCATES THE RETURN BUFFER, SO THE CALLING
+ *            FUNCTION IS RESPONSIBLE TO FREE THE MEMORY.
+ *
+ * @param   pCmd - pointer to incoming data to parse
+ *
+ * @return  pointer to the parsed command structure
+ */
+static void *zclParseInReportCmdRef( zclParseCmd_t *pCmd )
+{
+  return ( zclParseReportCmd( pCmd, FALSE ) );
+}
+#endif
+
+/*********************************************************************
+ * @fn      zclParseReportCmd
+ *
+ * @brief   Parse the "Profile" Report Command
+ *
+ *      NOTE: THIS FUNCTION ALLOCATES THE RETURN BUFFER, SO THE CALLING
+ *            FUNCTION IS RESPONSIBLE TO FREE THE MEMORY.
+ *
+ * @param   pCmd - pointer to incoming data to parse
+ * @param   copy - TRUE to copy the attribute data into the returned
+ *                 buffer, FALSE to point to it in the incoming data
+ *
+ * @return  pointer to the parsed command structure
+ */
+static void *zclParseReportCmd( zclParseCmd_t *pCmd, uint8 copy )
 {
   zclReportCmd_t *reportCmd;
   uint8 *pBuf = pCmd->pData;
@@ -3808,13 +5471,16 @@ void *zclParseInReportCmd( zclParseCmd_t *pCmd )
     attrDataLen = zclGetAttrDataLength( dataType, pBuf );
     pBuf += attrDataLen; // move pass attribute data
 
-    // add padding if needed
-    if ( PADDING_NEEDED( attrDataLen ) )
+    if ( copy )
     {
-      attrDataLen++;
-    }
+      // add padding if needed
+      if ( PADDING_NEEDED( attrDataLen ) )
+      {
+        attrDataLen++;
+      }
 
-    dataLen += attrDataLen;
+      dataLen += attrDataLen;
+    }
   }
 
   hdrLen = sizeof( zclReportCmd_t ) + ( numAttr * sizeof( zclReport_t ) );
@@ -3836,6 +5502,13 @@ void *zclParseInReportCmd( zclParseCmd_t *pCmd )
       reportRec->dataType = *pBuf++;
 
       attrDataLen = zclGetAttrDataLength( reportRec->dataType, pBuf );
+      if ( !copy )
+      {
+        reportRec->attrData = pBuf;
+        pBuf += attrDataLen; // move pass attribute data
+        continue;
+      }
+
       zcl_memcpy( dataPtr, pBuf, attrDataLen );
       reportRec->attrData = dataPtr;
 
@@ -4065,61 +5738,94 @@ static void *zclParseInDiscAttrsExtRspCmd( zclParseCmd_t *pCmd )
  */
 static uint8 zclProcessInReadCmd( zclIncoming_t *pInMsg )
 {
-  zclReadCmd_t *readCmd;
-  zclReadRspCmd_t *readRspCmd;
-  zclAttrRec_t attrRec;
-  uint16 len;
-  uint8 i;
-
-  readCmd = (zclReadCmd_t *)pInMsg->attrCmd;
+  zclReadRspStatus_t statusRec;
+  zclParseIter_t iter;
+  zclFrame_t frame;
+  uint16 len = 0;
+  uint16 attrID;
 
-  // calculate the length of the response status record
-  len = sizeof( zclReadRspCmd_t ) + (readCmd->numAttr * sizeof( zclReadRspStatus_t ));
+  // Size the response for the readable attributes, leaving out the
+  // authorization, which may only turn records into shorter ones
+  zcl_ParseIterInit( &iter, pInMsg->pData, pInMsg->pDataLen );
+  while ( zcl_ParseNextAttrID( &iter, &attrID ) )
+  {
+    zclReadAttrStatus( pInMsg, attrID, FALSE, &statusRec );
+    len += zclReadRspStatusLen( pInMsg->msg->endPoint, pInMsg->msg->clusterId, &statusRec );
+  }
 
-  readRspCmd = zcl_mem_alloc( len );
-  if ( readRspCmd == NULL )
+  if ( zclFrameStart( &frame, pInMsg->msg->endPoint, &(pInMsg->msg->srcAddr),
+                      pInMsg->msg->clusterId, ZCL_CMD_READ_RSP, FALSE,
+                      !pInMsg->hdr.fc.direction, true, 0, pInMsg->hdr.transSeqNum,
+                      len, TRUE ) != ZSuccess )
   {
     return FALSE; // EMBEDDED RETURN
   }
 
-  readRspCmd->numAttr = readCmd->numAttr;
-  for ( i = 0; i < readCmd->numAttr; i++ )
+  // Build the Read Response command straight in the frame
+  zcl_ParseIterInit( &iter, pInMsg->pData, pInMsg->pDataLen );
+  while ( zcl_ParseNextAttrID( &iter, &attrID ) )
   {
-    zclReadRspStatus_t *statusRec = &(readRspCmd->attrList[i]);
+    zclReadAttrStatus( pInMsg, attrID, TRUE, &statusRec );
+    if ( zclFrameAddReadRspStatus( &frame, pInMsg->msg->endPoint, pInMsg->msg->clusterId,
+                                   &statusRec ) != ZSuccess )
+    {
+      zcl_mem_free( frame.buf );
+
+      return FALSE; // EMBEDDED RETURN
+    }
+  }
 
-    statusRec->attrID = readCmd->attrID[i];
+  zclFrameSend( &frame );
 
-    if ( zclFindAttrRec( pInMsg->msg->endPoint, pInMsg->msg->clusterId,
-                         readCmd->attrID[i], &attrRec ) )
+  return TRUE;
+}
+
+/*********************************************************************
+ * @fn      zclReadAttrStatus
+ *
+ * @brief   Fill in the Read Attribute Status record of an attribute
+ *
+ * @param   pInMsg - incoming Read command
+ * @param   attrID - attribute to read
+ * @param   authorize - whether to ask the application to authorize the read
+ * @param   statusRec - record to fill in
+ *
+ * @return  none
+ */
+static void zclReadAttrStatus( zclIncoming_t *pInMsg, uint16 attrID, uint8 authorize,
+                               zclReadRspStatus_t *statusRec )
+{
+  zclAttrRec_t attrRec;
+
+  statusRec->attrID = attrID;
+
+  if ( zclFindAttrRec( pInMsg->msg->endPoint, pInMsg->msg->clusterId,
+                       attrID, &attrRec ) )
+  {
+    if ( zcl_AccessCtrlRead( attrRec.attr.accessControl ) )
     {
-      if ( zcl_AccessCtrlRead( attrRec.attr.accessControl ) )
+      statusRec->status = ZCL_STATUS_SUCCESS;
+      if ( authorize )
       {
         statusRec->status = zclAuthorizeRead( pInMsg->msg->endPoint,
                                               &(pInMsg->msg->srcAddr), &attrRec );
-        if ( statusRec->status == ZCL_STATUS_SUCCESS )
-        {
-          statusRec->data = attrRec.attr.dataPtr;
-          statusRec->dataType = attrRec.attr.dataType;
-        }
       }
-      else
+
+      if ( statusRec->status == ZCL_STATUS_SUCCESS )
       {
-        statusRec->status = ZCL_STATUS_WRITE_ONLY;
+        statusRec->data = attrRec.attr.dataPtr;
+        statusRec->dataType = attrRec.attr.dataType;
       }
     }
     else
     {
-      statusRec->status = ZCL_STATUS_UNSUPPORTED_ATTRIBUTE;
+      statusRec->status = ZCL_STATUS_WRITE_ONLY;
     }
   }
-
-  // Build and send Read Response command
-  zcl_SendReadRsp( pInMsg->msg->endPoint, &(pInMsg->msg->srcAddr), pInMsg->msg->clusterId,
-                   readRspCmd, !pInMsg->hdr.fc.direction,
-                   true, pInMsg->hdr.transSeqNum );
-  zcl_mem_free( readRspCmd );
-
-  return TRUE;
+  else
+  {
+    statusRec->status = ZCL_STATUS_UNSUPPORTED_ATTRIBUTE;
+  }
 }
 #endif // ZCL_READ
 
@@ -4135,38 +5841,45 @@ static uint8 zclProcessInReadCmd( zclIncoming_t *pInMsg )
  */
 static uint8 zclProcessInWriteCmd( zclIncoming_t *pInMsg )
 {
-  zclWriteCmd_t *writeCmd;
-  zclWriteRspCmd_t *writeRspCmd;
-  uint8 sendRsp = FALSE;
-  uint8 j = 0;
-  uint8 i;
+  zclWriteRec_t writeRec;
+  zclParseIter_t iter;
+  zclFrame_t frame;
+  uint8 *pRsp = NULL;
 
-  writeCmd = (zclWriteCmd_t *)pInMsg->attrCmd;
   if ( pInMsg->hdr.commandID == ZCL_CMD_WRITE )
   {
-    // We need to send a response back - allocate space for it
-    writeRspCmd = (zclWriteRspCmd_t *)zcl_mem_alloc( sizeof( zclWriteRspCmd_t )
-            + sizeof( zclWriteRspStatus_t ) * writeCmd->numAttr );
-    if ( writeRspCmd == NULL )
+    uint16 len = pInMsg->pDataLen;
+
+    // We need to send a response back - a write record is never shorter
+    // than its status record
+    if ( len == 0 )
+    {
+      len = 1;
+    }
+
+    if ( zclFrameStart( &frame, pInMsg->msg->endPoint, &(pInMsg->msg->srcAddr),
+                        pInMsg->msg->clusterId, ZCL_CMD_WRITE_RSP, FALSE,
+                        !pInMsg->hdr.fc.direction, true, 0, pInMsg->hdr.transSeqNum,
+                        len, FALSE ) != ZSuccess )
     {
       return FALSE; // EMBEDDED RETURN
     }
 
-    sendRsp = TRUE;
+    pRsp = frame.pData;
   }
 
-  for ( i = 0; i < writeCmd->numAttr; i++ )
+  zcl_ParseIterInit( &iter, pInMsg->pData, pInMsg->pDataLen );
+  while ( zcl_ParseNextWriteRec( &iter, &writeRec ) )
   {
     zclAttrRec_t attrRec;
-    zclWriteRec_t *statusRec = &(writeCmd->attrList[i]);
+    zclWriteRec_t *statusRec = &writeRec;
+    uint8 status;
 
     if ( zclFindAttrRec( pInMsg->msg->endPoint, pInMsg->msg->clusterId,
                          statusRec->attrID, &attrRec ) )
     {
       if ( statusRec->dataType == attrRec.attr.dataType )
       {
-        uint8 status;
-
         // Write the new attribute value
         if ( attrRec.attr.dataPtr != NULL )
         {
@@ -4178,52 +5891,39 @@ static uint8 zclProcessInWriteCmd( zclIncoming_t *pInMsg )
           status = zclWriteAttrDataUsingCB( pInMsg->msg->endPoint, &(pInMsg->msg->srcAddr),
                                             &attrRec, statusRec->attrData );
         }
-
-        // If successful, a write attribute status record shall NOT be generated
-        if ( sendRsp && status != ZCL_STATUS_SUCCESS )
-        {
-          // Attribute is read only - move on to the next write attribute record
-          writeRspCmd->attrList[j].status = status;
-          writeRspCmd->attrList[j++].attrID = statusRec->attrID;
-        }
       }
       else
       {
-        // Attribute data type is incorrect - move on to the next write attribute record
-        if ( sendRsp )
-        {
-          writeRspCmd->attrList[j].status = ZCL_STATUS_INVALID_DATA_TYPE;
-          writeRspCmd->attrList[j++].attrID = statusRec->attrID;
-        }
+        // Attribute data type is incorrect
+        status = ZCL_STATUS_INVALID_DATA_TYPE;
       }
     }
     else
     {
-      // Attribute is not supported - move on to the next write attribute record
-      if ( sendRsp )
-      {
-        writeRspCmd->attrList[j].status = ZCL_STATUS_UNSUPPORTED_ATTRIBUTE;
-        writeRspCmd->attrList[j++].attrID = statusRec->attrID;
-      }
+      // Attribute is not supported
+      status = ZCL_STATUS_UNSUPPORTED_ATTRIBUTE;
     }
-  } // for loop
 
-  if ( sendRsp )
+    // If successful, a write attribute status record shall NOT be generated
+    if ( ( pRsp != NULL ) && ( status != ZCL_STATUS_SUCCESS ) )
+    {
+      *frame.pData++ = status;
+      *frame.pData++ = LO_UINT16( statusRec->attrID );
+      *frame.pData++ = HI_UINT16( statusRec->attrID );
+    }
+  }
+
+  if ( pRsp != NULL )
   {
-    writeRspCmd->numAttr = j;
-    if ( writeRspCmd->numAttr == 0 )
+    if ( frame.pData == pRsp )
     {
       // Since all records were written successful, include a single status record
       // in the resonse command with the status field set to SUCCESS and the
       // attribute ID field omitted.
-      writeRspCmd->attrList[0].status = ZCL_STATUS_SUCCESS;
-      writeRspCmd->numAttr = 1;
+      *frame.pData++ = ZCL_STATUS_SUCCESS;
     }
 
-    zcl_SendWriteRsp( pInMsg->msg->endPoint, &(pInMsg->msg->srcAddr),
-                      pInMsg->msg->clusterId, writeRspCmd, !pInMsg->hdr.fc.direction,
-                      true, pInMsg->hdr.transSeqNum );
-    zcl_mem_free( writeRspCmd );
+    zclFrameSend( &frame );
   }
 
   return TRUE;
@@ -4456,6 +6156,161 @@ static uint8 zclProcessInWriteUndividedCmd( zclIncoming_t *pInMsg )
 }
 #endif // ZCL_WRITE
 
+#if defined ( ZCL_REPORT ) && ZCL_REPORTING
+/*********************************************************************
+ * @fn      zclProcessInConfigReportCmd
+ *
+ * @brief   Process the "Profile" Configure Reporting Command. Reports
+ *          configured over the air go to the bound devices. Commands
+ *          about reports to be received are left to the application.
+ *
+ * @param   pInMsg - incoming message to process
+ *
+ * @return  TRUE if command processed. FALSE, otherwise.
+ */
+static uint8 zclProcessInConfigReportCmd( zclIncoming_t *pInMsg )
+{
+  zclCfgReportCmd_t *cfgReportCmd;
+  zclCfgReportRspCmd_t *cfgReportRspCmd;
+  afAddrType_t dstAddr;
+  uint8 allSuccess = TRUE;
+  uint8 i;
+
+  cfgReportCmd = (zclCfgReportCmd_t *)pInMsg->attrCmd;
+
+  for ( i = 0; i < cfgReportCmd->numAttr; i++ )
+  {
+    if ( cfgReportCmd->attrList[i].direction != ZCL_SEND_ATTR_REPORTS )
+    {
+      return ( zcl_HandleExternal( pInMsg ) ); // EMBEDDED RETURN
+    }
+  }
+
+  cfgReportRspCmd = (zclCfgReportRspCmd_t *)zcl_mem_alloc( sizeof( zclCfgReportRspCmd_t )
+                                  + ( cfgReportCmd->numAttr * sizeof( zclCfgReportStatus_t ) ) );
+  if ( cfgReportRspCmd == NULL )
+  {
+    return FALSE; // EMBEDDED RETURN
+  }
+
+  zcl_memset( &dstAddr, 0, sizeof( afAddrType_t ) );
+  dstAddr.addrMode = afAddrNotPresent;
+
+  cfgReportRspCmd->numAttr = cfgReportCmd->numAttr;
+  for ( i = 0; i < cfgReportCmd->numAttr; i++ )
+  {
+    zclCfgReportStatus_t *statusRec = &(cfgReportRspCmd->attrList[i]);
+
+    statusRec->status = zcl_ConfigReport( pInMsg->msg->endPoint, pInMsg->msg->clusterId,
+                                          &dstAddr, &(cfgReportCmd->attrList[i]) );
+    statusRec->direction = cfgReportCmd->attrList[i].direction;
+    statusRec->attrID = cfgReportCmd->attrList[i].attrID;
+
+    if ( statusRec->status != ZCL_STATUS_SUCCESS )
+    {
+      allSuccess = FALSE;
+    }
+  }
+
+  // A single status record tells that all attributes were configured
+  if ( allSuccess )
+  {
+    cfgReportRspCmd->numAttr = 1;
+  }
+
+  zcl_SendConfigReportRspCmd( pInMsg->msg->endPoint, &(pInMsg->msg->srcAddr),
+                              pInMsg->msg->clusterId, cfgReportRspCmd,
+                              !pInMsg->hdr.fc.direction, true, pInMsg->hdr.transSeqNum );
+  zcl_mem_free( cfgReportRspCmd );
+
+  return TRUE;
+}
+
+/*********************************************************************
+ * @fn      zclProcessInReadReportCfgCmd
+ *
+ * @brief   Process the "Profile" Read Reporting Configuration Command.
+ *          Commands about reports to be received are left to the
+ *          application.
+ *
+ * @param   pInMsg - incoming message to process
+ *
+ * @return  TRUE if command processed. FALSE, otherwise.
+ */
+static uint8 zclProcessInReadReportCfgCmd( zclIncoming_t *pInMsg )
+{
+  zclReadReportCfgCmd_t *readReportCfgCmd;
+  zclReadReportCfgRspCmd_t *readReportCfgRspCmd;
+  zclReportCfg_t key;
+  zclAttrRec_t attrRec;
+  uint8 idx;
+  uint8 i;
+
+  readReportCfgCmd = (zclReadReportCfgCmd_t *)pInMsg->attrCmd;
+
+  for ( i = 0; i < readReportCfgCmd->numAttr; i++ )
+  {
+    if ( readReportCfgCmd->attrList[i].direction != ZCL_SEND_ATTR_REPORTS )
+    {
+      return ( zcl_HandleExternal( pInMsg ) ); // EMBEDDED RETURN
+    }
+  }
+
+  readReportCfgRspCmd = (zclReadReportCfgRspCmd_t *)zcl_mem_alloc( sizeof( zclReadReportCfgRspCmd_t )
+                           + ( readReportCfgCmd->numAttr * sizeof( zclReportCfgRspRec_t ) ) );
+  if ( readReportCfgRspCmd == NULL )
+  {
+    return FALSE; // EMBEDDED RETURN
+  }
+
+  zcl_memset( &key, 0, sizeof( zclReportCfg_t ) );
+  key.endpoint = pInMsg->msg->endPoint;
+  key.clusterID = pInMsg->msg->clusterId;
+  key.dstAddrMode = afAddrNotPresent;
+
+  readReportCfgRspCmd->numAttr = readReportCfgCmd->numAttr;
+  for ( i = 0; i < readReportCfgCmd->numAttr; i++ )
+  {
+    zclReportCfgRspRec_t *reportRspRec = &(readReportCfgRspCmd->attrList[i]);
+
+    zcl_memset( reportRspRec, 0, sizeof( zclReportCfgRspRec_t ) );
+    reportRspRec->direction = readReportCfgCmd->attrList[i].direction;
+    reportRspRec->attrID = readReportCfgCmd->attrList[i].attrID;
+
+    key.attrID = reportRspRec->attrID;
+    idx = zclReportFindCfg( &key );
+
+    if ( !zclFindAttrRec( key.endpoint, key.clusterID, key.attrID, &attrRec ) )
+    {
+      reportRspRec->status = ZCL_STATUS_UNSUPPORTED_ATTRIBUTE;
+    }
+    else if ( idx < ZCL_MAX_REPORT_CFGS )
+    {
+      reportRspRec->status = ZCL_STATUS_SUCCESS;
+      reportRspRec->dataType = zclReportCfgs[idx].dataType;
+      reportRspRec->minReportInt = zclReportCfgs[idx].minReportInt;
+      reportRspRec->maxReportInt = zclReportCfgs[idx].maxReportInt;
+      reportRspRec->reportableChange = zclReportCfgs[idx].reportableChange;
+    }
+    else if ( attrRec.attr.accessControl & ACCESS_REPORTABLE )
+    {
+      reportRspRec->status = ZCL_STATUS_NOT_FOUND;
+    }
+    else
+    {
+      reportRspRec->status = ZCL_STATUS_UNREPORTABLE_ATTRIBUTE;
+    }
+  }
+
+  zcl_SendReadReportCfgRspCmd( pInMsg->msg->endPoint, &(pInMsg->msg->srcAddr),
+                               pInMsg->msg->clusterId, readReportCfgRspCmd,
+                               !pInMsg->hdr.fc.direction, true, pInMsg->hdr.transSeqNum );
+  zcl_mem_free( readReportCfgRspCmd );
+
+  return TRUE;
+}
+#endif // ZCL_REPORT && ZCL_REPORTING
+
 #ifdef ZCL_DISCOVER
 /*********************************************************************
  * @fn      zclProcessInDiscAttrs
@@ -4642,7 +6497,7 @@ static uint8 zclProcessInDiscCmd( zclIncoming_t *pInMsg )
   zclCommandRec_t cmdRec;
   uint8 cmdID;
   uint8 i;
-  uint8 j;
+  uint8 j = 0;
 
   pDiscoverCmd = (zclDiscoverCmdsCmd_t *)pInMsg->attrCmd;
 
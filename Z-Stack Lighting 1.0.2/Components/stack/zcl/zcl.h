@@ -359,6 +359,49 @@ extern "C"
 // Padding needed if buffer has odd number of octects in length
 #define PADDING_NEEDED( bufLen )    ( (bufLen) % 2 )
 
+// Set to TRUE to hand incoming reports to the application pointing to the
+// attribute data in the received message, instead of copying it. The
+// ZCL_INCOMING_MSG keeps the received message until it is deallocated, so
+// the attrData pointers are only valid until then. The data is not padded
+// either, so it may be unaligned: only for applications that read it with
+// BUILD_UINT16()/BUILD_UINT32() or osal_memcpy(), never through a cast.
+#if !defined ( ZCL_REPORT_ZERO_COPY )
+  #define ZCL_REPORT_ZERO_COPY  FALSE
+#endif
+
+// Each registered attribute list gets an index sorted by cluster ID and
+// attribute ID, so that attribute lookups are binary searches instead of
+// scans of the whole list. Costs one byte per attribute and three bytes
+// per cluster of heap.
+#if !defined ( ZCL_ATTR_INDEX )
+  #define ZCL_ATTR_INDEX  TRUE
+#endif
+
+// Attribute reporting engine: ZCL answers Configure Reporting and Read
+// Reporting Configuration for the reportable (ACCESS_REPORTABLE) attributes
+// of its endpoints, keeps the configurations in NV and sends the Report
+// Attributes commands itself. Reports due at the same time for the same
+// endpoint, cluster and destination go out in one frame.
+#if !defined ( ZCL_REPORTING )
+  #define ZCL_REPORTING  FALSE
+#endif
+
+// Number of reporting configurations (endpoint, cluster, attribute and
+// destination) the engine can hold
+#if !defined ( ZCL_MAX_REPORT_CFGS )
+  #define ZCL_MAX_REPORT_CFGS  8
+#endif
+
+// Milliseconds a report may go out late, so that a sleeping device can
+// send it in a wakeup it makes anyway. Reporting intervals are in seconds.
+#if !defined ( ZCL_REPORT_SLACK )
+  #define ZCL_REPORT_SLACK  1000
+#endif
+
+#if ZCL_REPORTING && ( !defined ( ZCL_REPORT ) || defined ( ZCL_STANDALONE ) )
+  #error "ZCL_REPORTING needs ZCL_REPORT and the OSAL."
+#endif
+
 // Check for Cluster IDs
 #define ZCL_CLUSTER_ID_GEN( id )      ( /* (id) >= ZCL_CLUSTER_ID_GEN_BASIC &&*/ \
                                         (id) <= ZCL_CLUSTER_ID_GEN_COMMISSIONING )
@@ -681,6 +724,7 @@ typedef struct
   afAddrType_t     srcAddr;     // Sender's address
   uint8            endPoint;    // destination endpoint
   void             *attrCmd;    // pointer to the parsed attribute or command; must be freed by Application
+                                // - report data may point into data this message keeps
 } zclIncomingMsg_t;
 
 // Function pointer type to handle incoming messages.
@@ -749,6 +793,14 @@ typedef ZStatus_t (*zclReadWriteCB_t)( uint16 clusterId, uint16 attrId, uint8 op
 //           ZCL_STATUS_NOT_AUTHORIZED: Operation not authorized
 typedef ZStatus_t (*zclAuthorizeCB_t)( afAddrType_t *srcAddr, zclAttrRec_t *pAttr, uint8 oper );
 
+// Callback function prototype to tell the application that the value of
+//   an attribute has changed.
+//
+//   endpoint - endpoint of the attribute
+//   clusterId - cluster that attribute belongs to
+//   attrId - attribute that changed
+typedef void (*zclAttrChangeCB_t)( uint8 endpoint, uint16 clusterId, uint16 attrId );
+
 typedef struct
 {
   uint16  clusterID;      // Real cluster ID
@@ -763,6 +815,13 @@ typedef struct
   uint8  *pData;
 } zclParseCmd_t;
 
+// Walks the records of a received command in place, without copying them
+typedef struct
+{
+  uint8  *pData;          // Next record
+  uint8  *pEnd;           // End of the command payload
+} zclParseIter_t;
+
 /*********************************************************************
  * GLOBAL VARIABLES
  */
@@ -882,6 +941,21 @@ extern ZStatus_t zcl_registerValidateAttrData( zclValidateAttrData_t pfnValidate
 extern ZStatus_t zcl_registerReadWriteCB( uint8 endpoint, zclReadWriteCB_t pfnReadWriteCB,
                                           zclAuthorizeCB_t pfnAuthorizeCB );
 
+/*
+ *  Register the application's callback function for attribute value changes.
+ */
+extern ZStatus_t zcl_registerAttrChangeCB( uint8 endpoint, zclAttrChangeCB_t pfnAttrChangeCB );
+
+/*
+ *  Function for setting the value of a local attribute
+ */
+extern ZStatus_t zcl_SetAttrValue( uint8 endpoint, uint16 clusterID, uint16 attrID, void *pValue );
+
+/*
+ *  Function to tell ZCL that the value of a local attribute has changed
+ */
+extern void zcl_AttrChanged( uint8 endpoint, uint16 clusterID, uint16 attrID );
+
 /*
  *  Process incoming ZCL messages
  */
@@ -969,6 +1043,14 @@ extern ZStatus_t zcl_SendReadReportCfgRspCmd( uint8 srcEP, afAddrType_t *dstAddr
 extern ZStatus_t zcl_SendReportCmd( uint8 srcEP, afAddrType_t *dstAddr,
                               uint16 realClusterID, zclReportCmd_t *reportCmd,
                               uint8 direction, uint8 disableDefaultRsp, uint8 seqNum );
+
+#if ZCL_REPORTING
+/*
+ *  Function for configuring the reporting of a local attribute
+ */
+extern ZStatus_t zcl_ConfigReport( uint8 endpoint, uint16 clusterID, afAddrType_t *dstAddr,
+                                   zclCfgReportRec_t *cfgReportRec );
+#endif // ZCL_REPORTING
 #endif // ZCL_REPORT
 
 /*
@@ -1027,6 +1109,11 @@ extern ZStatus_t zcl_SendDiscoverAttrsExtRsp( uint8 srcEP, afAddrType_t *dstAddr
  * Function to parse the "Profile" Read Commands
  */
 extern void *zclParseInReadCmd( zclParseCmd_t *pCmd );
+
+/*
+ * Function to get the next attribute ID of a received Read Command
+ */
+extern uint8 zcl_ParseNextAttrID( zclParseIter_t *pIter, uint16 *pAttrID );
 #endif // ZCL_READ
 
 #ifdef ZCL_WRITE
@@ -1035,6 +1122,12 @@ extern void *zclParseInReadCmd( zclParseCmd_t *pCmd );
  * Commands
  */
 extern void *zclParseInWriteCmd( zclParseCmd_t *pCmd );
+
+/*
+ * Function to get the next record of a received Write, Write Undivided
+ * or Write No Response Command
+ */
+extern uint8 zcl_ParseNextWriteRec( zclParseIter_t *pIter, zclWriteRec_t *pRec );
 #endif // ZCL_WRITE
 
 #ifdef ZCL_REPORT
@@ -1079,6 +1172,11 @@ extern uint8 zclFindCmdRec( uint8 endpoint, uint16 clusterID, uint8 cmdID, zclCo
  */
 extern uint8 *zclParseHdr( zclFrameHdr_t *hdr, uint8 *pData );
 
+/*
+ * Function to start walking the records of a received command
+ */
+extern void zcl_ParseIterInit( zclParseIter_t *pIter, uint8 *pData, uint16 dataLen );
+
 /*
  * Function to find the attribute record that matchs the parameters
  */
@@ -66,6 +66,7 @@
 
 #include "zll_initiator.h"
 #include "zll_samplebridge.h"
+#include "OSAL_Nv.h"
 
 /*********************************************************************
  * GLOBAL VARIABLES
@@ -92,7 +93,10 @@ const pTaskEventHandlerFn tasksArr[] = {
 #endif
   zcl_event_loop,
   zllInitiator_event_loop,
-  zllSampleBridge_event_loop
+  zllSampleBridge_event_loop,
+#if defined ( OSAL_NV_TASK )
+  osal_nv_event_loop
+#endif
 };
 
 const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
@@ -137,7 +141,10 @@ void osalInitTasks( void )
 #endif
   zcl_Init( taskID++ );
   zllInitiator_Init( taskID++ );
-  zllSampleBridge_Init( taskID );
+  zllSampleBridge_Init( taskID++ );
+#if defined ( OSAL_NV_TASK )
+  osal_nv_task_init( taskID );
+#endif
 }
 
 /*********************************************************************
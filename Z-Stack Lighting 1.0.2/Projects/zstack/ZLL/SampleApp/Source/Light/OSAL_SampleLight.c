@@ -65,6 +65,7 @@
 
 #include "zll_target.h"
 #include "zll_samplelight.h"
+#include "OSAL_Nv.h"
 
 /*********************************************************************
  * GLOBAL VARIABLES
@@ -91,7 +92,10 @@ const pTaskEventHandlerFn tasksArr[] = {
 #endif
   zcl_event_loop,
   zllTarget_event_loop,
-  zllSampleLight_event_loop
+  zllSampleLight_event_loop,
+#if defined ( OSAL_NV_TASK )
+  osal_nv_event_loop
+#endif
 };
 
 const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
@@ -136,7 +140,10 @@ void osalInitTasks( void )
 #endif
   zcl_Init( taskID++ );
   zllTarget_Init( taskID++ );
-  zllSampleLight_Init( taskID );
+  zllSampleLight_Init( taskID++ );
+#if defined ( OSAL_NV_TASK )
+  osal_nv_task_init( taskID );
+#endif
 }
 
 /*********************************************************************
@@ -84,6 +84,13 @@
 /*********************************************************************
  * TYPEDEFS
  */
+typedef struct
+{
+  void   *pValue;
+  uint8  size;
+  uint16 clusterID;
+  uint16 attrID;
+} hwLightAttr_t;
 
 /*********************************************************************
  * GLOBAL VARIABLES
@@ -96,10 +103,32 @@
 /*********************************************************************
  * LOCAL VARIABLES
  */
+// Attributes that the light output follows. Their last values seen by
+// hwLight_AttrChanges() are kept in hwLightAttrVals.
+static CONST hwLightAttr_t hwLightAttrs[] =
+{
+  { &zllSampleLight_OnOff, 1, ZCL_CLUSTER_ID_GEN_ON_OFF, ATTRID_ON_OFF },
+#ifdef ZCL_LEVEL_CTRL
+  { &zclLevel_CurrentLevel, 1, ZCL_CLUSTER_ID_GEN_LEVEL_CONTROL, ATTRID_LEVEL_CURRENT_LEVEL },
+#endif //ZCL_LEVEL_CTRL
+#ifdef ZCL_COLOR_CTRL
+  { &zclColor_CurrentHue, 1, ZCL_CLUSTER_ID_LIGHTING_COLOR_CONTROL, ATTRID_LIGHTING_COLOR_CONTROL_CURRENT_HUE },
+  { &zclColor_CurrentSaturation, 1, ZCL_CLUSTER_ID_LIGHTING_COLOR_CONTROL, ATTRID_LIGHTING_COLOR_CONTROL_CURRENT_SATURATION },
+  { &zclColor_CurrentX, 2, ZCL_CLUSTER_ID_LIGHTING_COLOR_CONTROL, ATTRID_LIGHTING_COLOR_CONTROL_CURRENT_X },
+  { &zclColor_CurrentY, 2, ZCL_CLUSTER_ID_LIGHTING_COLOR_CONTROL, ATTRID_LIGHTING_COLOR_CONTROL_CURRENT_Y },
+  { &zclColor_EnhancedCurrentHue, 2, ZCL_CLUSTER_ID_LIGHTING_COLOR_CONTROL, ATTRID_LIGHTING_COLOR_CONTROL_ENHANCED_CURRENT_HUE },
+  { &zclColor_ColorMode, 1, ZCL_CLUSTER_ID_LIGHTING_COLOR_CONTROL, ATTRID_LIGHTING_COLOR_CONTROL_COLOR_MODE },
+#endif //ZCL_COLOR_CTRL
+};
+
+#define HW_LIGHT_NUM_ATTRS  ( sizeof( hwLightAttrs ) / sizeof( hwLightAttrs[0] ) )
+
+static uint16 hwLightAttrVals[HW_LIGHT_NUM_ATTRS];
 
 /*********************************************************************
  * LOCAL FUNCTIONS
  */
+static void hwLight_AttrChanges( void );
 #ifdef ZCL_COLOR_CTRL
 static void hwLight_UpdateColor(void);
 static uint8 hwLight_XyToSat(uint16 x, uint16 y, uint8 hue);
@@ -525,7 +554,7 @@ void hwLight_ApplyUpdate16b( uint16 *pCurrentVal, uint32 *pCurrentVal_256, int32
   }
 
   hwLight_Refresh( REFRESH_AUTO );
-  SCENE_INVALID();
+  hwLight_AttrChanges();
 }
 
 /*********************************************************************
@@ -648,6 +677,11 @@ void hwLight_UpdateLampLevel( uint8 level )
  */
 void hwLight_UpdateOnOff( uint8 state )
 {
+  // Compares the attributes rather than state, which the effects use
+  // to blink the light without changing its On/Off attribute
+  hwLight_AttrChanges();
+
+
   if ( state == LIGHT_ON )
   {
 #ifdef ZLL_HW_LED_LAMP
@@ -733,6 +767,46 @@ void hwLight_ApplyUpdate( uint8 *pCurrentVal, uint16 *pCurrentVal_256, int32 *pS
   }
 
   hwLight_Refresh( REFRESH_AUTO );
+  hwLight_AttrChanges();
+}
+
+/*********************************************************************
+ * @fn      hwLight_AttrChanges
+ *
+ * @brief   Tell ZCL about the light attributes that changed since the
+ *          last call, so that reporting and the other change consumers
+ *          see the new values. This covers the transition steps, the
+ *          changes made without a transition, the On/Off changes and
+ *          the color values recalculated on a color mode change.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+static void hwLight_AttrChanges( void )
+{
+  uint16 val;
+  uint8 i;
+
+  for ( i = 0; i < HW_LIGHT_NUM_ATTRS; i++ )
+  {
+    if ( hwLightAttrs[i].size == 1 )
+    {
+      val = *((uint8 *)hwLightAttrs[i].pValue);
+    }
+    else
+    {
+      val = *((uint16 *)hwLightAttrs[i].pValue);
+    }
+
+    if ( val != hwLightAttrVals[i] )
+    {
+      hwLightAttrVals[i] = val;
+
+      // The attributes are registered on both light endpoints
+      zcl_AttrChanged( AF_BROADCAST_ENDPOINT, hwLightAttrs[i].clusterID, hwLightAttrs[i].attrID );
+    }
+  }
 }
 
 /*********************************************************************
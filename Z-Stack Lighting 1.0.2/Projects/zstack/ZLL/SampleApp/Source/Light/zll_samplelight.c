@@ -69,10 +69,9 @@
 
 #ifdef HAL_BOARD_ZLIGHT
 #include "osal_clock.h"
-#else
-// NWK key printout
-#include "osal_nv.h"
 #endif
+// NWK key printout, light state
+#include "osal_nv.h"
 
 /*********************************************************************
  * MACROS
@@ -106,10 +105,17 @@ byte zllSampleLight_TaskID;
 #ifdef ZLL_1_0_HUB_COMPATIBILITY
 extern ZStatus_t zll_RegisterSimpleDesc( SimpleDescriptionFormat_t *simpleDesc );
 #endif
+#if defined ( SAMPLELIGHT_SAVE_STATE )
+extern void zll_ItemInit( uint16 id, uint16 len, void *pBuf );
+#endif
 
 /*********************************************************************
  * LOCAL VARIABLES
  */
+// Extension fields of the last recalled scene, to tell whether the
+// light still shows it
+static uint8 zllSampleLight_SceneExt[SAMPLELIGHT_SCENE_EXT_FIELD_SIZE];
+static uint8 zllSampleLight_SceneExtLen = 0;
 
 /*********************************************************************
  * LOCAL FUNCTIONS
@@ -132,6 +138,13 @@ static ZStatus_t zllSampleLight_AttrReadWriteCB( uint16 clusterId, uint16 attrId
 
 static uint8 zllSampleLight_SceneStoreCB( zclSceneReq_t *pReq );
 static void zllSampleLight_SceneRecallCB( zclSceneReq_t *pReq );
+static void zllSampleLight_SceneCapture( uint8 *pExt );
+static void zllSampleLight_SceneApply( uint8 *pExt, uint8 extLen, uint16 transTime, uint16 transTime100ms );
+static void zllSampleLight_AttrChangeCB( uint8 endpoint, uint16 clusterId, uint16 attrId );
+#if defined ( SAMPLELIGHT_SAVE_STATE )
+static void zllSampleLight_RestoreState( void );
+static void zllSampleLight_SaveState( void );
+#endif
 
 #if ( HAL_LCD == TRUE )
 static void zllSampleLight_PrintNwkKey( uint8 reverse );
@@ -218,6 +231,15 @@ void zllSampleLight_Init( byte task_id )
   // Register the ZCL General Cluster Library callback functions
   zclGeneral_RegisterCmdCallbacks( SAMPLELIGHT_ENDPOINT, &zllSampleLight_GenCmdCBs );
 
+#if defined ( ZCL_SCENES ) && defined ( OSAL_NV_CACHE ) && defined ( ZLL_SAMPLELIGHT_CACHE_SCENES )
+  // Every scene store rewrites the whole scene table one record at a time, so let the
+  // NV write cache turn those into a single NV write. The cache keeps a copy of the whole
+  // table in the heap for good, about 900 bytes with the default ZCL_GEN_MAX_SCENES, so
+  // this is only for a device with that much heap to spare, and OSAL_NV_CACHE_ITEM_MAX
+  // has to be raised to the size of the table.
+  (void)osal_nv_cache_add( ZCD_NV_SCENE_TABLE );
+#endif
+
 #ifdef ZLL_HW_LED_LAMP
   HalTimer1Init(0);
 #endif //ZLL_HW_LED_LAMP
@@ -244,6 +266,9 @@ void zllSampleLight_Init( byte task_id )
   // Register the application's callback function to read the Scene Count attribute.
   zcl_registerReadWriteCB( SAMPLELIGHT_ENDPOINT, zllSampleLight_AttrReadWriteCB, NULL );
 
+  // Register the application's callback function for attribute value changes
+  zcl_registerAttrChangeCB( SAMPLELIGHT_ENDPOINT, zllSampleLight_AttrChangeCB );
+
   // Register for all key events - This app will handle all key events
   RegisterForKeys( zllSampleLight_TaskID );
 
@@ -253,6 +278,10 @@ void zllSampleLight_Init( byte task_id )
 
   zllTarget_InitDevice();
 
+#if defined ( SAMPLELIGHT_SAVE_STATE )
+  zllSampleLight_RestoreState();
+#endif
+
   zllSampleLight_OnOffCB( zllSampleLight_OnOff );
 
 #ifdef ZLL_1_0_HUB_COMPATIBILITY
@@ -771,8 +800,6 @@ static void zllSampleLight_OnOffCB( uint8 cmd )
   }
 
   hwLight_UpdateOnOff( zllSampleLight_OnOff );
-
-  zllSampleLight_SceneValid = 0;
 }
 
 
@@ -883,11 +910,24 @@ static void zllSampleLight_OnOff_OnWithTimedOffCB( zclOnWithTimedOff_t *pCmd )
  */
 static uint8 zllSampleLight_SceneStoreCB( zclSceneReq_t *pReq )
 {
-  uint8 *pExt;
-
   pReq->scene->extLen = SAMPLELIGHT_SCENE_EXT_FIELD_SIZE;
-  pExt = pReq->scene->extField;
+  zllSampleLight_SceneCapture( pReq->scene->extField );
 
+  return ( TRUE );
+}
+
+/*********************************************************************
+ * @fn      zllSampleLight_SceneCapture
+ *
+ * @brief   Build the scene extension fields from the current attribute
+ *          values. They take SAMPLELIGHT_SCENE_EXT_FIELD_SIZE bytes.
+ *
+ * @param   pExt - where to put the extension fields
+ *
+ * @return  none
+ */
+static void zllSampleLight_SceneCapture( uint8 *pExt )
+{
   // Build an extension field for On/Off cluster
   *pExt++ = LO_UINT16( ZCL_CLUSTER_ID_GEN_ON_OFF );
   *pExt++ = HI_UINT16( ZCL_CLUSTER_ID_GEN_ON_OFF );
@@ -919,7 +959,8 @@ static uint8 zllSampleLight_SceneStoreCB( zclSceneReq_t *pReq )
     *pExt++ = HI_UINT16( zclColor_CurrentX );
     *pExt++ = LO_UINT16( zclColor_CurrentY );
     *pExt++ = HI_UINT16( zclColor_CurrentY );
-    pExt += COLOR_SCN_HUE_SAT_ATTRS_SIZE + COLOR_SCN_LOOP_ATTRS_SIZE; // ignore other parameters
+    osal_memset( pExt, 0x00, COLOR_SCN_HUE_SAT_ATTRS_SIZE + COLOR_SCN_LOOP_ATTRS_SIZE ); // ignore other parameters
+    pExt += COLOR_SCN_HUE_SAT_ATTRS_SIZE + COLOR_SCN_LOOP_ATTRS_SIZE;
   }
   else
   {
@@ -937,8 +978,6 @@ static uint8 zllSampleLight_SceneStoreCB( zclSceneReq_t *pReq )
 #endif //ZCL_COLOR_CTRL
 
   // Add more clusters here
-
-  return ( TRUE );
 }
 
 /*********************************************************************
@@ -957,12 +996,41 @@ static uint8 zllSampleLight_SceneStoreCB( zclSceneReq_t *pReq )
  * @return  none
  */
 static void zllSampleLight_SceneRecallCB( zclSceneReq_t *pReq )
+{
+  zllSampleLight_SceneApply( pReq->scene->extField, pReq->scene->extLen,
+                             pReq->scene->transTime, pReq->scene->transTime100ms );
+
+  zllSampleLight_SceneExtLen = pReq->scene->extLen;
+  osal_memcpy( zllSampleLight_SceneExt, pReq->scene->extField,
+               MIN( pReq->scene->extLen, SAMPLELIGHT_SCENE_EXT_FIELD_SIZE ) );
+
+  zllSampleLight_CurrentScene = pReq->scene->ID;
+  zllSampleLight_CurrentGroup = pReq->scene->groupID;
+  zllSampleLight_GlobalSceneCtrl = TRUE;
+  SCENE_VALID();
+}
+
+/*********************************************************************
+ * @fn      zllSampleLight_SceneApply
+ *
+ * @brief   Move the light to the state held in scene extension fields.
+ *
+ * @param   pExt - extension fields
+ * @param   extLen - length of the extension fields
+ * @param   transTime - transition time, in seconds
+ * @param   transTime100ms - additional transition time, in 1/10 seconds
+ *
+ * @return  none
+ */
+static void zllSampleLight_SceneApply( uint8 *pExt, uint8 extLen, uint16 transTime, uint16 transTime100ms )
 {
   int8 remain;
   uint16 clusterID;
-  uint8 *pExt = pReq->scene->extField;
+  uint8 *pEnd = pExt + extLen;
 
-  while ( pExt < pReq->scene->extField + pReq->scene->extLen )
+  (void)transTime100ms;  // Only used by color transitions
+
+  while ( pExt < pEnd )
   {
     clusterID =  BUILD_UINT16( pExt[0], pExt[1] );
     pExt += 2; // cluster ID
@@ -986,7 +1054,7 @@ static void zllSampleLight_SceneRecallCB( zclSceneReq_t *pReq )
         zclLCMoveToLevel_t levelCmd;
 
         levelCmd.level = *pExt++;
-        levelCmd.transitionTime = pReq->scene->transTime; // whole seconds only
+        levelCmd.transitionTime = transTime; // whole seconds only
         levelCmd.withOnOff = 0;
         zclLevel_MoveToLevelCB( &levelCmd );
         remain--;
@@ -1008,7 +1076,7 @@ static void zllSampleLight_SceneRecallCB( zclSceneReq_t *pReq )
         if ( ( colorCmd.colorX != 0 ) || ( colorCmd.colorY != 0 ) )
         {
           // COLOR_MODE_CURRENT_X_Y
-          colorCmd.transitionTime = (10 * pReq->scene->transTime) + pReq->scene->transTime100ms; // in 1/10th seconds
+          colorCmd.transitionTime = (10 * transTime) + transTime100ms; // in 1/10th seconds
           zclColor_MoveToColorCB( &colorCmd );
           // for non-zero X,Y other hue/sat and loop parameters are ignored (CCB 1683)
         }
@@ -1020,7 +1088,7 @@ static void zllSampleLight_SceneRecallCB( zclSceneReq_t *pReq )
           cmd.enhancedHue = BUILD_UINT16( pExt[0], pExt[1] );
           pExt += 2;
           cmd.saturation = *pExt++;
-          cmd.transitionTime = (10 * pReq->scene->transTime) + pReq->scene->transTime100ms; // in 1/10th seconds
+          cmd.transitionTime = (10 * transTime) + transTime100ms; // in 1/10th seconds
           zclColor_MoveToEnhHueAndSaturationCB( &cmd );
           remain -= COLOR_SCN_HUE_SAT_ATTRS_SIZE;
 
@@ -1046,12 +1114,100 @@ static void zllSampleLight_SceneRecallCB( zclSceneReq_t *pReq )
 
     pExt += remain; // remain should be 0 if all extension fields are processed
   }
+}
 
-  zllSampleLight_CurrentScene = pReq->scene->ID;
-  zllSampleLight_CurrentGroup = pReq->scene->groupID;
-  zllSampleLight_GlobalSceneCtrl = TRUE;
-  SCENE_VALID();
+/*********************************************************************
+ * @fn      zllSampleLight_AttrChangeCB
+ *
+ * @brief   Callback from the ZCL layer for the attributes whose value
+ *          changed. A change of the light state updates the Scene Valid
+ *          attribute and saves the state in NV.
+ *
+ * @param   endpoint - endpoint of the attribute
+ * @param   clusterId - cluster that attribute belongs to
+ * @param   attrId - attribute that changed
+ *
+ * @return  none
+ */
+static void zllSampleLight_AttrChangeCB( uint8 endpoint, uint16 clusterId, uint16 attrId )
+{
+  uint8 ext[SAMPLELIGHT_SCENE_EXT_FIELD_SIZE];
+
+  (void)endpoint;
+  (void)attrId;
+
+  if ( ( clusterId != ZCL_CLUSTER_ID_GEN_ON_OFF )
+#ifdef ZCL_LEVEL_CTRL
+      && ( clusterId != ZCL_CLUSTER_ID_GEN_LEVEL_CONTROL )
+#endif
+#ifdef ZCL_COLOR_CTRL
+      && ( clusterId != ZCL_CLUSTER_ID_LIGHTING_COLOR_CONTROL )
+#endif
+     )
+  {
+    return;
+  }
+
+  // The scene is valid while the light shows it
+  zllSampleLight_SceneCapture( ext );
+  if ( ( zllSampleLight_SceneExtLen == SAMPLELIGHT_SCENE_EXT_FIELD_SIZE )
+      && osal_memcmp( ext, zllSampleLight_SceneExt, SAMPLELIGHT_SCENE_EXT_FIELD_SIZE ) )
+  {
+    SCENE_VALID();
+  }
+  else
+  {
+    SCENE_INVALID();
+  }
+
+#if defined ( SAMPLELIGHT_SAVE_STATE )
+  zllSampleLight_SaveState();
+#endif
+}
+
+#if defined ( SAMPLELIGHT_SAVE_STATE )
+/*********************************************************************
+ * @fn      zllSampleLight_RestoreState
+ *
+ * @brief   Move the light to the state saved in NV, without a
+ *          transition, and keep the state in the NV write cache.
+ *          The first start saves the default state.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+static void zllSampleLight_RestoreState( void )
+{
+  uint8 state[SAMPLELIGHT_SCENE_EXT_FIELD_SIZE];
+
+  zllSampleLight_SceneCapture( state );
+  zll_ItemInit( ZCD_NV_ZLL_LIGHT_STATE, SAMPLELIGHT_SCENE_EXT_FIELD_SIZE, state );
+  (void)osal_nv_cache_add( ZCD_NV_ZLL_LIGHT_STATE );
+
+  zllSampleLight_SceneApply( state, SAMPLELIGHT_SCENE_EXT_FIELD_SIZE, 0, 0 );
+}
+
+/*********************************************************************
+ * @fn      zllSampleLight_SaveState
+ *
+ * @brief   Save the light state in NV. The write only updates the
+ *          cached copy, which the NV task writes once, OSAL_NV_CACHE_DEADLINE
+ *          ms after the first change, so a transition costs one NV write
+ *          rather than one per step.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+static void zllSampleLight_SaveState( void )
+{
+  uint8 state[SAMPLELIGHT_SCENE_EXT_FIELD_SIZE];
+
+  zllSampleLight_SceneCapture( state );
+  (void)osal_nv_write( ZCD_NV_ZLL_LIGHT_STATE, 0, SAMPLELIGHT_SCENE_EXT_FIELD_SIZE, state );
 }
+#endif // SAMPLELIGHT_SAVE_STATE
 
 
 /****************************************************************************
@@ -87,6 +87,7 @@ extern "C"
  */
 #define SAMPLELIGHT_ENDPOINT            11
 #define SAMPLELIGHT_NUM_GRPS            0
+#define ZCD_NV_ZLL_LIGHT_STATE          0x0401
 
 #ifdef ZLL_1_0_HUB_COMPATIBILITY
    // Compatibility with Hub operation for ZLL v1.0 is achieved by adding
@@ -151,6 +152,12 @@ extern "C"
 #define SAMPLELIGHT_COLOR_LOOP_PROCESS_EVT   0x0020
 #define SAMPLELIGHT_THERMAL_SAMPLE_EVT       0x0040
 
+// The light state is saved in NV through the NV write cache, which
+// turns the steps of a transition into a single NV write
+#if defined ( NV_RESTORE ) && defined ( OSAL_NV_CACHE )
+  #define SAMPLELIGHT_SAVE_STATE
+#endif
+
 /*********************************************************************
  * MACROS
  */
@@ -97,7 +97,7 @@ zclGeneral_Scene_t zllSampleLight_GlobalScene =
   0,                                     // Together with transTime, this allows transition time to be specified in 1/10s
   "GlobalScene",                         // Scene name
   ZCL_GEN_SCENE_EXT_LEN,                 // Length of extension fields
-  0,                                     // Extension fields
+  { 0 },                                 // Extension fields
 };
 
 // Level control Cluster (server) -----------------------------------------------------
@@ -315,7 +315,7 @@ CONST zclAttrRec_t zllSampleLight_Attrs[SAMPLELIGHT_NUM_ATTRIBUTES] =
     { // Attribute record
       ATTRID_ON_OFF,
       ZCL_DATATYPE_BOOLEAN,
-      ACCESS_CONTROL_READ,
+      (ACCESS_CONTROL_READ | ACCESS_REPORTABLE),
       (void *)&zllSampleLight_OnOff
     }
   },
@@ -353,7 +353,7 @@ CONST zclAttrRec_t zllSampleLight_Attrs[SAMPLELIGHT_NUM_ATTRIBUTES] =
     { // Attribute record
       ATTRID_LEVEL_CURRENT_LEVEL,
       ZCL_DATATYPE_UINT8,
-      (ACCESS_CONTROL_READ | ACCESS_CONTROL_WRITE),
+      (ACCESS_CONTROL_READ | ACCESS_CONTROL_WRITE | ACCESS_REPORTABLE),
       (void *)&zclLevel_CurrentLevel
     }
   },
@@ -375,7 +375,7 @@ CONST zclAttrRec_t zllSampleLight_Attrs[SAMPLELIGHT_NUM_ATTRIBUTES] =
     { // Attribute record
       ATTRID_LIGHTING_COLOR_CONTROL_CURRENT_SATURATION,
       ZCL_DATATYPE_UINT8,
-      ACCESS_CONTROL_READ,
+      (ACCESS_CONTROL_READ | ACCESS_REPORTABLE),
       (void *)&zclColor_CurrentSaturation
     }
   },
@@ -384,7 +384,7 @@ CONST zclAttrRec_t zllSampleLight_Attrs[SAMPLELIGHT_NUM_ATTRIBUTES] =
     { // Attribute record
       ATTRID_LIGHTING_COLOR_CONTROL_CURRENT_HUE,
       ZCL_DATATYPE_UINT8,
-      ACCESS_CONTROL_READ,
+      (ACCESS_CONTROL_READ | ACCESS_REPORTABLE),
       (void *)&zclColor_CurrentHue
     }
   },
@@ -402,7 +402,7 @@ CONST zclAttrRec_t zllSampleLight_Attrs[SAMPLELIGHT_NUM_ATTRIBUTES] =
     { // Attribute record
       ATTRID_LIGHTING_COLOR_CONTROL_CURRENT_X,
       ZCL_DATATYPE_UINT16,
-      (ACCESS_CONTROL_READ),
+      (ACCESS_CONTROL_READ | ACCESS_REPORTABLE),
       (void *)&zclColor_CurrentX
     }
   },
@@ -411,7 +411,7 @@ CONST zclAttrRec_t zllSampleLight_Attrs[SAMPLELIGHT_NUM_ATTRIBUTES] =
     { // Attribute record
       ATTRID_LIGHTING_COLOR_CONTROL_CURRENT_Y,
       ZCL_DATATYPE_UINT16,
-      (ACCESS_CONTROL_READ),
+      (ACCESS_CONTROL_READ | ACCESS_REPORTABLE),
       (void *)&zclColor_CurrentY
     }
   },
@@ -62,6 +62,7 @@
 
 #include "zll_initiator.h"
 #include "zll_sampleremote.h"
+#include "OSAL_Nv.h"
 
 /*********************************************************************
  * GLOBAL VARIABLES
@@ -85,7 +86,10 @@ const pTaskEventHandlerFn tasksArr[] = {
 #endif
   zcl_event_loop,
   zllInitiator_event_loop,
-  zllSampleRemote_event_loop
+  zllSampleRemote_event_loop,
+#if defined ( OSAL_NV_TASK )
+  osal_nv_event_loop
+#endif
 };
 
 const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
@@ -127,7 +131,10 @@ void osalInitTasks( void )
 #endif
   zcl_Init( taskID++ );
   zllInitiator_Init( taskID++ );
-  zllSampleRemote_Init( taskID );
+  zllSampleRemote_Init( taskID++ );
+#if defined ( OSAL_NV_TASK )
+  osal_nv_task_init( taskID );
+#endif
 }
 
 /*********************************************************************
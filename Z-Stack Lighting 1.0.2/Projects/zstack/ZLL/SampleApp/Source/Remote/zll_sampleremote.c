@@ -54,6 +54,7 @@
 #include "OSAL_Clock.h"
 
 #include "ZDApp.h"
+#include "nwk.h"
 
 #if defined ( INTER_PAN )
 #include "stub_aps.h"
@@ -230,6 +231,13 @@
 #define SAMPLEREMOTE_SEND_GRP_ADD_EVT        0x0002
 #define SAMPLEREMOTE_GRP_REMOVE_EVT          0x0004
 
+// How late a data request poll may go out, so that it can share a wakeup
+// with another timer. It applies to every poll rate, so it is kept below
+// QUEUED_POLL_RATE.
+#if !defined ( SAMPLEREMOTE_POLL_SLACK )
+  #define SAMPLEREMOTE_POLL_SLACK            50
+#endif
+
 #define MOVE_FLAG_LEVEL     0x1
 #define MOVE_FLAG_HUE       0x2
 #define MOVE_FLAG_SAT       0x4
@@ -403,6 +411,9 @@ void zllSampleRemote_Init( byte task_id )
 
   zllInitiator_InitDevice();
 
+  // The NWK library starts the poll timer without a slack
+  osal_set_timer_slack( NWK_TaskID, NWK_AUTO_POLL_EVT, SAMPLEREMOTE_POLL_SLACK );
+
 #ifdef BUZZER_FEEDBACK
   HalBuzzerRing(200,NULL);
 #endif //BUZZER_FEEDBACK
@@ -926,27 +926,35 @@ void zll_UpdateNV( uint8 enables )
   ZMacSetReq( ZMacRxOnIdle, &x );
  #endif
 
+  // The NIB and the ranges are written together, so a reset can't leave them out of step
+  osal_nv_txn_begin();
+
   if ( enables & ZLL_UPDATE_NV_NIB )
   {
     // Update NIB in NV
-    osal_nv_write( ZCD_NV_NIB, 0, sizeof( nwkIB_t ), &_NIB );
-
-    // Reset the NV startup option to resume from NV by clearing
-    // the "New" join option.
-    zgWriteStartupOptions( ZG_STARTUP_CLEAR, ZCD_STARTOPT_DEFAULT_NETWORK_STATE );
+    osal_nv_txn_stage( ZCD_NV_NIB, 0, sizeof( nwkIB_t ), &_NIB );
   }
 
   if ( enables & ZLL_UPDATE_NV_RANGES )
   {
     // Store our free network address and group ID ranges
-    osal_nv_write( ZCD_NV_MIN_FREE_NWK_ADDR, 0, sizeof( zllFreeNwkAddrBegin ), &zllFreeNwkAddrBegin );
-    osal_nv_write( ZCD_NV_MAX_FREE_NWK_ADDR, 0, sizeof( zllFreeNwkAddrEnd ), &zllFreeNwkAddrEnd );
-    osal_nv_write( ZCD_NV_MIN_FREE_GRP_ID, 0, sizeof( zllFreeGrpIdBegin ), &zllFreeGrpIdBegin );
-    osal_nv_write( ZCD_NV_MAX_FREE_GRP_ID, 0, sizeof( zllFreeGrpIdEnd ), &zllFreeGrpIdEnd );
+    osal_nv_txn_stage( ZCD_NV_MIN_FREE_NWK_ADDR, 0, sizeof( zllFreeNwkAddrBegin ), &zllFreeNwkAddrBegin );
+    osal_nv_txn_stage( ZCD_NV_MAX_FREE_NWK_ADDR, 0, sizeof( zllFreeNwkAddrEnd ), &zllFreeNwkAddrEnd );
+    osal_nv_txn_stage( ZCD_NV_MIN_FREE_GRP_ID, 0, sizeof( zllFreeGrpIdBegin ), &zllFreeGrpIdBegin );
+    osal_nv_txn_stage( ZCD_NV_MAX_FREE_GRP_ID, 0, sizeof( zllFreeGrpIdEnd ), &zllFreeGrpIdEnd );
 
     // Store our group ID range
-    osal_nv_write( ZCD_NV_MIN_GRP_IDS, 0, sizeof( zllGrpIDsBegin ), &zllGrpIDsBegin );
-    osal_nv_write( ZCD_NV_MAX_GRP_IDS, 0, sizeof( zllGrpIDsEnd ), &zllGrpIDsEnd );
+    osal_nv_txn_stage( ZCD_NV_MIN_GRP_IDS, 0, sizeof( zllGrpIDsBegin ), &zllGrpIDsBegin );
+    osal_nv_txn_stage( ZCD_NV_MAX_GRP_IDS, 0, sizeof( zllGrpIDsEnd ), &zllGrpIDsEnd );
+  }
+
+  osal_nv_txn_commit();
+
+  if ( enables & ZLL_UPDATE_NV_NIB )
+  {
+    // Reset the NV startup option to resume from NV by clearing
+    // the "New" join option.
+    zgWriteStartupOptions( ZG_STARTUP_CLEAR, ZCD_STARTOPT_DEFAULT_NETWORK_STATE );
   }
 
  #if defined ( NV_TURN_OFF_RADIO )
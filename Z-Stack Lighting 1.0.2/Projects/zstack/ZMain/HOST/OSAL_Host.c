@@ -0,0 +1,189 @@
+/**************************************************************************************************
+  Filename:       OSAL_Host.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Task table of the OSAL host (x86-64 Linux) simulation.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include <stdio.h>
+
+#include "ZComDef.h"
+#include "hal_drivers.h"
+#include "hal_sim.h"
+#include "OSAL.h"
+#include "OSAL_Tasks.h"
+
+/*********************************************************************
+ * MACROS
+ */
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Host application events
+#define HOST_APP_TICK_EVT          0x0001
+#define HOST_APP_SEND_EVT          0x0002
+
+#define HOST_APP_TICK_MSEC         1000
+#define HOST_APP_SEND_MSEC         7
+
+#define HOST_APP_MSG_EVT           0xE0
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static uint8 hostApp_TaskID;
+static uint32 hostApp_Ticks;
+static uint32 hostApp_Msgs;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+static void hostApp_Init( uint8 task_id );
+static uint16 hostApp_event_loop( uint8 task_id, uint16 events );
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+// The order in this table must be identical to the task initialization calls below in osalInitTask.
+const pTaskEventHandlerFn tasksArr[] = {
+  Hal_ProcessEvent,
+  hostApp_event_loop
+};
+
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+/*********************************************************************
+ * FUNCTIONS
+ *********************************************************************/
+
+/*********************************************************************
+ * @fn      osalInitTasks
+ *
+ * @brief   This function invokes the initialization function for each task.
+ *
+ * @param   void
+ *
+ * @return  none
+ */
+void osalInitTasks( void )
+{
+  uint8 taskID = 0;
+
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt);
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt));
+
+  Hal_Init( taskID++ );
+  hostApp_Init( taskID );
+}
+
+/*********************************************************************
+ * @fn      hostApp_Init
+ *
+ * @brief   Start the periodic timers of the host sample task.
+ *
+ * @param   task_id - OSAL task ID
+ *
+ * @return  none
+ */
+static void hostApp_Init( uint8 task_id )
+{
+  hostApp_TaskID = task_id;
+
+  osal_start_reload_timer( hostApp_TaskID, HOST_APP_TICK_EVT, HOST_APP_TICK_MSEC );
+  osal_start_reload_timer( hostApp_TaskID, HOST_APP_SEND_EVT, HOST_APP_SEND_MSEC );
+}
+
+/*********************************************************************
+ * @fn      hostApp_event_loop
+ *
+ * @brief   Host sample task: sends itself a message every few
+ *          milliseconds and prints a line once per virtual second.
+ *
+ * @param   task_id - OSAL task ID
+ * @param   events - events to process
+ *
+ * @return  events not processed
+ */
+static uint16 hostApp_event_loop( uint8 task_id, uint16 events )
+{
+  uint8 *pMsg;
+
+  if ( events & SYS_EVENT_MSG )
+  {
+    while ( (pMsg = osal_msg_receive( task_id )) )
+    {
+      hostApp_Msgs++;
+      osal_msg_deallocate( pMsg );
+    }
+
+    return ( events ^ SYS_EVENT_MSG );
+  }
+
+  if ( events & HOST_APP_SEND_EVT )
+  {
+    pMsg = osal_msg_allocate( sizeof( osal_event_hdr_t ) );
+    if ( pMsg )
+    {
+      ((osal_event_hdr_t *)pMsg)->event = HOST_APP_MSG_EVT;
+      osal_msg_send( task_id, pMsg );
+    }
+
+    return ( events ^ HOST_APP_SEND_EVT );
+  }
+
+  if ( events & HOST_APP_TICK_EVT )
+  {
+    hostApp_Ticks++;
+    printf( "t=%lu ms ticks=%lu msgs=%lu\n", (unsigned long)halSimClockMs(),
+            (unsigned long)hostApp_Ticks, (unsigned long)hostApp_Msgs );
+
+    return ( events ^ HOST_APP_TICK_EVT );
+  }
+
+  return 0;
+}
+
+/*********************************************************************
+*********************************************************************/
@@ -0,0 +1,265 @@
+/**************************************************************************************************
+  Filename:       OnBoard.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    This file contains the UI and control for the
+                  simulated peripherals of the host target
+  Notes:          This file targets the OSAL host (x86-64 Linux) simulation
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include "ZComDef.h"
+#include "OnBoard.h"
+#include "OSAL.h"
+
+/* Hal */
+#include "hal_key.h"
+#include "hal_mcu.h"
+#include "hal_sim.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Task ID not initialized
+#define NO_TASK_ID 0xFF
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+// 64-bit Extended Address of this device
+uint8 aExtendedAddress[8];
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// Registered keys task ID, initialized to NOT USED.
+static uint8 registeredKeysTaskID = NO_TASK_ID;
+
+// Seed of the random number generator - fixed so that every run is reproducible.
+static uint16 randSeed = 0xACE1;
+
+/*********************************************************************
+ * @fn      InitBoard()
+ * @brief   Initialize the simulated board
+ * @param   level: COLD,WARM,READY
+ * @return  None
+ */
+void InitBoard( uint8 level )
+{
+  if ( level == OB_COLD )
+  {
+    // Interrupts off
+    osal_int_disable( INTS_ALL );
+  }
+}
+
+/*********************************************************************
+ *                        "Keyboard" Support
+ *********************************************************************/
+
+/*********************************************************************
+ * Keyboard Register function
+ *
+ * The keyboard handler is setup to send all keyboard changes to
+ * one task (if a task is registered).
+ *********************************************************************/
+uint8 RegisterForKeys( uint8 task_id )
+{
+  // Allow only the first task
+  if ( registeredKeysTaskID == NO_TASK_ID )
+  {
+    registeredKeysTaskID = task_id;
+    return ( true );
+  }
+  else
+    return ( false );
+}
+
+/*********************************************************************
+ * @fn      OnBoard_SendKeys
+ *
+ * @brief   Send "Key Pressed" message to application.
+ *
+ * @param   keys  - keys that were pressed
+ *          state - shifted
+ *
+ * @return  status
+ *********************************************************************/
+uint8 OnBoard_SendKeys( uint8 keys, uint8 state )
+{
+  keyChange_t *msgPtr;
+
+  if ( registeredKeysTaskID != NO_TASK_ID )
+  {
+    // Send the address to the task
+    msgPtr = (keyChange_t *)osal_msg_allocate( sizeof(keyChange_t) );
+    if ( msgPtr )
+    {
+      msgPtr->hdr.event = KEY_CHANGE;
+      msgPtr->state = state;
+      msgPtr->keys = keys;
+
+      osal_msg_send( registeredKeysTaskID, (uint8 *)msgPtr );
+    }
+    return ( ZSuccess );
+  }
+  else
+    return ( ZFailure );
+}
+
+/*********************************************************************
+ * @fn      OnBoard_KeyCallback
+ *
+ * @brief   Callback service for keys
+ *
+ * @param   keys  - keys that were pressed
+ *          state - shifted
+ *
+ * @return  void
+ *********************************************************************/
+void OnBoard_KeyCallback ( uint8 keys, uint8 state )
+{
+  uint8 shift;
+  (void)state;
+
+  shift = (keys & HAL_KEY_SW_6) ? true : false;
+
+  (void)OnBoard_SendKeys( keys, shift );
+}
+
+/*********************************************************************
+ * @fn      OnBoard_stack_used
+ *
+ * @brief   Stack usage is not tracked on the host.
+ *
+ * @param   none
+ *
+ * @return  zero
+ *********************************************************************/
+uint16 OnBoard_stack_used(void)
+{
+  return 0;
+}
+
+/*********************************************************************
+ * @fn      _itoa
+ *
+ * @brief   convert a 16bit number to ASCII
+ *
+ * @param   num -
+ *          buf -
+ *          radix -
+ *
+ * @return  void
+ *
+ *********************************************************************/
+void _itoa(uint16 num, uint8 *buf, uint8 radix)
+{
+  char c,i;
+  uint8 *p, rst[5];
+
+  p = rst;
+  for ( i=0; i<5; i++,p++ )
+  {
+    c = num % radix;  // Isolate a digit
+    *p = c + (( c < 10 ) ? '0' : '7');  // Convert to Ascii
+    num /= radix;
+    if ( !num )
+      break;
+  }
+
+  for ( c=0 ; c<=i; c++ )
+    *buf++ = *p--;  // Reverse character order
+
+  *buf = '\0';
+}
+
+/*********************************************************************
+ * @fn        Onboard_rand
+ *
+ * @brief    Random number generator - a 16-bit Galois LFSR so that
+ *           simulation runs are reproducible.
+ *
+ * @param   none
+ *
+ * @return  uint16 - new random number
+ *
+ *********************************************************************/
+uint16 Onboard_rand( void )
+{
+  randSeed = (randSeed >> 1) ^ (-(randSeed & 1u) & 0xB400u);
+
+  return ( randSeed );
+}
+
+/*********************************************************************
+ * @fn        Onboard_wait
+ *
+ * @brief    Delay wait - charged to the virtual clock.
+ *
+ * @param   uint16 - time to wait
+ *
+ * @return  none
+ *
+ *********************************************************************/
+void Onboard_wait( uint16 timeout )
+{
+  halSimClockAdvance( timeout );
+}
+
+/*********************************************************************
+ * @fn      Onboard_soft_reset
+ *
+ * @brief   Effect a soft reset.
+ *
+ * @param   none
+ *
+ * @return  none
+ *
+ *********************************************************************/
+void Onboard_soft_reset( void )
+{
+  OSAL_NV_FLUSH();
+  HAL_SYSTEM_RESET();
+}
+
+/*********************************************************************
+*********************************************************************/
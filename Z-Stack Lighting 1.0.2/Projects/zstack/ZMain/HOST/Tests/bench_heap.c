@@ -0,0 +1,318 @@
+/**************************************************************************************************
+  Filename:       bench_heap.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host trace-replay benchmark of the OSAL heap allocators.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include <stdio.h>
+
+#include "ZComDef.h"
+#include "hal_drivers.h"
+#include "OSAL.h"
+#include "OSAL_Memory.h"
+#include "OSAL_Tasks.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Set by the makefile for the segregated-fit build, as in OSAL_Memory.c
+#if !defined ( OSALMEM_SEGFIT )
+  #define OSALMEM_SEGFIT  FALSE
+#endif
+
+#define BENCH_SLOTS                1024
+#define BENCH_OPS                  1000000
+#define BENCH_REPEAT               10
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+// One step of a workload: allocate 'size' bytes into a slot, or free it
+typedef struct
+{
+  uint16 slot;
+  uint16 size;   // 0 to free
+} benchOp_t;
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+const pTaskEventHandlerFn tasksArr[] = {
+  Hal_ProcessEvent
+};
+
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt);
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt));
+
+  Hal_Init( 0 );
+}
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static benchOp_t bench_Ops[BENCH_OPS];
+static uint32 bench_OpCnt;
+static void *bench_Ptr[BENCH_SLOTS];
+static uint32 bench_Seed = 1;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+static uint16 bench_Rand( void )
+{
+  bench_Seed = bench_Seed * 1103515245 + 12345;
+
+  return ( (uint16)(bench_Seed >> 16) & 0x7FFF );
+}
+
+/*
+ * Free the blocks left allocated by a workload.
+ */
+static void bench_FreeAll( void )
+{
+  uint16 slot;
+
+  for ( slot = 0; slot < BENCH_SLOTS; slot++ )
+  {
+    if ( bench_Ptr[slot] != NULL )
+    {
+      osal_mem_free( bench_Ptr[slot] );
+      bench_Ptr[slot] = NULL;
+    }
+  }
+}
+
+/*
+ * Read a workload: one "a <slot> <size>" or "f <slot>" per line, as written
+ * by Tools/heap_trace -w from a heap trace recorded over MT.
+ */
+static uint8 bench_Load( const char *fname )
+{
+  FILE *fp = fopen( fname, "r" );
+  unsigned slot, size;
+  char op;
+
+  if ( fp == NULL )
+  {
+    return ( FALSE );
+  }
+
+  while ( (bench_OpCnt < BENCH_OPS) && (fscanf( fp, " %c %u", &op, &slot ) == 2) )
+  {
+    size = 0;
+    if ( (op == 'a') && (fscanf( fp, " %u", &size ) != 1) )
+    {
+      break;
+    }
+
+    if ( (slot < BENCH_SLOTS) && ((op == 'f') || (size != 0)) )
+    {
+      bench_Ops[bench_OpCnt].slot = slot;
+      bench_Ops[bench_OpCnt].size = size;
+      bench_OpCnt++;
+    }
+  }
+
+  fclose( fp );
+
+  return ( TRUE );
+}
+
+/*
+ * Build a synthetic coordinator workload: short-lived AF messages and ZCL
+ * parse buffers of varying size, beacon descriptors and timers that live a
+ * little longer, and a few large frames and long-lived allocations.
+ */
+static void bench_Generate( void )
+{
+  static uint8 live[BENCH_SLOTS];
+  uint16 slot, size;
+  uint16 r;
+
+  while ( bench_OpCnt < BENCH_OPS )
+  {
+    slot = bench_Rand() % 48;
+    r = bench_Rand() % 100;
+
+    if ( r < 45 )
+    {
+      size = 24 + (bench_Rand() % 80);        // AF incoming message
+    }
+    else if ( r < 75 )
+    {
+      size = 4 + (bench_Rand() % 40);         // ZCL parse buffer
+    }
+    else if ( r < 90 )
+    {
+      size = 12;                              // timer record
+    }
+    else if ( r < 98 )
+    {
+      size = 26;                              // beacon descriptor
+    }
+    else
+    {
+      size = 128 + (bench_Rand() % 128);      // large frame
+    }
+
+    // Slots 0..7 are long-lived: they are only freed now and then
+    if ( (slot < 8) && live[slot] && (bench_Rand() % 64) )
+    {
+      continue;
+    }
+
+    bench_Ops[bench_OpCnt].slot = slot;
+    bench_Ops[bench_OpCnt].size = live[slot] ? 0 : size;
+    live[slot] ^= 1;
+    bench_OpCnt++;
+  }
+}
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   Replay a workload into the heap and report the time per
+ *          operation, the failed allocations and the peak fragmentation
+ *          (free blocks) and use.
+ *
+ *          Usage: bench_heap [workload-file]
+ */
+int main( int argc, char **argv )
+{
+  uint32 n, fails = 0;
+  uint16 peakFree = 0, peakUsed = 0;
+  uint16 baseUsed, slot;
+  double t0, t1;
+  uint8 rep;
+
+  hostTestBoot();
+
+  if ( argc > 1 )
+  {
+    if ( !bench_Load( argv[1] ) )
+    {
+      printf( "cannot read %s\n", argv[1] );
+      return 1;
+    }
+  }
+  else
+  {
+    bench_Generate();
+  }
+
+  baseUsed = osal_heap_mem_used();
+
+  // Fragmentation and failures, one pass with the metrics read after each step
+  for ( n = 0; n < bench_OpCnt; n++ )
+  {
+    slot = bench_Ops[n].slot;
+    if ( bench_Ops[n].size == 0 )
+    {
+      if ( bench_Ptr[slot] != NULL )
+      {
+        osal_mem_free( bench_Ptr[slot] );
+        bench_Ptr[slot] = NULL;
+      }
+    }
+    else if ( bench_Ptr[slot] == NULL )
+    {
+      bench_Ptr[slot] = osal_mem_alloc( bench_Ops[n].size );
+      fails += ( bench_Ptr[slot] == NULL );
+    }
+
+    if ( osal_heap_block_free() > peakFree )
+    {
+      peakFree = osal_heap_block_free();
+    }
+    if ( osal_heap_mem_used() > peakUsed )
+    {
+      peakUsed = osal_heap_mem_used();
+    }
+  }
+
+  bench_FreeAll();
+  HOST_CHECK( osal_heap_mem_used() == baseUsed );
+
+  // Time, without the metric reads
+  t0 = hostBenchSec();
+  for ( rep = 0; rep < BENCH_REPEAT; rep++ )
+  {
+    for ( n = 0; n < bench_OpCnt; n++ )
+    {
+      slot = bench_Ops[n].slot;
+      if ( bench_Ops[n].size == 0 )
+      {
+        if ( bench_Ptr[slot] != NULL )
+        {
+          osal_mem_free( bench_Ptr[slot] );
+          bench_Ptr[slot] = NULL;
+        }
+      }
+      else if ( bench_Ptr[slot] == NULL )
+      {
+        bench_Ptr[slot] = osal_mem_alloc( bench_Ops[n].size );
+      }
+    }
+
+    bench_FreeAll();
+  }
+  t1 = hostBenchSec();
+
+  printf( "%s: %lu ops, %.1f ns/op, %lu failed, peak %u free blocks, peak %u bytes used\n",
+          OSALMEM_SEGFIT ? "segregated-fit" : "first-fit", (unsigned long)bench_OpCnt,
+          (t1 - t0) * 1e9 / ((double)bench_OpCnt * BENCH_REPEAT),
+          (unsigned long)fails, peakFree, peakUsed );
+
+  return hostTestResult( OSALMEM_SEGFIT ? "bench_heap_segfit" : "bench_heap" );
+}
+
+/*********************************************************************
+*********************************************************************/
@@ -0,0 +1,208 @@
+/**************************************************************************************************
+  Filename:       bench_memcpy.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Benchmark of the OSAL memory copy and compare functions.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include <stdio.h>
+
+#include "ZComDef.h"
+#include "hal_drivers.h"
+#include "OSAL.h"
+#include "OSAL_Tasks.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define BENCH_BUF_LEN              256
+#define BENCH_BYTES                (64UL * 1024 * 1024)
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+const pTaskEventHandlerFn tasksArr[] = {
+  Hal_ProcessEvent
+};
+
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt);
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt));
+
+  Hal_Init( 0 );
+}
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static uint8 bench_Src[BENCH_BUF_LEN + 1];
+static uint8 bench_Dst[BENCH_BUF_LEN + 1];
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+/*
+ * The byte loops the unrolled versions replaced, as the baseline. Kept
+ * out of line, like the OSAL functions, so that the compiler cannot see
+ * through either at the call site.
+ */
+static void * __attribute__((noipa)) bench_LoopCpy( void *dst, const void *src, unsigned int len )
+{
+  uint8 *pDst = dst;
+  const uint8 *pSrc = src;
+
+  while ( len-- )
+    *pDst++ = *pSrc++;
+
+  return ( pDst );
+}
+
+static void * __attribute__((noipa)) bench_LoopRevCpy( void *dst, const void *src, unsigned int len )
+{
+  uint8 *pDst = dst;
+  const uint8 *pSrc = (const uint8 *)src + (len - 1);
+
+  while ( len-- )
+    *pDst++ = *pSrc--;
+
+  return ( pDst );
+}
+
+static uint8 __attribute__((noipa)) bench_LoopCmp( const void *src1, const void *src2, unsigned int len )
+{
+  const uint8 *pSrc1 = src1;
+  const uint8 *pSrc2 = src2;
+
+  while ( len-- )
+  {
+    if ( *pSrc1++ != *pSrc2++ )
+      return FALSE;
+  }
+
+  return TRUE;
+}
+
+typedef void *(*benchCpyFn_t)( void *, const void *, unsigned int );
+typedef uint8 (*benchCmpFn_t)( const void *, const void *, unsigned int );
+
+/*
+ * Host ns per call of a copy, from an odd source address.
+ */
+static double bench_Cpy( benchCpyFn_t pFn, uint16 len )
+{
+  uint32 n, calls = BENCH_BYTES / len;
+  double start = hostBenchSec();
+
+  for ( n = 0; n < calls; n++ )
+  {
+    (void)pFn( bench_Dst, bench_Src + 1, len );
+  }
+
+  return ( (hostBenchSec() - start) * 1e9 / calls );
+}
+
+static double bench_Cmp( benchCmpFn_t pFn, uint16 len, uint32 *pSame )
+{
+  uint32 n, calls = BENCH_BYTES / len;
+  double start = hostBenchSec();
+
+  for ( n = 0; n < calls; n++ )
+  {
+    *pSame += pFn( bench_Dst, bench_Src + 1, len );
+  }
+
+  return ( (hostBenchSec() - start) * 1e9 / calls );
+}
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   Host time per call of the OSAL copy and compare functions
+ *          against the byte loops they replaced, for the lengths of a
+ *          key, a ZCL frame, an NV item and an AF payload. On the 8051
+ *          the gain is in the loop count: osal_memcpy runs one pass per
+ *          eight bytes, osal_revmemcpy and osal_memcmp one per four.
+ *          The DMA path for long copies needs the CC2530 and is not run.
+ */
+int main( void )
+{
+  static const uint16 lens[] = { 16, 48, 100, 256 };
+  uint32 sameLoop = 0, sameOsal = 0;
+  uint16 idx;
+
+  for ( idx = 0; idx < sizeof( bench_Src ); idx++ )
+  {
+    bench_Src[idx] = (uint8)idx;
+  }
+
+  printf( "bytes    memcpy ns (loop)  revmemcpy ns (loop)  memcmp ns (loop)\n" );
+  for ( idx = 0; idx < sizeof( lens ) / sizeof( lens[0] ); idx++ )
+  {
+    uint16 len = lens[idx];
+    double cpy, cpyLoop, rev, revLoop, cmp, cmpLoop;
+
+    cpyLoop = bench_Cpy( bench_LoopCpy, len );
+    cpy = bench_Cpy( osal_memcpy, len );
+    revLoop = bench_Cpy( bench_LoopRevCpy, len );
+    rev = bench_Cpy( osal_revmemcpy, len );
+
+    (void)osal_memcpy( bench_Dst, bench_Src + 1, len );
+    cmpLoop = bench_Cmp( bench_LoopCmp, len, &sameLoop );
+    cmp = bench_Cmp( osal_memcmp, len, &sameOsal );
+
+    printf( "%5u  %8.1f (%6.1f)  %11.1f (%6.1f)  %8.1f (%6.1f)\n",
+            len, cpy, cpyLoop, rev, revLoop, cmp, cmpLoop );
+  }
+
+  HOST_CHECK( sameOsal == sameLoop );
+
+  return hostTestResult( "bench_memcpy" );
+}
+
+/*********************************************************************
+*********************************************************************/
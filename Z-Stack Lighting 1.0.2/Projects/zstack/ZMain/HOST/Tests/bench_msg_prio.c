@@ -0,0 +1,239 @@
+/**************************************************************************************************
+  Filename:       bench_msg_prio.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host benchmark of the latency of urgent messages under a message flood.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include <stdio.h>
+
+#include "ZComDef.h"
+#include "hal_drivers.h"
+#include "OSAL.h"
+#include "OSAL_Tasks.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define BENCH_TASK_APP             1
+
+#define BENCH_FLOOD_EVT            0x01
+#define BENCH_CONFIRM_EVT          0x02
+
+// A confirm is sent every that many messages, this many times per run
+#define BENCH_CONFIRM_EVERY        37
+#define BENCH_CONFIRMS             2000
+
+// Spin count standing in for the handling of one flood message
+#define BENCH_MSG_WORK             200
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+static uint16 bench_event_loop( uint8 task_id, uint16 events );
+
+const pTaskEventHandlerFn tasksArr[] = {
+  Hal_ProcessEvent,
+  bench_event_loop
+};
+
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt);
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt));
+
+  Hal_Init( 0 );
+}
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// Priority given to the confirms of the current run
+static uint8 benchPrio;
+
+static uint32 benchMsgCnt;
+static uint16 benchConfirmCnt;
+static uint8 benchConfirmQueued;
+static double benchConfirmSent;
+
+static double benchLatSum;
+static double benchLatMax;
+
+static volatile uint16 benchSink;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+static void bench_Send( uint8 event, uint8 prio )
+{
+  uint8 *pMsg = osal_msg_allocate( sizeof( osal_event_hdr_t ) );
+
+  if ( pMsg )
+  {
+    ((osal_event_hdr_t *)pMsg)->event = event;
+    OSAL_MSG_PRIO( pMsg ) = prio;
+    osal_msg_send( BENCH_TASK_APP, pMsg );
+  }
+}
+
+/*
+ * The application task handles one message a run, like a sample
+ * application behind a serial port flooding it with MT commands. Each
+ * flood message handled is replaced by a new one, so the queue depth
+ * stays the same.
+ */
+static uint16 bench_event_loop( uint8 task_id, uint16 events )
+{
+  if ( events & SYS_EVENT_MSG )
+  {
+    uint8 *pMsg = osal_msg_receive( task_id );
+
+    if ( pMsg )
+    {
+      if ( ((osal_event_hdr_t *)pMsg)->event == BENCH_CONFIRM_EVT )
+      {
+        double lat = hostBenchSec() - benchConfirmSent;
+
+        benchLatSum += lat;
+        if ( benchLatMax < lat )
+        {
+          benchLatMax = lat;
+        }
+        benchConfirmQueued = FALSE;
+        benchConfirmCnt++;
+      }
+      else
+      {
+        uint16 i;
+
+        for ( i = 0; i < BENCH_MSG_WORK; i++ )
+        {
+          benchSink += i;
+        }
+        bench_Send( BENCH_FLOOD_EVT, OSAL_MSG_PRIO_NORMAL );
+
+        if ( (++benchMsgCnt % BENCH_CONFIRM_EVERY) == 0 && !benchConfirmQueued )
+        {
+          benchConfirmQueued = TRUE;
+          benchConfirmSent = hostBenchSec();
+          bench_Send( BENCH_CONFIRM_EVT, benchPrio );
+        }
+      }
+
+      osal_msg_deallocate( pMsg );
+    }
+
+    return ( events ^ SYS_EVENT_MSG );
+  }
+
+  return 0;
+}
+
+/*
+ * Run the flood at the given queue depth until all the confirms came in.
+ */
+static void bench_Run( uint16 depth, uint8 prio, double *pMax, double *pAvg )
+{
+  uint8 *pMsg;
+  uint16 i;
+
+  benchPrio = prio;
+  benchMsgCnt = 0;
+  benchConfirmCnt = 0;
+  benchConfirmQueued = FALSE;
+  benchLatSum = 0;
+  benchLatMax = 0;
+
+  for ( i = 0; i < depth; i++ )
+  {
+    bench_Send( BENCH_FLOOD_EVT, OSAL_MSG_PRIO_NORMAL );
+  }
+
+  while ( benchConfirmCnt < BENCH_CONFIRMS )
+  {
+    osal_run_system();
+  }
+
+  while ( (pMsg = osal_msg_receive( BENCH_TASK_APP )) != NULL )
+  {
+    osal_msg_deallocate( pMsg );
+  }
+
+  *pMax = benchLatMax * 1e6;
+  *pAvg = benchLatSum * 1e6 / benchConfirmCnt;
+}
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   Worst-case latency of a data confirm sent to a task whose
+ *          queue is flooded, sent as a normal and as an urgent message.
+ */
+int main( void )
+{
+  static const uint16 depths[] = { 1, 10, 50, 100 };
+  uint8 i;
+
+  hostTestBoot();
+
+  printf( "queued  normal max us  avg us  urgent max us  avg us\n" );
+  for ( i = 0; i < sizeof( depths ) / sizeof( depths[0] ); i++ )
+  {
+    double normMax, normAvg, urgMax, urgAvg;
+
+    bench_Run( depths[i], OSAL_MSG_PRIO_NORMAL, &normMax, &normAvg );
+    bench_Run( depths[i], OSAL_MSG_PRIO_URGENT, &urgMax, &urgAvg );
+
+    printf( "%6u  %13.1f  %6.1f  %13.1f  %6.1f\n",
+            depths[i], normMax, normAvg, urgMax, urgAvg );
+  }
+
+  return hostTestResult( "bench_msg_prio" );
+}
+
+/*********************************************************************
+*********************************************************************/
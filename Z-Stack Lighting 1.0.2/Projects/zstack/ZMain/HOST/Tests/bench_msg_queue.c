@@ -0,0 +1,249 @@
+/**************************************************************************************************
+  Filename:       bench_msg_queue.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host benchmark of the per-task OSAL message queues against one global queue.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include <stdio.h>
+
+#include "ZComDef.h"
+#include "hal_drivers.h"
+#include "hal_mcu.h"
+#include "OSAL.h"
+#include "OSAL_Tasks.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define BENCH_TASK_BUSY            1
+#define BENCH_TASK_QUIET           2
+
+#define BENCH_OPS                  200000
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+static uint16 bench_event_loop( uint8 task_id, uint16 events );
+
+const pTaskEventHandlerFn tasksArr[] = {
+  Hal_ProcessEvent,
+  bench_event_loop,
+  bench_event_loop
+};
+
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt);
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt));
+
+  Hal_Init( 0 );
+}
+
+static uint16 bench_event_loop( uint8 task_id, uint16 events )
+{
+  return 0;
+}
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// The single queue shared by all of the tasks, as OSAL used to keep it
+static osal_msg_q_t bench_qHead;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+/*
+ * osal_msg_send() over one queue shared by all of the tasks.
+ */
+static void bench_GlobalSend( uint8 task_id, uint8 *msg_ptr )
+{
+  OSAL_MSG_ID( msg_ptr ) = task_id;
+  osal_msg_enqueue( &bench_qHead, msg_ptr );
+  osal_set_event( task_id, SYS_EVENT_MSG );
+}
+
+/*
+ * osal_msg_receive() over one queue shared by all of the tasks: find the
+ * first message of the task, and go on to a second one to decide whether
+ * SYS_EVENT_MSG stays set.
+ */
+static uint8 *bench_GlobalReceive( uint8 task_id )
+{
+  void *listHdr;
+  void *prevHdr = NULL;
+  void *foundHdr = NULL;
+  halIntState_t intState;
+
+  HAL_ENTER_CRITICAL_SECTION(intState);
+
+  listHdr = bench_qHead;
+
+  while ( listHdr != NULL )
+  {
+    if ( OSAL_MSG_ID( listHdr ) == task_id )
+    {
+      if ( foundHdr == NULL )
+      {
+        foundHdr = listHdr;
+      }
+      else
+      {
+        break;
+      }
+    }
+    if ( foundHdr == NULL )
+    {
+      prevHdr = listHdr;
+    }
+    listHdr = OSAL_MSG_NEXT( listHdr );
+  }
+
+  if ( listHdr != NULL )
+  {
+    osal_set_event( task_id, SYS_EVENT_MSG );
+  }
+  else
+  {
+    osal_clear_event( task_id, SYS_EVENT_MSG );
+  }
+
+  if ( foundHdr != NULL )
+  {
+    osal_msg_extract( &bench_qHead, foundHdr, prevHdr );
+  }
+
+  HAL_EXIT_CRITICAL_SECTION(intState);
+
+  return ( (uint8 *)foundHdr );
+}
+
+/*
+ * Time a send and a receive of the quiet task while the busy task has
+ * 'queued' messages waiting; returns nanoseconds per send and receive.
+ */
+static double bench_Run( uint16 queued, uint8 global )
+{
+  uint8 *pMsg;
+  uint16 i;
+  uint32 n;
+  double t0, t1;
+
+  for ( i = 0; i < queued; i++ )
+  {
+    pMsg = osal_msg_allocate( sizeof( osal_event_hdr_t ) );
+    if ( global )
+    {
+      bench_GlobalSend( BENCH_TASK_BUSY, pMsg );
+    }
+    else
+    {
+      osal_msg_send( BENCH_TASK_BUSY, pMsg );
+    }
+  }
+
+  pMsg = osal_msg_allocate( sizeof( osal_event_hdr_t ) );
+
+  t0 = hostBenchSec();
+  for ( n = 0; n < BENCH_OPS; n++ )
+  {
+    if ( global )
+    {
+      bench_GlobalSend( BENCH_TASK_QUIET, pMsg );
+      pMsg = bench_GlobalReceive( BENCH_TASK_QUIET );
+    }
+    else
+    {
+      osal_msg_send( BENCH_TASK_QUIET, pMsg );
+      pMsg = osal_msg_receive( BENCH_TASK_QUIET );
+    }
+  }
+  t1 = hostBenchSec();
+
+  HOST_CHECK( pMsg != NULL );
+  osal_msg_deallocate( pMsg );
+
+  for ( i = 0; i < queued; i++ )
+  {
+    pMsg = global ? bench_GlobalReceive( BENCH_TASK_BUSY )
+                  : osal_msg_receive( BENCH_TASK_BUSY );
+    HOST_CHECK( pMsg != NULL );
+    osal_msg_deallocate( pMsg );
+  }
+
+  return ( (t1 - t0) * 1e9 / BENCH_OPS );
+}
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   Compare a send and receive with per-task queues against the
+ *          single global queue, with 1, 10 and 100 messages queued for
+ *          another task.
+ */
+int main( void )
+{
+  static const uint16 queued[] = { 1, 10, 100 };
+  uint8 i;
+
+  hostTestBoot();
+
+  printf( "queued  per-task ns  global ns\n" );
+  for ( i = 0; i < sizeof( queued ) / sizeof( queued[0] ); i++ )
+  {
+    double perTask = bench_Run( queued[i], FALSE );
+    double global = bench_Run( queued[i], TRUE );
+
+    printf( "%6u  %11.1f  %9.1f\n", queued[i], perTask, global );
+  }
+
+  return hostTestResult( "bench_msg_queue" );
+}
+
+/*********************************************************************
+*********************************************************************/
@@ -0,0 +1,258 @@
+/**************************************************************************************************
+  Filename:       bench_msg_ref.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Benchmark of the copies saved by reference counted OSAL messages.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include <stdio.h>
+
+#include "ZComDef.h"
+#include "hal_drivers.h"
+#include "OSAL.h"
+#include "OSAL_Tasks.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+/* The buffers of an incoming ZCL report on its way from AF to the
+ * application and MT, sized as on the CC2530: the afIncomingMSGPacket_t
+ * before the ASDU, the zclIncomingMsg_t with the zclReportCmd_t header,
+ * a zclReport_t record, and the MT frame overhead around the indication.
+ */
+#define BENCH_AF_HDR               36
+#define BENCH_ZCL_HDR              20
+#define BENCH_ZCL_REC              5
+#define BENCH_MT_HDR               25
+
+// A report of the level, the on/off state and the color of a light
+#define BENCH_ZCL_FRAME_HDR        3
+#define BENCH_ATTRS                4
+#define BENCH_ATTR_DATA            6
+#define BENCH_ASDU_LEN             (BENCH_ZCL_FRAME_HDR + (BENCH_ATTRS * 3) + BENCH_ATTR_DATA)
+
+#define BENCH_REPORTS              100000
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+const pTaskEventHandlerFn tasksArr[] = {
+  Hal_ProcessEvent
+};
+
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt);
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt));
+
+  Hal_Init( 0 );
+}
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static uint8 bench_Asdu[BENCH_ASDU_LEN];
+
+static uint32 bench_Allocs;
+static uint32 bench_Copied;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+static uint8 *bench_Alloc( uint16 len )
+{
+  bench_Allocs++;
+
+  return osal_msg_allocate( len );
+}
+
+static void bench_Copy( uint8 *pDst, const uint8 *pSrc, uint16 len )
+{
+  bench_Copied += len;
+  (void)osal_memcpy( pDst, pSrc, len );
+}
+
+/*
+ * Deliver one report to each endpoint, and to MT when mt is set. The
+ * copying path is the one before the messages were reference counted:
+ * every endpoint's AF message, every parsed report and the MT indication
+ * copy the data. Otherwise AF copies the ASDU once, the parsed report
+ * and the other endpoints point into it, and MT builds its indication
+ * right in the frame.
+ */
+static void bench_Report( uint8 ref, uint8 endpoints, uint8 mt )
+{
+  uint8 *pFirst = NULL;
+  uint8 ep;
+
+  for ( ep = 0; ep < endpoints; ep++ )
+  {
+    uint8 *pAf, *pZcl;
+
+    if ( !ref || (pFirst == NULL) )
+    {
+      pAf = bench_Alloc( BENCH_AF_HDR + BENCH_ASDU_LEN );
+      bench_Copy( pAf + BENCH_AF_HDR, bench_Asdu, BENCH_ASDU_LEN );
+    }
+    else
+    {
+      pAf = bench_Alloc( BENCH_AF_HDR );
+      (void)osal_msg_attach( pAf, pFirst );
+    }
+
+    if ( ref )
+    {
+      pZcl = bench_Alloc( BENCH_ZCL_HDR + (BENCH_ATTRS * BENCH_ZCL_REC) );
+      (void)osal_msg_attach( pZcl, pAf );
+    }
+    else
+    {
+      pZcl = bench_Alloc( BENCH_ZCL_HDR + (BENCH_ATTRS * BENCH_ZCL_REC) + BENCH_ATTR_DATA );
+      bench_Copy( pZcl + BENCH_ZCL_HDR + (BENCH_ATTRS * BENCH_ZCL_REC),
+                  bench_Asdu + BENCH_ZCL_FRAME_HDR, BENCH_ATTR_DATA );
+    }
+
+    if ( mt && (ep == 0) )
+    {
+      uint8 *pFrame;
+
+      if ( !ref )
+      {
+        // The indication is built, then copied into the transport frame
+        uint8 *pInd = bench_Alloc( BENCH_AF_HDR + BENCH_ASDU_LEN );
+
+        bench_Copy( pInd + BENCH_AF_HDR, pAf + BENCH_AF_HDR, BENCH_ASDU_LEN );
+        pFrame = bench_Alloc( BENCH_MT_HDR + BENCH_ASDU_LEN );
+        bench_Copy( pFrame, pInd, BENCH_AF_HDR + BENCH_ASDU_LEN );
+        (void)osal_msg_deallocate( pInd );
+      }
+      else
+      {
+        pFrame = bench_Alloc( BENCH_MT_HDR + BENCH_ASDU_LEN );
+        bench_Copy( pFrame + BENCH_MT_HDR, pAf + BENCH_AF_HDR, BENCH_ASDU_LEN );
+      }
+      (void)osal_msg_deallocate( pFrame );
+    }
+
+    if ( ref && (pFirst == NULL) )
+    {
+      pFirst = pAf;
+    }
+    else
+    {
+      (void)osal_msg_deallocate( pAf );
+    }
+
+    // The application is done with the report
+    (void)osal_msg_deallocate( pZcl );
+  }
+
+  if ( pFirst != NULL )
+  {
+    (void)osal_msg_deallocate( pFirst );
+  }
+}
+
+static void bench_Run( uint8 endpoints, uint8 mt )
+{
+  uint16 heapUsed = osal_heap_mem_used();
+  uint8 ref;
+
+  printf( "%9u  %3s", endpoints, mt ? "on" : "off" );
+  for ( ref = FALSE; ref <= TRUE; ref++ )
+  {
+    double start;
+    uint32 n;
+
+    bench_Allocs = 0;
+    bench_Copied = 0;
+    start = hostBenchSec();
+    for ( n = 0; n < BENCH_REPORTS; n++ )
+    {
+      bench_Report( ref, endpoints, mt );
+    }
+
+    printf( "  %6.1f  %6.1f  %5.0f",
+            (double)bench_Allocs / BENCH_REPORTS, (double)bench_Copied / BENCH_REPORTS,
+            (hostBenchSec() - start) * 1e9 / BENCH_REPORTS );
+  }
+  printf( "\n" );
+
+  HOST_CHECK( osal_heap_mem_used() == heapUsed );
+}
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   Allocations and bytes copied per incoming ZCL report between
+ *          AF, ZCL and MT, copying at each layer against handing the
+ *          received message on by reference, for one or more endpoints
+ *          and with the MT callback off and on.
+ */
+int main( void )
+{
+  uint8 idx;
+
+  hostTestBoot();
+
+  for ( idx = 0; idx < BENCH_ASDU_LEN; idx++ )
+  {
+    bench_Asdu[idx] = idx;
+  }
+
+  printf( "                   copying                 by reference\n" );
+  printf( "endpoints  MT  allocs  copied     ns  allocs  copied     ns\n" );
+  bench_Run( 1, FALSE );
+  bench_Run( 1, TRUE );
+  bench_Run( 3, FALSE );
+  bench_Run( 3, TRUE );
+
+  return hostTestResult( "bench_msg_ref" );
+}
+
+/*********************************************************************
+*********************************************************************/
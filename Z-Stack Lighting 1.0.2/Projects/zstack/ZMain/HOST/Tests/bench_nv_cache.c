@@ -0,0 +1,218 @@
+/**************************************************************************************************
+  Filename:       bench_nv_cache.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Benchmark of the flash writes saved by the NV write cache.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include <stdio.h>
+
+#include "ZComDef.h"
+#include "hal_board_cfg.h"
+#include "hal_drivers.h"
+#include "hal_sim.h"
+#include "OSAL.h"
+#include "OSAL_Nv.h"
+#include "OSAL_Tasks.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define BENCH_TASK_NV              1
+
+// The items of the direct runs; the cached runs use the next Ids up
+#define BENCH_ID_LEVEL             0x0401
+#define BENCH_ID_SCENES            0x0402
+#define BENCH_ID_CACHED            0x0010
+
+// Move-to-level over 5 s, the level stored on every 20 ms step
+#define BENCH_DIM_STEPS            250
+#define BENCH_DIM_STEP_MS          20
+#define BENCH_DIMS                 20
+
+// Scene records stored one by one, then the count, as the scene table does
+#define BENCH_SCENE_LEN            28
+#define BENCH_SCENES               16
+#define BENCH_SCENE_MS             2000
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+const pTaskEventHandlerFn tasksArr[] = {
+  Hal_ProcessEvent,
+  osal_nv_event_loop
+};
+
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt);
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt));
+
+  Hal_Init( 0 );
+  osal_nv_task_init( BENCH_TASK_NV );
+}
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static uint8 bench_Scenes[2 + BENCH_SCENES * BENCH_SCENE_LEN];
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+static void bench_Words( uint32 *pErases, uint32 *pWords )
+{
+  static uint32 erases0, words0;
+  uint32 erases, words;
+
+  halSimFlashStats( &erases, &words );
+  *pErases = erases - erases0;
+  *pWords = words - words0;
+  erases0 = erases;
+  words0 = words;
+}
+
+/*
+ * Run the dimming and the scene workloads, with or without the items
+ * in the write cache, and report the flash words written by each.
+ */
+static void bench_Run( uint8 cached, uint32 *pDimWords, uint32 *pSceneWords, uint32 *pErases,
+                       uint16 *pHeap )
+{
+  uint16 idLevel = BENCH_ID_LEVEL + (cached ? BENCH_ID_CACHED : 0);
+  uint16 idScenes = BENCH_ID_SCENES + (cached ? BENCH_ID_CACHED : 0);
+  uint32 erases, erases2;
+  uint16 n, k, cnt, fails = 0;
+  uint8 level = 0;
+
+  halSimFlashInit();
+  osal_nv_init( NULL );
+
+  osal_memset( bench_Scenes, 0, sizeof( bench_Scenes ) );
+  osal_nv_item_init( idLevel, 1, &level );
+  osal_nv_item_init( idScenes, sizeof( bench_Scenes ), bench_Scenes );
+  *pHeap = osal_heap_mem_used();
+  if ( cached )
+  {
+    HOST_CHECK( osal_nv_cache_add( idLevel ) == SUCCESS );
+    HOST_CHECK( osal_nv_cache_add( idScenes ) == SUCCESS );
+  }
+  *pHeap = osal_heap_mem_used() - *pHeap;
+  bench_Words( &erases, pDimWords );
+
+  for ( n = 0; n < BENCH_DIMS; n++ )
+  {
+    for ( k = 0; k < BENCH_DIM_STEPS; k++ )
+    {
+      level = (uint8)((n & 1) ? (BENCH_DIM_STEPS - k) : k);
+      if ( osal_nv_write( idLevel, 0, 1, &level ) != SUCCESS )
+      {
+        fails++;
+      }
+      hostTestRun( BENCH_DIM_STEP_MS );
+    }
+    hostTestRun( 10000 );
+  }
+  bench_Words( &erases, pDimWords );
+
+  for ( n = 0; n < BENCH_SCENES; n++ )
+  {
+    uint8 *pRec = bench_Scenes + 2 + n * BENCH_SCENE_LEN;
+
+    osal_memset( pRec, n + 1, BENCH_SCENE_LEN );
+    cnt = n + 1;
+    if ( (osal_nv_write( idScenes, 2 + n * BENCH_SCENE_LEN, BENCH_SCENE_LEN, pRec ) != SUCCESS) ||
+         (osal_nv_write( idScenes, 0, 2, &cnt ) != SUCCESS) )
+    {
+      fails++;
+    }
+    hostTestRun( BENCH_SCENE_MS );
+  }
+  hostTestRun( 10000 );
+  bench_Words( &erases2, pSceneWords );
+  HOST_CHECK( fails == 0 );
+
+  *pErases = erases + erases2;
+}
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   Flash words written by a lamp dimming and storing scenes, with
+ *          the level and scene items written straight to NV against held
+ *          in the NV write cache, and the heap the cache holds for them.
+ *          The scene table is longer than the default
+ *          OSAL_NV_CACHE_ITEM_MAX, which the Makefile raises.
+ */
+int main( void )
+{
+  uint32 dimDirect, sceneDirect, erasesDirect;
+  uint32 dimCached, sceneCached, erasesCached;
+  uint16 heapDirect, heapCached;
+
+  hostTestBoot();
+
+  bench_Run( FALSE, &dimDirect, &sceneDirect, &erasesDirect, &heapDirect );
+  bench_Run( TRUE, &dimCached, &sceneCached, &erasesCached, &heapCached );
+
+  printf( "workload                     direct words  cached words\n" );
+  printf( "%2u dims of %u level steps  %12lu  %12lu\n", BENCH_DIMS, BENCH_DIM_STEPS,
+          (unsigned long)dimDirect, (unsigned long)dimCached );
+  printf( "%2u scene stores              %12lu  %12lu\n", BENCH_SCENES,
+          (unsigned long)sceneDirect, (unsigned long)sceneCached );
+  printf( "page erases                  %12lu  %12lu\n",
+          (unsigned long)erasesDirect, (unsigned long)erasesCached );
+  printf( "heap held by the cache        %12u  %12u bytes\n", heapDirect, heapCached );
+
+  HOST_CHECK( dimCached * 10 < dimDirect );
+  HOST_CHECK( sceneCached < sceneDirect );
+
+  return hostTestResult( "bench_nv_cache" );
+}
+
+/*********************************************************************
+*********************************************************************/
@@ -0,0 +1,221 @@
+/**************************************************************************************************
+  Filename:       bench_nv_latency.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host simulator of the worst-case NV write latency, with and without background compaction.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include <stdio.h>
+
+#include "ZComDef.h"
+#include "hal_drivers.h"
+#include "hal_sim.h"
+#include "OSAL.h"
+#include "OSAL_Nv.h"
+#include "OSAL_Tasks.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define BENCH_TASK_NV              1
+
+#define BENCH_ID_BASE              0x0300
+#define BENCH_ITEMS                40
+#define BENCH_ITEM_MAX             128
+
+#define BENCH_WRITES               50000
+
+// Flash timing of the CC2530 (datasheet): page erase and Flash-WORD write
+#define BENCH_ERASE_MS             20.0
+#define BENCH_WORD_MS              0.020
+
+// A write slower than this misses a ZLL touchlink response window
+#define BENCH_SLOW_MS              15.0
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+const pTaskEventHandlerFn tasksArr[] = {
+  Hal_ProcessEvent,
+#if defined ( OSAL_NV_COMPACT_TASK )
+  osal_nv_event_loop
+#endif
+};
+
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt);
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt));
+
+  Hal_Init( 0 );
+#if defined ( OSAL_NV_COMPACT_TASK )
+  osal_nv_task_init( BENCH_TASK_NV );
+#endif
+}
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static uint16 bench_Len[BENCH_ITEMS];
+static uint32 bench_Seed = 4242;
+
+static uint32 bench_Erases;
+static uint32 bench_Words;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+static uint16 bench_Rand( void )
+{
+  bench_Seed = bench_Seed * 1103515245 + 12345;
+
+  return ( (uint16)(bench_Seed >> 16) & 0x7FFF );
+}
+
+/*
+ * Flash time, in milliseconds, since the previous call.
+ */
+static double bench_FlashMs( void )
+{
+  uint32 erases, words;
+  double ms;
+
+  halSimFlashStats( &erases, &words );
+  ms = ((erases - bench_Erases) * BENCH_ERASE_MS) + ((words - bench_Words) * BENCH_WORD_MS);
+  bench_Erases = erases;
+  bench_Words = words;
+
+  return ( ms );
+}
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   Worst-case time an osal_nv_write() holds up the OSAL loop in
+ *          flash operations, with the pages compacted inside the writes
+ *          or by the NV task between them.
+ */
+int main( void )
+{
+  uint8 buf[BENCH_ITEM_MAX];
+  double ms, writeMax = 0, writeSum = 0;
+#if defined ( OSAL_NV_COMPACT_TASK )
+  double taskMax = 0;
+#endif
+  uint32 slow = 0, fails = 0, n;
+  uint8 k;
+
+  hostTestBoot();
+  osal_nv_init( NULL );
+
+  for ( k = 0; k < BENCH_ITEMS; k++ )
+  {
+    bench_Len[k] = 8 + (bench_Rand() % ((k < 4) ? 120 : 40));
+    osal_memset( buf, k, bench_Len[k] );
+    osal_nv_item_init( BENCH_ID_BASE + k, bench_Len[k], buf );
+  }
+  bench_FlashMs();
+
+  for ( n = 0; n < BENCH_WRITES; n++ )
+  {
+    uint8 i;
+
+    k = bench_Rand() % BENCH_ITEMS;
+    for ( i = 0; i < bench_Len[k]; i++ )
+    {
+      buf[i] = (uint8)bench_Rand();
+    }
+
+    if ( osal_nv_write( BENCH_ID_BASE + k, 0, bench_Len[k], buf ) != SUCCESS )
+    {
+      fails++;
+    }
+    ms = bench_FlashMs();
+    writeSum += ms;
+    if ( writeMax < ms )
+    {
+      writeMax = ms;
+    }
+    if ( ms > BENCH_SLOW_MS )
+    {
+      slow++;
+    }
+
+#if defined ( OSAL_NV_COMPACT_TASK )
+    // The loop is idle between writes: the NV task catches up one event a pass
+    while ( tasksEvents[BENCH_TASK_NV] != 0 )
+    {
+      osal_run_system();
+      ms = bench_FlashMs();
+      if ( taskMax < ms )
+      {
+        taskMax = ms;
+      }
+    }
+#endif
+  }
+
+  HOST_CHECK( fails == 0 );
+
+#if defined ( OSAL_NV_COMPACT_TASK )
+  printf( "background compaction: " );
+#else
+  printf( "compaction in the write: " );
+#endif
+  printf( "%lu writes, worst %.2f ms, mean %.3f ms, %lu over %.0f ms",
+          (unsigned long)BENCH_WRITES, writeMax, writeSum / BENCH_WRITES,
+          (unsigned long)slow, BENCH_SLOW_MS );
+#if defined ( OSAL_NV_COMPACT_TASK )
+  printf( ", worst NV task event %.2f ms", taskMax );
+#endif
+  printf( "\n" );
+
+  return hostTestResult( "bench_nv_latency" );
+}
+
+/*********************************************************************
+*********************************************************************/
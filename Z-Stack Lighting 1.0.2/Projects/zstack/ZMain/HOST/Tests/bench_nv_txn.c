@@ -0,0 +1,197 @@
+/**************************************************************************************************
+  Filename:       bench_nv_txn.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host benchmark of the flash wear of NV transactions against per-item writes.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include <stdio.h>
+
+#include "ZComDef.h"
+#include "hal_board_cfg.h"
+#include "hal_drivers.h"
+#include "hal_sim.h"
+#include "OSAL.h"
+#include "OSAL_Nv.h"
+#include "OSAL_Tasks.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Items like the ZLL NIB and range items written by zll_UpdateNV()
+#define BENCH_ID_BASE              0x0200
+#define BENCH_ITEMS                30
+#define BENCH_ITEM_MAX             64
+
+#define BENCH_COMMITS              5000
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+const pTaskEventHandlerFn tasksArr[] = {
+  Hal_ProcessEvent
+};
+
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt);
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt));
+
+  Hal_Init( 0 );
+}
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static uint8 bench_Data[BENCH_ITEMS][BENCH_ITEM_MAX];
+static uint16 bench_Len[BENCH_ITEMS];
+static uint32 bench_Seed;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+static uint16 bench_Rand( void )
+{
+  bench_Seed = bench_Seed * 1103515245 + 12345;
+
+  return ( (uint16)(bench_Seed >> 16) & 0x7FFF );
+}
+
+/*
+ * Write groups of cnt items, all changed, in transactions or one by one,
+ * and report the flash wear per group.
+ */
+static void bench_Run( uint8 cnt, uint8 txn, double *pBytes, double *pErases )
+{
+  uint32 erases0, writes0, erases, writes;
+  uint16 n, fails = 0;
+  uint8 k;
+
+  halSimFlashInit();
+  osal_nv_init( NULL );
+
+  bench_Seed = 4242;
+  for ( k = 0; k < BENCH_ITEMS; k++ )
+  {
+    bench_Len[k] = 8 + (bench_Rand() % ((k < 3) ? 56 : 24));
+    osal_memset( bench_Data[k], k, bench_Len[k] );
+    osal_nv_item_init( BENCH_ID_BASE + k, bench_Len[k], bench_Data[k] );
+  }
+
+  halSimFlashStats( &erases0, &writes0 );
+
+  for ( n = 0; n < BENCH_COMMITS; n++ )
+  {
+    uint8 first = bench_Rand() % BENCH_ITEMS;
+    uint8 i;
+
+    if ( txn )
+    {
+      osal_nv_txn_begin();
+    }
+
+    for ( i = 0; i < cnt; i++ )
+    {
+      k = (first + i) % BENCH_ITEMS;
+      bench_Data[k][bench_Rand() % bench_Len[k]]++;
+
+      if ( txn )
+      {
+        osal_nv_txn_stage( BENCH_ID_BASE + k, 0, bench_Len[k], bench_Data[k] );
+      }
+      else
+      {
+        osal_nv_write( BENCH_ID_BASE + k, 0, bench_Len[k], bench_Data[k] );
+      }
+    }
+
+    if ( txn )
+    {
+      if ( osal_nv_txn_commit() != SUCCESS )
+      {
+        fails++;
+      }
+    }
+  }
+  HOST_CHECK( fails == 0 );
+
+  halSimFlashStats( &erases, &writes );
+
+  *pBytes = (double)(writes - writes0) * HAL_FLASH_WORD_SIZE / BENCH_COMMITS;
+  *pErases = (double)(erases - erases0) * 1000 / BENCH_COMMITS;
+}
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   Flash wear of a group of item writes committed as one
+ *          transaction against one osal_nv_write() per item.
+ */
+int main( void )
+{
+  static const uint8 counts[] = { 1, 2, 4, 7 };
+  uint8 i;
+
+  hostTestBoot();
+
+  printf( "items  per-item bytes  erases/1000  txn bytes  erases/1000\n" );
+  for ( i = 0; i < sizeof( counts ) / sizeof( counts[0] ); i++ )
+  {
+    double itemBytes, itemErases, txnBytes, txnErases;
+
+    bench_Run( counts[i], FALSE, &itemBytes, &itemErases );
+    bench_Run( counts[i], TRUE, &txnBytes, &txnErases );
+
+    printf( "%5u  %14.1f  %11.1f  %9.1f  %11.1f\n",
+            counts[i], itemBytes, itemErases, txnBytes, txnErases );
+  }
+
+  return hostTestResult( "bench_nv_txn" );
+}
+
+/*********************************************************************
+*********************************************************************/
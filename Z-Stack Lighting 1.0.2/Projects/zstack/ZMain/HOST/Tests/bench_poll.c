@@ -0,0 +1,165 @@
+/**************************************************************************************************
+  Filename:       bench_poll.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Benchmark of polling the UART on every pass against pending polls.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include <stdio.h>
+
+#include "ZComDef.h"
+#include "hal_drivers.h"
+#include "hal_sim.h"
+#include "hal_uart.h"
+#include "OSAL.h"
+#include "OSAL_Tasks.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+/* The cost of a poll of the DMA UART on the CC2530: an idle poll checks
+ * the Rx ring and the Tx state, a busy one also hands a few bytes on.
+ */
+#define BENCH_POLL_USEC            20
+#define BENCH_POLL_BYTE_USEC       4
+#define BENCH_POLL_BYTES           16
+
+#define BENCH_SECONDS              10
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+const pTaskEventHandlerFn tasksArr[] = {
+  Hal_ProcessEvent
+};
+
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt);
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt));
+
+  Hal_Init( 0 );
+}
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static uint32 bench_RxBytes;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+void HalUARTInit( void )
+{
+}
+
+void HalUARTPoll( void )
+{
+  uint32 bytes = (bench_RxBytes < BENCH_POLL_BYTES) ? bench_RxBytes : BENCH_POLL_BYTES;
+
+  halSimClockAdvance( BENCH_POLL_USEC + (bytes * BENCH_POLL_BYTE_USEC) );
+  bench_RxBytes -= bytes;
+  if ( bench_RxBytes != 0 )
+  {
+    HAL_POLL_UART_SET();
+  }
+}
+
+/*
+ * Run the OSAL loop while frames of the given length come in every period
+ * milliseconds, each one raising the Rx interrupt once.
+ */
+static void bench_Run( const char *name, uint16 frameLen, uint16 period )
+{
+  uint32 end = halSimClockMs() + (BENCH_SECONDS * 1000);
+  uint32 next = halSimClockMs();
+  halPollStats_t stats;
+
+  bench_RxBytes = 0;
+  HalPollStatsReset();
+  while ( (int32)(halSimClockMs() - end) < 0 )
+  {
+    if ( (frameLen != 0) && ((int32)(halSimClockMs() - next) >= 0) )
+    {
+      bench_RxBytes += frameLen;
+      HAL_POLL_UART_SET();
+      next += period;
+    }
+    osal_run_system();
+  }
+  HalPollStatsGet( &stats );
+
+  printf( "%-22s  %8u  %8u  %7.1f\n", name,
+          stats.passes / BENCH_SECONDS, stats.uartPolls / BENCH_SECONDS,
+          (double)stats.usec / (BENCH_SECONDS * 10000) );
+  HOST_CHECK( (stats.uartPolls <= stats.passes) && (bench_RxBytes <= BENCH_POLL_BYTES * 2) );
+}
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   Passes through the OSAL loop per second, UART polls per
+ *          second and the share of the time spent polling, idle and
+ *          with MT traffic on the UART. Built once polling the UART on
+ *          every pass and once with HAL_POLL_PENDING.
+ */
+int main( void )
+{
+  hostTestBoot();
+
+  printf( "UART polls: %s\n", HAL_POLL_PENDING ? "pending" : "every pass" );
+  printf( "load                    passes/s   polls/s  polling %%\n" );
+  bench_Run( "idle", 0, 0 );
+  bench_Run( "20 bytes / 100 ms", 20, 100 );
+  bench_Run( "20 bytes / 10 ms", 20, 10 );
+  bench_Run( "115200 baud", 12, 1 );
+
+  return hostTestResult( HAL_POLL_PENDING ? "bench_poll" : "bench_poll_always" );
+}
+
+/*********************************************************************
+*********************************************************************/
@@ -0,0 +1,200 @@
+/**************************************************************************************************
+  Filename:       bench_ready_map.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host benchmark of the OSAL loop with the task table of the sample apps.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include <stdio.h>
+
+#include "ZComDef.h"
+#include "hal_drivers.h"
+#include "OSAL.h"
+#include "OSAL_Tasks.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// The tasks of OSAL_SampleLight.c and OSAL_SampleBridge.c, which only
+// differ by the ZLL task, with all the optional ones enabled
+#define BENCH_TASK_HAL             2
+#define BENCH_TASK_APP             11
+#define BENCH_TASK_CNT             13
+
+#define BENCH_PASSES               1000000
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+static uint16 bench_event_loop( uint8 task_id, uint16 events );
+
+const pTaskEventHandlerFn tasksArr[BENCH_TASK_CNT] = {
+  bench_event_loop,  // macEventLoop
+  bench_event_loop,  // nwk_event_loop
+  Hal_ProcessEvent,
+  bench_event_loop,  // MT_ProcessEvent
+  bench_event_loop,  // APS_event_loop
+  bench_event_loop,  // APSF_ProcessEvent
+  bench_event_loop,  // ZDApp_event_loop
+  bench_event_loop,  // ZDNwkMgr_event_loop
+  bench_event_loop,  // StubAPS_ProcessEvent
+  bench_event_loop,  // zcl_event_loop
+  bench_event_loop,  // zllTarget_event_loop, zllInitiator_event_loop
+  bench_event_loop,  // zllSampleLight_event_loop, zllSampleBridge_event_loop
+  bench_event_loop   // osal_nv_event_loop
+};
+
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt);
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt));
+
+  Hal_Init( BENCH_TASK_HAL );
+}
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static volatile uint8 benchSink;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+// The task keeps its event, so that it is ready on every pass
+static uint16 bench_event_loop( uint8 task_id, uint16 events )
+{
+  return ( events );
+}
+
+/*
+ * Cost of a pass through osal_run_system(), which looks the task up in the
+ * ready-task bitmap.
+ */
+static double bench_Pass( void )
+{
+  double start = hostBenchSec();
+  uint32 i;
+
+  for ( i = 0; i < BENCH_PASSES; i++ )
+  {
+    osal_run_system();
+  }
+
+  return ( (hostBenchSec() - start) * 1e9 / BENCH_PASSES );
+}
+
+/*
+ * Cost of the lookup it replaced: a scan of tasksEvents for the first task
+ * with events.
+ */
+static double bench_Scan( void )
+{
+  double start = hostBenchSec();
+  uint32 i;
+
+  for ( i = 0; i < BENCH_PASSES; i++ )
+  {
+    uint8 idx = 0;
+
+    do
+    {
+      if ( tasksEvents[idx] )
+      {
+        break;
+      }
+    } while ( ++idx < tasksCnt );
+
+    benchSink = idx;
+  }
+
+  return ( (hostBenchSec() - start) * 1e9 / BENCH_PASSES );
+}
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   Cost of a pass through the OSAL loop with the task table of
+ *          the sample light and bridge, idle and with one task ready.
+ */
+int main( void )
+{
+  static const uint8 ready[] = { BENCH_TASK_CNT, 1, 6, BENCH_TASK_APP, BENCH_TASK_CNT - 1 };
+  uint8 i;
+
+  hostTestBoot();
+  hostTestRun( 10 );
+
+  printf( "%u tasks\n", tasksCnt );
+  printf( "ready task  pass ns  scan ns\n" );
+  for ( i = 0; i < sizeof( ready ) / sizeof( ready[0] ); i++ )
+  {
+    double pass, scan;
+
+    if ( ready[i] < tasksCnt )
+    {
+      osal_set_event( ready[i], 0x0001 );
+    }
+
+    pass = bench_Pass();
+    scan = bench_Scan();
+
+    if ( ready[i] < tasksCnt )
+    {
+      osal_clear_event( ready[i], 0x0001 );
+      printf( "%10u  %7.1f  %7.1f\n", ready[i], pass, scan );
+    }
+    else
+    {
+      printf( "%10s  %7.1f  %7.1f\n", "none", pass, scan );
+    }
+  }
+
+  return hostTestResult( "bench_ready_map" );
+}
+
+/*********************************************************************
+*********************************************************************/
@@ -0,0 +1,151 @@
+/**************************************************************************************************
+  Filename:       bench_timers.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host benchmark of the OSAL timer engine with up to 64 timers.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include <stdio.h>
+
+#include "ZComDef.h"
+#include "hal_drivers.h"
+#include "OSAL.h"
+#include "OSAL_Tasks.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define BENCH_TICKS                1000000
+#define BENCH_RESTARTS             200000
+
+// Far enough out that no timer expires during the benchmark
+#define BENCH_TIMEOUT              3600000
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+static uint16 bench_event_loop( uint8 task_id, uint16 events );
+
+const pTaskEventHandlerFn tasksArr[] = {
+  Hal_ProcessEvent,
+  bench_event_loop,
+  bench_event_loop,
+  bench_event_loop,
+  bench_event_loop
+};
+
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt);
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt));
+
+  Hal_Init( 0 );
+}
+
+static uint16 bench_event_loop( uint8 task_id, uint16 events )
+{
+  return 0;
+}
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   Time the 1 ms timer tick, a timer restart and the next-expiry
+ *          query with 1 to 64 concurrent timers.
+ */
+int main( void )
+{
+  static const uint8 counts[] = { 1, 8, 16, 32, 64 };
+  double t0, tick, restart, next;
+  uint32 n;
+  uint8 i, k;
+
+  hostTestBoot();
+
+  printf( "timers  tick ns  restart ns  next ns\n" );
+  for ( i = 0; i < sizeof( counts ) / sizeof( counts[0] ); i++ )
+  {
+    for ( k = 0; k < counts[i]; k++ )
+    {
+      osal_start_timerEx( 1 + (k / 16), BV( k % 16 ), BENCH_TIMEOUT + (k * 100) );
+    }
+    HOST_CHECK( osal_timer_num_active() == counts[i] );
+
+    t0 = hostBenchSec();
+    for ( n = 0; n < BENCH_TICKS; n++ )
+    {
+      osalTimerUpdate( 1 );
+    }
+    tick = (hostBenchSec() - t0) * 1e9 / BENCH_TICKS;
+
+    // Restart the timer in the middle of the list
+    k = counts[i] / 2;
+    t0 = hostBenchSec();
+    for ( n = 0; n < BENCH_RESTARTS; n++ )
+    {
+      osal_start_timerEx( 1 + (k / 16), BV( k % 16 ), BENCH_TIMEOUT );
+    }
+    restart = (hostBenchSec() - t0) * 1e9 / BENCH_RESTARTS;
+
+    t0 = hostBenchSec();
+    for ( n = 0; n < BENCH_RESTARTS; n++ )
+    {
+      (void)osal_next_timeout();
+    }
+    next = (hostBenchSec() - t0) * 1e9 / BENCH_RESTARTS;
+
+    printf( "%6u  %7.1f  %10.1f  %7.1f\n", counts[i], tick, restart, next );
+
+    for ( k = 0; k < counts[i]; k++ )
+    {
+      HOST_CHECK( osal_stop_timerEx( 1 + (k / 16), BV( k % 16 ) ) == SUCCESS );
+    }
+  }
+
+  return hostTestResult( "bench_timers" );
+}
+
+/*********************************************************************
+*********************************************************************/
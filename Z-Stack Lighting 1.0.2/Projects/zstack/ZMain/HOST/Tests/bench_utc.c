@@ -0,0 +1,220 @@
+/**************************************************************************************************
+  Filename:       bench_utc.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Benchmark of the UTC calendar conversions.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include <stdio.h>
+
+#include "ZComDef.h"
+#include "hal_drivers.h"
+#include "OSAL.h"
+#include "OSAL_Clock.h"
+#include "OSAL_Tasks.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define BENCH_BEGYEAR              2000
+#define BENCH_DAY                  86400UL
+#define BENCH_DAYS                 (0xFFFFFFFFUL / BENCH_DAY)
+#define BENCH_ROUNDS               20
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+const pTaskEventHandlerFn tasksArr[] = {
+  Hal_ProcessEvent
+};
+
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt);
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt));
+
+  Hal_Init( 0 );
+}
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// Loop passes taken by the year and month loops
+static uint32 bench_Loops;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+/*
+ * The conversions as they were, walking the years and then the months
+ * from 2000, as the baseline.
+ */
+static uint8 bench_MonthLength( uint8 lpyr, uint8 mon )
+{
+  uint8 days = 31;
+
+  if ( mon == 1 ) // feb
+  {
+    days = ( 28 + lpyr );
+  }
+  else
+  {
+    if ( mon > 6 ) // aug-dec
+    {
+      mon--;
+    }
+
+    if ( mon & 1 )
+    {
+      days = 30;
+    }
+  }
+
+  return ( days );
+}
+
+#define BENCH_YEAR_LENGTH( yr )  ((uint16)(IsLeapYear( yr ) ? 366 : 365))
+
+static void bench_LoopUTCTime( UTCTimeStruct *tm, UTCTime secTime )
+{
+  uint32 day = secTime % BENCH_DAY;
+  uint16 numDays = secTime / BENCH_DAY;
+
+  tm->seconds = day % 60UL;
+  tm->minutes = (day % 3600UL) / 60UL;
+  tm->hour = day / 3600UL;
+
+  tm->year = BENCH_BEGYEAR;
+  while ( numDays >= BENCH_YEAR_LENGTH( tm->year ) )
+  {
+    numDays -= BENCH_YEAR_LENGTH( tm->year );
+    tm->year++;
+    bench_Loops++;
+  }
+
+  tm->month = 0;
+  while ( numDays >= bench_MonthLength( IsLeapYear( tm->year ), tm->month ) )
+  {
+    numDays -= bench_MonthLength( IsLeapYear( tm->year ), tm->month );
+    tm->month++;
+    bench_Loops++;
+  }
+
+  tm->day = numDays;
+}
+
+static UTCTime bench_LoopUTCSecs( UTCTimeStruct *tm )
+{
+  uint32 seconds = (((tm->hour * 60UL) + tm->minutes) * 60UL) + tm->seconds;
+  uint16 days = tm->day;
+  int8 month = tm->month;
+  uint16 year = tm->year;
+
+  while ( --month >= 0 )
+  {
+    days += bench_MonthLength( IsLeapYear( tm->year ), month );
+    bench_Loops++;
+  }
+
+  while ( --year >= BENCH_BEGYEAR )
+  {
+    days += BENCH_YEAR_LENGTH( year );
+    bench_Loops++;
+  }
+
+  return ( seconds + (days * BENCH_DAY) );
+}
+
+/*
+ * Convert a time on every day of the range both ways, returns the host ns
+ * per round trip.
+ */
+static double bench_Run( void (*pToTime)( UTCTimeStruct *, UTCTime ),
+                         UTCTime (*pToSecs)( UTCTimeStruct * ), uint32 *pSum )
+{
+  double start = hostBenchSec();
+  UTCTimeStruct tm;
+  uint32 round, day;
+
+  for ( round = 0; round < BENCH_ROUNDS; round++ )
+  {
+    for ( day = 0; day < BENCH_DAYS; day++ )
+    {
+      pToTime( &tm, (day * BENCH_DAY) + (day * 7919UL) % BENCH_DAY );
+      *pSum += pToSecs( &tm );
+    }
+  }
+
+  return ( (hostBenchSec() - start) * 1e9 / ((double)BENCH_ROUNDS * BENCH_DAYS) );
+}
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   Host time of a round trip through the calendar conversions
+ *          over the UTCTime range, against the year and month loops they
+ *          replaced. The loop passes are what the 8051 no longer runs,
+ *          each with a leap year test of 16-bit divisions.
+ */
+int main( void )
+{
+  uint32 sumLoop = 0, sumTable = 0;
+  double nsLoop, nsTable;
+
+  nsLoop = bench_Run( bench_LoopUTCTime, bench_LoopUTCSecs, &sumLoop );
+  nsTable = bench_Run( osal_ConvertUTCTime, osal_ConvertUTCSecs, &sumTable );
+  HOST_CHECK( sumLoop == sumTable );
+
+  printf( "year/month loops: %.1f ns per round trip, %.1f loop passes\n",
+          nsLoop, (double)bench_Loops / ((double)BENCH_ROUNDS * BENCH_DAYS) );
+  printf( "closed form:      %.1f ns per round trip, no loops\n", nsTable );
+
+  return hostTestResult( "bench_utc" );
+}
+
+/*********************************************************************
+*********************************************************************/
@@ -0,0 +1,241 @@
+/**************************************************************************************************
+  Filename:       bench_wakeups.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Wakeups per hour of the sample remote's timers, with and without slack.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include <stdio.h>
+
+#include "ZComDef.h"
+#include "hal_drivers.h"
+#include "hal_sim.h"
+#include "OSAL.h"
+#include "OSAL_PwrMgr.h"
+#include "OSAL_Tasks.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Tasks standing in for the ones of the sample remote
+#define BENCH_NWK_TASK             1
+#define BENCH_HAL_TASK             2
+#define BENCH_ZCL_TASK             3
+#define BENCH_APP_TASK             4
+
+#define BENCH_POLL_EVT             0x0001
+#define BENCH_KEY_EVT              0x0001
+#define BENCH_LED_EVT              0x0002
+#define BENCH_REPORT_EVT           0x0001
+#define BENCH_USE_EVT              0x0001
+
+// Timers of the sample remote: POLL_RATE and SAMPLEREMOTE_POLL_SLACK, the
+// held-key repeat of hal_key.c, a blink step of HalLedBlink( leds, 4, 50,
+// 500 ) with HAL_LED_BLINK_SLACK, and a report with a 60 s maximum
+// reporting interval and ZCL_REPORT_SLACK
+#define BENCH_POLL_MSEC            1000
+#define BENCH_POLL_SLACK           50
+#define BENCH_KEY_MSEC             200
+#define BENCH_KEY_SLACK            50
+#define BENCH_LED_MSEC             250
+#define BENCH_LED_SLACK            30
+#define BENCH_REPORT_MSEC          60000
+#define BENCH_REPORT_SLACK         1000
+
+// Once every BENCH_USE_MSEC the user holds a key for 2 s, and the LED
+// blinks 4 times
+#define BENCH_USE_MSEC             30000
+#define BENCH_KEY_REPEATS          10
+#define BENCH_LED_STEPS            8
+
+#define BENCH_RUN_MSEC             3600000UL
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+static uint16 bench_event_loop( uint8 task_id, uint16 events );
+
+const pTaskEventHandlerFn tasksArr[] = {
+  Hal_ProcessEvent,
+  bench_event_loop,
+  bench_event_loop,
+  bench_event_loop,
+  bench_event_loop
+};
+
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt);
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt));
+
+  Hal_Init( 0 );
+}
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static uint8 bench_Slack;
+static uint8 bench_KeyRepeats;
+static uint8 bench_LedSteps;
+static uint32 bench_Polls;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+static uint16 bench_event_loop( uint8 task_id, uint16 events )
+{
+  if ( task_id == BENCH_NWK_TASK )
+  {
+    bench_Polls++;
+  }
+  else if ( task_id == BENCH_HAL_TASK )
+  {
+    if ( events & BENCH_KEY_EVT )
+    {
+      if ( bench_KeyRepeats && --bench_KeyRepeats )
+      {
+        osal_start_timer_slack( BENCH_HAL_TASK, BENCH_KEY_EVT, BENCH_KEY_MSEC,
+                                bench_Slack ? BENCH_KEY_SLACK : 0 );
+      }
+      return ( events ^ BENCH_KEY_EVT );
+    }
+
+    if ( bench_LedSteps && --bench_LedSteps )
+    {
+      osal_start_timer_slack( BENCH_HAL_TASK, BENCH_LED_EVT, BENCH_LED_MSEC,
+                              bench_Slack ? BENCH_LED_SLACK : 0 );
+    }
+    return ( events ^ BENCH_LED_EVT );
+  }
+  else if ( task_id == BENCH_ZCL_TASK )
+  {
+    osal_start_timer_slack( BENCH_ZCL_TASK, BENCH_REPORT_EVT, BENCH_REPORT_MSEC,
+                            bench_Slack ? BENCH_REPORT_SLACK : 0 );
+  }
+  else
+  {
+    // The key press wakes the device, whatever the timers
+    osal_start_timerEx( BENCH_APP_TASK, BENCH_USE_EVT, BENCH_USE_MSEC );
+
+    bench_KeyRepeats = BENCH_KEY_REPEATS;
+    osal_start_timer_slack( BENCH_HAL_TASK, BENCH_KEY_EVT, BENCH_KEY_MSEC,
+                            bench_Slack ? BENCH_KEY_SLACK : 0 );
+    bench_LedSteps = BENCH_LED_STEPS;
+    osal_start_timer_slack( BENCH_HAL_TASK, BENCH_LED_EVT, BENCH_LED_MSEC,
+                            bench_Slack ? BENCH_LED_SLACK : 0 );
+  }
+
+  return 0;
+}
+
+/*********************************************************************
+ * @fn      bench_Run
+ *
+ * @brief   Run the remote for an hour and print its wakeups.
+ *
+ * @param   slack - TRUE to give the timers their slack
+ *
+ * @return  wakeups in the hour
+ */
+static uint16 bench_Run( uint8 slack )
+{
+  uint16 wakes;
+
+  bench_Slack = slack;
+  bench_Polls = 0;
+
+  // The NWK library starts the poll timer without a slack
+  osal_set_timer_slack( BENCH_NWK_TASK, BENCH_POLL_EVT, slack ? BENCH_POLL_SLACK : 0 );
+  osal_start_reload_timer( BENCH_NWK_TASK, BENCH_POLL_EVT, BENCH_POLL_MSEC );
+  osal_start_timer_slack( BENCH_ZCL_TASK, BENCH_REPORT_EVT, BENCH_REPORT_MSEC,
+                          slack ? BENCH_REPORT_SLACK : 0 );
+  osal_start_timerEx( BENCH_APP_TASK, BENCH_USE_EVT, BENCH_USE_MSEC );
+
+  osal_pwrmgr_wake_reset();
+  hostTestRun( BENCH_RUN_MSEC );
+  wakes = osal_pwrmgr_wake_cnt( TASK_NO_TASK );
+
+  printf( "%-8s %7u %7u %7u %7u %7u %7lu\n", slack ? "slack" : "none", wakes,
+          osal_pwrmgr_wake_cnt( BENCH_NWK_TASK ), osal_pwrmgr_wake_cnt( BENCH_HAL_TASK ),
+          osal_pwrmgr_wake_cnt( BENCH_ZCL_TASK ), osal_pwrmgr_wake_cnt( BENCH_APP_TASK ),
+          (unsigned long)bench_Polls );
+
+  osal_stop_timerEx( BENCH_NWK_TASK, BENCH_POLL_EVT );
+  osal_stop_timerEx( BENCH_ZCL_TASK, BENCH_REPORT_EVT );
+  osal_stop_timerEx( BENCH_APP_TASK, BENCH_USE_EVT );
+  bench_KeyRepeats = 0;
+  bench_LedSteps = 0;
+  hostTestRun( BENCH_USE_MSEC );
+
+  return ( wakes );
+}
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   Wakeups per hour of the sample remote, with and without the
+ *          slack of its timers.
+ */
+int main( void )
+{
+  uint16 none, slack;
+
+  hostTestBoot();
+  osal_pwrmgr_device( PWRMGR_BATTERY );
+
+  printf( "timers    wakes/h     nwk     hal     zcl     app   polls\n" );
+  none = bench_Run( FALSE );
+  slack = bench_Run( TRUE );
+  printf( "slack saves %.1f%% of the wakeups\n", 100.0 * (none - slack) / none );
+
+  HOST_CHECK( slack < none );
+
+  return hostTestResult( "bench_wakeups" );
+}
+
+/*********************************************************************
+*********************************************************************/
@@ -0,0 +1,172 @@
+/**************************************************************************************************
+  Filename:       bench_zcl_attr.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Benchmark of the ZCL attribute record lookups, with and without the index.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include <stdio.h>
+
+#include "ZComDef.h"
+#include "hal_drivers.h"
+#include "OSAL.h"
+#include "OSAL_Tasks.h"
+#include "zcl.h"
+#include "zcl_ll.h"
+#include "zll_samplelight.h"
+#include "host_af.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// A full attribute list: 255 records of 15 attributes in each of 17 clusters
+#define BENCH_FULL_EP              20
+#define BENCH_FULL_CLUSTERS        17
+#define BENCH_FULL_ATTRS           15
+#define BENCH_FULL_LEN             (BENCH_FULL_CLUSTERS * BENCH_FULL_ATTRS)
+
+#define BENCH_ROUNDS               20000
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+const pTaskEventHandlerFn tasksArr[] = {
+  Hal_ProcessEvent,
+  zcl_event_loop
+};
+
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt);
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt));
+
+  Hal_Init( 0 );
+  zcl_Init( 1 );
+}
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static zclAttrRec_t bench_Full[BENCH_FULL_LEN];
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+/*
+ * Look up every record of the list, then the next attribute ID of each,
+ * which is mostly missing; prints the time per lookup of both.
+ */
+static void bench_Run( const char *name, uint8 endpoint, const zclAttrRec_t *pList, uint8 numAttr )
+{
+  zclAttrRec_t attrRec;
+  double start, hit, miss;
+  uint32 found = 0;
+  uint16 n;
+  uint8 x;
+
+  start = hostBenchSec();
+  for ( n = 0; n < BENCH_ROUNDS; n++ )
+  {
+    for ( x = 0; x < numAttr; x++ )
+    {
+      found += zclFindAttrRec( endpoint, pList[x].clusterID, pList[x].attr.attrId, &attrRec );
+    }
+  }
+  hit = (hostBenchSec() - start) * 1e9 / ((double)BENCH_ROUNDS * numAttr);
+  HOST_CHECK( found == (uint32)BENCH_ROUNDS * numAttr );
+
+  start = hostBenchSec();
+  for ( n = 0; n < BENCH_ROUNDS; n++ )
+  {
+    for ( x = 0; x < numAttr; x++ )
+    {
+      found += zclFindAttrRec( endpoint, pList[x].clusterID, pList[x].attr.attrId + 0x100, &attrRec );
+    }
+  }
+  miss = (hostBenchSec() - start) * 1e9 / ((double)BENCH_ROUNDS * numAttr);
+
+  printf( "%-14s  %7u  %7.1f  %7.1f\n", name, numAttr, hit, miss );
+}
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   Time per attribute record lookup, for the sample light's
+ *          attributes and for a list of the largest size, found and
+ *          not found. Built with the index and with the scan of
+ *          the list (ZCL_ATTR_INDEX FALSE).
+ */
+int main( void )
+{
+  uint16 heapUsed;
+  uint16 x;
+
+  hostTestBoot();
+
+  heapUsed = osal_heap_mem_used();
+  HOST_CHECK( zcl_registerAttrList( SAMPLELIGHT_ENDPOINT, SAMPLELIGHT_NUM_ATTRIBUTES,
+                                    zllSampleLight_Attrs ) == ZSuccess );
+
+  for ( x = 0; x < BENCH_FULL_LEN; x++ )
+  {
+    bench_Full[x].clusterID = x / BENCH_FULL_ATTRS;
+    bench_Full[x].attr.attrId = x % BENCH_FULL_ATTRS;
+    bench_Full[x].attr.accessControl = ACCESS_CONTROL_READ;
+  }
+  HOST_CHECK( zcl_registerAttrList( BENCH_FULL_EP, BENCH_FULL_LEN, bench_Full ) == ZSuccess );
+
+  printf( "attribute lookups: %s, %u bytes of heap\n", ZCL_ATTR_INDEX ? "index" : "scan",
+          osal_heap_mem_used() - heapUsed );
+  printf( "list            records   hit ns  miss ns\n" );
+  bench_Run( "sample light", SAMPLELIGHT_ENDPOINT, zllSampleLight_Attrs, SAMPLELIGHT_NUM_ATTRIBUTES );
+  bench_Run( "full", BENCH_FULL_EP, bench_Full, BENCH_FULL_LEN );
+
+  return hostTestResult( ZCL_ATTR_INDEX ? "bench_zcl_attr" : "bench_zcl_attr_scan" );
+}
+
+/*********************************************************************
+*********************************************************************/
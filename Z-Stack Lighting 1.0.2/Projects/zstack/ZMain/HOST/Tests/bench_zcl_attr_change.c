@@ -0,0 +1,228 @@
+/**************************************************************************************************
+  Filename:       bench_zcl_attr_change.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host benchmark of the ZCL attribute change tracking.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include <stdio.h>
+
+#include "ZComDef.h"
+#include "hal_drivers.h"
+#include "OSAL.h"
+#include "OSAL_Tasks.h"
+#include "zcl.h"
+#include "zcl_lighting.h"
+#include "zcl_ll.h"
+#include "zll_samplelight.h"
+#include "host_af.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// zclColor_process() steps a color transition every 100 ms
+#define BENCH_STEPS_PER_SEC        10
+#define BENCH_STEPS                200000UL
+
+// How the consumer of the attribute values learns about changes
+#define BENCH_NONE                 0   // no consumer, for the cost of the loop
+#define BENCH_CHANGES              1   // zcl_AttrChanged() and the change callback
+#define BENCH_POLL                 2   // compare every attribute at every step
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+const pTaskEventHandlerFn tasksArr[] = {
+  Hal_ProcessEvent,
+  zcl_event_loop
+};
+
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt);
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt));
+
+  Hal_Init( 0 );
+  zcl_Init( 1 );
+}
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static uint8 bench_Mode;
+static uint32 bench_Changes;
+
+// Values of the sample light attributes at the last poll
+static uint8 bench_Shadow[SAMPLELIGHT_NUM_ATTRIBUTES][4];
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+static void bench_AttrChangeCB( uint8 endpoint, uint16 clusterId, uint16 attrId )
+{
+  bench_Changes++;
+}
+
+/*
+ * Compare every sample light attribute with its value at the last poll
+ */
+static void bench_Poll( void )
+{
+  uint8 x;
+
+  for ( x = 0; x < SAMPLELIGHT_NUM_ATTRIBUTES; x++ )
+  {
+    CONST zclAttrRec_t *pAttr = &zllSampleLight_Attrs[x];
+    uint16 len;
+
+    if ( pAttr->attr.dataPtr == NULL )
+    {
+      continue; // read through the application's callback
+    }
+
+    len = zclGetAttrDataLength( pAttr->attr.dataType, pAttr->attr.dataPtr );
+    if ( ( len <= sizeof( bench_Shadow[x] ) ) &&
+         !osal_memcmp( bench_Shadow[x], pAttr->attr.dataPtr, len ) )
+    {
+      osal_memcpy( bench_Shadow[x], pAttr->attr.dataPtr, len );
+      bench_Changes++;
+    }
+  }
+}
+
+/*
+ * Tell ZCL about a changed color attribute, as hw_light_ctrl.c does
+ */
+static void bench_Changed( uint16 attrID )
+{
+  if ( bench_Mode == BENCH_CHANGES )
+  {
+    zcl_AttrChanged( AF_BROADCAST_ENDPOINT, ZCL_CLUSTER_ID_LIGHTING_COLOR_CONTROL, attrID );
+  }
+}
+
+/*
+ * A step of an XY transition: X and Y move, and the light output
+ * follows with hue and saturation
+ */
+static void bench_Step( void )
+{
+  zclColor_CurrentX += 7;
+  bench_Changed( ATTRID_LIGHTING_COLOR_CONTROL_CURRENT_X );
+  zclColor_CurrentY -= 5;
+  bench_Changed( ATTRID_LIGHTING_COLOR_CONTROL_CURRENT_Y );
+  zclColor_CurrentHue++;
+  bench_Changed( ATTRID_LIGHTING_COLOR_CONTROL_CURRENT_HUE );
+  zclColor_CurrentSaturation++;
+  bench_Changed( ATTRID_LIGHTING_COLOR_CONTROL_CURRENT_SATURATION );
+
+  if ( bench_Mode == BENCH_POLL )
+  {
+    bench_Poll();
+  }
+}
+
+/*
+ * Run the transition steps, each followed by a pass of the OSAL loop
+ * that delivers the changes; returns the host time per step, in ns
+ */
+static double bench_Run( uint8 mode )
+{
+  double start;
+  uint32 n;
+
+  bench_Mode = mode;
+  bench_Changes = 0;
+
+  start = hostBenchSec();
+  for ( n = 0; n < BENCH_STEPS; n++ )
+  {
+    bench_Step();
+    osal_run_system();
+  }
+
+  return ( (hostBenchSec() - start) * 1e9 / BENCH_STEPS );
+}
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   Host CPU time per second of a continuous color transition
+ *          of the sample light, for a consumer of the attribute values
+ *          that is told about the changes and for one that polls every
+ *          attribute at every step. The time of the same steps without
+ *          a consumer is subtracted.
+ */
+int main( void )
+{
+  double loop, changes, poll;
+
+  hostTestBoot();
+  HOST_CHECK( zcl_registerAttrList( SAMPLELIGHT_ENDPOINT, SAMPLELIGHT_NUM_ATTRIBUTES,
+                                    zllSampleLight_Attrs ) == ZSuccess );
+  HOST_CHECK( zcl_registerAttrChangeCB( SAMPLELIGHT_ENDPOINT, bench_AttrChangeCB ) == ZSuccess );
+
+  loop = bench_Run( BENCH_NONE );
+
+  changes = bench_Run( BENCH_CHANGES ) - loop;
+  HOST_CHECK( bench_Changes == BENCH_STEPS * 4 );
+
+  bench_Poll();
+  poll = bench_Run( BENCH_POLL ) - loop;
+  HOST_CHECK( bench_Changes == BENCH_STEPS * 4 );
+
+  printf( "color transition, %u attributes, %u steps/s\n",
+          SAMPLELIGHT_NUM_ATTRIBUTES, BENCH_STEPS_PER_SEC );
+  printf( "consumer             ns/step   us/s\n" );
+  printf( "  change callback    %7.1f  %5.2f\n", changes, changes * BENCH_STEPS_PER_SEC / 1000 );
+  printf( "  polling            %7.1f  %5.2f\n", poll, poll * BENCH_STEPS_PER_SEC / 1000 );
+
+  return hostTestResult( "bench_zcl_attr_change" );
+}
+
+/*********************************************************************
+*********************************************************************/
@@ -0,0 +1,260 @@
+/**************************************************************************************************
+  Filename:       bench_zcl_rw.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host benchmark of the Read and Write Attributes processing.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include <stdio.h>
+
+#include "ZComDef.h"
+#include "hal_drivers.h"
+#include "OSAL.h"
+#include "OSAL_Tasks.h"
+#include "zcl.h"
+#include "zcl_lighting.h"
+#include "zcl_ll.h"
+#include "zll_samplelight.h"
+#include "host_af.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define BENCH_REQUESTS             100000UL
+
+// Most records in a request
+#define BENCH_MAX_RECS             8
+
+// Writable attributes of a test cluster
+#define BENCH_EP                   20
+#define BENCH_CLUSTER              0xFC00
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+const pTaskEventHandlerFn tasksArr[] = {
+  Hal_ProcessEvent,
+  zcl_event_loop
+};
+
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt);
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt));
+
+  Hal_Init( 0 );
+  zcl_Init( 1 );
+}
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static uint16 bench_Vals[BENCH_MAX_RECS];
+
+#define BENCH_ATTR( id ) \
+  { BENCH_CLUSTER, { (id), ZCL_DATATYPE_UINT16, \
+                     (ACCESS_CONTROL_READ | ACCESS_CONTROL_WRITE), (void *)&bench_Vals[id] } }
+
+static CONST zclAttrRec_t bench_Attrs[BENCH_MAX_RECS] =
+{
+  BENCH_ATTR( 0 ), BENCH_ATTR( 1 ), BENCH_ATTR( 2 ), BENCH_ATTR( 3 ),
+  BENCH_ATTR( 4 ), BENCH_ATTR( 5 ), BENCH_ATTR( 6 ), BENCH_ATTR( 7 )
+};
+
+static uint8 bench_Req[3 + (BENCH_MAX_RECS * 5)];
+static uint16 bench_ReqLen;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+/*
+ * A Read Attributes request for the first color control attributes
+ * of the sample light
+ */
+static void bench_ReadReq( uint8 numAttr )
+{
+  uint8 *pBuf = &bench_Req[3];
+  uint8 x;
+
+  bench_Req[0] = ZCL_FRAME_TYPE_PROFILE_CMD;
+  bench_Req[2] = ZCL_CMD_READ;
+
+  for ( x = 0; ( x < SAMPLELIGHT_NUM_ATTRIBUTES ) && ( numAttr > 0 ); x++ )
+  {
+    CONST zclAttrRec_t *pAttr = &zllSampleLight_Attrs[x];
+
+    if ( ( pAttr->clusterID == ZCL_CLUSTER_ID_LIGHTING_COLOR_CONTROL ) &&
+         ( pAttr->attr.dataPtr != NULL ) )
+    {
+      *pBuf++ = LO_UINT16( pAttr->attr.attrId );
+      *pBuf++ = HI_UINT16( pAttr->attr.attrId );
+      numAttr--;
+    }
+  }
+
+  bench_ReqLen = (uint16)( pBuf - bench_Req );
+}
+
+/*
+ * A Write Attributes request for the test attributes
+ */
+static void bench_WriteReq( uint8 numAttr )
+{
+  uint8 *pBuf = &bench_Req[3];
+  uint8 x;
+
+  bench_Req[0] = ZCL_FRAME_TYPE_PROFILE_CMD;
+  bench_Req[2] = ZCL_CMD_WRITE;
+
+  for ( x = 0; x < numAttr; x++ )
+  {
+    *pBuf++ = x;
+    *pBuf++ = 0;
+    *pBuf++ = ZCL_DATATYPE_UINT16;
+    *pBuf++ = x;
+    *pBuf++ = 0x5A;
+  }
+
+  bench_ReqLen = (uint16)( pBuf - bench_Req );
+}
+
+/*
+ * Receive the request and let ZCL answer it
+ */
+static void bench_Request( uint8 endpoint, uint16 clusterID )
+{
+  bench_Req[1]++;
+  hostAfReset();
+  hostAfReceive( endpoint, clusterID, bench_Req, bench_ReqLen );
+  osal_run_system();
+}
+
+/*
+ * Allocations made by ZCL for a request, besides the received message
+ */
+static uint16 bench_Allocs( uint8 endpoint, uint16 clusterID )
+{
+  uint16 seq = osal_mem_trace_seq();
+  uint16 allocs = 0;
+  osalMemTrace_t rec;
+
+  bench_Request( endpoint, clusterID );
+
+  for ( ; seq != osal_mem_trace_seq(); seq++ )
+  {
+    if ( osal_mem_trace_get( seq, &rec ) && ( rec.op == OSALMEM_TRACE_ALLOC ) )
+    {
+      allocs++;
+    }
+  }
+
+  HOST_CHECK( hostAfFrameCnt == 1 );
+
+  return ( allocs - 1 );
+}
+
+/*
+ * Run the request, returning the host time per request, in ns
+ */
+static double bench_Run( const char *name, uint8 numRecs, uint8 endpoint, uint16 clusterID )
+{
+  uint16 allocs = bench_Allocs( endpoint, clusterID );
+  double start, ns;
+  uint32 n;
+
+  start = hostBenchSec();
+  for ( n = 0; n < BENCH_REQUESTS; n++ )
+  {
+    bench_Request( endpoint, clusterID );
+  }
+  ns = (hostBenchSec() - start) * 1e9 / BENCH_REQUESTS;
+
+  printf( "  %-6s %u records   %7.1f   %u\n", name, numRecs, ns, allocs );
+
+  return ( ns );
+}
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   Host CPU time and ZCL heap allocations per Read and Write
+ *          Attributes request, from the received message to the sent
+ *          response. The records are parsed in place, so the only
+ *          allocation is the response frame.
+ */
+int main( void )
+{
+  static const uint8 numRecs[] = { 1, 4, BENCH_MAX_RECS };
+  uint8 x;
+
+  hostTestBoot();
+  hostAfRegister( SAMPLELIGHT_ENDPOINT, ZLL_PROFILE_ID );
+  hostAfRegister( BENCH_EP, ZLL_PROFILE_ID );
+  HOST_CHECK( zcl_registerAttrList( SAMPLELIGHT_ENDPOINT, SAMPLELIGHT_NUM_ATTRIBUTES,
+                                    zllSampleLight_Attrs ) == ZSuccess );
+  HOST_CHECK( zcl_registerAttrList( BENCH_EP, BENCH_MAX_RECS, bench_Attrs ) == ZSuccess );
+
+  printf( "request               ns/req   allocs\n" );
+  for ( x = 0; x < sizeof( numRecs ); x++ )
+  {
+    bench_ReadReq( numRecs[x] );
+    bench_Run( "read", numRecs[x], SAMPLELIGHT_ENDPOINT, ZCL_CLUSTER_ID_LIGHTING_COLOR_CONTROL );
+    HOST_CHECK( ( hostAfFrames[0].data[2] == ZCL_CMD_READ_RSP ) &&
+                ( hostAfFrames[0].data[5] == ZCL_STATUS_SUCCESS ) );
+  }
+
+  for ( x = 0; x < sizeof( numRecs ); x++ )
+  {
+    bench_WriteReq( numRecs[x] );
+    bench_Run( "write", numRecs[x], BENCH_EP, BENCH_CLUSTER );
+    HOST_CHECK( bench_Vals[numRecs[x] - 1] == BUILD_UINT16( numRecs[x] - 1, 0x5A ) );
+  }
+
+  return hostTestResult( "bench_zcl_rw" );
+}
+
+/*********************************************************************
+*********************************************************************/
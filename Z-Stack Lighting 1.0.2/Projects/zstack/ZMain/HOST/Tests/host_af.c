@@ -0,0 +1,226 @@
+/**************************************************************************************************
+  Filename:       host_af.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    AF on the host for the ZCL tests: endpoints, sent frames and received frames.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include "ZComDef.h"
+#include "OSAL.h"
+#include "ZGlobals.h"
+#include "zcl.h"
+#include "host_af.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define HOST_AF_ENDPOINTS          8
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+uint8 zgSecurityMode = ZG_SECURITY_NONE;
+
+uint8 hostAfMtu = 80;
+
+uint16 hostAfFrameCnt;
+hostAfFrame_t hostAfFrames[HOST_AF_FRAMES];
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static uint8 hostAfEpCnt;
+static endPointDesc_t hostAfEps[HOST_AF_ENDPOINTS];
+static SimpleDescriptionFormat_t hostAfSimpleDescs[HOST_AF_ENDPOINTS];
+
+/*********************************************************************
+ * @fn      hostAfRegister
+ *
+ * @brief   Add an endpoint to the endpoints AF knows.
+ *
+ * @param   endpoint - endpoint number
+ * @param   profileID - its application profile
+ *
+ * @return  none
+ */
+void hostAfRegister( uint8 endpoint, uint16 profileID )
+{
+  if ( hostAfEpCnt < HOST_AF_ENDPOINTS )
+  {
+    hostAfSimpleDescs[hostAfEpCnt].EndPoint = endpoint;
+    hostAfSimpleDescs[hostAfEpCnt].AppProfId = profileID;
+    hostAfEps[hostAfEpCnt].endPoint = endpoint;
+    hostAfEps[hostAfEpCnt].simpleDesc = &hostAfSimpleDescs[hostAfEpCnt];
+    hostAfEpCnt++;
+  }
+}
+
+/*********************************************************************
+ * @fn      hostAfReset
+ *
+ * @brief   Forget the frames sent so far.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void hostAfReset( void )
+{
+  hostAfFrameCnt = 0;
+}
+
+/*********************************************************************
+ * @fn      hostAfReceive
+ *
+ * @brief   Hand a frame from the peer to ZCL as a unicast to the
+ *          endpoint, the way AF delivers it.
+ *
+ * @param   endpoint - destination endpoint
+ * @param   clusterID - cluster of the frame
+ * @param   pData - ZCL frame
+ * @param   len - its length
+ *
+ * @return  none
+ */
+void hostAfReceive( uint8 endpoint, uint16 clusterID, uint8 *pData, uint16 len )
+{
+  afIncomingMSGPacket_t *pkt;
+
+  pkt = (afIncomingMSGPacket_t *)osal_msg_allocate( sizeof( afIncomingMSGPacket_t ) + len );
+  if ( pkt == NULL )
+  {
+    return;
+  }
+
+  osal_memset( pkt, 0, sizeof( afIncomingMSGPacket_t ) );
+  pkt->hdr.event = AF_INCOMING_MSG_CMD;
+  pkt->clusterId = clusterID;
+  pkt->srcAddr.addrMode = afAddr16Bit;
+  pkt->srcAddr.addr.shortAddr = HOST_AF_PEER_ADDR;
+  pkt->srcAddr.endPoint = HOST_AF_PEER_EP;
+  pkt->endPoint = endpoint;
+  pkt->cmd.DataLength = len;
+  pkt->cmd.Data = (uint8 *)(pkt + 1);
+  osal_memcpy( pkt->cmd.Data, pData, len );
+
+  zcl_ProcessMessageMSG( pkt );
+
+  (void)osal_msg_deallocate( (uint8 *)pkt );
+}
+
+/*********************************************************************
+ * @fn      afFindEndPointDesc
+ *
+ * @brief   Find the descriptor of an endpoint added by hostAfRegister().
+ *
+ * @param   endPoint - endpoint number
+ *
+ * @return  the descriptor, NULL if there is none
+ */
+endPointDesc_t *afFindEndPointDesc( uint8 endPoint )
+{
+  uint8 x;
+
+  for ( x = 0; x < hostAfEpCnt; x++ )
+  {
+    if ( hostAfEps[x].endPoint == endPoint )
+    {
+      return ( &hostAfEps[x] );
+    }
+  }
+
+  return ( NULL );
+}
+
+/*********************************************************************
+ * @fn      afDataReqMTU
+ *
+ * @brief   Largest ASDU that AF_DataRequest() takes.
+ *
+ * @param   fields - unused
+ *
+ * @return  hostAfMtu
+ */
+uint8 afDataReqMTU( afDataReqMTU_t *fields )
+{
+  return ( hostAfMtu );
+}
+
+/*********************************************************************
+ * @fn      AF_DataRequest
+ *
+ * @brief   Keep a copy of the frame. Frames longer than hostAfMtu are
+ *          refused, as by AF without fragmentation.
+ *
+ * @param   see AF.h
+ *
+ * @return  afStatus_SUCCESS, afStatus_INVALID_PARAMETER for a frame
+ *          longer than hostAfMtu
+ */
+afStatus_t AF_DataRequest( afAddrType_t *dstAddr, endPointDesc_t *srcEP,
+                           uint16 cID, uint16 len, uint8 *buf, uint8 *transID,
+                           uint8 options, uint8 radius )
+{
+  if ( len > hostAfMtu )
+  {
+    return ( afStatus_INVALID_PARAMETER );
+  }
+
+  if ( hostAfFrameCnt < HOST_AF_FRAMES )
+  {
+    hostAfFrame_t *pFrame = &hostAfFrames[hostAfFrameCnt];
+
+    pFrame->dstAddr = *dstAddr;
+    pFrame->srcEP = srcEP->endPoint;
+    pFrame->clusterID = cID;
+    pFrame->transID = *transID;
+    pFrame->len = len;
+    osal_memcpy( pFrame->data, buf, len );
+  }
+  hostAfFrameCnt++;
+  (*transID)++;
+
+  return ( afStatus_SUCCESS );
+}
+
+/*********************************************************************
+*********************************************************************/
@@ -0,0 +1,118 @@
+/**************************************************************************************************
+  Filename:       host_af.h
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    AF on the host for the ZCL tests: endpoints, sent frames and received frames.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+#ifndef HOST_AF_H
+#define HOST_AF_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include "AF.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Frames kept of those sent since hostAfReset(), and their largest size
+#define HOST_AF_FRAMES             16
+#define HOST_AF_FRAME_MAX          256
+
+// Short address of the peer that hostAfReceive() frames come from
+#define HOST_AF_PEER_ADDR          0x1234
+#define HOST_AF_PEER_EP            1
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+// A frame sent through AF_DataRequest()
+typedef struct
+{
+  afAddrType_t dstAddr;
+  uint8 srcEP;
+  uint16 clusterID;
+  uint8 transID;
+  uint16 len;
+  uint8 data[HOST_AF_FRAME_MAX];
+} hostAfFrame_t;
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+// Largest ASDU that AF_DataRequest() takes, as returned by afDataReqMTU()
+extern uint8 hostAfMtu;
+
+// Frames sent since hostAfReset(); the first HOST_AF_FRAMES are kept
+extern uint16 hostAfFrameCnt;
+extern hostAfFrame_t hostAfFrames[HOST_AF_FRAMES];
+
+/*********************************************************************
+ * FUNCTIONS
+ */
+
+/*
+ * Add an endpoint of the given profile to the endpoints AF knows.
+ */
+extern void hostAfRegister( uint8 endpoint, uint16 profileID );
+
+/*
+ * Forget the frames sent so far.
+ */
+extern void hostAfReset( void );
+
+/*
+ * Hand a frame from the peer to ZCL as a unicast to the endpoint.
+ */
+extern void hostAfReceive( uint8 endpoint, uint16 clusterID, uint8 *pData, uint16 len );
+
+/*********************************************************************
+*********************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_AF_H */
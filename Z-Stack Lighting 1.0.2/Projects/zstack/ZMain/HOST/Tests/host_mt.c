@@ -0,0 +1,300 @@
+/**************************************************************************************************
+  Filename:       host_mt.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    MT on the host for the MT tests: a UART that keeps the frames MT sends.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include "ZComDef.h"
+#include "OSAL.h"
+#include "OnBoard.h"
+#include "hal_uart.h"
+#include "AF.h"
+#include "ZMAC.h"
+#include "ZGlobals.h"
+#include "MT_AF.h"
+#include "MT_DEBUG.h"
+#include "MT_UART.h"
+#include "host_mt.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Bits per second of the UART, with a start and a stop bit for each byte
+#define HOST_MT_BAUD               38400
+#define HOST_MT_BYTE_BITS          10
+
+#define HOST_MT_RX_MAX             (MT_RPC_DATA_MAX + SPI_0DATA_MSG_LEN)
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+uint16 hostMtFrameCnt;
+hostMtFrame_t hostMtFrames[HOST_MT_FRAMES];
+
+uint16 hostMtOverruns;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static halUARTCBack_t hostMtCallBack;
+static uint16 hostMtTxMax;
+
+// Bits waiting in the transmit buffer at hostMtTxTime
+static uint32 hostMtTxBits;
+static uint32 hostMtTxTime;
+
+static uint8 hostMtRx[HOST_MT_RX_MAX];
+static uint16 hostMtRxHead;
+static uint16 hostMtRxTail;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+/*
+ * Take the bytes sent since the last call out of the transmit buffer.
+ */
+static void hostMtTxDrain( void )
+{
+  uint32 now = osal_GetSystemClock();
+  uint32 sent = (now - hostMtTxTime) * (HOST_MT_BAUD / 1000);
+
+  hostMtTxBits = (sent < hostMtTxBits) ? (hostMtTxBits - sent) : 0;
+  hostMtTxTime = now;
+}
+
+/*********************************************************************
+ * @fn      hostMtReset
+ *
+ * @brief   Forget the frames sent so far.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void hostMtReset( void )
+{
+  hostMtFrameCnt = 0;
+  hostMtOverruns = 0;
+}
+
+/*********************************************************************
+ * @fn      hostMtRequest
+ *
+ * @brief   Receive a request on the UART, framed the way the tool
+ *          sends it, and hand it to the MT UART callback.
+ *
+ * @param   cmd0 - type and subsystem of the command
+ * @param   cmd1 - command ID
+ * @param   len - length of the data
+ * @param   pData - data of the command
+ *
+ * @return  none
+ */
+void hostMtRequest( uint8 cmd0, uint8 cmd1, uint8 len, uint8 *pData )
+{
+  uint8 *pRx = hostMtRx;
+
+  *pRx++ = MT_UART_SOF;
+  *pRx++ = len;
+  *pRx++ = cmd0;
+  *pRx++ = cmd1;
+  osal_memcpy( pRx, pData, len );
+  pRx += len;
+  *pRx = MT_UartCalcFCS( hostMtRx + 1, (uint8)(MT_RPC_FRAME_HDR_SZ + len) );
+
+  hostMtRxHead = 0;
+  hostMtRxTail = (uint16)(pRx + 1 - hostMtRx);
+
+  if ( hostMtCallBack != NULL )
+  {
+    hostMtCallBack( HAL_UART_PORT_0, HAL_UART_RX_TIMEOUT );
+  }
+}
+
+/*********************************************************************
+ * @fn      HalUARTOpen
+ *
+ * @brief   Keep the callback and the transmit buffer size of the port.
+ *
+ * @param   port - UART port
+ * @param   config - its configuration
+ *
+ * @return  HAL_UART_SUCCESS
+ */
+uint8 HalUARTOpen( uint8 port, halUARTCfg_t *config )
+{
+  hostMtCallBack = config->callBackFunc;
+  hostMtTxMax = config->tx.maxBufSize;
+  hostMtTxBits = 0;
+  hostMtTxTime = osal_GetSystemClock();
+
+  return HAL_UART_SUCCESS;
+}
+
+/*********************************************************************
+ * @fn      HalUARTRead
+ *
+ * @brief   Read the bytes of the last request.
+ *
+ * @param   port - UART port
+ * @param   pBuffer - where to put the bytes
+ * @param   length - most bytes to read
+ *
+ * @return  Number of bytes read
+ */
+uint16 HalUARTRead( uint8 port, uint8 *pBuffer, uint16 length )
+{
+  uint16 cnt = hostMtRxTail - hostMtRxHead;
+
+  if ( cnt > length )
+  {
+    cnt = length;
+  }
+
+  osal_memcpy( pBuffer, hostMtRx + hostMtRxHead, cnt );
+  hostMtRxHead += cnt;
+
+  return cnt;
+}
+
+/*********************************************************************
+ * @fn      Hal_UART_RxBufLen
+ *
+ * @brief   Number of bytes of the last request still to be read.
+ *
+ * @param   port - UART port
+ *
+ * @return  Number of bytes
+ */
+uint16 Hal_UART_RxBufLen( uint8 port )
+{
+  return hostMtRxTail - hostMtRxHead;
+}
+
+/*********************************************************************
+ * @fn      HalUARTWrite
+ *
+ * @brief   Keep an MT frame sent to the UART. Like the CC2530 DMA
+ *          driver, the whole frame is taken if it fits in what is
+ *          left of the transmit buffer, or else none of it.
+ *
+ * @param   port - UART port
+ * @param   pBuffer - SOF, length, command, data and FCS of the frame
+ * @param   length - length of the frame
+ *
+ * @return  Number of bytes taken
+ */
+uint16 HalUARTWrite( uint8 port, uint8 *pBuffer, uint16 length )
+{
+  hostMtTxDrain();
+
+  if ( hostMtTxBits + (uint32)length * HOST_MT_BYTE_BITS > (uint32)hostMtTxMax * HOST_MT_BYTE_BITS )
+  {
+    hostMtOverruns++;
+    return 0;
+  }
+  hostMtTxBits += (uint32)length * HOST_MT_BYTE_BITS;
+
+  if ( hostMtFrameCnt < HOST_MT_FRAMES )
+  {
+    hostMtFrame_t *pFrame = &hostMtFrames[hostMtFrameCnt];
+
+    pFrame->time = osal_GetSystemClock();
+    pFrame->len = pBuffer[1 + MT_RPC_POS_LEN];
+    pFrame->cmd0 = pBuffer[1 + MT_RPC_POS_CMD0];
+    pFrame->cmd1 = pBuffer[1 + MT_RPC_POS_CMD1];
+    osal_memcpy( pFrame->data, pBuffer + 1 + MT_RPC_POS_DAT0, pFrame->len );
+  }
+  hostMtFrameCnt++;
+
+  return length;
+}
+
+/*********************************************************************
+ * Parts of the stack that MT calls into, not used by the tests
+ */
+
+void MT_AfExec( void )
+{
+}
+
+void MT_ProcessDebugMsg( mtDebugMsg_t *pData )
+{
+}
+
+void MT_ProcessDebugStr( mtDebugStr_t *pData )
+{
+}
+
+endPointDesc_t *afFindEndPointDesc( uint8 endPoint )
+{
+  return NULL;
+}
+
+uint8 MAC_MlmeSetReq( uint8 pibAttribute, void *pValue )
+{
+  return FAILURE;
+}
+
+ZMacStatus_t ZMacGetReq( ZMacAttributes_t attr, byte *value )
+{
+  return FAILURE;
+}
+
+ZMacStatus_t ZMacSetReq( ZMacAttributes_t attr, byte *value )
+{
+  return FAILURE;
+}
+
+uint8 macRadioSetTxPower( uint8 txPower )
+{
+  return txPower;
+}
+
+void zgSetItem( uint16 id, uint16 len, void *buf )
+{
+}
+
+/*********************************************************************
+*********************************************************************/
@@ -0,0 +1,108 @@
+/**************************************************************************************************
+  Filename:       host_mt.h
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    MT on the host for the MT tests: a UART that keeps the frames MT sends.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+#ifndef HOST_MT_H
+#define HOST_MT_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include "MT.h"
+#include "MT_RPC.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Frames kept of those sent since hostMtReset()
+#define HOST_MT_FRAMES             64
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+// A frame sent to the UART by MT
+typedef struct
+{
+  uint32 time;                     // System clock when it was written
+  uint8 cmd0;
+  uint8 cmd1;
+  uint8 len;
+  uint8 data[MT_RPC_DATA_MAX];
+} hostMtFrame_t;
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+// Frames sent since hostMtReset(); the first HOST_MT_FRAMES are kept
+extern uint16 hostMtFrameCnt;
+extern hostMtFrame_t hostMtFrames[HOST_MT_FRAMES];
+
+// Frames that did not fit in the UART transmit buffer and were lost
+extern uint16 hostMtOverruns;
+
+/*********************************************************************
+ * FUNCTIONS
+ */
+
+/*
+ * Forget the frames sent so far.
+ */
+extern void hostMtReset( void );
+
+/*
+ * Receive a request on the UART, as the tool sends it.
+ */
+extern void hostMtRequest( uint8 cmd0, uint8 cmd1, uint8 len, uint8 *pData );
+
+/*********************************************************************
+*********************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_MT_H */
@@ -0,0 +1,158 @@
+/**************************************************************************************************
+  Filename:       host_test.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Check and run helpers shared by the host (x86-64 Linux) tests.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include <stdio.h>
+#include <time.h>
+
+#include "hal_drivers.h"
+#include "hal_sim.h"
+#include "OnBoard.h"
+#include "OSAL.h"
+#include "ZComDef.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static uint32 hostTestChecks;
+static uint32 hostTestFails;
+
+/*********************************************************************
+ * @fn      hostTestCheck
+ *
+ * @brief   Count a check, reporting it when it failed.
+ *
+ * @param   ok - result of the check
+ * @param   file, line - location of the check
+ * @param   expr - text of the checked expression
+ *
+ * @return  none
+ */
+void hostTestCheck( uint8 ok, const char *file, int line, const char *expr )
+{
+  hostTestChecks++;
+
+  if ( !ok )
+  {
+    hostTestFails++;
+    printf( "%s:%d: check failed: %s\n", file, line, expr );
+  }
+}
+
+/*********************************************************************
+ * @fn      hostTestBoot
+ *
+ * @brief   Bring up the virtual board, the HAL drivers and OSAL.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void hostTestBoot( void )
+{
+  osal_int_disable( INTS_ALL );
+  HAL_BOARD_INIT();
+  InitBoard( OB_COLD );
+  HalDriverInit();
+  osal_init_system();
+  osal_int_enable( INTS_ALL );
+  InitBoard( OB_READY );
+}
+
+/*********************************************************************
+ * @fn      hostTestRun
+ *
+ * @brief   Run the OSAL loop for a number of virtual milliseconds.
+ *
+ * @param   msec - virtual time to run for
+ *
+ * @return  none
+ */
+void hostTestRun( uint32 msec )
+{
+  uint32 end = halSimClockMs() + msec;
+
+  while ( (int32)(halSimClockMs() - end) < 0 )
+  {
+    osal_run_system();
+  }
+}
+
+/*********************************************************************
+ * @fn      hostBenchSec
+ *
+ * @brief   Read the host monotonic clock.
+ *
+ * @param   none
+ *
+ * @return  seconds
+ */
+double hostBenchSec( void )
+{
+  struct timespec ts;
+
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+
+  return ( (double)ts.tv_sec + ((double)ts.tv_nsec / 1e9) );
+}
+
+/*********************************************************************
+ * @fn      hostTestResult
+ *
+ * @brief   Print the summary line of the test.
+ *
+ * @param   name - name of the test
+ *
+ * @return  0 when every check passed, 1 otherwise
+ */
+int hostTestResult( const char *name )
+{
+  printf( "%s: %lu checks, %lu failed\n", name,
+          (unsigned long)hostTestChecks, (unsigned long)hostTestFails );
+
+  return ( (hostTestFails == 0) ? 0 : 1 );
+}
+
+/*********************************************************************
+*********************************************************************/
@@ -0,0 +1,100 @@
+/**************************************************************************************************
+  Filename:       host_test.h
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Check and run helpers shared by the host (x86-64 Linux) tests.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include "hal_types.h"
+
+/*********************************************************************
+ * MACROS
+ */
+
+// Record a failure, with its location, when expr is false.
+#define HOST_CHECK( expr ) \
+  hostTestCheck( (expr) ? TRUE : FALSE, __FILE__, __LINE__, #expr )
+
+/*********************************************************************
+ * FUNCTIONS
+ */
+
+/*
+ * Count a check, reporting it when it failed.
+ */
+extern void hostTestCheck( uint8 ok, const char *file, int line, const char *expr );
+
+/*
+ * Bring up the virtual board, the HAL drivers and OSAL with the task table
+ * supplied by the test - the same sequence as main() in ZMain.c.
+ */
+extern void hostTestBoot( void );
+
+/*
+ * Run the OSAL loop for the given number of virtual milliseconds.
+ */
+extern void hostTestRun( uint32 msec );
+
+/*
+ * Host (wall clock) time in seconds, for benchmarks - the virtual clock does
+ * not see the cost of the code under test.
+ */
+extern double hostBenchSec( void );
+
+/*
+ * Print the summary line of the test; returns the process exit status.
+ */
+extern int hostTestResult( const char *name );
+
+/*********************************************************************
+*********************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_TEST_H */
@@ -0,0 +1,283 @@
+/**************************************************************************************************
+  Filename:       test_af_incoming.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host test of the delivery of incoming frames to AF endpoints.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include "ZComDef.h"
+#include "hal_drivers.h"
+#include "OSAL.h"
+#include "OSAL_Tasks.h"
+#include "AF.h"
+#include "APSMEDE.h"
+#include "aps_frag.h"
+#include "aps_groups.h"
+#include "nwk_util.h"
+#include "rtg.h"
+#include "saddr.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define TEST_TASK_EP1              1
+#define TEST_TASK_EP2              2
+
+#define TEST_EP1                   10
+#define TEST_EP2                   11
+#define TEST_PROFILE               0x0104
+#define TEST_GROUP                 0x0003
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+static uint16 test_event_loop( uint8 task_id, uint16 events );
+
+const pTaskEventHandlerFn tasksArr[] = {
+  Hal_ProcessEvent,
+  test_event_loop,
+  test_event_loop
+};
+
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt);
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt));
+
+  Hal_Init( 0 );
+}
+
+// The APS and NWK functions that AF calls
+APSF_SendFragmented_t *apsfSendFragmented = NULL;
+
+ZStatus_t APSDE_DataReq( APSDE_DataReq_t* req )
+{
+  return ( ZSuccess );
+}
+
+uint8 APSDE_DataReqMTU( APSDE_DataReqMTU_t* fields )
+{
+  return ( 80 );
+}
+
+uint16 NLME_GetShortAddr( void )
+{
+  return ( 0x0001 );
+}
+
+addr_filter_t NLME_IsAddressBroadcast( uint16 shortAddress )
+{
+  return ( ADDR_NOT_BCAST );
+}
+
+RTG_Status_t RTG_CheckRtStatus( uint16 DstAddress, byte RtStatus, uint8 options )
+{
+  return ( RTG_SUCCESS );
+}
+
+RTG_Status_t RTG_AddSrcRtgEntry_Guaranteed( uint16 srcAddr, uint8 relayCnt, uint16* pRelayList )
+{
+  return ( RTG_SUCCESS );
+}
+
+void *sAddrExtCpy( uint8 * pDest, const uint8 * pSrc )
+{
+  return ( osal_memcpy( pDest, pSrc, Z_EXTADDR_LEN ) );
+}
+
+// Both test endpoints are in TEST_GROUP
+uint8 aps_FindGroupForEndpoint( uint16 groupID, uint8 lastEP )
+{
+  if ( groupID != TEST_GROUP )
+  {
+    return ( APS_GROUPS_EP_NOT_FOUND );
+  }
+  else if ( lastEP == APS_GROUPS_FIND_FIRST )
+  {
+    return ( TEST_EP1 );
+  }
+  else if ( lastEP == TEST_EP1 )
+  {
+    return ( TEST_EP2 );
+  }
+
+  return ( APS_GROUPS_EP_NOT_FOUND );
+}
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static uint8 test_TaskEp1 = TEST_TASK_EP1;
+static uint8 test_TaskEp2 = TEST_TASK_EP2;
+
+static SimpleDescriptionFormat_t test_SimpleDesc1;
+static SimpleDescriptionFormat_t test_SimpleDesc2;
+
+static endPointDesc_t test_Ep1 = { TEST_EP1, &test_TaskEp1, &test_SimpleDesc1, noLatencyReqs };
+static endPointDesc_t test_Ep2 = { TEST_EP2, &test_TaskEp2, &test_SimpleDesc2, noLatencyReqs };
+
+static uint8 test_Asdu[40];
+
+// Messages received by each endpoint task, and where their data was
+static uint16 test_Received[3];
+static uint8 *test_Data[3];
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+static uint16 test_event_loop( uint8 task_id, uint16 events )
+{
+  if ( events & SYS_EVENT_MSG )
+  {
+    afIncomingMSGPacket_t *pMsg;
+
+    while ( (pMsg = (afIncomingMSGPacket_t *)osal_msg_receive( task_id )) != NULL )
+    {
+      HOST_CHECK( pMsg->hdr.event == AF_INCOMING_MSG_CMD );
+      HOST_CHECK( ( pMsg->cmd.DataLength == 0 ) ||
+                  osal_memcmp( pMsg->cmd.Data, test_Asdu, pMsg->cmd.DataLength ) );
+      test_Data[task_id] = pMsg->cmd.Data;
+      test_Received[task_id]++;
+
+      HOST_CHECK( osal_msg_deallocate( (uint8 *)pMsg ) == SUCCESS );
+    }
+
+    return ( events ^ SYS_EVENT_MSG );
+  }
+
+  return 0;
+}
+
+/*
+ * Hand a frame from APS to AF, let the endpoint tasks take it, and
+ * return the number of endpoints it reached
+ */
+static uint16 test_Incoming( uint8 dstEP, uint16 groupID, uint8 asduLen )
+{
+  aps_FrameFormat_t aff;
+  zAddrType_t srcAddr;
+  NLDE_Signal_t sig;
+
+  osal_memset( &aff, 0, sizeof( aff ) );
+  aff.FrmCtrl = ( groupID != 0 ) ? APS_FC_DM_GROUP : 0;
+  aff.DstEndPoint = dstEP;
+  aff.SrcEndPoint = 1;
+  aff.GroupID = groupID;
+  aff.ClusterID = 0x0006;
+  aff.ProfileID = TEST_PROFILE;
+  aff.asdu = test_Asdu;
+  aff.asduLength = asduLen;
+
+  srcAddr.addrMode = Addr16Bit;
+  srcAddr.addr.shortAddr = 0x1234;
+  osal_memset( &sig, 0, sizeof( sig ) );
+
+  osal_memset( test_Received, 0, sizeof( test_Received ) );
+  osal_memset( test_Data, 0, sizeof( test_Data ) );
+
+  afIncomingData( &aff, &srcAddr, 0xABCD, &sig, 0, FALSE, 0 );
+  hostTestRun( 5 );
+
+  return ( test_Received[TEST_TASK_EP1] + test_Received[TEST_TASK_EP2] );
+}
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   An incoming frame for several endpoints is copied once, into
+ *          the first endpoint's message, and the others point to it.
+ *          Whatever the order the endpoint tasks free their messages in,
+ *          the heap goes back to its level before the frame.
+ */
+int main( void )
+{
+  uint16 heapUsed;
+  uint8 x;
+
+  hostTestBoot();
+  for ( x = 0; x < sizeof( test_Asdu ); x++ )
+  {
+    test_Asdu[x] = x + 1;
+  }
+  test_SimpleDesc1.EndPoint = TEST_EP1;
+  test_SimpleDesc1.AppProfId = TEST_PROFILE;
+  test_SimpleDesc2.EndPoint = TEST_EP2;
+  test_SimpleDesc2.AppProfId = TEST_PROFILE;
+  HOST_CHECK( afRegister( &test_Ep1 ) == afStatus_SUCCESS );
+  HOST_CHECK( afRegister( &test_Ep2 ) == afStatus_SUCCESS );
+  heapUsed = osal_heap_mem_used();
+
+  // One endpoint
+  HOST_CHECK( test_Incoming( TEST_EP2, 0, sizeof( test_Asdu ) ) == 1 );
+  HOST_CHECK( test_Received[TEST_TASK_EP2] == 1 );
+  HOST_CHECK( osal_heap_mem_used() == heapUsed );
+
+  // Broadcast to both: one copy of the data
+  HOST_CHECK( test_Incoming( AF_BROADCAST_ENDPOINT, 0, sizeof( test_Asdu ) ) == 2 );
+  HOST_CHECK( test_Data[TEST_TASK_EP1] == test_Data[TEST_TASK_EP2] );
+  HOST_CHECK( osal_heap_mem_used() == heapUsed );
+
+  // Group of both
+  HOST_CHECK( test_Incoming( 0, TEST_GROUP, sizeof( test_Asdu ) ) == 2 );
+  HOST_CHECK( test_Data[TEST_TASK_EP1] == test_Data[TEST_TASK_EP2] );
+  HOST_CHECK( osal_heap_mem_used() == heapUsed );
+
+  // Without a payload nothing is shared
+  HOST_CHECK( test_Incoming( AF_BROADCAST_ENDPOINT, 0, 0 ) == 2 );
+  HOST_CHECK( osal_heap_mem_used() == heapUsed );
+
+  // Many frames
+  for ( x = 0; x < 100; x++ )
+  {
+    test_Incoming( AF_BROADCAST_ENDPOINT, 0, x % sizeof( test_Asdu ) );
+  }
+  HOST_CHECK( osal_heap_mem_used() == heapUsed );
+
+  return hostTestResult( "test_af_incoming" );
+}
+
+/*********************************************************************
+*********************************************************************/
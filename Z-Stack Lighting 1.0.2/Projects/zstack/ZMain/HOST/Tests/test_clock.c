@@ -0,0 +1,147 @@
+/**************************************************************************************************
+  Filename:       test_clock.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host test of the virtual clock and the OSAL timers running on it.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include "ZComDef.h"
+#include "hal_drivers.h"
+#include "hal_sim.h"
+#include "OSAL.h"
+#include "OSAL_Tasks.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define TEST_ONESHOT_EVT           0x0001
+#define TEST_RELOAD_EVT            0x0002
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static uint8 test_TaskID;
+static uint32 test_OneShotAt;
+static uint32 test_Reloads;
+
+static uint16 test_event_loop( uint8 task_id, uint16 events );
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+const pTaskEventHandlerFn tasksArr[] = {
+  Hal_ProcessEvent,
+  test_event_loop
+};
+
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+void osalInitTasks( void )
+{
+  uint8 taskID = 0;
+
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt);
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt));
+
+  Hal_Init( taskID++ );
+  test_TaskID = taskID;
+}
+
+static uint16 test_event_loop( uint8 task_id, uint16 events )
+{
+  if ( events & TEST_ONESHOT_EVT )
+  {
+    test_OneShotAt = halSimClockMs();
+    return ( events ^ TEST_ONESHOT_EVT );
+  }
+
+  if ( events & TEST_RELOAD_EVT )
+  {
+    test_Reloads++;
+    return ( events ^ TEST_RELOAD_EVT );
+  }
+
+  return 0;
+}
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   Timers fire on the virtual clock, which the OSAL clock follows.
+ */
+int main( void )
+{
+  uint32 start;
+
+  hostTestBoot();
+  start = halSimClockMs();
+
+  osal_start_timerEx( test_TaskID, TEST_ONESHOT_EVT, 250 );
+  osal_start_reload_timer( test_TaskID, TEST_RELOAD_EVT, 10 );
+
+  hostTestRun( 1000 );
+
+  HOST_CHECK( test_OneShotAt >= start + 250 );
+  HOST_CHECK( test_OneShotAt <= start + 251 );
+  // A reload timer restarts from the tick it fired on, so it may lag a little.
+  HOST_CHECK( test_Reloads >= 95 && test_Reloads <= 100 );
+  HOST_CHECK( osal_GetSystemClock() - start >= 999 );
+  HOST_CHECK( osal_GetSystemClock() - start <= 1001 );
+
+  // A stopped reload timer does not fire again.
+  HOST_CHECK( osal_stop_timerEx( test_TaskID, TEST_RELOAD_EVT ) == SUCCESS );
+  test_Reloads = 0;
+  hostTestRun( 100 );
+  HOST_CHECK( test_Reloads == 0 );
+
+  // Time only moves when the loop runs or the test advances it.
+  start = halSimClockUs();
+  halSimClockAdvance( 5000 );
+  HOST_CHECK( halSimClockUs() - start == 5000 );
+
+  return hostTestResult( "test_clock" );
+}
+
+/*********************************************************************
+*********************************************************************/
@@ -0,0 +1,221 @@
+/**************************************************************************************************
+  Filename:       test_heap.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host test of the OSAL heap with either allocator.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include "ZComDef.h"
+#include "hal_drivers.h"
+#include "OSAL.h"
+#include "OSAL_Memory.h"
+#include "OSAL_Tasks.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Set by the makefile for the segregated-fit build, as in OSAL_Memory.c
+#if !defined ( OSALMEM_SEGFIT )
+  #define OSALMEM_SEGFIT  FALSE
+#endif
+
+#define TEST_SLOTS                 64
+#define TEST_OPS                   200000
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+const pTaskEventHandlerFn tasksArr[] = {
+  Hal_ProcessEvent
+};
+
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt);
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt));
+
+  Hal_Init( 0 );
+}
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static uint8 *test_Ptr[TEST_SLOTS];
+static uint16 test_Size[TEST_SLOTS];
+static uint32 test_Seed = 7;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+static uint16 test_Rand( void )
+{
+  test_Seed = test_Seed * 1103515245 + 12345;
+
+  return ( (uint16)(test_Seed >> 16) & 0x7FFF );
+}
+
+/*
+ * Blocks in use: osal_heap_block_cnt() counts the free blocks too.
+ */
+static uint16 test_BlocksUsed( void )
+{
+  return ( osal_heap_block_cnt() - osal_heap_block_free() );
+}
+
+/*
+ * Check the fill pattern of a block.
+ */
+static uint8 test_Intact( uint8 k )
+{
+  uint16 i;
+
+  for ( i = 0; i < test_Size[k]; i++ )
+  {
+    if ( test_Ptr[k][i] != (uint8)(k + i) )
+    {
+      return ( FALSE );
+    }
+  }
+
+  return ( TRUE );
+}
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   Random allocations and frees keep the data of the live blocks
+ *          intact and the heap metrics consistent.
+ */
+int main( void )
+{
+  uint16 baseUsed, baseMem, i;
+  uint32 n, allocs = 0, fails = 0, corrupt = 0;
+  uint8 k, live;
+
+  hostTestBoot();
+
+  baseUsed = test_BlocksUsed();
+  baseMem = osal_heap_mem_used();
+
+  for ( n = 0; n < TEST_OPS; n++ )
+  {
+    k = test_Rand() % TEST_SLOTS;
+
+    if ( test_Ptr[k] )
+    {
+      if ( !test_Intact( k ) )
+      {
+        corrupt++;
+      }
+      osal_mem_free( test_Ptr[k] );
+      test_Ptr[k] = NULL;
+    }
+    else
+    {
+      // Mostly messages and parse buffers, with some large frames
+      test_Size[k] = (test_Rand() % 4) ? 1 + (test_Rand() % 60) : 1 + (test_Rand() % 300);
+      test_Ptr[k] = osal_mem_alloc( test_Size[k] );
+      allocs++;
+
+      if ( test_Ptr[k] == NULL )
+      {
+        fails++;
+      }
+      else
+      {
+        for ( i = 0; i < test_Size[k]; i++ )
+        {
+          test_Ptr[k][i] = (uint8)(k + i);
+        }
+      }
+    }
+
+    if ( (n % 1000) == 0 )
+    {
+      for ( k = 0, live = 0; k < TEST_SLOTS; k++ )
+      {
+        live += ( test_Ptr[k] != NULL );
+      }
+      HOST_CHECK( test_BlocksUsed() == baseUsed + live );
+      HOST_CHECK( osal_heap_block_max() >= osal_heap_block_cnt() );
+    }
+  }
+
+  HOST_CHECK( corrupt == 0 );
+
+  // The heap holds 4K (see the makefile) and the live set averages a little
+  // over 2K, so only a few allocations fail for lack of a large enough block.
+  HOST_CHECK( fails * 20 < allocs );
+
+  for ( k = 0; k < TEST_SLOTS; k++ )
+  {
+    if ( test_Ptr[k] )
+    {
+      HOST_CHECK( test_Intact( k ) );
+      osal_mem_free( test_Ptr[k] );
+    }
+  }
+
+  HOST_CHECK( test_BlocksUsed() == baseUsed );
+  HOST_CHECK( osal_heap_mem_used() == baseMem );
+
+  // The whole heap is usable again
+  {
+    uint8 *pBig = osal_mem_alloc( 2048 );
+
+    HOST_CHECK( pBig != NULL );
+    if ( pBig != NULL )
+    {
+      osal_mem_free( pBig );
+    }
+  }
+
+  return hostTestResult( OSALMEM_SEGFIT ? "test_heap_segfit" : "test_heap" );
+}
+
+/*********************************************************************
+*********************************************************************/
@@ -0,0 +1,357 @@
+/**************************************************************************************************
+  Filename:       test_heap_trace.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host test of the OSAL heap allocation trace and its MT stream.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ZComDef.h"
+#include "hal_drivers.h"
+#include "OSAL.h"
+#include "OSAL_Memory.h"
+#include "OSAL_Tasks.h"
+#include "MT_TASK.h"
+#include "host_mt.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define TEST_SLOTS                 16
+#define TEST_OPS                   200
+
+// Long enough for MT to send a whole trace
+#define TEST_STREAM_MSEC           1000
+
+#define TEST_SREQ_CMD0             ((uint8)MT_RPC_CMD_SREQ | (uint8)MT_RPC_SYS_SYS)
+#define TEST_SRSP_CMD0             ((uint8)MT_RPC_CMD_SRSP | (uint8)MT_RPC_SYS_SYS)
+#define TEST_IND_CMD0              ((uint8)MT_RPC_CMD_AREQ | (uint8)MT_RPC_SYS_SYS)
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+const pTaskEventHandlerFn tasksArr[] = {
+  Hal_ProcessEvent,
+  MT_ProcessEvent
+};
+
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+void osalInitTasks( void )
+{
+  uint8 taskID = 0;
+
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt);
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt));
+
+  Hal_Init( taskID++ );
+  MT_TaskInit( taskID );
+}
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static FILE *test_Fp;         // Where to write the INDs, if anywhere
+static uint16 test_FrameIdx;  // Next frame of hostMtFrames to look at
+static uint8 test_Waiting;    // TRUE from a request to its SRSP
+static uint8 test_Left;       // INDs still to come
+static uint16 test_Seq;       // Sequence number of the next IND
+static uint16 test_Recs;      // INDs received
+static uint32 test_TxTime;    // Time of the last frame from MT
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+/*
+ * Send an MT_SYS_HEAP_TRACE request for the records from seq onward.
+ */
+static void test_Request( uint16 seq )
+{
+  uint8 buf[2];
+
+  buf[0] = LO_UINT16( seq );
+  buf[1] = HI_UINT16( seq );
+
+  hostMtReset();
+  test_FrameIdx = 0;
+  test_Waiting = TRUE;
+  hostMtRequest( TEST_SREQ_CMD0, MT_SYS_HEAP_TRACE, sizeof( buf ), buf );
+}
+
+/*
+ * Check the frames MT sent since the last call: the SRSP of the
+ * request and then its INDs, one after the other with no sequence
+ * number missing. Write each IND in hex, one per line - the input
+ * of Tools/heap_trace.
+ */
+static void test_Collect( void )
+{
+  while ( (test_FrameIdx < hostMtFrameCnt) && (test_FrameIdx < HOST_MT_FRAMES) )
+  {
+    hostMtFrame_t *pFrame = &hostMtFrames[test_FrameIdx++];
+
+    if ( (pFrame->cmd0 == TEST_SRSP_CMD0) && (pFrame->cmd1 == MT_SYS_HEAP_TRACE) )
+    {
+      uint16 next = BUILD_UINT16( pFrame->data[1], pFrame->data[2] );
+
+      HOST_CHECK( test_Waiting );
+      HOST_CHECK( test_Left == 0 );
+      HOST_CHECK( pFrame->len == 4 );
+      HOST_CHECK( pFrame->data[0] == ZSuccess );
+
+      test_Seq = next - pFrame->data[3];
+      test_Left = pFrame->data[3];
+      test_Waiting = FALSE;
+      test_TxTime = pFrame->time;
+    }
+    else if ( (pFrame->cmd0 == TEST_IND_CMD0) && (pFrame->cmd1 == MT_SYS_HEAP_TRACE_IND) )
+    {
+      uint8 n;
+
+      HOST_CHECK( test_Left != 0 );
+      HOST_CHECK( BUILD_UINT16( pFrame->data[0], pFrame->data[1] ) == test_Seq );
+      HOST_CHECK( (pFrame->data[2] == OSALMEM_TRACE_ALLOC) || (pFrame->data[2] == OSALMEM_TRACE_FREE) );
+      HOST_CHECK( pFrame->len == 16 + pFrame->data[15] );
+
+      // Paced, not sent with the SRSP or the IND before
+      HOST_CHECK( pFrame->time != test_TxTime );
+
+      if ( test_Fp != NULL )
+      {
+        for ( n = 0; n < pFrame->len; n++ )
+        {
+          fprintf( test_Fp, (n == 0) ? "%02X" : " %02X", pFrame->data[n] );
+        }
+        fprintf( test_Fp, "\n" );
+      }
+
+      test_Seq++;
+      test_Left--;
+      test_Recs++;
+      test_TxTime = pFrame->time;
+    }
+  }
+}
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   The heap trace records each allocation and free with its
+ *          caller, and reports overwritten records as missing. Over
+ *          MT_SYS_HEAP_TRACE, with the default OSALMEM_TRACE_CNT, a
+ *          workload that keeps allocating while the INDs go out is
+ *          streamed with no record lost, none sent twice and no IND
+ *          lost to a full UART transmit buffer.
+ *
+ *          Usage: test_heap_trace [trace-file] - also write the INDs
+ *          in the format read by Tools/heap_trace.
+ */
+int main( int argc, char **argv )
+{
+  static uint8 *ptr[TEST_SLOTS];
+  osalMemTrace_t rec;
+  uint16 seq, first, line, used;
+  uint16 requests = 0;
+  uint8 *pA, *pB;
+  uint16 n;
+
+  hostTestBoot();
+
+  // MT starts up and sends its reset indication
+  hostTestRun( 1 );
+  HOST_CHECK( hostMtFrameCnt == 1 );
+  HOST_CHECK( hostMtFrames[0].cmd0 == TEST_IND_CMD0 );
+
+  // The start-up allocations are in the trace
+  HOST_CHECK( osal_mem_trace_seq() != 0 );
+  HOST_CHECK( osal_mem_trace_get( osal_mem_trace_seq() - 1, &rec ) );
+
+  seq = osal_mem_trace_seq();
+  line = __LINE__; pA = osal_mem_alloc( 10 );
+  pB = osal_mem_alloc( 40 );
+  osal_mem_free( pA );
+  HOST_CHECK( osal_mem_trace_seq() == (uint16)(seq + 3) );
+
+  HOST_CHECK( osal_mem_trace_get( seq, &rec ) );
+  HOST_CHECK( rec.op == OSALMEM_TRACE_ALLOC );
+  HOST_CHECK( rec.size == 10 );
+  HOST_CHECK( rec.lnum == line );
+  HOST_CHECK( (rec.fname != NULL) && (strstr( rec.fname, "test_heap_trace.c" ) != NULL) );
+  HOST_CHECK( rec.time == osal_GetSystemClock() );
+
+  HOST_CHECK( osal_mem_trace_get( seq + 2, &rec ) );
+  HOST_CHECK( rec.op == OSALMEM_TRACE_FREE );
+  HOST_CHECK( rec.size >= 10 );
+  HOST_CHECK( rec.blkFree == osal_heap_block_free() );
+
+  // The first allocation and the free are of the same block
+  {
+    osalMemTrace_t alloc;
+
+    HOST_CHECK( osal_mem_trace_get( seq, &alloc ) );
+    HOST_CHECK( alloc.offset == rec.offset );
+  }
+
+  // Nothing is recorded past the end
+  HOST_CHECK( !osal_mem_trace_get( osal_mem_trace_seq(), &rec ) );
+
+  osal_mem_free( pB );
+
+  // Nothing is recorded while paused
+  seq = osal_mem_trace_seq();
+  osal_mem_trace_pause( TRUE );
+  osal_mem_free( osal_mem_alloc( 4 ) );
+  HOST_CHECK( osal_mem_trace_seq() == seq );
+  osal_mem_trace_pause( FALSE );
+  osal_mem_free( osal_mem_alloc( 4 ) );
+  HOST_CHECK( osal_mem_trace_seq() == (uint16)(seq + 2) );
+
+  // Once overwritten, a record is missing and is not sent
+  for ( n = 0; n < OSALMEM_TRACE_CNT; n++ )
+  {
+    osal_mem_free( osal_mem_alloc( 4 ) );
+  }
+  HOST_CHECK( !osal_mem_trace_get( seq, &rec ) );
+  HOST_CHECK( osal_mem_trace_get( osal_mem_trace_seq() - 1, &rec ) );
+  HOST_CHECK( rec.op == OSALMEM_TRACE_FREE );
+
+  used = osal_heap_mem_used();
+  test_Request( seq );
+  hostTestRun( 1 );
+  test_Collect();
+  HOST_CHECK( !test_Waiting );
+  HOST_CHECK( test_Left == OSALMEM_TRACE_CNT );
+  HOST_CHECK( (uint16)(test_Seq - seq) > OSALMEM_TRACE_CNT );
+
+  // A request while the last one is being sent is refused
+  {
+    uint8 buf[2] = { 0x34, 0x12 };
+    hostMtFrame_t *pFrame = &hostMtFrames[hostMtFrameCnt];
+
+    hostMtRequest( TEST_SREQ_CMD0, MT_SYS_HEAP_TRACE, sizeof( buf ), buf );
+    hostTestRun( 1 );
+    HOST_CHECK( hostMtFrameCnt == test_FrameIdx + 1 );
+    HOST_CHECK( pFrame->cmd0 == TEST_SRSP_CMD0 );
+    HOST_CHECK( pFrame->data[0] != ZSuccess );
+    HOST_CHECK( BUILD_UINT16( pFrame->data[1], pFrame->data[2] ) == 0x1234 );
+    HOST_CHECK( pFrame->data[3] == 0 );
+    test_FrameIdx++;
+  }
+
+  hostTestRun( TEST_STREAM_MSEC );
+  test_Collect();
+  HOST_CHECK( test_Left == 0 );
+  HOST_CHECK( hostMtOverruns == 0 );
+
+  // The copy of the records is freed with the last IND
+  HOST_CHECK( osal_heap_mem_used() == used );
+
+  // A mix of allocations and frees, streamed out while it runs
+  if ( argc > 1 )
+  {
+    test_Fp = fopen( argv[1], "w" );
+    HOST_CHECK( test_Fp != NULL );
+  }
+
+  seq = osal_mem_trace_seq();
+  first = seq;
+  test_Recs = 0;
+  test_Request( seq );
+  requests++;
+
+  for ( n = 0; n < TEST_OPS; n++ )
+  {
+    uint8 k = (uint8)((n * 7) % TEST_SLOTS);
+
+    hostTestRun( 10 + 10 * (n % 4) );
+    test_Collect();
+
+    if ( !test_Waiting && (test_Left == 0) )
+    {
+      test_Request( test_Seq );
+      requests++;
+    }
+
+    if ( ptr[k] != NULL )
+    {
+      osal_mem_free( ptr[k] );
+      ptr[k] = NULL;
+    }
+    else
+    {
+      ptr[k] = osal_mem_alloc( 8 + ((n * 13) % 64) );
+    }
+  }
+
+  hostTestRun( TEST_STREAM_MSEC );
+  test_Collect();
+  test_Request( test_Seq );
+  requests++;
+  hostTestRun( TEST_STREAM_MSEC );
+  test_Collect();
+
+  if ( test_Fp != NULL )
+  {
+    fclose( test_Fp );
+  }
+
+  HOST_CHECK( !test_Waiting );
+  HOST_CHECK( test_Left == 0 );
+  HOST_CHECK( hostMtOverruns == 0 );
+
+  // Every record was sent once, and the trace only holds the workload
+  // and the requests: the copy, the timer and the frames sent by MT are
+  // not traced.
+  HOST_CHECK( test_Recs == (uint16)(test_Seq - first) );
+  HOST_CHECK( (uint16)(osal_mem_trace_seq() - first) == TEST_OPS + 2 * requests );
+  HOST_CHECK( test_Recs > 10 * OSALMEM_TRACE_CNT );
+
+  return hostTestResult( "test_heap_trace" );
+}
+
+/*********************************************************************
+*********************************************************************/
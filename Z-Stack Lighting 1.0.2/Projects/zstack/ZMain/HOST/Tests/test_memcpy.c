@@ -0,0 +1,194 @@
+/**************************************************************************************************
+  Filename:       test_memcpy.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host test of the OSAL memory copy and compare functions.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include <string.h>
+
+#include "ZComDef.h"
+#include "hal_drivers.h"
+#include "OSAL.h"
+#include "OSAL_Tasks.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define TEST_ALIGN                 8
+#define TEST_LEN_MAX               200
+#define TEST_BUF_LEN               (TEST_ALIGN + TEST_LEN_MAX + TEST_ALIGN)
+
+#define TEST_GUARD                 0xA5
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+const pTaskEventHandlerFn tasksArr[] = {
+  Hal_ProcessEvent
+};
+
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt);
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt));
+
+  Hal_Init( 0 );
+}
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static uint8 test_Src[TEST_BUF_LEN];
+static uint8 test_Dst[TEST_BUF_LEN];
+static uint8 test_Ref[TEST_BUF_LEN];
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+static void test_Reset( void )
+{
+  memset( test_Dst, TEST_GUARD, sizeof( test_Dst ) );
+  memset( test_Ref, TEST_GUARD, sizeof( test_Ref ) );
+}
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   The unrolled copy and compare loops give the same bytes and
+ *          return values as plain byte loops, at every source and
+ *          destination alignment and every length up to TEST_LEN_MAX,
+ *          and write nothing outside the destination.
+ */
+int main( void )
+{
+  uint32 badCpy = 0, badRev = 0, badCmp = 0, badSet = 0;
+  uint16 len, idx;
+  uint8 so, dof;
+
+  for ( idx = 0; idx < TEST_BUF_LEN; idx++ )
+  {
+    test_Src[idx] = (uint8)(idx * 37 + 11);
+  }
+
+  for ( so = 0; so < TEST_ALIGN; so++ )
+  {
+    for ( dof = 0; dof < TEST_ALIGN; dof++ )
+    {
+      for ( len = 0; len <= TEST_LEN_MAX; len++ )
+      {
+        const uint8 *pSrc = test_Src + so;
+        uint8 *pDst = test_Dst + dof;
+
+        // osal_memcpy
+        test_Reset();
+        memcpy( test_Ref + dof, pSrc, len );
+        if ( (osal_memcpy( pDst, pSrc, len ) != pDst + len) ||
+             (memcmp( test_Dst, test_Ref, TEST_BUF_LEN ) != 0) )
+        {
+          badCpy++;
+        }
+
+        // osal_revmemcpy
+        test_Reset();
+        for ( idx = 0; idx < len; idx++ )
+        {
+          test_Ref[dof + idx] = pSrc[len - 1 - idx];
+        }
+        if ( (osal_revmemcpy( pDst, pSrc, len ) != pDst + len) ||
+             (memcmp( test_Dst, test_Ref, TEST_BUF_LEN ) != 0) )
+        {
+          badRev++;
+        }
+
+        // osal_memcmp, equal and then differing at the first, a middle and the last byte
+        memcpy( pDst, pSrc, len );
+        if ( osal_memcmp( pDst, pSrc, len ) != TRUE )
+        {
+          badCmp++;
+        }
+        if ( len != 0 )
+        {
+          uint16 diff[3];
+          uint8 k;
+
+          diff[0] = 0;
+          diff[1] = len / 2;
+          diff[2] = len - 1;
+          for ( k = 0; k < 3; k++ )
+          {
+            pDst[diff[k]] ^= 0x10;
+            if ( osal_memcmp( pDst, pSrc, len ) != FALSE )
+            {
+              badCmp++;
+            }
+            pDst[diff[k]] ^= 0x10;
+          }
+        }
+
+        // osal_memset
+        test_Reset();
+        memset( test_Ref + dof, so, len );
+        if ( (osal_memset( pDst, so, len ) != pDst) ||
+             (memcmp( test_Dst, test_Ref, TEST_BUF_LEN ) != 0) )
+        {
+          badSet++;
+        }
+      }
+    }
+  }
+
+  HOST_CHECK( badCpy == 0 );
+  HOST_CHECK( badRev == 0 );
+  HOST_CHECK( badCmp == 0 );
+  HOST_CHECK( badSet == 0 );
+
+  return hostTestResult( "test_memcpy" );
+}
+
+/*********************************************************************
+*********************************************************************/
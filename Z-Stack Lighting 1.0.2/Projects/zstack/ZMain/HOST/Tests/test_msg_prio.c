@@ -0,0 +1,259 @@
+/**************************************************************************************************
+  Filename:       test_msg_prio.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host test of urgent message priority in the OSAL scheduler.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include "ZComDef.h"
+#include "hal_drivers.h"
+#include "OSAL.h"
+#include "OSAL_Tasks.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define TEST_TASK_HOG              1
+#define TEST_TASK_IDLE             2
+#define TEST_TASK_RX               3
+
+#define TEST_HOG_EVT               0x0001
+
+#define TEST_RX_MAX                16
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+static uint16 test_hog_loop( uint8 task_id, uint16 events );
+static uint16 test_idle_loop( uint8 task_id, uint16 events );
+static uint16 test_rx_loop( uint8 task_id, uint16 events );
+
+const pTaskEventHandlerFn tasksArr[] = {
+  Hal_ProcessEvent,
+  test_hog_loop,
+  test_idle_loop,
+  test_rx_loop
+};
+
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt);
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt));
+
+  Hal_Init( 0 );
+}
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static uint32 testRuns[4];
+
+// The hog task keeps its events while on, the receiver sends itself an
+// urgent message for each one received while echo is on
+static uint8 testHogOn;
+static uint8 testRxEcho;
+
+// Events and priorities of the messages received by the receiver task
+static uint8 testRxEvent[TEST_RX_MAX];
+static uint8 testRxPrio[TEST_RX_MAX];
+static uint8 testRxCnt;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+static uint8 *test_Msg( uint8 event, uint8 prio )
+{
+  uint8 *pMsg = osal_msg_allocate( sizeof( osal_event_hdr_t ) );
+
+  if ( pMsg )
+  {
+    ((osal_event_hdr_t *)pMsg)->event = event;
+    OSAL_MSG_PRIO( pMsg ) = prio;
+  }
+
+  return ( pMsg );
+}
+
+static uint16 test_hog_loop( uint8 task_id, uint16 events )
+{
+  testRuns[task_id]++;
+
+  return ( testHogOn ? events : 0 );
+}
+
+static uint16 test_idle_loop( uint8 task_id, uint16 events )
+{
+  testRuns[task_id]++;
+
+  return 0;
+}
+
+static uint16 test_rx_loop( uint8 task_id, uint16 events )
+{
+  testRuns[task_id]++;
+
+  if ( events & SYS_EVENT_MSG )
+  {
+    // One message a run, osal_msg_receive() keeps the event while more wait
+    uint8 *pMsg = osal_msg_receive( task_id );
+
+    if ( pMsg )
+    {
+      if ( testRxCnt < TEST_RX_MAX )
+      {
+        testRxEvent[testRxCnt] = ((osal_event_hdr_t *)pMsg)->event;
+        testRxPrio[testRxCnt] = OSAL_MSG_PRIO( pMsg );
+        testRxCnt++;
+      }
+
+      if ( testRxEcho )
+      {
+        osal_msg_send( task_id, test_Msg( 0xEE, OSAL_MSG_PRIO_URGENT ) );
+      }
+
+      osal_msg_deallocate( pMsg );
+    }
+
+    return ( events ^ SYS_EVENT_MSG );
+  }
+
+  return 0;
+}
+
+static void test_Pass( uint16 cnt )
+{
+  while ( cnt-- )
+  {
+    osal_run_system();
+  }
+}
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   Urgent messages are received first and run their task ahead of
+ *          the others, within the ready bitmap and the task quantum.
+ */
+int main( void )
+{
+  uint8 *pMsg;
+  uint32 runs;
+  uint8 i;
+
+  hostTestBoot();
+  hostTestRun( 10 );
+
+  // Urgent messages are received first, in order; the priority is cleared
+  HOST_CHECK( osal_msg_send( TEST_TASK_RX, test_Msg( 0x11, OSAL_MSG_PRIO_NORMAL ) ) == SUCCESS );
+  HOST_CHECK( osal_msg_send( TEST_TASK_RX, test_Msg( 0x21, OSAL_MSG_PRIO_URGENT ) ) == SUCCESS );
+  HOST_CHECK( osal_msg_send( TEST_TASK_RX, test_Msg( 0x12, OSAL_MSG_PRIO_NORMAL ) ) == SUCCESS );
+  HOST_CHECK( osal_msg_send( TEST_TASK_RX, test_Msg( 0x22, OSAL_MSG_PRIO_URGENT ) ) == SUCCESS );
+  HOST_CHECK( osal_msg_push_front( TEST_TASK_RX, test_Msg( 0x20, OSAL_MSG_PRIO_URGENT ) ) == SUCCESS );
+  hostTestRun( 5 );
+
+  HOST_CHECK( testRxCnt == 5 );
+  HOST_CHECK( testRxEvent[0] == 0x20 );
+  HOST_CHECK( testRxEvent[1] == 0x21 );
+  HOST_CHECK( testRxEvent[2] == 0x22 );
+  HOST_CHECK( testRxEvent[3] == 0x11 );
+  HOST_CHECK( testRxEvent[4] == 0x12 );
+  for ( i = 0; i < testRxCnt; i++ )
+  {
+    HOST_CHECK( testRxPrio[i] == OSAL_MSG_PRIO_NORMAL );
+  }
+
+  // A task whose SYS_EVENT_MSG was cleared behind OSAL's back is not run
+  // for its urgent message, and the loop does not wait for it
+  runs = testRuns[TEST_TASK_IDLE];
+  HOST_CHECK( osal_msg_send( TEST_TASK_IDLE, test_Msg( 0x31, OSAL_MSG_PRIO_URGENT ) ) == SUCCESS );
+  HOST_CHECK( osal_clear_event( TEST_TASK_IDLE, SYS_EVENT_MSG ) == SUCCESS );
+  test_Pass( 10 );
+  HOST_CHECK( testRuns[TEST_TASK_IDLE] == runs );
+
+  pMsg = osal_msg_receive( TEST_TASK_IDLE );
+  HOST_CHECK( (pMsg != NULL) && (((osal_event_hdr_t *)pMsg)->event == 0x31) );
+  if ( pMsg )
+  {
+    osal_msg_deallocate( pMsg );
+  }
+
+  // An urgent message runs its task ahead of a higher priority busy task
+  testHogOn = TRUE;
+  osal_set_event( TEST_TASK_HOG, TEST_HOG_EVT );
+  test_Pass( 1 );
+
+  testRxCnt = 0;
+  runs = testRuns[TEST_TASK_HOG];
+  HOST_CHECK( osal_msg_send( TEST_TASK_RX, test_Msg( 0x41, OSAL_MSG_PRIO_URGENT ) ) == SUCCESS );
+  test_Pass( 1 );
+  HOST_CHECK( testRxCnt == 1 );
+  HOST_CHECK( testRuns[TEST_TASK_HOG] == runs );
+
+  // A normal one waits for the busy task to use up its quantum
+  HOST_CHECK( osal_msg_send( TEST_TASK_RX, test_Msg( 0x42, OSAL_MSG_PRIO_NORMAL ) ) == SUCCESS );
+  test_Pass( OSAL_TASK_QUANTUM + 1 );
+  HOST_CHECK( testRxCnt == 2 );
+
+  // A task that keeps receiving urgent messages is held to its quantum too
+  testRxEcho = TRUE;
+  runs = testRuns[TEST_TASK_HOG];
+  HOST_CHECK( osal_msg_send( TEST_TASK_RX, test_Msg( 0x43, OSAL_MSG_PRIO_URGENT ) ) == SUCCESS );
+  test_Pass( 50 * (OSAL_TASK_QUANTUM + 1) );
+  HOST_CHECK( testRuns[TEST_TASK_HOG] - runs >= 49 );
+  HOST_CHECK( testRuns[TEST_TASK_HOG] - runs <= 51 );
+
+  testRxEcho = FALSE;
+  testHogOn = FALSE;
+  hostTestRun( 5 );
+  HOST_CHECK( osal_msg_receive( TEST_TASK_RX ) == NULL );
+  HOST_CHECK( tasksEvents[TEST_TASK_HOG] == 0 );
+
+  return hostTestResult( "test_msg_prio" );
+}
+
+/*********************************************************************
+*********************************************************************/
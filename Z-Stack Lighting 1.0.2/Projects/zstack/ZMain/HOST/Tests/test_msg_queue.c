@@ -0,0 +1,194 @@
+/**************************************************************************************************
+  Filename:       test_msg_queue.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host test of the per-task OSAL message queues.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include "ZComDef.h"
+#include "hal_drivers.h"
+#include "OSAL.h"
+#include "OSAL_Tasks.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define TEST_TASK_A                1
+#define TEST_TASK_B                2
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+static uint16 test_event_loop( uint8 task_id, uint16 events );
+
+const pTaskEventHandlerFn tasksArr[] = {
+  Hal_ProcessEvent,
+  test_event_loop,
+  test_event_loop
+};
+
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt);
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt));
+
+  Hal_Init( 0 );
+}
+
+static uint16 test_event_loop( uint8 task_id, uint16 events )
+{
+  return 0;
+}
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+static uint8 *test_Msg( uint8 event )
+{
+  uint8 *pMsg = osal_msg_allocate( sizeof( osal_event_hdr_t ) );
+
+  if ( pMsg )
+  {
+    ((osal_event_hdr_t *)pMsg)->event = event;
+  }
+
+  return ( pMsg );
+}
+
+static uint8 test_Receive( uint8 task_id )
+{
+  uint8 *pMsg = osal_msg_receive( task_id );
+  uint8 event = 0;
+
+  if ( pMsg )
+  {
+    event = ((osal_event_hdr_t *)pMsg)->event;
+    HOST_CHECK( osal_msg_deallocate( pMsg ) == SUCCESS );
+  }
+
+  return ( event );
+}
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   Per-task message queues keep the OSAL queueing semantics.
+ */
+int main( void )
+{
+  uint8 *pMsg;
+  uint8 i;
+
+  hostTestBoot();
+
+  // Interleaved sends are received in order, per task
+  for ( i = 1; i <= 3; i++ )
+  {
+    HOST_CHECK( osal_msg_send( TEST_TASK_A, test_Msg( 0x10 + i ) ) == SUCCESS );
+    HOST_CHECK( osal_msg_send( TEST_TASK_B, test_Msg( 0x20 + i ) ) == SUCCESS );
+  }
+  HOST_CHECK( tasksEvents[TEST_TASK_A] & SYS_EVENT_MSG );
+  HOST_CHECK( tasksEvents[TEST_TASK_B] & SYS_EVENT_MSG );
+
+  HOST_CHECK( test_Receive( TEST_TASK_B ) == 0x21 );
+  HOST_CHECK( test_Receive( TEST_TASK_A ) == 0x11 );
+  HOST_CHECK( test_Receive( TEST_TASK_B ) == 0x22 );
+  HOST_CHECK( test_Receive( TEST_TASK_B ) == 0x23 );
+
+  // The event stays set while messages are left, and is cleared with the last
+  HOST_CHECK( (tasksEvents[TEST_TASK_B] & SYS_EVENT_MSG) == 0 );
+  HOST_CHECK( test_Receive( TEST_TASK_B ) == 0 );
+  HOST_CHECK( tasksEvents[TEST_TASK_A] & SYS_EVENT_MSG );
+
+  // push_front goes ahead of the queued messages
+  HOST_CHECK( osal_msg_push_front( TEST_TASK_A, test_Msg( 0x1F ) ) == SUCCESS );
+
+  // osal_msg_find only looks at the queue of the given task
+  HOST_CHECK( osal_msg_find( TEST_TASK_A, 0x13 ) != NULL );
+  HOST_CHECK( osal_msg_find( TEST_TASK_B, 0x13 ) == NULL );
+  HOST_CHECK( osal_msg_find( TEST_TASK_A, 0x21 ) == NULL );
+  HOST_CHECK( osal_msg_find( tasksCnt, 0x13 ) == NULL );
+
+  HOST_CHECK( test_Receive( TEST_TASK_A ) == 0x1F );
+  HOST_CHECK( test_Receive( TEST_TASK_A ) == 0x12 );
+
+  // A queued message can be neither sent again nor deallocated
+  pMsg = (uint8 *)osal_msg_find( TEST_TASK_A, 0x13 );
+  HOST_CHECK( osal_msg_deallocate( pMsg ) == MSG_BUFFER_NOT_AVAIL );
+  HOST_CHECK( test_Receive( TEST_TASK_A ) == 0x13 );
+  HOST_CHECK( test_Receive( TEST_TASK_A ) == 0 );
+  HOST_CHECK( (tasksEvents[TEST_TASK_A] & SYS_EVENT_MSG) == 0 );
+
+  // Sending to a task that does not exist frees the message
+  HOST_CHECK( osal_msg_send( tasksCnt, test_Msg( 0x30 ) ) == INVALID_TASK );
+  HOST_CHECK( osal_msg_send( TEST_TASK_A, NULL ) == INVALID_MSG_POINTER );
+  HOST_CHECK( osal_msg_receive( tasksCnt ) == NULL );
+
+  // The generic queue helpers are unchanged
+  {
+    osal_msg_q_t q;
+    uint8 *pA = test_Msg( 1 ), *pB = test_Msg( 2 ), *pC = test_Msg( 3 );
+
+    OSAL_MSG_Q_INIT( &q );
+    osal_msg_enqueue( &q, pA );
+    osal_msg_enqueue( &q, pB );
+    osal_msg_push( &q, pC );
+    HOST_CHECK( OSAL_MSG_Q_HEAD( &q ) == pC );
+    osal_msg_extract( &q, pA, pC );
+    HOST_CHECK( osal_msg_dequeue( &q ) == pC );
+    HOST_CHECK( osal_msg_dequeue( &q ) == pB );
+    HOST_CHECK( OSAL_MSG_Q_EMPTY( &q ) );
+
+    osal_msg_deallocate( pA );
+    osal_msg_deallocate( pB );
+    osal_msg_deallocate( pC );
+  }
+
+  return hostTestResult( "test_msg_queue" );
+}
+
+/*********************************************************************
+*********************************************************************/
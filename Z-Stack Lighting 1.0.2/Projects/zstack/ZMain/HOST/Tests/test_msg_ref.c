@@ -0,0 +1,188 @@
+/**************************************************************************************************
+  Filename:       test_msg_ref.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host test of the reference counted OSAL messages.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include "ZComDef.h"
+#include "hal_drivers.h"
+#include "OSAL.h"
+#include "OSAL_Tasks.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define TEST_TASK_APP              1
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+static uint16 test_event_loop( uint8 task_id, uint16 events );
+
+const pTaskEventHandlerFn tasksArr[] = {
+  Hal_ProcessEvent,
+  test_event_loop
+};
+
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt);
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt));
+
+  Hal_Init( 0 );
+}
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static uint16 test_Received;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+static uint16 test_event_loop( uint8 task_id, uint16 events )
+{
+  if ( events & SYS_EVENT_MSG )
+  {
+    uint8 *pMsg;
+
+    while ( (pMsg = osal_msg_receive( task_id )) != NULL )
+    {
+      HOST_CHECK( osal_msg_deallocate( pMsg ) == SUCCESS );
+      test_Received++;
+    }
+
+    return ( events ^ SYS_EVENT_MSG );
+  }
+
+  return 0;
+}
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   Message buffers live until the last reference is given back:
+ *          retained, attached to other messages, sliced, and queued.
+ *          A reference to a queued message can be given back, as AF
+ *          does after sending a frame it retained, but the last one is
+ *          the queue's and only the receiver frees it.
+ */
+int main( void )
+{
+  osalMsgSlice_t slice;
+  uint16 heapUsed;
+  uint8 *pFrame, *pEp2, *pReport;
+
+  hostTestBoot();
+  heapUsed = osal_heap_mem_used();
+
+  // A received frame, a second endpoint's message pointing into it, and a report parsed from that
+  pFrame = osal_msg_allocate( 40 );
+  HOST_CHECK( (pFrame != NULL) && (OSAL_MSG_REFS( pFrame ) == 1) );
+  HOST_CHECK( osal_msg_retain( pFrame ) == pFrame );
+  HOST_CHECK( OSAL_MSG_REFS( pFrame ) == 2 );
+
+  pEp2 = osal_msg_allocate( 10 );
+  HOST_CHECK( osal_msg_attach( pEp2, pFrame ) == SUCCESS );
+  HOST_CHECK( OSAL_MSG_REFS( pFrame ) == 3 );
+  HOST_CHECK( osal_msg_attach( pEp2, pFrame ) == MSG_BUFFER_NOT_AVAIL );
+  HOST_CHECK( osal_msg_attach( pEp2, pEp2 ) == INVALID_MSG_POINTER );
+
+  pReport = osal_msg_allocate( 8 );
+  HOST_CHECK( osal_msg_attach( pReport, pEp2 ) == SUCCESS );
+
+  // A slice of the frame, found through the chain of references
+  HOST_CHECK( osal_msg_slice( &slice, pReport, pFrame + 5, 30 ) == SUCCESS );
+  HOST_CHECK( (slice.msg == pFrame) && (OSAL_MSG_REFS( pFrame ) == 4) );
+  osal_msg_slice_release( &slice );
+  HOST_CHECK( (slice.msg == NULL) && (OSAL_MSG_REFS( pFrame ) == 3) );
+  HOST_CHECK( osal_msg_slice( &slice, pReport, pFrame + 5, 36 ) == INVALIDPARAMETER );
+  HOST_CHECK( slice.msg == NULL );
+  HOST_CHECK( osal_msg_slice( &slice, pReport, pFrame + 5, 35 ) == SUCCESS );
+
+  // Queued, and retained by the sender: the sender's reference is given back
+  HOST_CHECK( osal_msg_retain( pFrame ) == pFrame );
+  HOST_CHECK( osal_msg_send( TEST_TASK_APP, pFrame ) == SUCCESS );
+  HOST_CHECK( OSAL_MSG_REFS( pFrame ) == 5 );
+  HOST_CHECK( osal_msg_deallocate( pFrame ) == SUCCESS );
+  HOST_CHECK( osal_msg_deallocate( pFrame ) == SUCCESS );
+  HOST_CHECK( OSAL_MSG_REFS( pFrame ) == 3 );
+  HOST_CHECK( osal_msg_send( TEST_TASK_APP, pEp2 ) == SUCCESS );
+  HOST_CHECK( OSAL_MSG_REFS( pEp2 ) == 2 );
+
+  // Freeing the report gives back its reference to the queued message
+  HOST_CHECK( osal_msg_deallocate( pReport ) == SUCCESS );
+  HOST_CHECK( (OSAL_MSG_REFS( pEp2 ) == 1) && (OSAL_MSG_REFS( pFrame ) == 3) );
+
+  // The last reference is the queue's
+  HOST_CHECK( osal_msg_deallocate( pEp2 ) == MSG_BUFFER_NOT_AVAIL );
+  HOST_CHECK( OSAL_MSG_REFS( pEp2 ) == 1 );
+
+  osal_msg_slice_release( &slice );
+  HOST_CHECK( OSAL_MSG_REFS( pFrame ) == 2 );
+
+  // The receiver frees the last of them
+  hostTestRun( 5 );
+  HOST_CHECK( test_Received == 2 );
+  HOST_CHECK( osal_heap_mem_used() == heapUsed );
+
+  // The count saturates rather than wraps
+  pFrame = osal_msg_allocate( 4 );
+  while ( (OSAL_MSG_REFS( pFrame ) < 0xFF) && (osal_msg_retain( pFrame ) == pFrame) );
+  HOST_CHECK( OSAL_MSG_REFS( pFrame ) == 0xFF );
+  HOST_CHECK( osal_msg_retain( pFrame ) == NULL );
+  while ( (OSAL_MSG_REFS( pFrame ) > 1) && (osal_msg_deallocate( pFrame ) == SUCCESS) );
+  HOST_CHECK( OSAL_MSG_REFS( pFrame ) == 1 );
+  HOST_CHECK( osal_msg_deallocate( pFrame ) == SUCCESS );
+  HOST_CHECK( osal_heap_mem_used() == heapUsed );
+
+  return hostTestResult( "test_msg_ref" );
+}
+
+/*********************************************************************
+*********************************************************************/
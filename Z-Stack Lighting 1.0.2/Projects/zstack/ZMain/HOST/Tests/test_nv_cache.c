@@ -0,0 +1,251 @@
+/**************************************************************************************************
+  Filename:       test_nv_cache.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host test of the NV write cache.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include <string.h>
+
+#include "ZComDef.h"
+#include "hal_board_cfg.h"
+#include "hal_drivers.h"
+#include "hal_sim.h"
+#include "OSAL.h"
+#include "OSAL_Nv.h"
+#include "OSAL_Tasks.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define TEST_TASK_NV               1
+
+#define TEST_ID_BASE               0x0300
+#define TEST_ITEMS                 5
+#define TEST_ITEM_LEN              8
+
+// The OSAL_Nv.c defaults
+#define TEST_DEADLINE              5000
+#define TEST_CACHE_SIZE            4
+#define TEST_CACHE_ITEM_MAX        64
+#define TEST_CACHE_VDD             (VDD_MIN_NV+4)
+
+#define TEST_ID_LONG               0x0310
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+const pTaskEventHandlerFn tasksArr[] = {
+  Hal_ProcessEvent,
+  osal_nv_event_loop
+};
+
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt);
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt));
+
+  Hal_Init( 0 );
+  osal_nv_task_init( TEST_TASK_NV );
+}
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+static uint32 test_Words( void )
+{
+  uint32 erases, words;
+
+  halSimFlashStats( &erases, &words );
+
+  return words;
+}
+
+/*
+ * TRUE if the data is in the NV pages, i.e. was written to flash.
+ */
+static uint8 test_InFlash( const uint8 *pData )
+{
+  const uint8 *pImage = halSimFlashImage();
+  uint32 idx;
+
+  for ( idx = 0; idx <= (HAL_NV_PAGE_CNT * HAL_FLASH_PAGE_SIZE) - TEST_ITEM_LEN; idx++ )
+  {
+    if ( memcmp( pImage + idx, pData, TEST_ITEM_LEN ) == 0 )
+    {
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+static void test_Fill( uint8 *pData, uint8 val )
+{
+  uint8 idx;
+
+  for ( idx = 0; idx < TEST_ITEM_LEN; idx++ )
+  {
+    pData[idx] = (uint8)(val + idx * 17);
+  }
+}
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   Writes to cached items stay in RAM until the deadline and are
+ *          then written once; reads and writes are bounded by the item
+ *          length; once Vdd is near VDD_MIN_NV the writes go through
+ *          at once, and below it the flush is held back, not the writes;
+ *          the cache can be flushed on demand; and long items are not
+ *          cached.
+ */
+int main( void )
+{
+  uint8 data[TEST_ITEM_LEN], rd[TEST_ITEM_LEN];
+  uint32 words, cached;
+  uint16 id;
+  uint8 idx;
+
+  hostTestBoot();
+  osal_nv_init( NULL );
+
+  HOST_CHECK( osal_nv_cache_add( TEST_ID_BASE ) == NV_ITEM_UNINIT );
+
+  test_Fill( data, 0 );
+  for ( id = TEST_ID_BASE; id < TEST_ID_BASE + TEST_ITEMS; id++ )
+  {
+    HOST_CHECK( osal_nv_item_init( id, TEST_ITEM_LEN, data ) == NV_ITEM_UNINIT );
+  }
+  for ( id = TEST_ID_BASE; id < TEST_ID_BASE + TEST_CACHE_SIZE; id++ )
+  {
+    HOST_CHECK( osal_nv_cache_add( id ) == SUCCESS );
+  }
+  HOST_CHECK( osal_nv_cache_add( TEST_ID_BASE ) == SUCCESS );
+  HOST_CHECK( osal_nv_cache_add( TEST_ID_BASE + TEST_CACHE_SIZE ) == NV_OPER_FAILED );
+
+  // Changes are held in RAM, and read back from there
+  words = test_Words();
+  for ( idx = 1; idx <= 100; idx++ )
+  {
+    test_Fill( data, idx );
+    HOST_CHECK( osal_nv_write( TEST_ID_BASE, 0, TEST_ITEM_LEN, data ) == SUCCESS );
+    hostTestRun( 10 );
+  }
+  HOST_CHECK( osal_nv_read( TEST_ID_BASE, 0, TEST_ITEM_LEN, rd ) == SUCCESS );
+  HOST_CHECK( memcmp( rd, data, TEST_ITEM_LEN ) == 0 );
+  HOST_CHECK( test_Words() == words );
+  HOST_CHECK( !test_InFlash( data ) );
+
+  // Bounded by the item length
+  HOST_CHECK( osal_nv_read( TEST_ID_BASE, 1, TEST_ITEM_LEN, rd ) == NV_OPER_FAILED );
+  HOST_CHECK( osal_nv_read( TEST_ID_BASE, TEST_ITEM_LEN, 1, rd ) == NV_OPER_FAILED );
+  HOST_CHECK( osal_nv_write( TEST_ID_BASE, 1, TEST_ITEM_LEN, data ) == NV_OPER_FAILED );
+  HOST_CHECK( osal_nv_read( TEST_ID_BASE, TEST_ITEM_LEN - 1, 1, rd ) == SUCCESS );
+  HOST_CHECK( rd[0] == data[TEST_ITEM_LEN - 1] );
+
+  // Written once, by the deadline after the first change
+  hostTestRun( TEST_DEADLINE - 1000 - 10 );
+  HOST_CHECK( !test_InFlash( data ) );
+  hostTestRun( 20 );
+  HOST_CHECK( test_InFlash( data ) );
+  cached = test_Words() - words;
+
+  // The same as one write of an item that is not cached
+  words = test_Words();
+  HOST_CHECK( osal_nv_write( TEST_ID_BASE + TEST_CACHE_SIZE, 0, TEST_ITEM_LEN, data ) == SUCCESS );
+  HOST_CHECK( test_Words() - words == cached );
+
+  // Just above VDD_MIN_NV, a change is written at once, while it still can be
+  halSimVddSet( TEST_CACHE_VDD );
+  test_Fill( data, 0x70 );
+  HOST_CHECK( osal_nv_write( TEST_ID_BASE + 1, 0, TEST_ITEM_LEN, data ) == SUCCESS );
+  HOST_CHECK( test_InFlash( data ) );
+  words = test_Words();
+  hostTestRun( TEST_DEADLINE * 2 );
+  HOST_CHECK( test_Words() == words );
+
+  // A lower Vdd holds the flush back until it recovers; the writes still succeed
+  halSimVddSet( VDD_MIN_NV );
+  words = test_Words();
+  for ( idx = 1; idx <= 10; idx++ )
+  {
+    test_Fill( data, (uint8)(0x80 + idx) );
+    HOST_CHECK( osal_nv_write( TEST_ID_BASE + 1, 0, TEST_ITEM_LEN, data ) == SUCCESS );
+  }
+  HOST_CHECK( osal_nv_flush() == NV_OPER_FAILED );
+  hostTestRun( TEST_DEADLINE * 2 );
+  HOST_CHECK( test_Words() == words );
+
+  halSimVddSet( 0xFF );
+  hostTestRun( TEST_DEADLINE + 10 );
+  HOST_CHECK( test_InFlash( data ) );
+
+  // Flushed on demand, as before a reset
+  test_Fill( data, 0x40 );
+  HOST_CHECK( osal_nv_write( TEST_ID_BASE + 2, 0, TEST_ITEM_LEN, data ) == SUCCESS );
+  HOST_CHECK( !test_InFlash( data ) );
+  OSAL_NV_FLUSH();
+  HOST_CHECK( test_InFlash( data ) );
+  words = test_Words();
+  HOST_CHECK( osal_nv_flush() == SUCCESS );
+  hostTestRun( TEST_DEADLINE * 2 );
+  HOST_CHECK( test_Words() == words );
+
+  // A deleted item leaves the cache, making room for another
+  HOST_CHECK( osal_nv_delete( TEST_ID_BASE + 3, TEST_ITEM_LEN ) == SUCCESS );
+  HOST_CHECK( osal_nv_read( TEST_ID_BASE + 3, 0, TEST_ITEM_LEN, rd ) == NV_OPER_FAILED );
+
+  // but not for an item longer than TEST_CACHE_ITEM_MAX, which would hold too much heap
+  HOST_CHECK( osal_nv_item_init( TEST_ID_LONG, TEST_CACHE_ITEM_MAX + 1, NULL ) == NV_ITEM_UNINIT );
+  HOST_CHECK( osal_nv_cache_add( TEST_ID_LONG ) == NV_OPER_FAILED );
+  HOST_CHECK( osal_nv_cache_add( TEST_ID_BASE + TEST_CACHE_SIZE ) == SUCCESS );
+
+  return hostTestResult( "test_nv_cache" );
+}
+
+/*********************************************************************
+*********************************************************************/
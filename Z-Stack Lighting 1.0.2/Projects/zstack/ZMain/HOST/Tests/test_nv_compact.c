@@ -0,0 +1,330 @@
+/**************************************************************************************************
+  Filename:       test_nv_compact.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host test of the background NV page compaction across power cuts.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include <setjmp.h>
+#include <string.h>
+
+#include "ZComDef.h"
+#include "hal_drivers.h"
+#include "hal_mcu.h"
+#include "hal_sim.h"
+#include "OSAL.h"
+#include "OSAL_Nv.h"
+#include "OSAL_Tasks.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define TEST_TASK_NV               1
+
+#define TEST_ID_BASE               0x0100
+#define TEST_ITEMS                 40
+#define TEST_ITEM_MAX              200
+
+#define TEST_OPS                   20000
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+const pTaskEventHandlerFn tasksArr[] = {
+  Hal_ProcessEvent,
+  osal_nv_event_loop
+};
+
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt);
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt));
+
+  Hal_Init( 0 );
+  osal_nv_task_init( TEST_TASK_NV );
+}
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// What NV should hold
+static uint8 test_Item[TEST_ITEMS][TEST_ITEM_MAX];
+static uint16 test_Len[TEST_ITEMS];
+static uint8 test_Exists[TEST_ITEMS];
+
+static uint32 test_Seed = 12345;
+static jmp_buf test_Cut;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+static uint16 test_Rand( void )
+{
+  test_Seed = test_Seed * 1103515245 + 12345;
+
+  return ( (uint16)(test_Seed >> 16) & 0x7FFF );
+}
+
+static void test_PowerCut( void )
+{
+  longjmp( test_Cut, 1 );
+}
+
+/*
+ * Compare every item in NV with the model, returns the number that differ.
+ */
+static uint8 test_Verify( void )
+{
+  uint8 buf[TEST_ITEM_MAX];
+  uint8 bad = 0;
+  uint8 k;
+
+  for ( k = 0; k < TEST_ITEMS; k++ )
+  {
+    if ( !test_Exists[k] )
+    {
+      if ( osal_nv_item_len( TEST_ID_BASE + k ) != 0 )
+      {
+        bad++;
+      }
+    }
+    else if ( (osal_nv_item_len( TEST_ID_BASE + k ) != test_Len[k]) ||
+              (osal_nv_read( TEST_ID_BASE + k, 0, test_Len[k], buf ) != SUCCESS) ||
+              (memcmp( buf, test_Item[k], test_Len[k] ) != 0) )
+    {
+      bad++;
+    }
+  }
+
+  return ( bad );
+}
+
+/*
+ * Let the NV task run for a few passes of the OSAL loop.
+ */
+static void test_Pass( uint8 cnt )
+{
+  while ( cnt-- )
+  {
+    osal_run_system();
+  }
+}
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   Items stay intact while the NV task compacts pages in the
+ *          background between the reads and writes, across restarts and
+ *          power cuts at any flash operation.
+ */
+int main( void )
+{
+  uint8 buf[TEST_ITEM_MAX];
+  uint32 erases, erasesAfter;
+  static uint16 bad, torn, cuts, syncErases;  // Kept across longjmp()
+  static uint32 tasksRun;
+  uint16 op;
+
+  hostTestBoot();
+  osal_nv_init( NULL );
+
+  for ( op = 0; op < TEST_OPS; op++ )
+  {
+    uint8 k = test_Rand() % TEST_ITEMS;
+    uint16 id = TEST_ID_BASE + k;
+    uint8 kind = test_Rand() % 10;
+
+    if ( !test_Exists[k] )
+    {
+      uint16 i;
+
+      test_Len[k] = 1 + (test_Rand() % ((k < 5) ? 190 : 40));
+      for ( i = 0; i < test_Len[k]; i++ )
+      {
+        test_Item[k][i] = (uint8)test_Rand();
+      }
+
+      if ( osal_nv_item_init( id, test_Len[k], test_Item[k] ) == NV_ITEM_UNINIT )
+      {
+        test_Exists[k] = TRUE;
+      }
+      else
+      {
+        bad++;
+      }
+    }
+    else if ( kind < 4 )
+    {
+      // A write, the power cut at some flash operation in one of ten
+      uint16 ndx = test_Rand() % test_Len[k];
+      uint16 len = 1 + (test_Rand() % (test_Len[k] - ndx));
+      uint16 i;
+
+      for ( i = 0; i < len; i++ )
+      {
+        buf[i] = (uint8)test_Rand();
+      }
+
+      if ( (test_Rand() % 10) == 0 )
+      {
+        halSimFlashCut( test_Rand() % 80, test_PowerCut );
+      }
+
+      halSimFlashStats( &erases, NULL );
+      if ( setjmp( test_Cut ) == 0 )
+      {
+        if ( osal_nv_write( id, ndx, len, buf ) != SUCCESS )
+        {
+          bad++;
+        }
+        halSimFlashCut( 0, NULL );
+        osal_memcpy( test_Item[k] + ndx, buf, len );
+
+        halSimFlashStats( &erasesAfter, NULL );
+        syncErases += (uint16)(erasesAfter - erases);
+      }
+      else
+      {
+        uint8 now[TEST_ITEM_MAX];
+
+        HAL_ENABLE_INTERRUPTS();
+        osal_nv_init( NULL );
+        cuts++;
+
+        // The write is all done or not at all
+        osal_nv_read( id, 0, test_Len[k], now );
+        if ( memcmp( now + ndx, buf, len ) == 0 )
+        {
+          osal_memcpy( test_Item[k] + ndx, buf, len );
+        }
+        if ( memcmp( now, test_Item[k], test_Len[k] ) != 0 )
+        {
+          torn++;
+          osal_memcpy( test_Item[k], now, test_Len[k] );
+        }
+      }
+    }
+    else if ( kind < 8 )
+    {
+      if ( (osal_nv_item_len( id ) != test_Len[k]) ||
+           (osal_nv_read( id, 0, test_Len[k], buf ) != SUCCESS) ||
+           (memcmp( buf, test_Item[k], test_Len[k] ) != 0) ||
+           (osal_nv_item_init( id, test_Len[k], NULL ) != SUCCESS) )
+      {
+        bad++;
+      }
+    }
+    else if ( kind == 8 )
+    {
+      if ( osal_nv_delete( id, test_Len[k] ) == SUCCESS )
+      {
+        test_Exists[k] = FALSE;
+      }
+      else
+      {
+        bad++;
+      }
+    }
+    else if ( (test_Rand() % 20) == 0 )
+    {
+      osal_nv_init( NULL );
+    }
+
+    // Background compaction, the power cut in the middle of it now and then
+    if ( (test_Rand() % 50) == 0 )
+    {
+      halSimFlashCut( test_Rand() % 40, test_PowerCut );
+    }
+
+    if ( setjmp( test_Cut ) == 0 )
+    {
+      uint8 passes = test_Rand() % 4;
+
+      while ( passes-- )
+      {
+        if ( tasksEvents[TEST_TASK_NV] != 0 )
+        {
+          tasksRun++;
+        }
+        test_Pass( 1 );
+      }
+      halSimFlashCut( 0, NULL );
+    }
+    else
+    {
+      HAL_ENABLE_INTERRUPTS();
+      osal_nv_init( NULL );
+      cuts++;
+    }
+
+    if ( test_Verify() != 0 )
+    {
+      bad++;
+      break;
+    }
+  }
+
+  HOST_CHECK( bad == 0 );
+  HOST_CHECK( torn == 0 );
+  HOST_CHECK( cuts > 100 );
+
+  // Compaction ran in the background, most pages were erased by the task
+  halSimFlashStats( &erases, NULL );
+  HOST_CHECK( tasksRun > 1000 );
+  HOST_CHECK( syncErases * 2 < erases );
+
+  // Left alone, the NV task finishes and goes idle
+  hostTestRun( 100 );
+  HOST_CHECK( tasksEvents[TEST_TASK_NV] == 0 );
+  osal_nv_init( NULL );
+  HOST_CHECK( test_Verify() == 0 );
+
+  return hostTestResult( "test_nv_compact" );
+}
+
+/*********************************************************************
+*********************************************************************/
@@ -0,0 +1,437 @@
+/**************************************************************************************************
+  Filename:       test_nv_index.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host test that NV lookups through the RAM index and by walking the pages agree.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include <setjmp.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "ZComDef.h"
+#include "hal_board_cfg.h"
+#include "hal_drivers.h"
+#include "hal_mcu.h"
+#include "hal_sim.h"
+#include "OSAL.h"
+#include "OSAL_Nv.h"
+#include "OSAL_Tasks.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define TEST_ID_BASE               0x0100
+#define TEST_ITEMS                 40
+#define TEST_ITEM_MAX              200
+
+#define TEST_OPS                   20000
+
+// Compacting writes done again with each of their flash writes lost in turn
+#define TEST_COMPACTS              8
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+const pTaskEventHandlerFn tasksArr[] = {
+  Hal_ProcessEvent
+};
+
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt);
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt));
+
+  Hal_Init( 0 );
+}
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// What NV should hold
+static uint8 test_Item[TEST_ITEMS][TEST_ITEM_MAX];
+static uint16 test_Len[TEST_ITEMS];
+static uint8 test_Exists[TEST_ITEMS];
+
+static uint32 test_Seed = 24680;
+static uint8 test_Image[HAL_NV_PAGE_CNT * HAL_FLASH_PAGE_SIZE];
+static uint8 test_ImageItem[TEST_ITEMS][TEST_ITEM_MAX];
+static jmp_buf test_Cut;
+static uint16 test_Fails;
+
+// Hash of everything the lookups returned, one line per operation
+static uint32 test_Hash;
+static FILE *test_Fp;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+static uint16 test_Rand( void )
+{
+  test_Seed = test_Seed * 1103515245 + 12345;
+
+  return ( (uint16)(test_Seed >> 16) & 0x7FFF );
+}
+
+static void test_PowerCut( void )
+{
+  longjmp( test_Cut, 1 );
+}
+
+static void test_HashAdd( const uint8 *buf, uint16 len )
+{
+  while ( len-- )
+  {
+    test_Hash = (test_Hash ^ *buf++) * 16777619;
+  }
+}
+
+/*
+ * Read every item but 'skip' back, add what was found to the hash and compare
+ * it with the model. Returns the number of items that differ.
+ */
+static uint8 test_Verify( uint8 skip )
+{
+  uint8 buf[TEST_ITEM_MAX];
+  uint8 bad = 0;
+  uint8 k;
+
+  for ( k = 0; k < TEST_ITEMS; k++ )
+  {
+    uint16 len;
+    uint8 stat;
+
+    if ( k == skip )
+    {
+      continue;
+    }
+
+    len = osal_nv_item_len( TEST_ID_BASE + k );
+    stat = osal_nv_read( TEST_ID_BASE + k, 0, len, buf );
+
+    test_HashAdd( (uint8 *)&len, sizeof( len ) );
+    test_HashAdd( &stat, 1 );
+    test_HashAdd( buf, len );
+
+    if ( !test_Exists[k] )
+    {
+      if ( len != 0 )
+      {
+        bad++;
+      }
+    }
+    else if ( (len != test_Len[k]) || (stat != SUCCESS) ||
+              (memcmp( buf, test_Item[k], test_Len[k] ) != 0) )
+    {
+      bad++;
+    }
+  }
+
+  return ( bad );
+}
+
+/*
+ * Find the next write of item 'k' that compacts a page, then do it again from
+ * the same flash with each of its flash writes lost in turn. A lost write makes
+ * the compaction give up and erase the reserve page, which holds the copies made
+ * so far, or makes the new value fail after the compaction. Every other item
+ * must still be found as it was. Returns the number of items found wrong.
+ */
+static uint16 test_LostWrites( uint8 k )
+{
+  uint8 buf[TEST_ITEM_MAX];
+  uint32 erases0, writes0, erases, writes;
+  uint32 ops, n;
+  uint16 bad = 0;
+  uint16 i;
+
+  do
+  {
+    for ( i = 0; i < test_Len[k]; i++ )
+    {
+      buf[i] = (uint8)test_Rand();
+    }
+
+    osal_memcpy( test_Image, halSimFlashImage(), sizeof( test_Image ) );
+    osal_memcpy( test_ImageItem, test_Item, sizeof( test_Item ) );
+    osal_nv_init( NULL );
+
+    halSimFlashStats( &erases0, &writes0 );
+    if ( osal_nv_write( TEST_ID_BASE + k, 0, test_Len[k], buf ) != SUCCESS )
+    {
+      bad++;
+    }
+    osal_memcpy( test_Item[k], buf, test_Len[k] );
+    halSimFlashStats( &erases, &writes );
+  } while ( erases == erases0 );
+
+  ops = (erases + writes) - (erases0 + writes0);
+
+  for ( n = 0; n < ops; n++ )
+  {
+    uint8 stat;
+
+    osal_memcpy( halSimFlashImage(), test_Image, sizeof( test_Image ) );
+    osal_memcpy( test_Item, test_ImageItem, sizeof( test_Item ) );
+    osal_nv_init( NULL );
+
+    halSimFlashFail( n, TRUE );
+    stat = osal_nv_write( TEST_ID_BASE + k, 0, test_Len[k], buf );
+    halSimFlashFail( 0, FALSE );
+
+    if ( stat == SUCCESS )
+    {
+      osal_memcpy( test_Item[k], buf, test_Len[k] );
+      bad += test_Verify( TEST_ITEMS );
+    }
+    else
+    {
+      // The item written may now be found half written by the page walk, until the restart.
+      test_Fails++;
+      bad += test_Verify( k );
+    }
+  }
+
+  // Leave the write done
+  osal_memcpy( halSimFlashImage(), test_Image, sizeof( test_Image ) );
+  osal_memcpy( test_Item, test_ImageItem, sizeof( test_Item ) );
+  osal_nv_init( NULL );
+  if ( osal_nv_write( TEST_ID_BASE + k, 0, test_Len[k], buf ) != SUCCESS )
+  {
+    bad++;
+  }
+  osal_memcpy( test_Item[k], buf, test_Len[k] );
+
+  return ( bad );
+}
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   Lookups through the RAM index, through an index too small
+ *          for the items, and by walking the pages all return the same.
+ *          The workload fills the pages so that writes compact them,
+ *          and cuts the power at random flash operations. Then some
+ *          compacting writes are done again with a flash write lost,
+ *          so that they erase the reserve page while the index points
+ *          to it.
+ *
+ *          With a file name, writes the hash of the lookups after each
+ *          operation; the files of the three builds must be the same.
+ */
+int main( int argc, char **argv )
+{
+  uint8 buf[TEST_ITEM_MAX];
+  uint32 erases;
+  static uint16 bad, torn, cuts;  // Kept across longjmp()
+  static uint16 op;
+
+  if ( argc > 1 )
+  {
+    test_Fp = fopen( argv[1], "w" );
+    HOST_CHECK( test_Fp != NULL );
+  }
+
+  hostTestBoot();
+  osal_nv_init( NULL );
+
+  for ( op = 0; op < TEST_OPS; op++ )
+  {
+    uint8 k = test_Rand() % TEST_ITEMS;
+    uint16 id = TEST_ID_BASE + k;
+    uint8 kind = test_Rand() % 10;
+
+    test_Hash = 2166136261UL;
+
+    if ( !test_Exists[k] )
+    {
+      uint16 i;
+
+      test_Len[k] = 1 + (test_Rand() % ((k < 5) ? 190 : 40));
+      for ( i = 0; i < test_Len[k]; i++ )
+      {
+        test_Item[k][i] = (uint8)test_Rand();
+      }
+
+      if ( osal_nv_item_init( id, test_Len[k], test_Item[k] ) == NV_ITEM_UNINIT )
+      {
+        test_Exists[k] = TRUE;
+      }
+      else
+      {
+        bad++;
+      }
+    }
+    else if ( kind < 6 )
+    {
+      // A write, the power cut at some flash operation in one of eight
+      uint16 ndx = test_Rand() % test_Len[k];
+      uint16 len = 1 + (test_Rand() % (test_Len[k] - ndx));
+      uint16 i;
+
+      for ( i = 0; i < len; i++ )
+      {
+        buf[i] = (uint8)test_Rand();
+      }
+
+      if ( (test_Rand() % 8) == 0 )
+      {
+        halSimFlashCut( test_Rand() % 80, test_PowerCut );
+      }
+
+      if ( setjmp( test_Cut ) == 0 )
+      {
+        if ( osal_nv_write( id, ndx, len, buf ) != SUCCESS )
+        {
+          bad++;
+        }
+        halSimFlashCut( 0, NULL );
+        osal_memcpy( test_Item[k] + ndx, buf, len );
+      }
+      else
+      {
+        uint8 now[TEST_ITEM_MAX];
+
+        HAL_ENABLE_INTERRUPTS();
+        osal_nv_init( NULL );
+        cuts++;
+
+        // The write is all done or not at all
+        osal_nv_read( id, 0, test_Len[k], now );
+        if ( memcmp( now + ndx, buf, len ) == 0 )
+        {
+          osal_memcpy( test_Item[k] + ndx, buf, len );
+        }
+        if ( memcmp( now, test_Item[k], test_Len[k] ) != 0 )
+        {
+          torn++;
+          osal_memcpy( test_Item[k], now, test_Len[k] );
+        }
+      }
+    }
+    else if ( kind < 9 )
+    {
+      if ( osal_nv_delete( id, test_Len[k] ) == SUCCESS )
+      {
+        test_Exists[k] = FALSE;
+      }
+      else
+      {
+        bad++;
+      }
+    }
+    else if ( (test_Rand() % 10) == 0 )
+    {
+      osal_nv_init( NULL );
+    }
+
+    if ( test_Verify( TEST_ITEMS ) != 0 )
+    {
+      bad++;
+      break;
+    }
+
+    if ( test_Fp != NULL )
+    {
+      fprintf( test_Fp, "%u %08lX\n", op, (unsigned long)test_Hash );
+    }
+  }
+
+  HOST_CHECK( bad == 0 );
+  HOST_CHECK( torn == 0 );
+  HOST_CHECK( cuts > 100 );
+
+  // The pages were compacted many times over
+  halSimFlashStats( &erases, NULL );
+  HOST_CHECK( erases > 200 );
+
+  // The index built at restart agrees
+  osal_nv_init( NULL );
+  HOST_CHECK( test_Verify( TEST_ITEMS ) == 0 );
+
+  // Compacting writes that give up part way
+  bad = 0;
+  for ( op = 0; op < TEST_COMPACTS; op++ )
+  {
+    uint8 k = test_Rand() % 5;
+
+    if ( !test_Exists[k] )
+    {
+      HOST_CHECK( osal_nv_item_init( TEST_ID_BASE + k, test_Len[k], test_Item[k] ) == NV_ITEM_UNINIT );
+      test_Exists[k] = TRUE;
+    }
+
+    test_Hash = 2166136261UL;
+    bad += test_LostWrites( k );
+
+    if ( test_Fp != NULL )
+    {
+      fprintf( test_Fp, "lost %u %08lX\n", op, (unsigned long)test_Hash );
+    }
+  }
+  HOST_CHECK( bad == 0 );
+  HOST_CHECK( test_Fails > 100 );
+
+  osal_nv_init( NULL );
+  HOST_CHECK( test_Verify( TEST_ITEMS ) == 0 );
+
+  if ( test_Fp != NULL )
+  {
+    fclose( test_Fp );
+  }
+
+#if OSAL_NV_INDEX_SIZE == 0
+  return hostTestResult( "test_nv_index_scan" );
+#elif OSAL_NV_INDEX_SIZE < TEST_ITEMS
+  return hostTestResult( "test_nv_index_some" );
+#else
+  return hostTestResult( "test_nv_index" );
+#endif
+}
+
+/*********************************************************************
+*********************************************************************/
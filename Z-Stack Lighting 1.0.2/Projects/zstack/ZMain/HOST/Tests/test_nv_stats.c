@@ -0,0 +1,272 @@
+/**************************************************************************************************
+  Filename:       test_nv_stats.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host test of the NV wear statistics and lifetime projection.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include <stdio.h>
+
+#include "ZComDef.h"
+#include "hal_board_cfg.h"
+#include "hal_drivers.h"
+#include "hal_sim.h"
+#include "OSAL.h"
+#include "OSAL_Nv.h"
+#include "OSAL_Tasks.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// A lamp that stores its level on every change, its on/off state, and a
+// scene now and then
+#define TEST_ID_LEVEL              0x0401
+#define TEST_ID_ONOFF              0x0402
+#define TEST_ID_SCENE              0x0403
+#define TEST_ID_STATIC             0x0410
+#define TEST_STATIC_ITEMS          8
+
+#define TEST_SCENE_LEN             120
+
+// One hour, a step a second
+#define TEST_STEPS                 3600
+
+// The OSAL_Nv.c defaults
+#define TEST_ENDURANCE             20000
+#define TEST_STATS_ITEMS           8
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+const pTaskEventHandlerFn tasksArr[] = {
+  Hal_ProcessEvent
+};
+
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt);
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt));
+
+  Hal_Init( 0 );
+}
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static uint32 test_Seed = 99;
+static FILE *test_Trace;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+static uint16 test_Rand( void )
+{
+  test_Seed = test_Seed * 1103515245 + 12345;
+
+  return ( (uint16)(test_Seed >> 16) & 0x7FFF );
+}
+
+/*
+ * Write an item, and record the write for nv_replay.
+ */
+static uint8 test_Write( uint16 id, uint16 len, void *buf )
+{
+  if ( test_Trace != NULL )
+  {
+    fprintf( test_Trace, "%lu %04X 0 %u\n", (unsigned long)osal_GetSystemClock(), id, len );
+  }
+
+  return osal_nv_write( id, 0, len, buf );
+}
+
+static uint16 test_PageErases( osalNvPageStats_t *pMax )
+{
+  osalNvPageStats_t page;
+  uint16 sum = 0;
+  uint8 idx;
+
+  pMax->erases = 0;
+  for ( idx = 0; osal_nv_page_stats_get( idx, &page ) == SUCCESS; idx++ )
+  {
+    HOST_CHECK( (page.free + page.lost) <= HAL_FLASH_PAGE_SIZE );
+    sum += page.erases;
+    if ( page.erases >= pMax->erases )
+    {
+      *pMax = page;
+    }
+  }
+  HOST_CHECK( idx == HAL_NV_PAGE_CNT );
+
+  return ( sum );
+}
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   The NV statistics count the bytes written and the page erases
+ *          that the flash sees, keep the erase counts across restarts,
+ *          find the item written the most and project the lifetime.
+ *          With a file name, also writes the trace of the writes in the
+ *          nv_replay format.
+ */
+int main( int argc, char **argv )
+{
+  osalNvStats_t stats;
+  osalNvPageStats_t maxPage;
+  uint8 scene[TEST_SCENE_LEN];
+  uint32 erases0, words0, erases, words, writes;
+  uint32 levelWrites = 0, expect;
+  uint16 step, id, pageErases;
+  uint8 level = 0, onOff = 0;
+  uint8 idx;
+
+  if ( argc > 1 )
+  {
+    test_Trace = fopen( argv[1], "w" );
+    HOST_CHECK( test_Trace != NULL );
+  }
+
+  hostTestBoot();
+  osal_nv_init( NULL );
+
+  osal_memset( scene, 0, sizeof( scene ) );
+  osal_nv_item_init( TEST_ID_LEVEL, 1, &level );
+  osal_nv_item_init( TEST_ID_ONOFF, 1, &onOff );
+  osal_nv_item_init( TEST_ID_SCENE, TEST_SCENE_LEN, scene );
+  for ( id = TEST_ID_STATIC; id < TEST_ID_STATIC + TEST_STATIC_ITEMS; id++ )
+  {
+    osal_nv_item_init( id, 32, scene );
+  }
+
+  osal_nv_stats_reset();
+  halSimFlashStats( &erases0, &words0 );
+
+  for ( step = 0; step < TEST_STEPS; step++ )
+  {
+    if ( test_Rand() % 2 )
+    {
+      level++;
+      HOST_CHECK( test_Write( TEST_ID_LEVEL, 1, &level ) == SUCCESS );
+      levelWrites++;
+    }
+    if ( (step % 60) == 0 )
+    {
+      onOff ^= 1;
+      HOST_CHECK( test_Write( TEST_ID_ONOFF, 1, &onOff ) == SUCCESS );
+    }
+    if ( (step % 300) == 0 )
+    {
+      scene[step % TEST_SCENE_LEN]++;
+      HOST_CHECK( test_Write( TEST_ID_SCENE, TEST_SCENE_LEN, scene ) == SUCCESS );
+    }
+
+    halSimClockAdvance( 1000000 );
+    osal_run_system();
+  }
+
+  if ( test_Trace != NULL )
+  {
+    fclose( test_Trace );
+  }
+
+  halSimFlashStats( &erases, &words );
+  osal_nv_stats_get( &stats );
+  pageErases = test_PageErases( &maxPage );
+
+  // What the flash saw
+  HOST_CHECK( stats.bytes == (words - words0) * HAL_FLASH_WORD_SIZE );
+  HOST_CHECK( stats.erases == erases - erases0 );
+  HOST_CHECK( stats.erases > 10 );
+  HOST_CHECK( stats.eraseMax == maxPage.erases );
+  HOST_CHECK( pageErases >= stats.erases );
+
+  // One hour of writes
+  HOST_CHECK( stats.bytesPerHour >= stats.bytes - (stats.bytes / 100) );
+  HOST_CHECK( stats.bytesPerHour <= stats.bytes + (stats.bytes / 100) );
+
+  // The pages are erased in turn at the rate seen
+  expect = (uint32)(TEST_ENDURANCE - stats.eraseMax) * HAL_NV_PAGE_CNT * (TEST_STEPS / stats.erases) / 3600;
+  HOST_CHECK( stats.lifeHours >= expect - (expect / 50) );
+  HOST_CHECK( stats.lifeHours <= expect + (expect / 50) );
+
+  // The level is the item written the most, counted in a sample of all of the writes
+  for ( idx = 0; osal_nv_item_stats_get( idx, &id, &writes ) == SUCCESS; idx++ )
+  {
+    if ( id == TEST_ID_LEVEL )
+    {
+      break;
+    }
+  }
+  HOST_CHECK( id == TEST_ID_LEVEL );
+  HOST_CHECK( writes > levelWrites - (levelWrites / 10) );
+  HOST_CHECK( writes < levelWrites + (levelWrites / 10) );
+  for ( idx = 0; osal_nv_item_stats_get( idx, &id, &writes ) == SUCCESS; idx++ )
+  {
+    HOST_CHECK( (id == TEST_ID_LEVEL) || (writes < levelWrites) );
+  }
+  HOST_CHECK( osal_nv_item_stats_get( TEST_STATS_ITEMS, &id, &writes ) == NV_OPER_FAILED );
+  HOST_CHECK( osal_nv_page_stats_get( HAL_NV_PAGE_CNT, &maxPage ) == NV_OPER_FAILED );
+
+  /* The erase counts are kept across a restart, which erases the reserve page again and
+   * restarts the statistics with that one erase, and across a reset of the statistics.
+   */
+  osal_nv_init( NULL );
+  HOST_CHECK( test_PageErases( &maxPage ) == pageErases + 1 );
+  osal_nv_stats_get( &stats );
+  HOST_CHECK( (stats.bytes == HAL_FLASH_WORD_SIZE) && (stats.erases == 1) );
+  HOST_CHECK( stats.bytesPerHour == 0 );
+  HOST_CHECK( stats.lifeHours == OSAL_NV_LIFE_UNKNOWN );
+
+  osal_nv_stats_reset();
+  HOST_CHECK( test_PageErases( &maxPage ) == pageErases + 1 );
+  HOST_CHECK( osal_nv_item_stats_get( 0, &id, &writes ) == NV_OPER_FAILED );
+
+  return hostTestResult( "test_nv_stats" );
+}
+
+/*********************************************************************
+*********************************************************************/
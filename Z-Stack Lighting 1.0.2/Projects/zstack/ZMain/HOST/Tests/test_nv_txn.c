@@ -0,0 +1,338 @@
+/**************************************************************************************************
+  Filename:       test_nv_txn.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host test of the NV transactions across power cuts.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include <setjmp.h>
+#include <string.h>
+
+#include "ZComDef.h"
+#include "hal_drivers.h"
+#include "hal_mcu.h"
+#include "hal_sim.h"
+#include "OSAL.h"
+#include "OSAL_Nv.h"
+#include "OSAL_Tasks.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define TEST_ID_BASE               0x0200
+#define TEST_ITEMS                 30
+#define TEST_ITEM_MAX              64
+
+#define TEST_COMMITS               3000
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+const pTaskEventHandlerFn tasksArr[] = {
+  Hal_ProcessEvent
+};
+
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt);
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt));
+
+  Hal_Init( 0 );
+}
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// What NV should hold, and the writes of the commit under way
+static uint8 test_Item[TEST_ITEMS][TEST_ITEM_MAX];
+static uint8 test_New[TEST_ITEMS][TEST_ITEM_MAX];
+static uint16 test_Len[TEST_ITEMS];
+
+static uint32 test_Seed = 777;
+static jmp_buf test_Cut;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+static uint16 test_Rand( void )
+{
+  test_Seed = test_Seed * 1103515245 + 12345;
+
+  return ( (uint16)(test_Seed >> 16) & 0x7FFF );
+}
+
+static void test_PowerCut( void )
+{
+  longjmp( test_Cut, 1 );
+}
+
+/*
+ * Compare every item in NV with the model, returns the number that differ.
+ */
+static uint8 test_Verify( void )
+{
+  uint8 buf[TEST_ITEM_MAX];
+  uint8 bad = 0;
+  uint8 k;
+
+  for ( k = 0; k < TEST_ITEMS; k++ )
+  {
+    if ( (osal_nv_item_len( TEST_ID_BASE + k ) != test_Len[k]) ||
+         (osal_nv_read( TEST_ID_BASE + k, 0, test_Len[k], buf ) != SUCCESS) ||
+         (memcmp( buf, test_Item[k], test_Len[k] ) != 0) )
+    {
+      bad++;
+    }
+  }
+
+  return ( bad );
+}
+
+/*
+ * Check an interrupted commit after the restart: the items it changes are
+ * either all new or all old. The model follows what NV holds.
+ */
+static uint8 test_Recover( const uint8 *pKeys, uint8 cnt )
+{
+  uint8 buf[TEST_ITEM_MAX];
+  uint8 oldCnt = 0, newCnt = 0;
+  uint8 i;
+
+  for ( i = 0; i < cnt; i++ )
+  {
+    uint8 k = pKeys[i];
+
+    if ( memcmp( test_New[k], test_Item[k], test_Len[k] ) == 0 )
+    {
+      continue;  // Not changed by the commit
+    }
+
+    osal_nv_read( TEST_ID_BASE + k, 0, test_Len[k], buf );
+    if ( memcmp( buf, test_New[k], test_Len[k] ) == 0 )
+    {
+      newCnt++;
+    }
+    else if ( memcmp( buf, test_Item[k], test_Len[k] ) == 0 )
+    {
+      oldCnt++;
+    }
+    else
+    {
+      return ( FALSE );  // Torn item
+    }
+  }
+
+  if ( newCnt != 0 )
+  {
+    for ( i = 0; i < cnt; i++ )
+    {
+      osal_memcpy( test_Item[pKeys[i]], test_New[pKeys[i]], test_Len[pKeys[i]] );
+    }
+  }
+
+  return ( (oldCnt == 0) || (newCnt == 0) );
+}
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   A transaction updates all of its items or none of them, even
+ *          when the power is cut at any flash write or erase of the
+ *          commit, and compacts at most one page.
+ */
+int main( void )
+{
+  uint8 buf[TEST_ITEM_MAX];
+  uint32 erases, erasesAfter;
+  static uint16 commits, cuts, torn, bad, overErase;  // Kept across longjmp()
+  uint8 k;
+
+  hostTestBoot();
+  osal_nv_init( NULL );
+
+  for ( k = 0; k < TEST_ITEMS; k++ )
+  {
+    test_Len[k] = 4 + (test_Rand() % ((k < 3) ? 60 : 20));
+    osal_memset( test_Item[k], k, test_Len[k] );
+    HOST_CHECK( osal_nv_item_init( TEST_ID_BASE + k, test_Len[k], test_Item[k] ) == NV_ITEM_UNINIT );
+  }
+
+  // Misuse of the API
+  HOST_CHECK( osal_nv_txn_stage( TEST_ID_BASE, 0, 1, buf ) == NV_OPER_FAILED );
+  HOST_CHECK( osal_nv_txn_commit() == NV_OPER_FAILED );
+
+  osal_nv_txn_begin();
+  for ( k = 0; k < 8; k++ )
+  {
+    HOST_CHECK( osal_nv_txn_stage( TEST_ID_BASE + k, 0, 1, buf ) == SUCCESS );
+  }
+  HOST_CHECK( osal_nv_txn_stage( TEST_ID_BASE + k, 0, 1, buf ) == NV_OPER_FAILED );
+
+  // No item is updated when one of them is missing or too short
+  osal_memset( buf, 0xA5, sizeof( buf ) );
+  osal_nv_txn_begin();
+  HOST_CHECK( osal_nv_txn_stage( TEST_ID_BASE, 0, 2, buf ) == SUCCESS );
+  HOST_CHECK( osal_nv_txn_stage( TEST_ID_BASE + TEST_ITEMS, 0, 2, buf ) == SUCCESS );
+  HOST_CHECK( osal_nv_txn_commit() == NV_ITEM_UNINIT );
+
+  osal_nv_txn_begin();
+  HOST_CHECK( osal_nv_txn_stage( TEST_ID_BASE, 0, 2, buf ) == SUCCESS );
+  HOST_CHECK( osal_nv_txn_stage( TEST_ID_BASE + 5, test_Len[5] - 1, 2, buf ) == SUCCESS );
+  HOST_CHECK( osal_nv_txn_commit() == NV_OPER_FAILED );
+
+  halSimVddSet( 0 );
+  osal_nv_txn_begin();
+  HOST_CHECK( osal_nv_txn_stage( TEST_ID_BASE, 0, 2, buf ) == SUCCESS );
+  HOST_CHECK( osal_nv_txn_commit() == NV_OPER_FAILED );
+  halSimVddSet( 0xFF );
+  HOST_CHECK( test_Verify() == 0 );
+
+  // Later writes to an item overlay earlier ones
+  osal_nv_txn_begin();
+  HOST_CHECK( osal_nv_txn_stage( TEST_ID_BASE + 1, 0, 3, buf ) == SUCCESS );
+  HOST_CHECK( osal_nv_txn_stage( TEST_ID_BASE + 1, 1, 1, "\x5A" ) == SUCCESS );
+  HOST_CHECK( osal_nv_txn_commit() == SUCCESS );
+  HOST_CHECK( osal_nv_txn_commit() == NV_OPER_FAILED );
+  test_Item[1][0] = 0xA5;
+  test_Item[1][1] = 0x5A;
+  test_Item[1][2] = 0xA5;
+  HOST_CHECK( test_Verify() == 0 );
+
+  // Random commits of up to 7 items, the power cut in a quarter of them
+  while ( commits < TEST_COMMITS )
+  {
+    uint8 keys[8];
+    uint8 used[TEST_ITEMS];
+    uint8 cnt = 1 + (test_Rand() % 7);
+    uint8 i;
+
+    osal_memset( used, 0, sizeof( used ) );
+    for ( i = 0; i < cnt; i++ )
+    {
+      uint16 ndx, len;
+
+      do
+      {
+        k = test_Rand() % TEST_ITEMS;
+      } while ( used[k] );
+      used[k] = TRUE;
+      keys[i] = k;
+
+      osal_memcpy( test_New[k], test_Item[k], test_Len[k] );
+      ndx = test_Rand() % test_Len[k];
+      len = 1 + (test_Rand() % (test_Len[k] - ndx));
+      while ( len-- )
+      {
+        test_New[k][ndx++] = (uint8)test_Rand();
+      }
+    }
+
+    if ( (test_Rand() % 4) == 0 )
+    {
+      halSimFlashCut( test_Rand() % 60, test_PowerCut );
+    }
+
+    halSimFlashStats( &erases, NULL );
+
+    if ( setjmp( test_Cut ) == 0 )
+    {
+      osal_nv_txn_begin();
+      for ( i = 0; i < cnt; i++ )
+      {
+        osal_nv_txn_stage( TEST_ID_BASE + keys[i], 0, test_Len[keys[i]], test_New[keys[i]] );
+      }
+      if ( osal_nv_txn_commit() != SUCCESS )
+      {
+        bad++;
+      }
+      halSimFlashCut( 0, NULL );
+
+      for ( i = 0; i < cnt; i++ )
+      {
+        osal_memcpy( test_Item[keys[i]], test_New[keys[i]], test_Len[keys[i]] );
+      }
+
+      halSimFlashStats( &erasesAfter, NULL );
+      if ( erasesAfter - erases > 1 )
+      {
+        overErase++;
+      }
+    }
+    else
+    {
+      // Restart as from a reset
+      HAL_ENABLE_INTERRUPTS();
+      osal_nv_init( NULL );
+      cuts++;
+
+      if ( !test_Recover( keys, cnt ) )
+      {
+        torn++;
+      }
+    }
+
+    if ( test_Verify() != 0 )
+    {
+      bad++;
+    }
+    commits++;
+  }
+
+  HOST_CHECK( cuts > TEST_COMMITS / 8 );
+  HOST_CHECK( torn == 0 );
+  HOST_CHECK( bad == 0 );
+  HOST_CHECK( overErase == 0 );
+
+  // And all of it survives a restart
+  osal_nv_init( NULL );
+  HOST_CHECK( test_Verify() == 0 );
+
+  return hostTestResult( "test_nv_txn" );
+}
+
+/*********************************************************************
+*********************************************************************/
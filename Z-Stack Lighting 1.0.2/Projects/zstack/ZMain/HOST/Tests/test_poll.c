@@ -0,0 +1,182 @@
+/**************************************************************************************************
+  Filename:       test_poll.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host test of the pending UART polls and the poll statistics.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include "ZComDef.h"
+#include "hal_drivers.h"
+#include "hal_sim.h"
+#include "hal_uart.h"
+#include "OSAL.h"
+#include "OSAL_Tasks.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Bytes the simulated UART hands to its callback per poll, and the cost of a poll
+#define TEST_POLL_BYTES            4
+#define TEST_POLL_USEC             40
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+const pTaskEventHandlerFn tasksArr[] = {
+  Hal_ProcessEvent
+};
+
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt);
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt));
+
+  Hal_Init( 0 );
+}
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static uint16 test_RxBytes;
+static uint16 test_Polls;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+/*
+ * The UART driver on the host: a poll takes up to TEST_POLL_BYTES of the
+ * received bytes and, like the DMA driver, asks for the next poll while
+ * bytes are left.
+ */
+void HalUARTInit( void )
+{
+}
+
+void HalUARTPoll( void )
+{
+  test_Polls++;
+  halSimClockAdvance( TEST_POLL_USEC );
+
+  test_RxBytes -= (test_RxBytes < TEST_POLL_BYTES) ? test_RxBytes : TEST_POLL_BYTES;
+  if ( test_RxBytes != 0 )
+  {
+    HAL_POLL_UART_SET();
+  }
+}
+
+// The Rx interrupt
+static void test_Receive( uint16 bytes )
+{
+  test_RxBytes += bytes;
+  HAL_POLL_UART_SET();
+}
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   With HAL_POLL_PENDING the UART is only polled after its
+ *          interrupt asked for it, and for as long as it has work left.
+ *          The poll statistics count every pass through the OSAL loop,
+ *          the passes that polled the UART, and the time spent polling.
+ */
+int main( void )
+{
+  halPollStats_t stats;
+  uint32 start;
+
+  hostTestBoot();
+
+  // Idle: every pass is counted, none of them polls the UART
+  HalPollStatsReset();
+  start = halSimClockUs();
+  hostTestRun( 100 );
+  HalPollStatsGet( &stats );
+  HOST_CHECK( stats.passes == (halSimClockUs() - start) / HAL_SIM_LOOP_USEC );
+  HOST_CHECK( (stats.uartPolls == 0) && (stats.usec == 0) && (test_Polls == 0) );
+
+  // One byte, one poll
+  HalPollStatsReset();
+  test_Receive( 1 );
+  hostTestRun( 10 );
+  HalPollStatsGet( &stats );
+  HOST_CHECK( (test_Polls == 1) && (stats.uartPolls == 1) && (test_RxBytes == 0) );
+  HOST_CHECK( stats.usec == TEST_POLL_USEC );
+
+  // A burst keeps the polls going until it is drained, and no longer
+  test_Polls = 0;
+  HalPollStatsReset();
+  test_Receive( (TEST_POLL_BYTES * 5) + 1 );
+  hostTestRun( 10 );
+  HalPollStatsGet( &stats );
+  HOST_CHECK( (test_Polls == 6) && (stats.uartPolls == 6) && (test_RxBytes == 0) );
+  HOST_CHECK( stats.usec == (6 * TEST_POLL_USEC) );
+
+  // A byte arriving in the middle of a burst does not add a poll of its own
+  test_Polls = 0;
+  test_Receive( TEST_POLL_BYTES * 2 );
+  test_Receive( 1 );
+  hostTestRun( 10 );
+  HOST_CHECK( (test_Polls == 3) && (test_RxBytes == 0) );
+
+  // The passes are the loop passes, with the polls adding to the time they take
+  HalPollStatsReset();
+  test_Polls = 0;
+  start = halSimClockUs();
+  test_Receive( TEST_POLL_BYTES * 3 );
+  hostTestRun( 50 );
+  HalPollStatsGet( &stats );
+  HOST_CHECK( (stats.passes * HAL_SIM_LOOP_USEC) + stats.usec == halSimClockUs() - start );
+
+  HalPollStatsReset();
+  HalPollStatsGet( &stats );
+  HOST_CHECK( (stats.passes == 0) && (stats.uartPolls == 0) && (stats.usec == 0) );
+
+  return hostTestResult( "test_poll" );
+}
+
+/*********************************************************************
+*********************************************************************/
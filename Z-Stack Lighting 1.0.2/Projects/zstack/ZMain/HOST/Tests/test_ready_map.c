@@ -0,0 +1,219 @@
+/**************************************************************************************************
+  Filename:       test_ready_map.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host test of the ready-task bitmap of the OSAL scheduler.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include "ZComDef.h"
+#include "hal_drivers.h"
+#include "OSAL.h"
+#include "OSAL_Tasks.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Twelve tasks, as many as OSAL_SampleLight.c registers; the HAL task is
+// not first so that task 0 stands for the MAC (OSAL_READY_POLL_TASK)
+#define TEST_TASK_MAC              0
+#define TEST_TASK_HAL              2
+#define TEST_TASK_CNT              12
+
+#define TEST_RUN_MAX               32
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+static uint16 test_event_loop( uint8 task_id, uint16 events );
+
+const pTaskEventHandlerFn tasksArr[TEST_TASK_CNT] = {
+  test_event_loop,
+  test_event_loop,
+  Hal_ProcessEvent,
+  test_event_loop,
+  test_event_loop,
+  test_event_loop,
+  test_event_loop,
+  test_event_loop,
+  test_event_loop,
+  test_event_loop,
+  test_event_loop,
+  test_event_loop
+};
+
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt);
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt));
+
+  Hal_Init( TEST_TASK_HAL );
+}
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// Tasks in the order they ran
+static uint8 testRun[TEST_RUN_MAX];
+static uint8 testRunCnt;
+
+// Events a task hands back unprocessed, once
+static uint16 testKeep[TEST_TASK_CNT];
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+static uint16 test_event_loop( uint8 task_id, uint16 events )
+{
+  uint16 keep = testKeep[task_id];
+
+  if ( testRunCnt < TEST_RUN_MAX )
+  {
+    testRun[testRunCnt++] = task_id;
+  }
+
+  testKeep[task_id] = 0;
+
+  return ( events & keep );
+}
+
+/*
+ * Run the OSAL loop until no task is left to run, returns the number of
+ * task runs.
+ */
+static uint8 test_Drain( void )
+{
+  uint8 cnt;
+
+  testRunCnt = 0;
+  do
+  {
+    cnt = testRunCnt;
+    osal_run_system();
+  } while ( testRunCnt != cnt );
+
+  return ( testRunCnt );
+}
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   The ready-task bitmap picks the same task as a scan of
+ *          tasksEvents would.
+ */
+int main( void )
+{
+  uint8 i;
+
+  hostTestBoot();
+  hostTestRun( 10 );
+  test_Drain();
+
+  // Tasks run in priority order, across the bytes of the bitmap
+  HOST_CHECK( osal_set_event( 11, 0x0001 ) == SUCCESS );
+  HOST_CHECK( osal_set_event( 9, 0x0001 ) == SUCCESS );
+  HOST_CHECK( osal_set_event( 3, 0x0001 ) == SUCCESS );
+  HOST_CHECK( osal_set_event( 8, 0x0001 ) == SUCCESS );
+  HOST_CHECK( osal_set_event( tasksCnt, 0x0001 ) == INVALID_TASK );
+  HOST_CHECK( test_Drain() == 4 );
+  HOST_CHECK( testRun[0] == 3 );
+  HOST_CHECK( testRun[1] == 8 );
+  HOST_CHECK( testRun[2] == 9 );
+  HOST_CHECK( testRun[3] == 11 );
+
+  // A task whose events were all cleared does not run
+  osal_set_event( 9, 0x0003 );
+  osal_set_event( 4, 0x0001 );
+  HOST_CHECK( osal_clear_event( 9, 0x0001 ) == SUCCESS );
+  HOST_CHECK( osal_clear_event( 9, 0x0002 ) == SUCCESS );
+  HOST_CHECK( test_Drain() == 1 );
+  HOST_CHECK( testRun[0] == 4 );
+
+  // Events cleared behind OSAL's back leave a stale mark, dropped on the way
+  osal_set_event( 10, 0x0001 );
+  osal_set_event( 5, 0x0001 );
+  tasksEvents[5] = 0;
+  HOST_CHECK( test_Drain() == 1 );
+  HOST_CHECK( testRun[0] == 10 );
+
+  // The MAC task is polled, its events may be set directly
+  tasksEvents[TEST_TASK_MAC] |= 0x0001;
+  HOST_CHECK( test_Drain() == 1 );
+  HOST_CHECK( testRun[0] == TEST_TASK_MAC );
+
+  // Events handed back keep the task ready, ahead of lower priority ones
+  testKeep[6] = 0x0002;
+  osal_set_event( 6, 0x0003 );
+  osal_set_event( 7, 0x0001 );
+  HOST_CHECK( test_Drain() == 3 );
+  HOST_CHECK( testRun[0] == 6 );
+  HOST_CHECK( testRun[1] == 6 );
+  HOST_CHECK( testRun[2] == 7 );
+
+  // Every task, each in turn
+  for ( i = tasksCnt; i-- > 0; )
+  {
+    if ( i != TEST_TASK_HAL )
+    {
+      osal_set_event( i, 0x8000 );
+    }
+  }
+  HOST_CHECK( test_Drain() == tasksCnt - 1 );
+  for ( i = 0; i < tasksCnt - 1; i++ )
+  {
+    HOST_CHECK( testRun[i] == ((i < TEST_TASK_HAL) ? i : (i + 1)) );
+  }
+
+  for ( i = 0; i < tasksCnt; i++ )
+  {
+    HOST_CHECK( tasksEvents[i] == 0 );
+  }
+
+  return hostTestResult( "test_ready_map" );
+}
+
+/*********************************************************************
+*********************************************************************/
@@ -0,0 +1,281 @@
+/**************************************************************************************************
+  Filename:       test_sched_stats.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host test of the OSAL scheduler statistics.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include <stdio.h>
+
+#include "ZComDef.h"
+#include "hal_drivers.h"
+#include "hal_sim.h"
+#include "OSAL.h"
+#include "OSAL_Tasks.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define TEST_TASK_BUSY             1
+#define TEST_TASK_LOW              2
+
+#define TEST_LONG_EVT              0x0001
+#define TEST_SHORT_EVT             0x0002
+
+// OSAL_SCHED_TIME() counts the 320 usec ticks of the virtual clock, and
+// each pass of the OSAL loop takes one tick (HAL_SIM_LOOP_USEC)
+#define TEST_TICK_USEC             320
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+static uint16 test_busy_loop( uint8 task_id, uint16 events );
+static uint16 test_low_loop( uint8 task_id, uint16 events );
+
+const pTaskEventHandlerFn tasksArr[] = {
+  Hal_ProcessEvent,
+  test_busy_loop,
+  test_low_loop
+};
+
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt);
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt));
+
+  Hal_Init( 0 );
+}
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+/*
+ * The busy task takes 3 ticks for its long event and 1 for its short
+ * one, handling one event a run.
+ */
+static uint16 test_busy_loop( uint8 task_id, uint16 events )
+{
+  if ( events & TEST_LONG_EVT )
+  {
+    halSimClockAdvance( 3 * TEST_TICK_USEC );
+    return ( events ^ TEST_LONG_EVT );
+  }
+
+  if ( events & TEST_SHORT_EVT )
+  {
+    halSimClockAdvance( TEST_TICK_USEC );
+    return ( events ^ TEST_SHORT_EVT );
+  }
+
+  return 0;
+}
+
+static uint16 test_low_loop( uint8 task_id, uint16 events )
+{
+  return 0;
+}
+
+static void test_Pass( uint16 cnt )
+{
+  while ( cnt-- )
+  {
+    osal_run_system();
+  }
+}
+
+static uint8 test_Stats( uint8 task_id, uint8 event_bit, osalSchedStats_t *pStats )
+{
+  osal_memset( pStats, 0, sizeof( osalSchedStats_t ) );
+
+  if ( event_bit == 0xFF )
+  {
+    return osal_sched_stats_get( task_id, pStats );
+  }
+  else
+  {
+    return osal_sched_event_stats_get( event_bit, pStats );
+  }
+}
+
+/*
+ * Write the statistics as the request and response data of
+ * MT_SYS_SCHED_STATS (see MT_SysSchedStats() in MT_SYS.c), one per line,
+ * for the sched_stats report.
+ */
+static void test_WriteStats( FILE *fp, uint8 task_id, uint8 event_bit )
+{
+  osalSchedStats_t stats;
+  uint8 rsp[17];
+  uint8 *pRsp = rsp;
+  uint8 i;
+
+  *pRsp++ = test_Stats( task_id, event_bit, &stats );
+  pRsp = osal_buffer_uint32( pRsp, stats.runCnt );
+  pRsp = osal_buffer_uint32( pRsp, stats.runTotal );
+  *pRsp++ = LO_UINT16( stats.runMax );
+  *pRsp++ = HI_UINT16( stats.runMax );
+  pRsp = osal_buffer_uint32( pRsp, stats.waitTotal );
+  *pRsp++ = LO_UINT16( stats.waitMax );
+  *pRsp++ = HI_UINT16( stats.waitMax );
+
+  fprintf( fp, "%02X %02X", task_id, event_bit );
+  for ( i = 0; i < sizeof( rsp ); i++ )
+  {
+    fprintf( fp, " %02X", rsp[i] );
+  }
+  fprintf( fp, "\n" );
+}
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   Scheduler statistics account the runs and waits of the tasks,
+ *          and the runs of each event of the watched task.
+ *          With a file name, also writes the statistics of a short
+ *          workload for the sched_stats report.
+ */
+int main( int argc, char **argv )
+{
+  osalSchedStats_t stats;
+  uint16 i;
+
+  hostTestBoot();
+  hostTestRun( 10 );
+
+  osal_sched_stats_reset();
+  HOST_CHECK( osal_sched_stats_watch( TEST_TASK_BUSY ) == TASK_NO_TASK );
+
+  // The low priority task waits for the busy one to run
+  osal_set_event( TEST_TASK_LOW, 0x0001 );
+  osal_set_event( TEST_TASK_BUSY, TEST_LONG_EVT );
+  test_Pass( 2 );
+
+  HOST_CHECK( test_Stats( TEST_TASK_BUSY, 0xFF, &stats ) == SUCCESS );
+  HOST_CHECK( stats.runCnt == 1 );
+  HOST_CHECK( stats.runTotal == 3 );
+  HOST_CHECK( stats.runMax == 3 );
+  HOST_CHECK( stats.waitTotal == 1 );
+
+  HOST_CHECK( test_Stats( TEST_TASK_LOW, 0xFF, &stats ) == SUCCESS );
+  HOST_CHECK( stats.runCnt == 1 );
+  HOST_CHECK( stats.runTotal == 0 );
+  HOST_CHECK( stats.waitTotal == 5 );
+  HOST_CHECK( stats.waitMax == 5 );
+
+  // Each run is accounted to the events it processed, not to those it
+  // handed back; those wait from the end of the run
+  osal_set_event( TEST_TASK_BUSY, (TEST_LONG_EVT | TEST_SHORT_EVT) );
+  test_Pass( 2 );
+
+  HOST_CHECK( test_Stats( TEST_TASK_BUSY, 0xFF, &stats ) == SUCCESS );
+  HOST_CHECK( stats.runCnt == 3 );
+  HOST_CHECK( stats.runTotal == 7 );
+  HOST_CHECK( stats.runMax == 3 );
+  HOST_CHECK( stats.waitTotal == 3 );
+  HOST_CHECK( stats.waitMax == 1 );
+
+  HOST_CHECK( test_Stats( TEST_TASK_BUSY, 0, &stats ) == SUCCESS );
+  HOST_CHECK( stats.runCnt == 2 );
+  HOST_CHECK( stats.runTotal == 6 );
+  HOST_CHECK( test_Stats( TEST_TASK_BUSY, 1, &stats ) == SUCCESS );
+  HOST_CHECK( stats.runCnt == 1 );
+  HOST_CHECK( stats.runMax == 1 );
+  HOST_CHECK( test_Stats( TEST_TASK_BUSY, 2, &stats ) == SUCCESS );
+  HOST_CHECK( stats.runCnt == 0 );
+
+  // A run too long for 16 bits saturates the maximum, not the total
+  osal_set_event( TEST_TASK_LOW, 0x0001 );
+  halSimClockAdvance( 70000UL * TEST_TICK_USEC );
+  test_Pass( 1 );
+  HOST_CHECK( test_Stats( TEST_TASK_LOW, 0xFF, &stats ) == SUCCESS );
+  HOST_CHECK( stats.waitMax == 0xFFFF );
+  HOST_CHECK( stats.waitTotal == 70006UL );
+
+  // Bad arguments
+  HOST_CHECK( test_Stats( tasksCnt, 0xFF, &stats ) == INVALID_TASK );
+  HOST_CHECK( test_Stats( TEST_TASK_BUSY, 16, &stats ) == INVALID_EVENT_ID );
+
+  // Watching another task starts its event statistics afresh
+  HOST_CHECK( osal_sched_stats_watch( TEST_TASK_LOW ) == TEST_TASK_BUSY );
+  HOST_CHECK( test_Stats( TEST_TASK_LOW, 0, &stats ) == SUCCESS );
+  HOST_CHECK( stats.runCnt == 0 );
+  HOST_CHECK( osal_sched_stats_watch( tasksCnt ) == TEST_TASK_LOW );
+  HOST_CHECK( test_Stats( TEST_TASK_LOW, 0, &stats ) == INVALID_TASK );
+
+  osal_sched_stats_reset();
+  HOST_CHECK( test_Stats( TEST_TASK_BUSY, 0xFF, &stats ) == SUCCESS );
+  HOST_CHECK( (stats.runCnt == 0) && (stats.runTotal == 0) && (stats.waitMax == 0) );
+
+  if ( argc > 1 )
+  {
+    FILE *fp = fopen( argv[1], "w" );
+
+    HOST_CHECK( fp != NULL );
+    if ( fp != NULL )
+    {
+      // A mix of long and short events keeping the low task waiting
+      osal_sched_stats_watch( TEST_TASK_BUSY );
+      for ( i = 0; i < 100; i++ )
+      {
+        osal_set_event( TEST_TASK_LOW, 0x0001 );
+        osal_set_event( TEST_TASK_BUSY, ((i % 4) == 0) ? TEST_LONG_EVT : TEST_SHORT_EVT );
+        test_Pass( 2 );
+      }
+
+      fprintf( fp, "# test_sched_stats\n" );
+      test_WriteStats( fp, TEST_TASK_BUSY, 0xFF );
+      test_WriteStats( fp, TEST_TASK_BUSY, 0 );
+      test_WriteStats( fp, TEST_TASK_BUSY, 1 );
+      test_WriteStats( fp, TEST_TASK_LOW, 0xFF );
+      fclose( fp );
+    }
+  }
+
+  return hostTestResult( "test_sched_stats" );
+}
+
+/*********************************************************************
+*********************************************************************/
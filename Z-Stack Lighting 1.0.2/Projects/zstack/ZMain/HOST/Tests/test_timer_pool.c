@@ -0,0 +1,233 @@
+/**************************************************************************************************
+  Filename:       test_timer_pool.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host test that OSAL timer records overflow from the static pool into the heap.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include "ZComDef.h"
+#include "hal_drivers.h"
+#include "OSAL.h"
+#include "OSAL_Tasks.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define TEST_TASK                  1
+
+// Timers running at once, more than the pool holds
+#define TEST_TIMERS                7
+
+#if ( OSAL_TIMERS_POOL_SIZE == 0 ) || ( OSAL_TIMERS_POOL_SIZE >= TEST_TIMERS )
+  #error The pool must hold some of the test timers, but not all of them.
+#endif
+
+#define TEST_HEAP_TIMERS           ( TEST_TIMERS - OSAL_TIMERS_POOL_SIZE )
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+static uint16 test_event_loop( uint8 task_id, uint16 events );
+
+const pTaskEventHandlerFn tasksArr[] = {
+  Hal_ProcessEvent,
+  test_event_loop
+};
+
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt);
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt));
+
+  Hal_Init( 0 );
+}
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// Events in the order they fired, and the fires of each
+static uint8 test_Order[TEST_TIMERS];
+static uint8 test_OrderCnt;
+static uint16 test_Fires[TEST_TIMERS];
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+// Heap blocks in use
+static uint16 test_HeapBlocks( void )
+{
+  return ( osal_heap_block_cnt() - osal_heap_block_free() );
+}
+
+static uint16 test_event_loop( uint8 task_id, uint16 events )
+{
+  uint8 i;
+
+  for ( i = 0; i < TEST_TIMERS; i++ )
+  {
+    if ( events & BV( i ) )
+    {
+      if ( test_OrderCnt < TEST_TIMERS )
+      {
+        test_Order[test_OrderCnt++] = i;
+      }
+      test_Fires[i]++;
+
+      return ( events ^ BV( i ) );
+    }
+  }
+
+  return 0;
+}
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   Timer records come from the pool while it lasts, then from
+ *          the heap, and go back where they came from.
+ */
+int main( void )
+{
+  uint16 blocks, used;
+  uint8 i;
+
+  hostTestBoot();
+
+  blocks = test_HeapBlocks();
+  used = osal_heap_mem_used();
+  HOST_CHECK( osal_timer_pool_cnt() == 0 );
+
+  // Fill the pool; the heap is not touched
+  for ( i = 0; i < OSAL_TIMERS_POOL_SIZE; i++ )
+  {
+    HOST_CHECK( osal_start_timerEx( TEST_TASK, BV( i ), (i + 1) * 100 ) == SUCCESS );
+  }
+  HOST_CHECK( osal_timer_pool_cnt() == OSAL_TIMERS_POOL_SIZE );
+  HOST_CHECK( osal_timer_pool_max() == OSAL_TIMERS_POOL_SIZE );
+  HOST_CHECK( osal_timer_heap_cnt() == 0 );
+  HOST_CHECK( test_HeapBlocks() == blocks );
+  HOST_CHECK( osal_heap_mem_used() == used );
+
+  // The rest come from the heap, the first of them due before the pool timers
+  for ( ; i < TEST_TIMERS; i++ )
+  {
+    uint32 timeout = ( i == OSAL_TIMERS_POOL_SIZE ) ? 50 : (i + 1) * 100;
+
+    HOST_CHECK( osal_start_timerEx( TEST_TASK, BV( i ), timeout ) == SUCCESS );
+  }
+  HOST_CHECK( osal_timer_pool_cnt() == OSAL_TIMERS_POOL_SIZE );
+  HOST_CHECK( osal_timer_pool_max() == OSAL_TIMERS_POOL_SIZE );
+  HOST_CHECK( osal_timer_heap_cnt() == TEST_HEAP_TIMERS );
+  HOST_CHECK( test_HeapBlocks() == blocks + TEST_HEAP_TIMERS );
+  HOST_CHECK( osal_heap_mem_used() > used );
+  HOST_CHECK( osal_timer_num_active() == TEST_TIMERS );
+
+  // Restarting a running timer takes no record
+  HOST_CHECK( osal_start_timerEx( TEST_TASK, BV( TEST_TIMERS - 1 ), TEST_TIMERS * 100 ) == SUCCESS );
+  HOST_CHECK( osal_timer_heap_cnt() == TEST_HEAP_TIMERS );
+
+  // Pool and heap timers fire in the order they are due
+  hostTestRun( (TEST_TIMERS + 1) * 100 );
+  HOST_CHECK( test_OrderCnt == TEST_TIMERS );
+  HOST_CHECK( test_Order[0] == OSAL_TIMERS_POOL_SIZE );
+  for ( i = 1; i < TEST_TIMERS; i++ )
+  {
+    uint8 expect = ( i <= OSAL_TIMERS_POOL_SIZE ) ? (i - 1) : i;
+
+    HOST_CHECK( test_Order[i] == expect );
+  }
+
+  // Every record went back: the heap is as it was, the pool is empty
+  HOST_CHECK( osal_timer_num_active() == 0 );
+  HOST_CHECK( osal_timer_pool_cnt() == 0 );
+  HOST_CHECK( osal_timer_pool_max() == OSAL_TIMERS_POOL_SIZE );
+  HOST_CHECK( test_HeapBlocks() == blocks );
+  HOST_CHECK( osal_heap_mem_used() == used );
+
+  // The pool is used again before the heap
+  for ( i = 0; i < OSAL_TIMERS_POOL_SIZE; i++ )
+  {
+    HOST_CHECK( osal_start_timerEx( TEST_TASK, BV( i ), 100 ) == SUCCESS );
+  }
+  HOST_CHECK( osal_timer_pool_cnt() == OSAL_TIMERS_POOL_SIZE );
+  HOST_CHECK( osal_timer_heap_cnt() == TEST_HEAP_TIMERS );
+  for ( i = 0; i < OSAL_TIMERS_POOL_SIZE; i++ )
+  {
+    HOST_CHECK( osal_stop_timerEx( TEST_TASK, BV( i ) ) == SUCCESS );
+  }
+  HOST_CHECK( osal_timer_pool_cnt() == 0 );
+
+  // Reload timers keep their records across fires, wherever they came from
+  for ( i = 0; i < TEST_TIMERS; i++ )
+  {
+    test_Fires[i] = 0;
+    HOST_CHECK( osal_start_reload_timer( TEST_TASK, BV( i ), 100 ) == SUCCESS );
+  }
+  HOST_CHECK( osal_timer_heap_cnt() == 2 * TEST_HEAP_TIMERS );
+
+  hostTestRun( 1050 );
+  for ( i = 0; i < TEST_TIMERS; i++ )
+  {
+    HOST_CHECK( test_Fires[i] == 10 );
+  }
+  HOST_CHECK( osal_timer_pool_cnt() == OSAL_TIMERS_POOL_SIZE );
+  HOST_CHECK( osal_timer_heap_cnt() == 2 * TEST_HEAP_TIMERS );
+  HOST_CHECK( test_HeapBlocks() == blocks + TEST_HEAP_TIMERS );
+
+  for ( i = 0; i < TEST_TIMERS; i++ )
+  {
+    HOST_CHECK( osal_stop_timerEx( TEST_TASK, BV( i ) ) == SUCCESS );
+  }
+  HOST_CHECK( osal_timer_pool_cnt() == 0 );
+  HOST_CHECK( test_HeapBlocks() == blocks );
+  HOST_CHECK( osal_heap_mem_used() == used );
+
+  return hostTestResult( "test_timer_pool" );
+}
+
+/*********************************************************************
+*********************************************************************/
@@ -0,0 +1,268 @@
+/**************************************************************************************************
+  Filename:       test_timer_slack.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host test of the OSAL timer slack and of the wakeup counts.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include "ZComDef.h"
+#include "hal_drivers.h"
+#include "hal_sim.h"
+#include "OSAL.h"
+#include "OSAL_PwrMgr.h"
+#include "OSAL_Tasks.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define TEST_TASK                  1
+#define TEST_LIB_TASK              2   // Starts its timers without a slack
+
+#define TEST_FAST_EVT              0x0001
+#define TEST_SLOW_EVT              0x0002
+#define TEST_POLL_EVT              0x0001
+
+#define TEST_FAST_MSEC             1000
+#define TEST_SLOW_MSEC             1030
+#define TEST_SLACK                 100
+
+#define TEST_RUN_MSEC              60000
+
+// A fire may come a tick after it was due
+#define TEST_TICK                  1
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+static uint16 test_event_loop( uint8 task_id, uint16 events );
+
+const pTaskEventHandlerFn tasksArr[] = {
+  Hal_ProcessEvent,
+  test_event_loop,
+  test_event_loop
+};
+
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt);
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt));
+
+  Hal_Init( 0 );
+}
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// Per task and event: fires, time of the last one, and the shortest and
+// longest time between two of them
+static uint32 test_Fires[3][2];
+static uint32 test_Last[3][2];
+static uint32 test_MinGap[3][2];
+static uint32 test_MaxGap[3][2];
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+static uint16 test_event_loop( uint8 task_id, uint16 events )
+{
+  uint32 now = osal_GetSystemClock();
+  uint8 i = ( events & 0x0001 ) ? 0 : 1;
+
+  if ( test_Fires[task_id][i] != 0 )
+  {
+    uint32 gap = now - test_Last[task_id][i];
+
+    if ( gap < test_MinGap[task_id][i] )
+    {
+      test_MinGap[task_id][i] = gap;
+    }
+    if ( gap > test_MaxGap[task_id][i] )
+    {
+      test_MaxGap[task_id][i] = gap;
+    }
+  }
+  test_Fires[task_id][i]++;
+  test_Last[task_id][i] = now;
+
+  return ( events ^ BV( i ) );
+}
+
+static void test_Clear( void )
+{
+  osal_memset( test_Fires, 0, sizeof( test_Fires ) );
+  osal_memset( test_MinGap, 0xFF, sizeof( test_MinGap ) );
+  osal_memset( test_MaxGap, 0, sizeof( test_MaxGap ) );
+}
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   Sleep length with timer slack, the expiries of timers that
+ *          share wakeups and the wakeup counts.
+ */
+int main( void )
+{
+  uint32 sleeps;
+  uint16 wakes;
+  uint8 i;
+
+  hostTestBoot();
+
+  // osal_next_timeout: the head's slack reaches a timer 30 ms later,
+  // which has no slack of its own
+  HOST_CHECK( osal_start_timer_slack( TEST_TASK, BV( 0 ), 100, 50 ) == SUCCESS );
+  HOST_CHECK( osal_start_timerEx( TEST_TASK, BV( 1 ), 130 ) == SUCCESS );
+  HOST_CHECK( osal_start_timer_slack( TEST_TASK, BV( 2 ), 140, 500 ) == SUCCESS );
+  HOST_CHECK( osal_next_timeout() == 130 );
+
+  // Out of reach of the slack
+  HOST_CHECK( osal_start_timerEx( TEST_TASK, BV( 1 ), 160 ) == SUCCESS );
+  HOST_CHECK( osal_next_timeout() == 140 );
+  HOST_CHECK( osal_stop_timerEx( TEST_TASK, BV( 2 ) ) == SUCCESS );
+  HOST_CHECK( osal_next_timeout() == 100 );
+
+  // The budget is the smallest slack of the timers passed over
+  HOST_CHECK( osal_start_timer_slack( TEST_TASK, BV( 2 ), 120, 20 ) == SUCCESS );
+  HOST_CHECK( osal_start_timerEx( TEST_TASK, BV( 1 ), 145 ) == SUCCESS );
+  HOST_CHECK( osal_next_timeout() == 120 );
+  HOST_CHECK( osal_start_timerEx( TEST_TASK, BV( 1 ), 140 ) == SUCCESS );
+  HOST_CHECK( osal_next_timeout() == 140 );
+
+  // A head without slack is served on time; restarting without a slack
+  // takes the slack back
+  HOST_CHECK( osal_start_timerEx( TEST_TASK, BV( 0 ), 100 ) == SUCCESS );
+  HOST_CHECK( osal_next_timeout() == 100 );
+
+  for ( i = 0; i < 3; i++ )
+  {
+    HOST_CHECK( osal_stop_timerEx( TEST_TASK, BV( i ) ) == SUCCESS );
+  }
+  HOST_CHECK( osal_next_timeout() == 0 );
+
+  // osal_set_timer_slack: a running timer gets the slack, and so do the
+  // later starts of it that do not pass one
+  HOST_CHECK( osal_start_reload_timer( TEST_LIB_TASK, TEST_POLL_EVT, 1000 ) == SUCCESS );
+  HOST_CHECK( osal_start_timerEx( TEST_TASK, BV( 0 ), 1040 ) == SUCCESS );
+  HOST_CHECK( osal_next_timeout() == 1000 );
+  HOST_CHECK( osal_set_timer_slack( TEST_LIB_TASK, TEST_POLL_EVT, 50 ) == SUCCESS );
+  HOST_CHECK( osal_next_timeout() == 1040 );
+  HOST_CHECK( osal_stop_timerEx( TEST_LIB_TASK, TEST_POLL_EVT ) == SUCCESS );
+  HOST_CHECK( osal_start_reload_timer( TEST_LIB_TASK, TEST_POLL_EVT, 1000 ) == SUCCESS );
+  HOST_CHECK( osal_next_timeout() == 1040 );
+
+  // An explicit slack wins, a slack of 0 takes the default back
+  HOST_CHECK( osal_start_reload_timer_slack( TEST_LIB_TASK, TEST_POLL_EVT, 1000, 20 ) == SUCCESS );
+  HOST_CHECK( osal_next_timeout() == 1000 );
+  HOST_CHECK( osal_start_reload_timer( TEST_LIB_TASK, TEST_POLL_EVT, 1000 ) == SUCCESS );
+  HOST_CHECK( osal_next_timeout() == 1040 );
+  HOST_CHECK( osal_set_timer_slack( TEST_LIB_TASK, TEST_POLL_EVT, 0 ) == SUCCESS );
+  HOST_CHECK( osal_next_timeout() == 1000 );
+  HOST_CHECK( osal_start_reload_timer( TEST_LIB_TASK, TEST_POLL_EVT, 1000 ) == SUCCESS );
+  HOST_CHECK( osal_next_timeout() == 1000 );
+
+  // The table holds OSAL_TIMERS_SLACK_DEFAULTS timers; the ones in it can
+  // still be changed
+  for ( i = 1; i < OSAL_TIMERS_SLACK_DEFAULTS; i++ )
+  {
+    HOST_CHECK( osal_set_timer_slack( TEST_LIB_TASK, BV( i ), 10 ) == SUCCESS );
+  }
+  HOST_CHECK( osal_set_timer_slack( TEST_LIB_TASK, BV( i ), 10 ) == NO_TIMER_AVAIL );
+  HOST_CHECK( osal_set_timer_slack( TEST_LIB_TASK, TEST_POLL_EVT, 50 ) == SUCCESS );
+  HOST_CHECK( osal_next_timeout() == 1040 );
+
+  HOST_CHECK( osal_stop_timerEx( TEST_LIB_TASK, TEST_POLL_EVT ) == SUCCESS );
+  HOST_CHECK( osal_stop_timerEx( TEST_TASK, BV( 0 ) ) == SUCCESS );
+
+  // Sleeping: every wakeup is counted, also those after which no task
+  // had events
+  osal_pwrmgr_device( PWRMGR_BATTERY );
+  hostTestRun( 10 );
+  osal_pwrmgr_wake_reset();
+  sleeps = halSimSleepCnt();
+  hostTestRun( 100 );
+  sleeps = halSimSleepCnt() - sleeps;
+  HOST_CHECK( sleeps != 0 );
+  HOST_CHECK( osal_pwrmgr_wake_cnt( TASK_NO_TASK ) == sleeps );
+  HOST_CHECK( osal_pwrmgr_wake_cnt( TEST_TASK ) == 0 );
+
+  // Two reload timers without slack wake the device for each of them
+  test_Clear();
+  osal_pwrmgr_wake_reset();
+  sleeps = halSimSleepCnt();
+  HOST_CHECK( osal_start_reload_timer( TEST_TASK, TEST_FAST_EVT, TEST_FAST_MSEC ) == SUCCESS );
+  HOST_CHECK( osal_start_reload_timer( TEST_TASK, TEST_SLOW_EVT, TEST_SLOW_MSEC ) == SUCCESS );
+  hostTestRun( TEST_RUN_MSEC );
+  sleeps = halSimSleepCnt() - sleeps;
+  wakes = osal_pwrmgr_wake_cnt( TASK_NO_TASK );
+  HOST_CHECK( wakes == sleeps );
+  HOST_CHECK( osal_pwrmgr_wake_cnt( TEST_TASK ) >= (2 * (TEST_RUN_MSEC / TEST_SLOW_MSEC)) - 2 );
+  HOST_CHECK( test_MaxGap[TEST_TASK][0] <= TEST_FAST_MSEC + TEST_TICK );
+  HOST_CHECK( test_MaxGap[TEST_TASK][1] <= TEST_SLOW_MSEC + TEST_TICK );
+
+  // With slack they share wakeups, fire at most the slack late and are
+  // never early
+  test_Clear();
+  osal_pwrmgr_wake_reset();
+  sleeps = halSimSleepCnt();
+  HOST_CHECK( osal_start_reload_timer_slack( TEST_TASK, TEST_FAST_EVT, TEST_FAST_MSEC, TEST_SLACK ) == SUCCESS );
+  HOST_CHECK( osal_start_reload_timer_slack( TEST_TASK, TEST_SLOW_EVT, TEST_SLOW_MSEC, TEST_SLACK ) == SUCCESS );
+  hostTestRun( TEST_RUN_MSEC );
+  sleeps = halSimSleepCnt() - sleeps;
+  HOST_CHECK( osal_pwrmgr_wake_cnt( TASK_NO_TASK ) == sleeps );
+  HOST_CHECK( osal_pwrmgr_wake_cnt( TASK_NO_TASK ) <= (wakes / 2) + 2 );
+  HOST_CHECK( test_MinGap[TEST_TASK][0] >= TEST_FAST_MSEC );
+  HOST_CHECK( test_MinGap[TEST_TASK][1] >= TEST_SLOW_MSEC );
+  HOST_CHECK( test_MaxGap[TEST_TASK][0] <= TEST_FAST_MSEC + TEST_SLACK + TEST_TICK );
+  HOST_CHECK( test_MaxGap[TEST_TASK][1] <= TEST_SLOW_MSEC + TEST_SLACK + TEST_TICK );
+  HOST_CHECK( test_Fires[TEST_TASK][0] >= TEST_RUN_MSEC / (TEST_FAST_MSEC + TEST_SLACK + TEST_TICK) );
+  HOST_CHECK( test_Fires[TEST_TASK][1] >= TEST_RUN_MSEC / (TEST_SLOW_MSEC + TEST_SLACK + TEST_TICK) );
+
+  return hostTestResult( "test_timer_slack" );
+}
+
+/*********************************************************************
+*********************************************************************/
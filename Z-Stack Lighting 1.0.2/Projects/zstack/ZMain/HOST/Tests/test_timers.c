@@ -0,0 +1,212 @@
+/**************************************************************************************************
+  Filename:       test_timers.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host test of the OSAL timer engine with 64 concurrent timers.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include "ZComDef.h"
+#include "hal_drivers.h"
+#include "hal_sim.h"
+#include "OSAL.h"
+#include "OSAL_Tasks.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define TEST_APP_TASKS             4
+#define TEST_RELOAD_TIMERS         15
+#define TEST_SLOW_EVT              0x8000
+
+#define TEST_RUN_MSEC              10000
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static uint32 test_Fires[TEST_APP_TASKS + 1][16];
+static uint8 test_Order[4];
+static uint8 test_OrderCnt;
+
+static uint16 test_event_loop( uint8 task_id, uint16 events );
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+const pTaskEventHandlerFn tasksArr[] = {
+  Hal_ProcessEvent,
+  test_event_loop,
+  test_event_loop,
+  test_event_loop,
+  test_event_loop
+};
+
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt);
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt));
+
+  Hal_Init( 0 );
+}
+
+static uint16 test_event_loop( uint8 task_id, uint16 events )
+{
+  uint8 i;
+
+  for ( i = 0; i < 16; i++ )
+  {
+    if ( events & BV( i ) )
+    {
+      test_Fires[task_id][i]++;
+
+      if ( (task_id == 1) && (test_OrderCnt < sizeof( test_Order )) )
+      {
+        test_Order[test_OrderCnt++] = i;
+      }
+
+      return ( events ^ BV( i ) );
+    }
+  }
+
+  return 0;
+}
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   Timer semantics with 64 concurrent timers.
+ */
+int main( void )
+{
+  uint32 timeout, next;
+  uint8 task, i;
+
+  hostTestBoot();
+
+  // One-shots fire in expiry order, not in start order
+  HOST_CHECK( osal_start_timerEx( 1, BV( 2 ), 30 ) == SUCCESS );
+  HOST_CHECK( osal_start_timerEx( 1, BV( 0 ), 10 ) == SUCCESS );
+  HOST_CHECK( osal_start_timerEx( 1, BV( 1 ), 20 ) == SUCCESS );
+  HOST_CHECK( osal_next_timeout() == 10 );
+
+  // Restarting a running timer replaces its timeout
+  HOST_CHECK( osal_start_timerEx( 1, BV( 3 ), 5 ) == SUCCESS );
+  HOST_CHECK( osal_start_timerEx( 1, BV( 3 ), 40 ) == SUCCESS );
+  HOST_CHECK( osal_get_timeoutEx( 1, BV( 3 ) ) == 40 );
+  HOST_CHECK( osal_timer_num_active() == 4 );
+
+  hostTestRun( 50 );
+  HOST_CHECK( test_OrderCnt == 4 );
+  HOST_CHECK( test_Order[0] == 0 && test_Order[1] == 1 );
+  HOST_CHECK( test_Order[2] == 2 && test_Order[3] == 3 );
+  HOST_CHECK( osal_timer_num_active() == 0 );
+  HOST_CHECK( osal_next_timeout() == 0 );
+
+  // 64 reload timers with 16 different periods
+  osal_memset( test_Fires, 0, sizeof( test_Fires ) );
+  for ( task = 1; task <= TEST_APP_TASKS; task++ )
+  {
+    for ( i = 0; i < TEST_RELOAD_TIMERS; i++ )
+    {
+      HOST_CHECK( osal_start_reload_timer( task, BV( i ), (i + 1) * 13 ) == SUCCESS );
+    }
+    HOST_CHECK( osal_start_reload_timer( task, TEST_SLOW_EVT, 1000 ) == SUCCESS );
+  }
+  HOST_CHECK( osal_timer_num_active() == 64 );
+
+  hostTestRun( TEST_RUN_MSEC );
+  HOST_CHECK( osal_timer_num_active() == 64 );
+
+  next = 0xFFFFFFFF;
+  for ( task = 1; task <= TEST_APP_TASKS; task++ )
+  {
+    for ( i = 0; i < TEST_RELOAD_TIMERS; i++ )
+    {
+      uint32 period = (i + 1) * 13;
+
+      // No firing is lost; a reload may lag by a tick per period
+      HOST_CHECK( test_Fires[task][i] <= TEST_RUN_MSEC / period );
+      HOST_CHECK( test_Fires[task][i] >= (TEST_RUN_MSEC / (period + 1)) - 1 );
+
+      timeout = osal_get_timeoutEx( task, BV( i ) );
+      HOST_CHECK( timeout != 0 && timeout <= period );
+      if ( timeout < next )
+      {
+        next = timeout;
+      }
+    }
+    HOST_CHECK( test_Fires[task][15] >= 9 && test_Fires[task][15] <= 10 );
+  }
+
+  // The next expiry is the earliest timeout
+  HOST_CHECK( osal_next_timeout() == next );
+
+  // Stopped timers are gone and no longer fire
+  for ( task = 1; task <= TEST_APP_TASKS; task++ )
+  {
+    for ( i = 0; i < TEST_RELOAD_TIMERS; i += 2 )
+    {
+      HOST_CHECK( osal_stop_timerEx( task, BV( i ) ) == SUCCESS );
+      HOST_CHECK( osal_get_timeoutEx( task, BV( i ) ) == 0 );
+    }
+  }
+  HOST_CHECK( osal_stop_timerEx( 1, BV( 0 ) ) == INVALID_EVENT_ID );
+  HOST_CHECK( osal_timer_num_active() == 64 - (TEST_APP_TASKS * 8) );
+
+  osal_memset( test_Fires, 0, sizeof( test_Fires ) );
+  hostTestRun( 1000 );
+  for ( task = 1; task <= TEST_APP_TASKS; task++ )
+  {
+    for ( i = 0; i < TEST_RELOAD_TIMERS; i++ )
+    {
+      HOST_CHECK( (i & 1) ? (test_Fires[task][i] != 0) : (test_Fires[task][i] == 0) );
+    }
+  }
+
+  return hostTestResult( "test_timers" );
+}
+
+/*********************************************************************
+*********************************************************************/
@@ -0,0 +1,143 @@
+/**************************************************************************************************
+  Filename:       test_utc.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host test of the UTC calendar conversions.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include <time.h>
+
+#include "ZComDef.h"
+#include "hal_drivers.h"
+#include "OSAL.h"
+#include "OSAL_Clock.h"
+#include "OSAL_Tasks.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// 00:00:00 on the 1st of January 2000, in the host time_t
+#define TEST_EPOCH_2000            946684800LL
+
+#define TEST_DAY                   86400UL
+#define TEST_DAYS                  (0xFFFFFFFFUL / TEST_DAY)
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+const pTaskEventHandlerFn tasksArr[] = {
+  Hal_ProcessEvent
+};
+
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt);
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt));
+
+  Hal_Init( 0 );
+}
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+/*
+ * Convert a UTCTime both ways and compare with the host C library,
+ * returns 1 if anything differs.
+ */
+static uint32 test_Convert( UTCTime secs )
+{
+  time_t host = (time_t)(TEST_EPOCH_2000 + secs);
+  UTCTimeStruct tm;
+  struct tm ref;
+
+  osal_ConvertUTCTime( &tm, secs );
+  (void)gmtime_r( &host, &ref );
+
+  if ( (tm.year != ref.tm_year + 1900) || (tm.month != ref.tm_mon) ||
+       (tm.day != ref.tm_mday - 1) || (tm.hour != ref.tm_hour) ||
+       (tm.minutes != ref.tm_min) || (tm.seconds != ref.tm_sec) )
+  {
+    return 1;
+  }
+
+  return ( (osal_ConvertUTCSecs( &tm ) != secs) ? 1 : 0 );
+}
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   The calendar conversions agree with the host C library, and
+ *          with each other, on every day of the UTCTime range: at the
+ *          first and last second of the day and at one in each hour.
+ */
+int main( void )
+{
+  uint32 day, bad = 0;
+
+  for ( day = 0; day < TEST_DAYS; day++ )
+  {
+    UTCTime secs = day * TEST_DAY;
+
+    uint8 hour;
+
+    bad += test_Convert( secs );
+    for ( hour = 0; hour < 24; hour++ )
+    {
+      bad += test_Convert( secs + (hour * 3600UL) + ((day + hour) * 7919UL) % 3600 );
+    }
+    bad += test_Convert( secs + TEST_DAY - 1 );
+  }
+
+  // The last day of the range is cut short
+  bad += test_Convert( TEST_DAYS * TEST_DAY );
+  bad += test_Convert( 0xFFFFFFFF );
+  HOST_CHECK( bad == 0 );
+
+  return hostTestResult( "test_utc" );
+}
+
+/*********************************************************************
+*********************************************************************/
@@ -0,0 +1,378 @@
+/**************************************************************************************************
+  Filename:       test_zcl_attr.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host test of the ZCL attribute record lookups.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include <stdlib.h>
+
+#include "ZComDef.h"
+#include "hal_drivers.h"
+#include "OSAL.h"
+#include "OSAL_Tasks.h"
+#include "zcl.h"
+#include "zcl_ll.h"
+#include "zll_samplelight.h"
+#include "host_af.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Random attribute lists, out of order and with duplicate records, of
+// clusters 1 to TEST_CLUSTERS - the Basic cluster would turn the device off
+#define TEST_LISTS                 100
+#define TEST_LIST_MAX              48
+#define TEST_CLUSTERS              12
+#define TEST_ATTR_IDS              40
+
+#define TEST_LIST_EP               30
+#define TEST_DISC_EP               20
+#define TEST_DISC_LISTS            6
+
+// Attribute IDs asked for per Discover Attributes command
+#define TEST_DISC_MAX              8
+
+// Rounding of the heap blocks
+#define TEST_HEAP_ROUND            8
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+const pTaskEventHandlerFn tasksArr[] = {
+  Hal_ProcessEvent,
+  zcl_event_loop
+};
+
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt);
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt));
+
+  Hal_Init( 0 );
+  zcl_Init( 1 );
+}
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static zclAttrRec_t test_Lists[TEST_LISTS][TEST_LIST_MAX];
+static uint8 test_ListLen[TEST_LISTS];
+
+#if ZCL_ATTR_INDEX
+static uint8 test_SeqNum;
+#endif
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+/*
+ * The first record of the attribute in table order, as found by a scan.
+ */
+static const zclAttrRec_t *test_FindAttr( const zclAttrRec_t *pList, uint8 numAttr,
+                                          uint16 clusterID, uint16 attrId )
+{
+  uint8 x;
+
+  for ( x = 0; x < numAttr; x++ )
+  {
+    if ( (pList[x].clusterID == clusterID) && (pList[x].attr.attrId == attrId) )
+    {
+      return ( &pList[x] );
+    }
+  }
+
+  return ( NULL );
+}
+
+/*
+ * Check zclFindAttrRec() against the scan for every attribute ID of every
+ * cluster in the list and a few that are not; returns the mismatches.
+ */
+static uint16 test_CheckFind( uint8 endpoint, const zclAttrRec_t *pList, uint8 numAttr )
+{
+  const zclAttrRec_t *pExpect;
+  zclAttrRec_t attrRec;
+  uint16 fails = 0;
+  uint16 clusterID, attrId;
+  uint8 x;
+
+  for ( x = 0; x <= numAttr; x++ )
+  {
+    clusterID = (x < numAttr) ? pList[x].clusterID : 0xFFFF;
+
+    for ( attrId = 0; attrId < TEST_ATTR_IDS; attrId++ )
+    {
+      pExpect = test_FindAttr( pList, numAttr, clusterID, attrId );
+      if ( zclFindAttrRec( endpoint, clusterID, attrId, &attrRec ) )
+      {
+        if ( (pExpect == NULL) || (attrRec.attr.dataPtr != pExpect->attr.dataPtr) ||
+             (attrRec.attr.dataType != pExpect->attr.dataType) )
+        {
+          fails++;
+        }
+      }
+      else if ( pExpect != NULL )
+      {
+        fails++;
+      }
+    }
+
+    // The IDs of the list itself, which go beyond TEST_ATTR_IDS in the sample light
+    if ( x < numAttr )
+    {
+      pExpect = test_FindAttr( pList, numAttr, pList[x].clusterID, pList[x].attr.attrId );
+      if ( !zclFindAttrRec( endpoint, pList[x].clusterID, pList[x].attr.attrId, &attrRec ) ||
+           (attrRec.attr.dataPtr != pExpect->attr.dataPtr) )
+      {
+        fails++;
+      }
+
+      attrId = pList[x].attr.attrId + 1;
+      pExpect = test_FindAttr( pList, numAttr, pList[x].clusterID, attrId );
+      if ( zclFindAttrRec( endpoint, pList[x].clusterID, attrId, &attrRec ) != (pExpect != NULL) )
+      {
+        fails++;
+      }
+    }
+  }
+
+  return ( fails );
+}
+
+#if ZCL_ATTR_INDEX
+/*
+ * The record of the lowest attribute ID of at least attrId on the side of
+ * the cluster given by direction, the first of them in table order.
+ */
+static const zclAttrRec_t *test_FindNextAttr( const zclAttrRec_t *pList, uint8 numAttr,
+                                              uint16 clusterID, uint8 direction, uint16 attrId )
+{
+  const zclAttrRec_t *pFound = NULL;
+  uint8 x;
+
+  for ( x = 0; x < numAttr; x++ )
+  {
+    if ( (pList[x].clusterID == clusterID) && (pList[x].attr.attrId >= attrId) &&
+         (((pList[x].attr.accessControl & ACCESS_CLIENT) ? 1 : 0) == direction) &&
+         ((pFound == NULL) || (pList[x].attr.attrId < pFound->attr.attrId)) )
+    {
+      pFound = &pList[x];
+    }
+  }
+
+  return ( pFound );
+}
+
+/*
+ * Discover the attributes of one side of a cluster, TEST_DISC_MAX at a time,
+ * and check them against the scan; returns the mismatches.
+ */
+static uint16 test_CheckDiscover( uint8 endpoint, const zclAttrRec_t *pList, uint8 numAttr,
+                                  uint16 clusterID, uint8 direction )
+{
+  const zclAttrRec_t *pExpect;
+  uint16 fails = 0;
+  uint16 start = 0;
+  uint8 complete = FALSE;
+
+  while ( !complete )
+  {
+    uint8 req[6];
+    uint8 *pRsp;
+    uint8 numAttrs, x;
+
+    req[0] = ZCL_FRAME_TYPE_PROFILE_CMD | (direction ? ZCL_FRAME_CONTROL_DIRECTION : 0);
+    req[1] = test_SeqNum++;
+    req[2] = ZCL_CMD_DISCOVER_ATTRS;
+    req[3] = LO_UINT16( start );
+    req[4] = HI_UINT16( start );
+    req[5] = TEST_DISC_MAX;
+
+    hostAfReset();
+    hostAfReceive( endpoint, clusterID, req, sizeof( req ) );
+    if ( (hostAfFrameCnt != 1) || (hostAfFrames[0].data[2] != ZCL_CMD_DISCOVER_ATTRS_RSP) )
+    {
+      return ( fails + 1 );  // EMBEDDED RETURN
+    }
+
+    pRsp = &hostAfFrames[0].data[3];
+    complete = pRsp[0];
+    numAttrs = (hostAfFrames[0].len - 4) / 3;
+    for ( x = 0; x < numAttrs; x++ )
+    {
+      uint16 attrId = BUILD_UINT16( pRsp[1 + (x * 3)], pRsp[2 + (x * 3)] );
+
+      pExpect = test_FindNextAttr( pList, numAttr, clusterID, direction, start );
+      if ( (pExpect == NULL) || (pExpect->attr.attrId != attrId) ||
+           (pExpect->attr.dataType != pRsp[3 + (x * 3)]) )
+      {
+        fails++;
+      }
+      start = attrId + 1;
+    }
+
+    if ( ((numAttrs < TEST_DISC_MAX) && !complete) ||
+         (complete != (test_FindNextAttr( pList, numAttr, clusterID, direction, start ) == NULL)) )
+    {
+      return ( fails + 1 );  // EMBEDDED RETURN
+    }
+  }
+
+  return ( fails );
+}
+#endif
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   Attribute lookups and attribute discovery give the same
+ *          records as a scan of the list, for the sample light's
+ *          attributes and for lists out of order with duplicate
+ *          records - the first of the duplicates is the one found.
+ *          Built with and without ZCL_ATTR_INDEX.
+ */
+int main( void )
+{
+#if ZCL_ATTR_INDEX
+  uint16 heapUsed, heapOne;
+#endif
+  uint16 fails;
+  uint16 x;
+  uint8 y;
+
+  hostTestBoot();
+
+  // The index takes a byte per record, give or take the rounding of the heap blocks
+#if ZCL_ATTR_INDEX
+  heapUsed = osal_heap_mem_used();
+#endif
+  test_Lists[0][0].clusterID = 1;
+  HOST_CHECK( zcl_registerAttrList( TEST_LIST_EP - 1, 1, test_Lists[0] ) == ZSuccess );
+#if ZCL_ATTR_INDEX
+  heapOne = osal_heap_mem_used() - heapUsed;
+#endif
+
+  // The sample light
+  hostAfRegister( SAMPLELIGHT_ENDPOINT, ZLL_PROFILE_ID );
+  HOST_CHECK( zcl_registerAttrList( SAMPLELIGHT_ENDPOINT, SAMPLELIGHT_NUM_ATTRIBUTES,
+                                    zllSampleLight_Attrs ) == ZSuccess );
+  HOST_CHECK( test_CheckFind( SAMPLELIGHT_ENDPOINT, zllSampleLight_Attrs,
+                              SAMPLELIGHT_NUM_ATTRIBUTES ) == 0 );
+
+  // Without the index, discovery needs attribute IDs in ascending order, which the sample
+  // light's Basic and Color Control attributes are not
+#if ZCL_ATTR_INDEX
+  fails = 0;
+  for ( y = 0; y < SAMPLELIGHT_NUM_ATTRIBUTES; y++ )
+  {
+    if ( (y == 0) || (zllSampleLight_Attrs[y].clusterID != zllSampleLight_Attrs[y-1].clusterID) )
+    {
+      fails += test_CheckDiscover( SAMPLELIGHT_ENDPOINT, zllSampleLight_Attrs,
+                                   SAMPLELIGHT_NUM_ATTRIBUTES, zllSampleLight_Attrs[y].clusterID,
+                                   ZCL_FRAME_CLIENT_SERVER_DIR );
+    }
+  }
+  HOST_CHECK( fails == 0 );
+#endif
+
+  // Random lists
+  srand( 1 );
+  fails = 0;
+  for ( x = 0; x < TEST_LISTS; x++ )
+  {
+    test_ListLen[x] = 1 + (rand() % TEST_LIST_MAX);
+    for ( y = 0; y < test_ListLen[x]; y++ )
+    {
+      test_Lists[x][y].clusterID = 1 + (rand() % TEST_CLUSTERS);
+      test_Lists[x][y].attr.attrId = rand() % TEST_ATTR_IDS;
+      test_Lists[x][y].attr.dataType = y;
+      test_Lists[x][y].attr.accessControl = (rand() % 3) ? ACCESS_CONTROL_READ : ACCESS_CLIENT;
+      test_Lists[x][y].attr.dataPtr = &test_Lists[x][y];
+    }
+
+#if ZCL_ATTR_INDEX
+    heapUsed = osal_heap_mem_used();
+#endif
+    if ( zcl_registerAttrList( TEST_LIST_EP + x, test_ListLen[x], test_Lists[x] ) != ZSuccess )
+    {
+      fails++;
+    }
+#if ZCL_ATTR_INDEX
+    if ( (osal_heap_mem_used() - heapUsed) + TEST_HEAP_ROUND < heapOne + test_ListLen[x] )
+    {
+      fails++;
+    }
+#endif
+    fails += test_CheckFind( TEST_LIST_EP + x, test_Lists[x], test_ListLen[x] );
+  }
+  HOST_CHECK( fails == 0 );
+
+  // Discovery walks the out of order lists in attribute ID order
+#if ZCL_ATTR_INDEX
+  fails = 0;
+  for ( x = 0; x < TEST_DISC_LISTS; x++ )
+  {
+    hostAfRegister( TEST_DISC_EP + x, ZLL_PROFILE_ID );
+    HOST_CHECK( zcl_registerAttrList( TEST_DISC_EP + x, test_ListLen[x], test_Lists[x] ) == ZSuccess );
+
+    for ( y = 1; y <= TEST_CLUSTERS; y++ )
+    {
+      fails += test_CheckDiscover( TEST_DISC_EP + x, test_Lists[x], test_ListLen[x], y,
+                                   ZCL_FRAME_CLIENT_SERVER_DIR );
+      fails += test_CheckDiscover( TEST_DISC_EP + x, test_Lists[x], test_ListLen[x], y,
+                                   ZCL_FRAME_SERVER_CLIENT_DIR );
+    }
+  }
+  HOST_CHECK( fails == 0 );
+#endif
+
+  return hostTestResult( ZCL_ATTR_INDEX ? "test_zcl_attr" : "test_zcl_attr_scan" );
+}
+
+/*********************************************************************
+*********************************************************************/
@@ -0,0 +1,295 @@
+/**************************************************************************************************
+  Filename:       test_zcl_attr_change.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host test of the ZCL attribute change tracking.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include "ZComDef.h"
+#include "hal_drivers.h"
+#include "OSAL.h"
+#include "OSAL_Tasks.h"
+#include "zcl.h"
+#include "zcl_general.h"
+#include "zcl_lighting.h"
+#include "zcl_ll.h"
+#include "zll_samplelight.h"
+#include "host_af.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// The sample light attributes are also registered on a second endpoint,
+// as with ZLL_1_0_HUB_COMPATIBILITY
+#define TEST_EP2                   12
+
+// Writable attributes of a test cluster
+#define TEST_EP                    20
+#define TEST_CLUSTER               0xFC00
+#define TEST_ATTR_U16              0x0000
+#define TEST_ATTR_STR              0x0001
+#define TEST_ATTR_LONG_STR         0x0002
+
+// Current Level that the validation function refuses
+#define TEST_BAD_LEVEL             0x42
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+const pTaskEventHandlerFn tasksArr[] = {
+  Hal_ProcessEvent,
+  zcl_event_loop
+};
+
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt);
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt));
+
+  Hal_Init( 0 );
+  zcl_Init( 1 );
+}
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static uint16 test_U16;
+static uint8 test_Str[1 + MAX_UTF8_STRING_LEN];
+static uint8 test_LongStr[2 + MAX_UTF8_STRING_LEN];
+
+static CONST zclAttrRec_t test_Attrs[] =
+{
+  {
+    TEST_CLUSTER,
+    { // Attribute record
+      TEST_ATTR_U16,
+      ZCL_DATATYPE_UINT16,
+      (ACCESS_CONTROL_READ | ACCESS_CONTROL_WRITE),
+      (void *)&test_U16
+    }
+  },
+  {
+    TEST_CLUSTER,
+    { // Attribute record
+      TEST_ATTR_STR,
+      ZCL_DATATYPE_CHAR_STR,
+      (ACCESS_CONTROL_READ | ACCESS_CONTROL_WRITE),
+      (void *)test_Str
+    }
+  },
+  {
+    TEST_CLUSTER,
+    { // Attribute record
+      TEST_ATTR_LONG_STR,
+      ZCL_DATATYPE_LONG_OCTET_STR,
+      (ACCESS_CONTROL_READ | ACCESS_CONTROL_WRITE),
+      (void *)test_LongStr
+    }
+  }
+};
+
+// Changes seen by test_AttrChangeCB(), and the last one
+static uint16 test_Changes;
+static uint8 test_LastEp;
+static uint16 test_LastCluster;
+static uint16 test_LastAttr;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+static void test_AttrChangeCB( uint8 endpoint, uint16 clusterId, uint16 attrId )
+{
+  test_Changes++;
+  test_LastEp = endpoint;
+  test_LastCluster = clusterId;
+  test_LastAttr = attrId;
+}
+
+static uint8 test_ValidateAttrData( zclAttrRec_t *pAttr, zclWriteRec_t *pAttrInfo )
+{
+  if ( ( pAttr->clusterID == ZCL_CLUSTER_ID_GEN_LEVEL_CONTROL ) &&
+       ( pAttrInfo->attrID == ATTRID_LEVEL_CURRENT_LEVEL ) )
+  {
+    return ( *pAttrInfo->attrData != TEST_BAD_LEVEL );
+  }
+
+  return ( TRUE );
+}
+
+/*
+ * Let the ZCL task deliver the changes, counting them from zero
+ */
+static uint16 test_Deliver( void )
+{
+  test_Changes = 0;
+  hostTestRun( 10 );
+
+  return ( test_Changes );
+}
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   zcl_SetAttrValue() changes a value only when it is accepted
+ *          and signals only real changes. The changes are delivered from
+ *          the ZCL task, once per attribute however often it changed,
+ *          on every endpoint that zcl_AttrChanged() names. Attributes
+ *          written over the air are changes too.
+ */
+int main( void )
+{
+  uint8 str[3 + MAX_UTF8_STRING_LEN];
+  uint8 req[8];
+  uint8 level;
+  uint16 u16;
+
+  hostTestBoot();
+  hostAfRegister( TEST_EP, ZLL_PROFILE_ID );
+  HOST_CHECK( zcl_registerAttrList( SAMPLELIGHT_ENDPOINT, SAMPLELIGHT_NUM_ATTRIBUTES,
+                                    zllSampleLight_Attrs ) == ZSuccess );
+  HOST_CHECK( zcl_registerAttrList( TEST_EP2, SAMPLELIGHT_NUM_ATTRIBUTES,
+                                    zllSampleLight_Attrs ) == ZSuccess );
+  HOST_CHECK( zcl_registerAttrList( TEST_EP, sizeof( test_Attrs ) / sizeof( test_Attrs[0] ),
+                                    test_Attrs ) == ZSuccess );
+  HOST_CHECK( zcl_registerAttrChangeCB( SAMPLELIGHT_ENDPOINT, test_AttrChangeCB ) == ZSuccess );
+  HOST_CHECK( zcl_registerAttrChangeCB( TEST_EP2, test_AttrChangeCB ) == ZSuccess );
+  HOST_CHECK( zcl_registerAttrChangeCB( TEST_EP, test_AttrChangeCB ) == ZSuccess );
+  HOST_CHECK( test_Deliver() == 0 );
+
+  // Unknown attributes, unchanged values
+  level = zclLevel_CurrentLevel;
+  HOST_CHECK( zcl_SetAttrValue( SAMPLELIGHT_ENDPOINT, ZCL_CLUSTER_ID_GEN_LEVEL_CONTROL, 0x4000,
+                                &level ) == ZInvalidParameter );
+  HOST_CHECK( zcl_SetAttrValue( SAMPLELIGHT_ENDPOINT, ZCL_CLUSTER_ID_GEN_LEVEL_CONTROL,
+                                ATTRID_LEVEL_CURRENT_LEVEL, &level ) == ZSuccess );
+  HOST_CHECK( test_Deliver() == 0 );
+
+  // A change is delivered by the ZCL task, once
+  level = zclLevel_CurrentLevel - 10;
+  HOST_CHECK( zcl_SetAttrValue( SAMPLELIGHT_ENDPOINT, ZCL_CLUSTER_ID_GEN_LEVEL_CONTROL,
+                                ATTRID_LEVEL_CURRENT_LEVEL, &level ) == ZSuccess );
+  HOST_CHECK( zclLevel_CurrentLevel == level );
+  HOST_CHECK( test_Changes == 0 );
+  HOST_CHECK( test_Deliver() == 1 );
+  HOST_CHECK( ( test_LastEp == SAMPLELIGHT_ENDPOINT ) &&
+              ( test_LastCluster == ZCL_CLUSTER_ID_GEN_LEVEL_CONTROL ) &&
+              ( test_LastAttr == ATTRID_LEVEL_CURRENT_LEVEL ) );
+
+  // Many changes of the attributes of a transition: one per attribute and endpoint
+  for ( u16 = 0; u16 < 10; u16++ )
+  {
+    zclColor_CurrentX += 16;
+    zcl_AttrChanged( AF_BROADCAST_ENDPOINT, ZCL_CLUSTER_ID_LIGHTING_COLOR_CONTROL,
+                     ATTRID_LIGHTING_COLOR_CONTROL_CURRENT_X );
+    zclColor_CurrentY += 16;
+    zcl_AttrChanged( AF_BROADCAST_ENDPOINT, ZCL_CLUSTER_ID_LIGHTING_COLOR_CONTROL,
+                     ATTRID_LIGHTING_COLOR_CONTROL_CURRENT_Y );
+  }
+  HOST_CHECK( test_Deliver() == 4 );
+  zcl_AttrChanged( TEST_EP2, ZCL_CLUSTER_ID_GEN_ON_OFF, ATTRID_ON_OFF );
+  HOST_CHECK( test_Deliver() == 1 );
+  HOST_CHECK( ( test_LastEp == TEST_EP2 ) && ( test_LastCluster == ZCL_CLUSTER_ID_GEN_ON_OFF ) );
+
+  // The validation function sees the value first
+  HOST_CHECK( zcl_registerValidateAttrData( test_ValidateAttrData ) == ZSuccess );
+  level = TEST_BAD_LEVEL;
+  HOST_CHECK( zcl_SetAttrValue( SAMPLELIGHT_ENDPOINT, ZCL_CLUSTER_ID_GEN_LEVEL_CONTROL,
+                                ATTRID_LEVEL_CURRENT_LEVEL, &level ) == ZCL_STATUS_INVALID_VALUE );
+  HOST_CHECK( zclLevel_CurrentLevel != TEST_BAD_LEVEL );
+  level = TEST_BAD_LEVEL + 1;
+  HOST_CHECK( zcl_SetAttrValue( SAMPLELIGHT_ENDPOINT, ZCL_CLUSTER_ID_GEN_LEVEL_CONTROL,
+                                ATTRID_LEVEL_CURRENT_LEVEL, &level ) == ZSuccess );
+  HOST_CHECK( zclLevel_CurrentLevel == TEST_BAD_LEVEL + 1 );
+  HOST_CHECK( test_Deliver() == 1 );
+  HOST_CHECK( zcl_registerValidateAttrData( NULL ) == ZSuccess );
+
+  // Strings up to MAX_UTF8_STRING_LEN
+  osal_memset( str, 'a', sizeof( str ) );
+  str[0] = MAX_UTF8_STRING_LEN;
+  HOST_CHECK( zcl_SetAttrValue( TEST_EP, TEST_CLUSTER, TEST_ATTR_STR, str ) == ZSuccess );
+  HOST_CHECK( ( test_Str[0] == MAX_UTF8_STRING_LEN ) && ( test_Str[MAX_UTF8_STRING_LEN] == 'a' ) );
+  HOST_CHECK( test_Deliver() == 1 );
+  str[0] = MAX_UTF8_STRING_LEN + 1;
+  str[1] = 'b';
+  HOST_CHECK( zcl_SetAttrValue( TEST_EP, TEST_CLUSTER, TEST_ATTR_STR, str ) == ZCL_STATUS_INVALID_VALUE );
+  str[0] = 0xFF;
+  HOST_CHECK( zcl_SetAttrValue( TEST_EP, TEST_CLUSTER, TEST_ATTR_STR, str ) == ZCL_STATUS_INVALID_VALUE );
+  HOST_CHECK( ( test_Str[0] == MAX_UTF8_STRING_LEN ) && ( test_Str[1] == 'a' ) );
+
+  str[0] = LO_UINT16( MAX_UTF8_STRING_LEN );
+  str[1] = HI_UINT16( MAX_UTF8_STRING_LEN );
+  HOST_CHECK( zcl_SetAttrValue( TEST_EP, TEST_CLUSTER, TEST_ATTR_LONG_STR, str ) == ZSuccess );
+  str[0] = LO_UINT16( MAX_UTF8_STRING_LEN + 1 );
+  HOST_CHECK( zcl_SetAttrValue( TEST_EP, TEST_CLUSTER, TEST_ATTR_LONG_STR, str ) == ZCL_STATUS_INVALID_VALUE );
+  str[0] = 0;
+  str[1] = 1;
+  HOST_CHECK( zcl_SetAttrValue( TEST_EP, TEST_CLUSTER, TEST_ATTR_LONG_STR, str ) == ZCL_STATUS_INVALID_VALUE );
+  HOST_CHECK( BUILD_UINT16( test_LongStr[0], test_LongStr[1] ) == MAX_UTF8_STRING_LEN );
+  HOST_CHECK( test_Deliver() == 1 );
+
+  // Written over the air
+  req[0] = ZCL_FRAME_TYPE_PROFILE_CMD;
+  req[1] = 0x10;
+  req[2] = ZCL_CMD_WRITE;
+  req[3] = LO_UINT16( TEST_ATTR_U16 );
+  req[4] = HI_UINT16( TEST_ATTR_U16 );
+  req[5] = ZCL_DATATYPE_UINT16;
+  req[6] = 0x34;
+  req[7] = 0x12;
+  hostAfReset();
+  hostAfReceive( TEST_EP, TEST_CLUSTER, req, sizeof( req ) );
+  HOST_CHECK( test_U16 == 0x1234 );
+  HOST_CHECK( ( hostAfFrameCnt == 1 ) && ( hostAfFrames[0].data[2] == ZCL_CMD_WRITE_RSP ) &&
+              ( hostAfFrames[0].data[3] == ZCL_STATUS_SUCCESS ) );
+  HOST_CHECK( test_Deliver() == 1 );
+  HOST_CHECK( ( test_LastEp == TEST_EP ) && ( test_LastAttr == TEST_ATTR_U16 ) );
+
+  return hostTestResult( "test_zcl_attr_change" );
+}
+
+/*********************************************************************
+*********************************************************************/
@@ -0,0 +1,359 @@
+/**************************************************************************************************
+  Filename:       test_zcl_report.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host test of the ZCL attribute reporting engine.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include "ZComDef.h"
+#include "hal_drivers.h"
+#include "OSAL.h"
+#include "OSAL_Nv.h"
+#include "OSAL_Tasks.h"
+#include "zcl.h"
+#include "zcl_general.h"
+#include "zcl_lighting.h"
+#include "zcl_ll.h"
+#include "zll_samplelight.h"
+#include "host_af.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define TEST_TASK_ZCL              1
+
+// An analog input with a single precision Present Value, reported to a fixed destination
+#define TEST_ANALOG_EP             12
+#define TEST_ANALOG_CLUSTER        0x000C
+#define TEST_ANALOG_ATTR           0x0055
+#define TEST_ANALOG_DST            0x0001
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+const pTaskEventHandlerFn tasksArr[] = {
+  Hal_ProcessEvent,
+  zcl_event_loop
+};
+
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt);
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt));
+
+  // NV comes up before the tasks, as in ZMain
+  osal_nv_init( NULL );
+
+  Hal_Init( 0 );
+  zcl_Init( TEST_TASK_ZCL );
+}
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static float test_AnalogValue;
+
+static CONST zclAttrRec_t test_AnalogAttrs[] =
+{
+  {
+    TEST_ANALOG_CLUSTER,
+    { // Attribute record
+      TEST_ANALOG_ATTR,
+      ZCL_DATATYPE_SINGLE_PREC,
+      (ACCESS_CONTROL_READ | ACCESS_REPORTABLE),
+      (void *)&test_AnalogValue
+    }
+  }
+};
+
+static uint8 test_SeqNum;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+/*
+ * Configure the reporting of a sample light attribute over the air;
+ * returns the status of the response.
+ */
+static uint8 test_Configure( uint16 clusterID, uint16 attrID, uint8 dataType,
+                             uint16 minInt, uint16 maxInt, uint8 change )
+{
+  uint8 req[12];
+  uint8 len = 0;
+
+  req[len++] = ZCL_FRAME_TYPE_PROFILE_CMD;
+  req[len++] = test_SeqNum++;
+  req[len++] = ZCL_CMD_CONFIG_REPORT;
+  req[len++] = ZCL_SEND_ATTR_REPORTS;
+  req[len++] = LO_UINT16( attrID );
+  req[len++] = HI_UINT16( attrID );
+  req[len++] = dataType;
+  req[len++] = LO_UINT16( minInt );
+  req[len++] = HI_UINT16( minInt );
+  req[len++] = LO_UINT16( maxInt );
+  req[len++] = HI_UINT16( maxInt );
+  if ( zclAnalogDataType( dataType ) )
+  {
+    req[len++] = change;
+  }
+
+  hostAfReset();
+  hostAfReceive( SAMPLELIGHT_ENDPOINT, clusterID, req, len );
+  if ( (hostAfFrameCnt != 1) || (hostAfFrames[0].data[2] != ZCL_CMD_CONFIG_REPORT_RSP) )
+  {
+    return ( ZCL_STATUS_FAILURE );
+  }
+
+  return ( hostAfFrames[0].data[3] );
+}
+
+/*
+ * Count the reports of an attribute in the frames sent since the last
+ * hostAfReset(), keeping the value of the last one.
+ */
+static uint8 test_Reports( uint16 clusterID, uint16 attrID, uint8 *pValue )
+{
+  uint8 reports = 0;
+  uint16 f;
+
+  for ( f = 0; (f < hostAfFrameCnt) && (f < HOST_AF_FRAMES); f++ )
+  {
+    hostAfFrame_t *pFrame = &hostAfFrames[f];
+    uint16 pos = 3;
+
+    if ( (pFrame->clusterID != clusterID) || (pFrame->data[2] != ZCL_CMD_REPORT) )
+    {
+      continue;
+    }
+
+    while ( pos + 3 <= pFrame->len )
+    {
+      uint16 id = BUILD_UINT16( pFrame->data[pos], pFrame->data[pos + 1] );
+      uint8 len = zclGetDataTypeLength( pFrame->data[pos + 2] );
+
+      if ( id == attrID )
+      {
+        reports++;
+        if ( pValue != NULL )
+        {
+          osal_memcpy( pValue, &pFrame->data[pos + 3], len );
+        }
+      }
+      pos += 3 + len;
+    }
+  }
+
+  return ( reports );
+}
+
+/*
+ * Report the change of a sample light attribute, as the application does
+ */
+static void test_Changed( uint16 clusterID, uint16 attrID )
+{
+  zcl_AttrChanged( SAMPLELIGHT_ENDPOINT, clusterID, attrID );
+}
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   Attributes are reported once a reportable change has been
+ *          made and the Minimum Reporting Interval allows, and when the
+ *          Maximum Reporting Interval expires. An unchanged value is not
+ *          a reportable change, even with a Reportable Change of zero.
+ *          The intervals run on the system clock, also while no report
+ *          is pending. The configurations survive a restart.
+ */
+int main( void )
+{
+  zclCfgReportRec_t cfg;
+  afAddrType_t dstAddr;
+  float change;
+  uint8 value[4];
+
+  hostTestBoot();
+  hostAfRegister( SAMPLELIGHT_ENDPOINT, ZLL_PROFILE_ID );
+  hostAfRegister( TEST_ANALOG_EP, ZLL_PROFILE_ID );
+  HOST_CHECK( zcl_registerAttrList( SAMPLELIGHT_ENDPOINT, SAMPLELIGHT_NUM_ATTRIBUTES,
+                                    zllSampleLight_Attrs ) == ZSuccess );
+  HOST_CHECK( zcl_registerAttrList( TEST_ANALOG_EP, 1, test_AnalogAttrs ) == ZSuccess );
+
+  // Only reportable attributes, of the right type
+  HOST_CHECK( test_Configure( ZCL_CLUSTER_ID_GEN_ON_OFF, ATTRID_ON_OFF_ON_TIME, ZCL_DATATYPE_UINT16,
+                              1, 10, 0 ) == ZCL_STATUS_UNREPORTABLE_ATTRIBUTE );
+  HOST_CHECK( test_Configure( ZCL_CLUSTER_ID_GEN_ON_OFF, ATTRID_ON_OFF, ZCL_DATATYPE_UINT8,
+                              1, 10, 0 ) == ZCL_STATUS_INVALID_DATA_TYPE );
+
+  // Current X on change only, with a Reportable Change of zero: reported once when configured,
+  // then only when it changes - a minute later, with no report pending in between
+  HOST_CHECK( test_Configure( ZCL_CLUSTER_ID_LIGHTING_COLOR_CONTROL, ATTRID_LIGHTING_COLOR_CONTROL_CURRENT_X,
+                              ZCL_DATATYPE_UINT16, 2, 0, 0 ) == ZCL_STATUS_SUCCESS );
+  hostAfReset();
+  hostTestRun( 100 );
+  HOST_CHECK( test_Reports( ZCL_CLUSTER_ID_LIGHTING_COLOR_CONTROL, ATTRID_LIGHTING_COLOR_CONTROL_CURRENT_X,
+                            value ) == 1 );
+  HOST_CHECK( BUILD_UINT16( value[0], value[1] ) == zclColor_CurrentX );
+
+  hostAfReset();
+  hostTestRun( 60000 );
+  test_Changed( ZCL_CLUSTER_ID_LIGHTING_COLOR_CONTROL, ATTRID_LIGHTING_COLOR_CONTROL_CURRENT_X );
+  hostTestRun( 3000 );
+  HOST_CHECK( test_Reports( ZCL_CLUSTER_ID_LIGHTING_COLOR_CONTROL, ATTRID_LIGHTING_COLOR_CONTROL_CURRENT_X,
+                            NULL ) == 0 );
+
+  zclColor_CurrentX++;
+  test_Changed( ZCL_CLUSTER_ID_LIGHTING_COLOR_CONTROL, ATTRID_LIGHTING_COLOR_CONTROL_CURRENT_X );
+  hostTestRun( 100 );
+  HOST_CHECK( test_Reports( ZCL_CLUSTER_ID_LIGHTING_COLOR_CONTROL, ATTRID_LIGHTING_COLOR_CONTROL_CURRENT_X,
+                            value ) == 1 );
+  HOST_CHECK( BUILD_UINT16( value[0], value[1] ) == zclColor_CurrentX );
+
+  // On/Off every 10 seconds, and on a change once a second has passed since the last report
+  HOST_CHECK( test_Configure( ZCL_CLUSTER_ID_GEN_ON_OFF, ATTRID_ON_OFF, ZCL_DATATYPE_BOOLEAN,
+                              1, 10, 0 ) == ZCL_STATUS_SUCCESS );
+  hostAfReset();
+  hostTestRun( 100 );
+  HOST_CHECK( test_Reports( ZCL_CLUSTER_ID_GEN_ON_OFF, ATTRID_ON_OFF, NULL ) == 1 );
+  hostAfReset();
+  hostTestRun( 30000 );
+  HOST_CHECK( test_Reports( ZCL_CLUSTER_ID_GEN_ON_OFF, ATTRID_ON_OFF, NULL ) == 3 );
+
+  // A second after the last one
+  hostTestRun( 1000 );
+  hostAfReset();
+  zllSampleLight_OnOff = LIGHT_ON;
+  test_Changed( ZCL_CLUSTER_ID_GEN_ON_OFF, ATTRID_ON_OFF );
+  hostTestRun( 100 );
+  HOST_CHECK( test_Reports( ZCL_CLUSTER_ID_GEN_ON_OFF, ATTRID_ON_OFF, value ) == 1 );
+  HOST_CHECK( value[0] == LIGHT_ON );
+  zllSampleLight_OnOff = LIGHT_OFF;
+  test_Changed( ZCL_CLUSTER_ID_GEN_ON_OFF, ATTRID_ON_OFF );
+  hostTestRun( 500 );
+  HOST_CHECK( test_Reports( ZCL_CLUSTER_ID_GEN_ON_OFF, ATTRID_ON_OFF, NULL ) == 1 );
+  hostTestRun( 500 );
+  HOST_CHECK( test_Reports( ZCL_CLUSTER_ID_GEN_ON_OFF, ATTRID_ON_OFF, value ) == 2 );
+  HOST_CHECK( value[0] == LIGHT_OFF );
+
+  // Current Level on a change of at least 5, unannounced changes included
+  HOST_CHECK( test_Configure( ZCL_CLUSTER_ID_GEN_LEVEL_CONTROL, ATTRID_LEVEL_CURRENT_LEVEL,
+                              ZCL_DATATYPE_UINT8, 0, 0, 5 ) == ZCL_STATUS_SUCCESS );
+  hostTestRun( 100 );
+  hostAfReset();
+  zclLevel_CurrentLevel -= 4;
+  test_Changed( ZCL_CLUSTER_ID_GEN_LEVEL_CONTROL, ATTRID_LEVEL_CURRENT_LEVEL );
+  hostTestRun( 1000 );
+  HOST_CHECK( test_Reports( ZCL_CLUSTER_ID_GEN_LEVEL_CONTROL, ATTRID_LEVEL_CURRENT_LEVEL, NULL ) == 0 );
+  zclLevel_CurrentLevel -= 1;
+  test_Changed( ZCL_CLUSTER_ID_GEN_LEVEL_CONTROL, ATTRID_LEVEL_CURRENT_LEVEL );
+  hostTestRun( 100 );
+  HOST_CHECK( test_Reports( ZCL_CLUSTER_ID_GEN_LEVEL_CONTROL, ATTRID_LEVEL_CURRENT_LEVEL, value ) == 1 );
+  HOST_CHECK( value[0] == zclLevel_CurrentLevel );
+
+  // A single precision value, configured by the application
+  dstAddr.addrMode = afAddr16Bit;
+  dstAddr.addr.shortAddr = TEST_ANALOG_DST;
+  dstAddr.endPoint = HOST_AF_PEER_EP;
+  dstAddr.panId = 0;
+  change = 0.5f;
+  cfg.direction = ZCL_SEND_ATTR_REPORTS;
+  cfg.attrID = TEST_ANALOG_ATTR;
+  cfg.dataType = ZCL_DATATYPE_SINGLE_PREC;
+  cfg.minReportInt = 0;
+  cfg.maxReportInt = 0;
+  cfg.reportableChange = (uint8 *)&change;
+  HOST_CHECK( zcl_ConfigReport( TEST_ANALOG_EP, TEST_ANALOG_CLUSTER, &dstAddr, &cfg ) == ZCL_STATUS_SUCCESS );
+  hostAfReset();
+  hostTestRun( 100 );
+  HOST_CHECK( test_Reports( TEST_ANALOG_CLUSTER, TEST_ANALOG_ATTR, NULL ) == 1 );
+  HOST_CHECK( (hostAfFrames[0].dstAddr.addr.shortAddr == TEST_ANALOG_DST) &&
+              (hostAfFrames[0].srcEP == TEST_ANALOG_EP) );
+
+  hostAfReset();
+  test_AnalogValue -= 0.25f;
+  zcl_AttrChanged( TEST_ANALOG_EP, TEST_ANALOG_CLUSTER, TEST_ANALOG_ATTR );
+  hostTestRun( 100 );
+  HOST_CHECK( test_Reports( TEST_ANALOG_CLUSTER, TEST_ANALOG_ATTR, NULL ) == 0 );
+  test_AnalogValue -= 0.25f;
+  zcl_AttrChanged( TEST_ANALOG_EP, TEST_ANALOG_CLUSTER, TEST_ANALOG_ATTR );
+  hostTestRun( 100 );
+  HOST_CHECK( test_Reports( TEST_ANALOG_CLUSTER, TEST_ANALOG_ATTR, value ) == 1 );
+  HOST_CHECK( osal_memcmp( value, &test_AnalogValue, sizeof( float ) ) );
+
+  change = 0.0f;
+  HOST_CHECK( zcl_ConfigReport( TEST_ANALOG_EP, TEST_ANALOG_CLUSTER, &dstAddr, &cfg ) == ZCL_STATUS_SUCCESS );
+  hostTestRun( 100 );
+  hostAfReset();
+  zcl_AttrChanged( TEST_ANALOG_EP, TEST_ANALOG_CLUSTER, TEST_ANALOG_ATTR );
+  hostTestRun( 1000 );
+  HOST_CHECK( test_Reports( TEST_ANALOG_CLUSTER, TEST_ANALOG_ATTR, NULL ) == 0 );
+  test_AnalogValue += 0.001f;
+  zcl_AttrChanged( TEST_ANALOG_EP, TEST_ANALOG_CLUSTER, TEST_ANALOG_ATTR );
+  hostTestRun( 100 );
+  HOST_CHECK( test_Reports( TEST_ANALOG_CLUSTER, TEST_ANALOG_ATTR, NULL ) == 1 );
+
+  // ZCL_REPORTING_OFF stops the On/Off reports
+  HOST_CHECK( test_Configure( ZCL_CLUSTER_ID_GEN_ON_OFF, ATTRID_ON_OFF, ZCL_DATATYPE_BOOLEAN,
+                              1, ZCL_REPORTING_OFF, 0 ) == ZCL_STATUS_SUCCESS );
+  hostAfReset();
+  hostTestRun( 30000 );
+  HOST_CHECK( test_Reports( ZCL_CLUSTER_ID_GEN_ON_OFF, ATTRID_ON_OFF, NULL ) == 0 );
+
+  // After a restart the configurations come back from NV and report the current values
+  zcl_Init( TEST_TASK_ZCL );
+  hostAfReset();
+  hostTestRun( 2100 );
+  HOST_CHECK( test_Reports( ZCL_CLUSTER_ID_LIGHTING_COLOR_CONTROL, ATTRID_LIGHTING_COLOR_CONTROL_CURRENT_X,
+                            NULL ) == 1 );
+  HOST_CHECK( test_Reports( ZCL_CLUSTER_ID_GEN_LEVEL_CONTROL, ATTRID_LEVEL_CURRENT_LEVEL, NULL ) == 1 );
+  HOST_CHECK( test_Reports( TEST_ANALOG_CLUSTER, TEST_ANALOG_ATTR, NULL ) == 1 );
+  HOST_CHECK( test_Reports( ZCL_CLUSTER_ID_GEN_ON_OFF, ATTRID_ON_OFF, NULL ) == 0 );
+
+  return hostTestResult( "test_zcl_report" );
+}
+
+/*********************************************************************
+*********************************************************************/
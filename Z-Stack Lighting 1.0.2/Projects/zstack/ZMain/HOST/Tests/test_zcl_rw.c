@@ -0,0 +1,304 @@
+/**************************************************************************************************
+  Filename:       test_zcl_rw.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host test of the in-place Read and Write Attributes processing.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "ZComDef.h"
+#include "hal_drivers.h"
+#include "OSAL.h"
+#include "OSAL_Tasks.h"
+#include "zcl.h"
+#include "zcl_general.h"
+#include "zcl_ll.h"
+#include "zll_samplelight.h"
+#include "host_af.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Writable attributes of a test cluster
+#define TEST_EP                    20
+#define TEST_CLUSTER               0xFC00
+#define TEST_ATTR_U16              0x0000
+#define TEST_ATTR_STR              0x0001
+#define TEST_ATTR_UNKNOWN          0x5000
+
+#define TEST_SEQ                   0x27
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+const pTaskEventHandlerFn tasksArr[] = {
+  Hal_ProcessEvent,
+  zcl_event_loop
+};
+
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt);
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt));
+
+  Hal_Init( 0 );
+  zcl_Init( 1 );
+}
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static uint16 test_U16;
+static uint8 test_Str[1 + MAX_UTF8_STRING_LEN];
+
+static CONST zclAttrRec_t test_Attrs[] =
+{
+  {
+    TEST_CLUSTER,
+    { // Attribute record
+      TEST_ATTR_U16,
+      ZCL_DATATYPE_UINT16,
+      (ACCESS_CONTROL_READ | ACCESS_CONTROL_WRITE),
+      (void *)&test_U16
+    }
+  },
+  {
+    TEST_CLUSTER,
+    { // Attribute record
+      TEST_ATTR_STR,
+      ZCL_DATATYPE_CHAR_STR,
+      (ACCESS_CONTROL_READ | ACCESS_CONTROL_WRITE),
+      (void *)test_Str
+    }
+  }
+};
+
+// Last bytes of a readable page, followed by one that cannot be read
+static uint8 *test_PageEnd;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+/*
+ * Map a page followed by a page that faults when read, so that a parser
+ * reading past the end of a payload placed at test_PageEnd crashes
+ */
+static void test_MapGuard( void )
+{
+  long page = sysconf( _SC_PAGESIZE );
+  uint8 *pMap;
+
+  pMap = mmap( NULL, 2 * page, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+  HOST_CHECK( pMap != MAP_FAILED );
+  HOST_CHECK( mprotect( pMap + page, page, PROT_NONE ) == 0 );
+
+  test_PageEnd = pMap + page;
+}
+
+/*
+ * Copy the write records to the end of the readable page and return the
+ * number of them that the iterator parses, and the last one
+ */
+static uint8 test_ParseAtEnd( const uint8 *pRecs, uint16 len, zclWriteRec_t *pLast )
+{
+  zclParseIter_t iter;
+  zclWriteRec_t rec;
+  uint8 *pBuf = test_PageEnd - len;
+  uint8 cnt = 0;
+
+  osal_memcpy( pBuf, pRecs, len );
+
+  zcl_ParseIterInit( &iter, pBuf, len );
+  while ( zcl_ParseNextWriteRec( &iter, &rec ) )
+  {
+    *pLast = rec;
+    cnt++;
+  }
+
+  return ( cnt );
+}
+
+/*
+ * Hand a request to ZCL and count the heap allocations of its
+ * processing, the received message included
+ */
+static uint16 test_Request( uint8 endpoint, uint16 clusterID, uint8 *pReq, uint16 len )
+{
+  uint16 seq = osal_mem_trace_seq();
+  uint16 allocs = 0;
+  osalMemTrace_t rec;
+
+  hostAfReset();
+  hostAfReceive( endpoint, clusterID, pReq, len );
+  hostTestRun( 10 );
+
+  for ( ; seq != osal_mem_trace_seq(); seq++ )
+  {
+    if ( osal_mem_trace_get( seq, &rec ) && ( rec.op == OSALMEM_TRACE_ALLOC ) )
+    {
+      allocs++;
+    }
+  }
+
+  return ( allocs );
+}
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   Read and Write Attributes records are parsed in place from
+ *          the received payload, without reading past its end however
+ *          the last record is cut. A request takes one allocation besides
+ *          the received message - the response frame - and leaves the
+ *          heap as it found it.
+ */
+int main( void )
+{
+  static const uint8 recU16[] = { LO_UINT16( TEST_ATTR_U16 ), HI_UINT16( TEST_ATTR_U16 ),
+                                  ZCL_DATATYPE_UINT16, 0x34, 0x12 };
+  static const uint8 recStr[] = { LO_UINT16( TEST_ATTR_STR ), HI_UINT16( TEST_ATTR_STR ),
+                                  ZCL_DATATYPE_CHAR_STR, 2, 'a', 'b' };
+  static const uint8 noLen[] = { 0x01, 0x00, ZCL_DATATYPE_CHAR_STR };
+  static const uint8 halfLen[] = { 0x01, 0x00, ZCL_DATATYPE_LONG_OCTET_STR, 0x05 };
+  static const uint8 shortStr[] = { 0x01, 0x00, ZCL_DATATYPE_OCTET_STR, 5, 'a', 'b' };
+  static const uint8 shortU32[] = { 0x01, 0x00, ZCL_DATATYPE_UINT32, 0x01, 0x02 };
+  uint8 recs[sizeof( recU16 ) + sizeof( recStr )];
+  uint8 req[32];
+  zclWriteRec_t rec;
+  uint8 *pRsp;
+  uint16 heapUsed;
+
+  hostTestBoot();
+  test_MapGuard();
+  hostAfRegister( SAMPLELIGHT_ENDPOINT, ZLL_PROFILE_ID );
+  hostAfRegister( TEST_EP, ZLL_PROFILE_ID );
+  HOST_CHECK( zcl_registerAttrList( SAMPLELIGHT_ENDPOINT, SAMPLELIGHT_NUM_ATTRIBUTES,
+                                    zllSampleLight_Attrs ) == ZSuccess );
+  HOST_CHECK( zcl_registerAttrList( TEST_EP, sizeof( test_Attrs ) / sizeof( test_Attrs[0] ),
+                                    test_Attrs ) == ZSuccess );
+
+  // Complete records, in place
+  HOST_CHECK( test_ParseAtEnd( recU16, 0, &rec ) == 0 );
+  HOST_CHECK( test_ParseAtEnd( recU16, sizeof( recU16 ), &rec ) == 1 );
+  HOST_CHECK( ( rec.attrID == TEST_ATTR_U16 ) && ( rec.dataType == ZCL_DATATYPE_UINT16 ) &&
+              ( rec.attrData == test_PageEnd - 2 ) );
+  osal_memcpy( recs, recU16, sizeof( recU16 ) );
+  osal_memcpy( recs + sizeof( recU16 ), recStr, sizeof( recStr ) );
+  HOST_CHECK( test_ParseAtEnd( recs, sizeof( recs ), &rec ) == 2 );
+  HOST_CHECK( ( rec.attrID == TEST_ATTR_STR ) && ( rec.attrData[0] == 2 ) &&
+              ( rec.attrData[2] == 'b' ) );
+
+  // A cut record is not parsed, and nothing past the payload is read
+  HOST_CHECK( test_ParseAtEnd( recU16, sizeof( recU16 ) - 1, &rec ) == 0 );
+  HOST_CHECK( test_ParseAtEnd( recU16, 2, &rec ) == 0 );
+  HOST_CHECK( test_ParseAtEnd( noLen, sizeof( noLen ), &rec ) == 0 );
+  HOST_CHECK( test_ParseAtEnd( halfLen, sizeof( halfLen ), &rec ) == 0 );
+  HOST_CHECK( test_ParseAtEnd( shortStr, sizeof( shortStr ), &rec ) == 0 );
+  HOST_CHECK( test_ParseAtEnd( shortU32, sizeof( shortU32 ), &rec ) == 0 );
+  osal_memcpy( recs, recU16, sizeof( recU16 ) );
+  osal_memcpy( recs + sizeof( recU16 ), noLen, sizeof( noLen ) );
+  HOST_CHECK( test_ParseAtEnd( recs, sizeof( recU16 ) + sizeof( noLen ), &rec ) == 1 );
+  HOST_CHECK( rec.attrID == TEST_ATTR_U16 );
+
+  // Read Attributes: a record per attribute, in the response frame alone
+  heapUsed = osal_heap_mem_used();
+  req[0] = ZCL_FRAME_TYPE_PROFILE_CMD;
+  req[1] = TEST_SEQ;
+  req[2] = ZCL_CMD_READ;
+  req[3] = LO_UINT16( ATTRID_ON_OFF );
+  req[4] = HI_UINT16( ATTRID_ON_OFF );
+  req[5] = LO_UINT16( TEST_ATTR_UNKNOWN );
+  req[6] = HI_UINT16( TEST_ATTR_UNKNOWN );
+  HOST_CHECK( test_Request( SAMPLELIGHT_ENDPOINT, ZCL_CLUSTER_ID_GEN_ON_OFF, req, 7 ) == 2 );
+  HOST_CHECK( osal_heap_mem_used() == heapUsed );
+  HOST_CHECK( hostAfFrameCnt == 1 );
+  pRsp = hostAfFrames[0].data;
+  HOST_CHECK( ( hostAfFrames[0].len == 3 + 5 + 3 ) && ( pRsp[1] == TEST_SEQ ) &&
+              ( pRsp[2] == ZCL_CMD_READ_RSP ) );
+  HOST_CHECK( ( BUILD_UINT16( pRsp[3], pRsp[4] ) == ATTRID_ON_OFF ) &&
+              ( pRsp[5] == ZCL_STATUS_SUCCESS ) && ( pRsp[6] == ZCL_DATATYPE_BOOLEAN ) &&
+              ( pRsp[7] == zllSampleLight_OnOff ) );
+  HOST_CHECK( ( BUILD_UINT16( pRsp[8], pRsp[9] ) == TEST_ATTR_UNKNOWN ) &&
+              ( pRsp[10] == ZCL_STATUS_UNSUPPORTED_ATTRIBUTE ) );
+
+  // A cut attribute ID is left out
+  HOST_CHECK( test_Request( SAMPLELIGHT_ENDPOINT, ZCL_CLUSTER_ID_GEN_ON_OFF, req, 6 ) == 2 );
+  HOST_CHECK( ( hostAfFrameCnt == 1 ) && ( hostAfFrames[0].len == 3 + 5 ) );
+
+  // Write Attributes: the records that are complete are written
+  req[2] = ZCL_CMD_WRITE;
+  osal_memcpy( &req[3], recU16, sizeof( recU16 ) );
+  osal_memcpy( &req[3 + sizeof( recU16 )], recStr, sizeof( recStr ) );
+  HOST_CHECK( test_Request( TEST_EP, TEST_CLUSTER, req, 3 + sizeof( recs ) ) == 2 );
+  HOST_CHECK( osal_heap_mem_used() == heapUsed );
+  HOST_CHECK( ( test_U16 == 0x1234 ) && ( test_Str[0] == 2 ) && ( test_Str[2] == 'b' ) );
+  HOST_CHECK( ( hostAfFrameCnt == 1 ) && ( hostAfFrames[0].len == 4 ) &&
+              ( hostAfFrames[0].data[1] == TEST_SEQ ) &&
+              ( hostAfFrames[0].data[2] == ZCL_CMD_WRITE_RSP ) &&
+              ( hostAfFrames[0].data[3] == ZCL_STATUS_SUCCESS ) );
+
+  req[6] = 0x78;
+  osal_memcpy( &req[3 + sizeof( recU16 )], halfLen, sizeof( halfLen ) );
+  HOST_CHECK( test_Request( TEST_EP, TEST_CLUSTER, req, 3 + sizeof( recU16 ) + sizeof( halfLen ) ) == 2 );
+  HOST_CHECK( test_U16 == 0x1278 );
+  HOST_CHECK( ( hostAfFrameCnt == 1 ) && ( hostAfFrames[0].data[3] == ZCL_STATUS_SUCCESS ) );
+
+  // A record that is not written gets a status record
+  req[5] = ZCL_DATATYPE_INT16;
+  HOST_CHECK( test_Request( TEST_EP, TEST_CLUSTER, req, 3 + sizeof( recU16 ) ) == 2 );
+  HOST_CHECK( test_U16 == 0x1278 );
+  HOST_CHECK( ( hostAfFrameCnt == 1 ) && ( hostAfFrames[0].len == 3 + 3 ) &&
+              ( hostAfFrames[0].data[3] == ZCL_STATUS_INVALID_DATA_TYPE ) &&
+              ( BUILD_UINT16( hostAfFrames[0].data[4], hostAfFrames[0].data[5] ) == TEST_ATTR_U16 ) );
+  HOST_CHECK( osal_heap_mem_used() == heapUsed );
+
+  return hostTestResult( "test_zcl_rw" );
+}
+
+/*********************************************************************
+*********************************************************************/
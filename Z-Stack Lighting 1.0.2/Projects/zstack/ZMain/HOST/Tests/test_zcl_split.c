@@ -0,0 +1,347 @@
+/**************************************************************************************************
+  Filename:       test_zcl_split.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host test of the ZCL read responses and reports split by the MTU.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include "ZComDef.h"
+#include "hal_drivers.h"
+#include "OSAL.h"
+#include "OSAL_Tasks.h"
+#include "zcl.h"
+#include "zcl_ll.h"
+#include "host_af.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Attributes of a test cluster, the last one a string
+#define TEST_EP                    20
+#define TEST_CLUSTER               0xFC00
+#define TEST_NUM_U16               6
+#define TEST_ATTR_STR              TEST_NUM_U16
+
+// Records of the u16 attributes
+#define TEST_READ_REC_LEN          6
+#define TEST_REPORT_REC_LEN        5
+
+// MTU of two read or report records, too small for the string attribute
+#define TEST_MTU                   (3 + (2 * TEST_READ_REC_LEN))
+#define TEST_STR_LEN               20
+
+#define TEST_SEQ                   0x40
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+const pTaskEventHandlerFn tasksArr[] = {
+  Hal_ProcessEvent,
+  zcl_event_loop
+};
+
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt);
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt));
+
+  Hal_Init( 0 );
+  zcl_Init( 1 );
+}
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static uint16 test_Vals[TEST_NUM_U16];
+static uint8 test_Str[1 + TEST_STR_LEN];
+
+#define TEST_ATTR( id ) \
+  { TEST_CLUSTER, { (id), ZCL_DATATYPE_UINT16, ACCESS_CONTROL_READ, (void *)&test_Vals[id] } }
+
+static CONST zclAttrRec_t test_Attrs[] =
+{
+  TEST_ATTR( 0 ), TEST_ATTR( 1 ), TEST_ATTR( 2 ),
+  TEST_ATTR( 3 ), TEST_ATTR( 4 ), TEST_ATTR( 5 ),
+  {
+    TEST_CLUSTER,
+    { // Attribute record
+      TEST_ATTR_STR,
+      ZCL_DATATYPE_CHAR_STR,
+      ACCESS_CONTROL_READ,
+      (void *)test_Str
+    }
+  }
+};
+
+// Payloads of the frames sent, one after the other
+static uint8 test_Payload[256];
+static uint16 test_PayloadLen;
+
+// Heap trace sequence number at test_AllocStart()
+static uint16 test_AllocSeq;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+static void test_AllocStart( void )
+{
+  test_AllocSeq = osal_mem_trace_seq();
+}
+
+/*
+ * Allocations since test_AllocStart()
+ */
+static uint16 test_Allocs( void )
+{
+  uint16 allocs = 0;
+  osalMemTrace_t rec;
+
+  for ( ; test_AllocSeq != osal_mem_trace_seq(); test_AllocSeq++ )
+  {
+    if ( osal_mem_trace_get( test_AllocSeq, &rec ) && ( rec.op == OSALMEM_TRACE_ALLOC ) )
+    {
+      allocs++;
+    }
+  }
+
+  return ( allocs );
+}
+
+/*
+ * Check the frames sent: no longer than the MTU, with the same command
+ * and consecutive sequence numbers from seqNum, or all with seqNum.
+ * Their payloads are put together in test_Payload.
+ */
+static void test_CheckFrames( uint8 cmd, uint8 seqNum, uint8 consecutive )
+{
+  uint16 x;
+
+  test_PayloadLen = 0;
+
+  HOST_CHECK( ( hostAfFrameCnt > 0 ) && ( hostAfFrameCnt <= HOST_AF_FRAMES ) );
+  for ( x = 0; ( x < hostAfFrameCnt ) && ( x < HOST_AF_FRAMES ); x++ )
+  {
+    hostAfFrame_t *pFrame = &hostAfFrames[x];
+
+    HOST_CHECK( ( pFrame->len > 3 ) && ( pFrame->len <= hostAfMtu ) );
+    HOST_CHECK( ( pFrame->data[1] == seqNum ) && ( pFrame->data[2] == cmd ) );
+
+    osal_memcpy( &test_Payload[test_PayloadLen], &pFrame->data[3], pFrame->len - 3 );
+    test_PayloadLen += pFrame->len - 3;
+
+    if ( consecutive )
+    {
+      seqNum++;
+    }
+  }
+}
+
+/*
+ * Read all the test attributes over the air with the given sequence number
+ */
+static void test_Read( uint8 seqNum )
+{
+  uint8 req[3 + (sizeof( test_Attrs ) / sizeof( test_Attrs[0] )) * 2];
+  uint8 x;
+
+  req[0] = ZCL_FRAME_TYPE_PROFILE_CMD;
+  req[1] = seqNum;
+  req[2] = ZCL_CMD_READ;
+  for ( x = 0; x < sizeof( test_Attrs ) / sizeof( test_Attrs[0] ); x++ )
+  {
+    req[3 + (x * 2)] = LO_UINT16( test_Attrs[x].attr.attrId );
+    req[4 + (x * 2)] = HI_UINT16( test_Attrs[x].attr.attrId );
+  }
+
+  hostAfReset();
+  hostAfReceive( TEST_EP, TEST_CLUSTER, req, sizeof( req ) );
+  hostTestRun( 10 );
+}
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   Read responses and reports longer than the MTU are split
+ *          into frames that together carry the records of a single
+ *          frame, built in one allocation. All the frames of a response
+ *          keep the sequence number of the request, and zcl_SeqNum is
+ *          left alone. The frames of a report take consecutive numbers
+ *          from zcl_SeqNum. A value too long for any frame is answered
+ *          with INSUFFICIENT_SPACE, or left out of a report.
+ */
+int main( void )
+{
+  uint8 whole[256];
+  uint16 wholeLen;
+  afAddrType_t dstAddr;
+  zclReadRspCmd_t *pReadRsp;
+  zclReportCmd_t *pReport;
+  uint8 seqNum;
+  uint8 x;
+
+  hostTestBoot();
+  hostAfRegister( TEST_EP, ZLL_PROFILE_ID );
+  HOST_CHECK( zcl_registerAttrList( TEST_EP, sizeof( test_Attrs ) / sizeof( test_Attrs[0] ),
+                                    test_Attrs ) == ZSuccess );
+  for ( x = 0; x < TEST_NUM_U16; x++ )
+  {
+    test_Vals[x] = 0x1100 * (x + 1);
+  }
+  test_Str[0] = TEST_STR_LEN;
+  osal_memset( &test_Str[1], 's', TEST_STR_LEN );
+
+  // The whole response fits in one frame
+  test_AllocStart();
+  test_Read( TEST_SEQ );
+  HOST_CHECK( test_Allocs() == 2 );
+  HOST_CHECK( hostAfFrameCnt == 1 );
+  test_CheckFrames( ZCL_CMD_READ_RSP, TEST_SEQ, FALSE );
+  HOST_CHECK( test_PayloadLen == (TEST_NUM_U16 * TEST_READ_REC_LEN) + 5 + TEST_STR_LEN );
+  wholeLen = test_PayloadLen;
+  osal_memcpy( whole, test_Payload, wholeLen );
+
+  // Split, with the sequence number of the request in every frame
+  hostAfMtu = TEST_MTU;
+  seqNum = zcl_SeqNum;
+  test_AllocStart();
+  test_Read( TEST_SEQ );
+  HOST_CHECK( test_Allocs() == 2 );
+  HOST_CHECK( hostAfFrameCnt == TEST_NUM_U16 / 2 + 1 );
+  test_CheckFrames( ZCL_CMD_READ_RSP, TEST_SEQ, FALSE );
+  HOST_CHECK( zcl_SeqNum == seqNum );
+
+  // The string doesn't fit in any frame
+  wholeLen = TEST_NUM_U16 * TEST_READ_REC_LEN;
+  HOST_CHECK( test_PayloadLen == wholeLen + 3 );
+  HOST_CHECK( osal_memcmp( test_Payload, whole, wholeLen ) );
+  HOST_CHECK( ( BUILD_UINT16( test_Payload[wholeLen], test_Payload[wholeLen + 1] ) == TEST_ATTR_STR ) &&
+              ( test_Payload[wholeLen + 2] == ZCL_STATUS_INSUFFICIENT_SPACE ) );
+
+  // A peer's sequence number equal to ours doesn't change ours
+  test_Read( zcl_SeqNum );
+  test_CheckFrames( ZCL_CMD_READ_RSP, seqNum, FALSE );
+  HOST_CHECK( zcl_SeqNum == seqNum );
+  test_Read( zcl_SeqNum - 1 );
+  test_CheckFrames( ZCL_CMD_READ_RSP, seqNum - 1, FALSE );
+  HOST_CHECK( zcl_SeqNum == seqNum );
+
+  dstAddr.addrMode = afAddr16Bit;
+  dstAddr.addr.shortAddr = HOST_AF_PEER_ADDR;
+  dstAddr.endPoint = HOST_AF_PEER_EP;
+  dstAddr.panId = 0;
+
+  // A response sent by the application is split the same way
+  pReadRsp = osal_mem_alloc( sizeof( zclReadRspCmd_t ) + (TEST_NUM_U16 * sizeof( zclReadRspStatus_t )) );
+  HOST_CHECK( pReadRsp != NULL );
+  pReadRsp->numAttr = TEST_NUM_U16;
+  for ( x = 0; x < TEST_NUM_U16; x++ )
+  {
+    pReadRsp->attrList[x].attrID = x;
+    pReadRsp->attrList[x].status = ZCL_STATUS_SUCCESS;
+    pReadRsp->attrList[x].dataType = ZCL_DATATYPE_UINT16;
+    pReadRsp->attrList[x].data = (uint8 *)&test_Vals[x];
+  }
+  hostAfReset();
+  test_AllocStart();
+  HOST_CHECK( zcl_SendReadRsp( TEST_EP, &dstAddr, TEST_CLUSTER, pReadRsp,
+                               ZCL_FRAME_SERVER_CLIENT_DIR, TRUE, TEST_SEQ ) == ZSuccess );
+  HOST_CHECK( test_Allocs() == 1 );
+  HOST_CHECK( hostAfFrameCnt == TEST_NUM_U16 / 2 );
+  test_CheckFrames( ZCL_CMD_READ_RSP, TEST_SEQ, FALSE );
+  HOST_CHECK( ( test_PayloadLen == wholeLen ) && osal_memcmp( test_Payload, whole, wholeLen ) );
+  HOST_CHECK( zcl_SeqNum == seqNum );
+  osal_mem_free( pReadRsp );
+
+  // A report takes consecutive sequence numbers from zcl_SeqNum
+  pReport = osal_mem_alloc( sizeof( zclReportCmd_t ) + ((TEST_NUM_U16 + 1) * sizeof( zclReport_t )) );
+  HOST_CHECK( pReport != NULL );
+  pReport->numAttr = TEST_NUM_U16 + 1;
+  for ( x = 0; x < TEST_NUM_U16; x++ )
+  {
+    pReport->attrList[x].attrID = x;
+    pReport->attrList[x].dataType = ZCL_DATATYPE_UINT16;
+    pReport->attrList[x].attrData = (uint8 *)&test_Vals[x];
+  }
+  pReport->attrList[x].attrID = TEST_ATTR_STR;
+  pReport->attrList[x].dataType = ZCL_DATATYPE_CHAR_STR;
+  pReport->attrList[x].attrData = test_Str;
+
+  hostAfReset();
+  test_AllocStart();
+  HOST_CHECK( zcl_SendReportCmd( TEST_EP, &dstAddr, TEST_CLUSTER, pReport,
+                                 ZCL_FRAME_SERVER_CLIENT_DIR, TRUE, zcl_SeqNum++ ) == ZSuccess );
+  HOST_CHECK( test_Allocs() == 1 );
+  HOST_CHECK( hostAfFrameCnt == TEST_NUM_U16 / 2 );
+  test_CheckFrames( ZCL_CMD_REPORT, seqNum, TRUE );
+  HOST_CHECK( zcl_SeqNum == (uint8)(seqNum + TEST_NUM_U16 / 2) );
+
+  // The string is left out
+  HOST_CHECK( test_PayloadLen == TEST_NUM_U16 * TEST_REPORT_REC_LEN );
+  for ( x = 0; x < TEST_NUM_U16; x++ )
+  {
+    uint8 *pRec = &test_Payload[x * TEST_REPORT_REC_LEN];
+
+    HOST_CHECK( ( BUILD_UINT16( pRec[0], pRec[1] ) == x ) && ( pRec[2] == ZCL_DATATYPE_UINT16 ) &&
+                ( BUILD_UINT16( pRec[3], pRec[4] ) == test_Vals[x] ) );
+  }
+
+  // Unsplit at a larger MTU
+  hostAfMtu = 80;
+  seqNum = zcl_SeqNum;
+  hostAfReset();
+  HOST_CHECK( zcl_SendReportCmd( TEST_EP, &dstAddr, TEST_CLUSTER, pReport,
+                                 ZCL_FRAME_SERVER_CLIENT_DIR, TRUE, zcl_SeqNum++ ) == ZSuccess );
+  HOST_CHECK( hostAfFrameCnt == 1 );
+  test_CheckFrames( ZCL_CMD_REPORT, seqNum, TRUE );
+  HOST_CHECK( test_PayloadLen == (TEST_NUM_U16 * TEST_REPORT_REC_LEN) + 4 + TEST_STR_LEN );
+  HOST_CHECK( zcl_SeqNum == (uint8)(seqNum + 1) );
+  osal_mem_free( pReport );
+
+  return hostTestResult( "test_zcl_split" );
+}
+
+/*********************************************************************
+*********************************************************************/
@@ -0,0 +1,473 @@
+/**************************************************************************************************
+  Filename:       heap_trace.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Offline analyzer of the OSAL heap trace streamed out over MT.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * This tool reads a heap trace streamed out with MT_SYS_HEAP_TRACE
+ * (see MT_SysHeapTrace() in MT_SYS.c) and reports:
+ *  - the fragmentation over time: blocks and bytes in use, free blocks;
+ *  - the longest-lived allocations, by caller;
+ *  - the allocations that are never freed; those made at start-up,
+ *    before the first free, are the candidates for the long-lived
+ *    bucket sized by OSALMEM_LL_BLKSZ.
+ *
+ * Input: the data field of each MT_SYS_HEAP_TRACE_IND, as hex bytes,
+ * one indication per line. Blank lines and lines starting with '#' are
+ * skipped. To size OSALMEM_LL_BLKSZ the trace must start at power-up,
+ * so build with an OSALMEM_TRACE_CNT big enough to hold the start-up.
+ *
+ * Usage: heap_trace [-w workload] [-n rows] trace
+ *   -w  also write the trace as a workload for bench_heap
+ *   -n  rows of the fragmentation table (default 20)
+ */
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include <ctype.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define HEAP_TRACE_ALLOC           'A'
+#define HEAP_TRACE_FREE            'F'
+#define HEAP_TRACE_FAILED          0xFFFF
+
+// Fixed part of an MT_SYS_HEAP_TRACE_IND, before the file name
+#define HEAP_TRACE_IND_LEN         16
+#define HEAP_TRACE_FNAME_MAX       32
+
+#define HEAP_TRACE_TOP             10
+#define HEAP_TRACE_SLOTS           1024
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+typedef struct
+{
+  uint16_t seq;
+  uint8_t  op;
+  uint16_t size;
+  uint16_t offset;
+  uint16_t blkFree;
+  uint32_t time;
+  uint16_t lnum;
+  char     fname[HEAP_TRACE_FNAME_MAX + 1];
+} heapTraceRec_t;
+
+// An allocation and how long it lived
+typedef struct
+{
+  const heapTraceRec_t *pAlloc;
+  uint32_t life;
+  int      live;     // still allocated at the end of the trace
+} heapTraceLife_t;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static heapTraceRec_t *traceRecs;
+static size_t traceCnt;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+/*********************************************************************
+ * @fn      heapTraceParse
+ *
+ * @brief   Decode one line of hex bytes into a trace record.
+ *
+ * @param   line - text of the line
+ * @param   pRec - record to fill in
+ *
+ * @return  1 for a record, 0 for a line to skip, -1 for a bad line
+ */
+static int heapTraceParse( const char *line, heapTraceRec_t *pRec )
+{
+  uint8_t buf[HEAP_TRACE_IND_LEN + HEAP_TRACE_FNAME_MAX];
+  size_t len = 0;
+  unsigned byte;
+  int n;
+
+  while ( isspace( (unsigned char)*line ) )
+  {
+    line++;
+  }
+  if ( (*line == '\0') || (*line == '#') )
+  {
+    return 0;
+  }
+
+  while ( *line != '\0' )
+  {
+    if ( isspace( (unsigned char)*line ) )
+    {
+      line++;
+    }
+    else if ( (len < sizeof( buf )) && (sscanf( line, "%2x%n", &byte, &n ) == 1) && (n == 2) )
+    {
+      buf[len++] = (uint8_t)byte;
+      line += 2;
+    }
+    else
+    {
+      return -1;
+    }
+  }
+
+  if ( (len < HEAP_TRACE_IND_LEN) || (len != (size_t)HEAP_TRACE_IND_LEN + buf[15]) )
+  {
+    return -1;
+  }
+
+  pRec->seq = buf[0] | (buf[1] << 8);
+  pRec->op = buf[2];
+  pRec->size = buf[3] | (buf[4] << 8);
+  pRec->offset = buf[5] | (buf[6] << 8);
+  pRec->blkFree = buf[7] | (buf[8] << 8);
+  pRec->time = buf[9] | (buf[10] << 8) | ((uint32_t)buf[11] << 16) | ((uint32_t)buf[12] << 24);
+  pRec->lnum = buf[13] | (buf[14] << 8);
+  memcpy( pRec->fname, buf + HEAP_TRACE_IND_LEN, buf[15] );
+  pRec->fname[buf[15]] = '\0';
+
+  return ( ((pRec->op == HEAP_TRACE_ALLOC) || (pRec->op == HEAP_TRACE_FREE)) ? 1 : -1 );
+}
+
+/*********************************************************************
+ * @fn      heapTraceLoad
+ *
+ * @brief   Read all of the records of a trace file.
+ *
+ * @param   fname - trace file
+ *
+ * @return  0 on success
+ */
+static int heapTraceLoad( const char *fname )
+{
+  FILE *fp = fopen( fname, "r" );
+  char line[512];
+  size_t size = 0;
+  unsigned lineNum = 0;
+
+  if ( fp == NULL )
+  {
+    fprintf( stderr, "heap_trace: cannot read %s\n", fname );
+    return -1;
+  }
+
+  while ( fgets( line, sizeof( line ), fp ) != NULL )
+  {
+    heapTraceRec_t rec;
+    int rtrn;
+
+    lineNum++;
+    rtrn = heapTraceParse( line, &rec );
+    if ( rtrn < 0 )
+    {
+      fprintf( stderr, "heap_trace: %s:%u: not a heap trace indication\n", fname, lineNum );
+      continue;
+    }
+    if ( rtrn == 0 )
+    {
+      continue;
+    }
+
+    if ( traceCnt == size )
+    {
+      size = size ? (size * 2) : 256;
+      traceRecs = realloc( traceRecs, size * sizeof( heapTraceRec_t ) );
+      if ( traceRecs == NULL )
+      {
+        fclose( fp );
+        return -1;
+      }
+    }
+    traceRecs[traceCnt++] = rec;
+  }
+
+  fclose( fp );
+
+  return 0;
+}
+
+/*********************************************************************
+ * @fn      heapTraceLifeCmp
+ *
+ * @brief   qsort() order: longest-lived first.
+ */
+static int heapTraceLifeCmp( const void *a, const void *b )
+{
+  const heapTraceLife_t *pA = a, *pB = b;
+
+  return ( (pA->life < pB->life) - (pA->life > pB->life) );
+}
+
+/*********************************************************************
+ * @fn      heapTraceReport
+ *
+ * @brief   Print the fragmentation over time, the longest-lived
+ *          allocations and the long-lived bucket candidates.
+ *
+ * @param   rows - rows of the fragmentation table
+ * @param   fpWork - workload file to write for bench_heap, or NULL
+ *
+ * @return  none
+ */
+static void heapTraceReport( unsigned rows, FILE *fpWork )
+{
+  // Allocation live at each heap offset, and its bench_heap slot
+  static const heapTraceRec_t *live[65536];
+  static uint16_t slotOf[65536];
+  static uint8_t slotUsed[HEAP_TRACE_SLOTS];
+  heapTraceLife_t *lives = calloc( traceCnt, sizeof( heapTraceLife_t ) );
+  size_t i, lifeCnt = 0, step;
+  uint32_t endTime = traceRecs[traceCnt - 1].time;
+  unsigned blkUsed = 0, bytesUsed = 0, lost = 0, failed = 0, unknown = 0;
+  unsigned peakFree = 0, liveCnt = 0, llCnt = 0, llBytes = 0;
+  size_t firstFree = traceCnt;
+
+  step = (rows && (traceCnt > rows)) ? ((traceCnt + rows - 1) / rows) : 1;
+
+  printf( "Fragmentation over time\n" );
+  printf( "     seq      time ms  blocks used  bytes used  free blocks\n" );
+
+  for ( i = 0; i < traceCnt; i++ )
+  {
+    const heapTraceRec_t *pRec = traceRecs + i;
+
+    if ( (i != 0) && (pRec->seq != (uint16_t)(traceRecs[i - 1].seq + 1)) )
+    {
+      lost += (uint16_t)(pRec->seq - traceRecs[i - 1].seq - 1);
+    }
+
+    if ( (pRec->op == HEAP_TRACE_FREE) && (firstFree == traceCnt) )
+    {
+      firstFree = i;
+    }
+
+    if ( pRec->op == HEAP_TRACE_ALLOC )
+    {
+      if ( pRec->offset == HEAP_TRACE_FAILED )
+      {
+        failed++;
+      }
+      else
+      {
+        uint16_t slot;
+
+        live[pRec->offset] = pRec;
+        blkUsed++;
+        bytesUsed += pRec->size;
+
+        for ( slot = 0; (slot < HEAP_TRACE_SLOTS) && slotUsed[slot]; slot++ );
+        if ( fpWork && (slot < HEAP_TRACE_SLOTS) )
+        {
+          slotUsed[slot] = 1;
+          slotOf[pRec->offset] = slot;
+          fprintf( fpWork, "a %u %u\n", slot, pRec->size );
+        }
+      }
+    }
+    else if ( live[pRec->offset] != NULL )
+    {
+      const heapTraceRec_t *pAlloc = live[pRec->offset];
+
+      lives[lifeCnt].pAlloc = pAlloc;
+      lives[lifeCnt].life = pRec->time - pAlloc->time;
+      lifeCnt++;
+
+      blkUsed--;
+      bytesUsed -= pAlloc->size;
+      live[pRec->offset] = NULL;
+
+      if ( fpWork && slotUsed[slotOf[pRec->offset]] )
+      {
+        slotUsed[slotOf[pRec->offset]] = 0;
+        fprintf( fpWork, "f %u\n", slotOf[pRec->offset] );
+      }
+    }
+    else
+    {
+      // Allocated before the start of the trace
+      unknown++;
+    }
+
+    if ( pRec->blkFree > peakFree )
+    {
+      peakFree = pRec->blkFree;
+    }
+
+    if ( ((i % step) == 0) || (i == traceCnt - 1) )
+    {
+      printf( "%8u  %11lu  %11u  %10u  %11u\n", pRec->seq, (unsigned long)pRec->time,
+              blkUsed, bytesUsed, pRec->blkFree );
+    }
+  }
+
+  printf( "\n%lu records, %u lost, %u failed allocations, %u frees of earlier allocations\n",
+          (unsigned long)traceCnt, lost, failed, unknown );
+  printf( "Peak free blocks: %u\n", peakFree );
+
+  // Allocations still live at the end of the trace
+  for ( i = 0; i < 65536; i++ )
+  {
+    if ( live[i] != NULL )
+    {
+      lives[lifeCnt].pAlloc = live[i];
+      lives[lifeCnt].life = endTime - live[i]->time;
+      lives[lifeCnt].live = 1;
+      lifeCnt++;
+      liveCnt++;
+
+      if ( (size_t)(live[i] - traceRecs) < firstFree )
+      {
+        llCnt++;
+        llBytes += live[i]->size;
+      }
+    }
+  }
+
+  qsort( lives, lifeCnt, sizeof( heapTraceLife_t ), heapTraceLifeCmp );
+
+  printf( "\nLongest-lived allocations\n" );
+  printf( "   life ms   size  caller\n" );
+  for ( i = 0; (i < lifeCnt) && (i < HEAP_TRACE_TOP); i++ )
+  {
+    const heapTraceRec_t *pAlloc = lives[i].pAlloc;
+
+    printf( "%10lu%s  %5u  %s:%u\n", (unsigned long)lives[i].life, lives[i].live ? "+" : " ",
+            pAlloc->size, pAlloc->fname[0] ? pAlloc->fname : "(library)", pAlloc->lnum );
+  }
+  printf( "(+ still allocated at the end of the trace)\n" );
+
+  printf( "\nNever freed: %u allocations, %u of them at start-up (*)\n", liveCnt, llCnt );
+  for ( i = 0; i < lifeCnt; i++ )
+  {
+    if ( lives[i].live )
+    {
+      printf( "  %5u%s %s:%u\n", lives[i].pAlloc->size,
+              ((size_t)(lives[i].pAlloc - traceRecs) < firstFree) ? "*" : " ",
+              lives[i].pAlloc->fname[0] ? lives[i].pAlloc->fname : "(library)",
+              lives[i].pAlloc->lnum );
+    }
+  }
+
+  if ( llCnt != 0 )
+  {
+    printf( "If the trace starts at power-up, size the long-lived bucket with:\n" );
+    printf( "  #define OSALMEM_LL_BLKSZ  (OSALMEM_ROUND(%u) + (%u * OSALMEM_HDRSZ))\n",
+            llBytes, llCnt );
+  }
+
+  free( lives );
+}
+
+/*********************************************************************
+ * @fn      main
+ */
+int main( int argc, char **argv )
+{
+  const char *workName = NULL;
+  unsigned rows = 20;
+  FILE *fpWork = NULL;
+  int i;
+
+  for ( i = 1; (i < argc - 1) && (argv[i][0] == '-'); i++ )
+  {
+    if ( (strcmp( argv[i], "-w" ) == 0) && (i < argc - 2) )
+    {
+      workName = argv[++i];
+    }
+    else if ( (strcmp( argv[i], "-n" ) == 0) && (i < argc - 2) )
+    {
+      rows = (unsigned)atoi( argv[++i] );
+    }
+    else
+    {
+      break;
+    }
+  }
+
+  if ( i != argc - 1 )
+  {
+    fprintf( stderr, "usage: heap_trace [-w workload] [-n rows] trace\n" );
+    return 2;
+  }
+
+  if ( heapTraceLoad( argv[i] ) != 0 )
+  {
+    return 1;
+  }
+  if ( traceCnt == 0 )
+  {
+    fprintf( stderr, "heap_trace: no records in %s\n", argv[i] );
+    return 1;
+  }
+
+  if ( workName != NULL )
+  {
+    fpWork = fopen( workName, "w" );
+    if ( fpWork == NULL )
+    {
+      fprintf( stderr, "heap_trace: cannot write %s\n", workName );
+      return 1;
+    }
+  }
+
+  heapTraceReport( rows, fpWork );
+
+  if ( fpWork != NULL )
+  {
+    fclose( fpWork );
+  }
+  free( traceRecs );
+
+  return 0;
+}
+
+/*********************************************************************
+*********************************************************************/
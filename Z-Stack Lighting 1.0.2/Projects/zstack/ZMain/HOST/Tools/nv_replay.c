@@ -0,0 +1,376 @@
+/**************************************************************************************************
+  Filename:       nv_replay.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Replay of an NV write trace, projecting the NV page lifetime.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * This tool replays a recorded trace of osal_nv_write() calls through
+ * the NV engine on the simulated flash, built with OSAL_NV_STATS, and
+ * reports the flash bytes written per hour, the page erases and the
+ * projected lifetime of the NV pages. Build it for the number of pages
+ * to evaluate: make tools NV_PAGES=<OSAL_NV_PAGES_USED>.
+ *
+ * Input: one write per line - the time in milliseconds, the item Id in
+ * hex, the offset and the length. Blank lines and lines starting with
+ * '#' are skipped. Each item is created with the largest offset plus
+ * length written to it, before the statistics are cleared.
+ *
+ * Usage: nv_replay [-r repeats] trace
+ *   -r  replay the trace this many times back to back (default 1); a
+ *       short trace may end before any page is erased
+ */
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ZComDef.h"
+#include "hal_board_cfg.h"
+#include "hal_drivers.h"
+#include "hal_sim.h"
+#include "OSAL.h"
+#include "OSAL_Nv.h"
+#include "OSAL_Tasks.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define NV_REPLAY_ITEMS            256
+#define NV_REPLAY_LEN_MAX          1024
+
+// Longest step of the virtual clock, within the 32-bit microseconds of halSimClockAdvance()
+#define NV_REPLAY_STEP_MS          1000000UL
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+typedef struct
+{
+  uint32 ms;
+  uint16 id;
+  uint16 offset;
+  uint16 len;
+} nvReplayRec_t;
+
+typedef struct
+{
+  uint16 id;
+  uint16 len;
+} nvReplayItem_t;
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+const pTaskEventHandlerFn tasksArr[] = {
+  Hal_ProcessEvent
+};
+
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt);
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt));
+
+  Hal_Init( 0 );
+}
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static nvReplayRec_t *replayRecs;
+static size_t replayCnt;
+
+static nvReplayItem_t replayItems[NV_REPLAY_ITEMS];
+static uint16 replayItemCnt;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+/*********************************************************************
+ * @fn      nvReplayRead
+ *
+ * @brief   Read the trace and size the items written in it.
+ *
+ * @param   fp - trace file
+ * @param   name - trace file name, for the errors
+ *
+ * @return  0 when the trace was read, -1 for a bad trace
+ */
+static int nvReplayRead( FILE *fp, const char *name )
+{
+  char line[128];
+  unsigned lineNum = 0;
+  size_t size = 0;
+
+  while ( fgets( line, sizeof( line ), fp ) != NULL )
+  {
+    unsigned long ms;
+    unsigned id, offset, len;
+    char *pLine = line;
+    uint16 idx;
+
+    lineNum++;
+    while ( (*pLine == ' ') || (*pLine == '\t') )
+    {
+      pLine++;
+    }
+    if ( (*pLine == '\n') || (*pLine == '\r') || (*pLine == '\0') || (*pLine == '#') )
+    {
+      continue;
+    }
+
+    if ( (sscanf( pLine, "%lu %x %u %u", &ms, &id, &offset, &len ) != 4) ||
+         (id == 0) || (id >= 0xFFFF) || (len == 0) || ((offset + len) > NV_REPLAY_LEN_MAX) ||
+         ((replayCnt != 0) && (ms < replayRecs[replayCnt - 1].ms)) )
+    {
+      fprintf( stderr, "nv_replay: %s:%u: not a write in time order\n", name, lineNum );
+      return -1;
+    }
+
+    if ( replayCnt == size )
+    {
+      size = (size == 0) ? 1024 : (size * 2);
+      replayRecs = realloc( replayRecs, size * sizeof( nvReplayRec_t ) );
+      if ( replayRecs == NULL )
+      {
+        fprintf( stderr, "nv_replay: out of memory\n" );
+        return -1;
+      }
+    }
+    replayRecs[replayCnt].ms = (uint32)ms;
+    replayRecs[replayCnt].id = (uint16)id;
+    replayRecs[replayCnt].offset = (uint16)offset;
+    replayRecs[replayCnt].len = (uint16)len;
+    replayCnt++;
+
+    for ( idx = 0; idx < replayItemCnt; idx++ )
+    {
+      if ( replayItems[idx].id == id )
+      {
+        break;
+      }
+    }
+    if ( idx == replayItemCnt )
+    {
+      if ( replayItemCnt == NV_REPLAY_ITEMS )
+      {
+        fprintf( stderr, "nv_replay: %s:%u: more than %u items\n", name, lineNum, NV_REPLAY_ITEMS );
+        return -1;
+      }
+      replayItems[replayItemCnt].id = (uint16)id;
+      replayItems[replayItemCnt].len = 0;
+      replayItemCnt++;
+    }
+    if ( replayItems[idx].len < (offset + len) )
+    {
+      replayItems[idx].len = (uint16)(offset + len);
+    }
+  }
+
+  return 0;
+}
+
+/*********************************************************************
+ * @fn      nvReplayClock
+ *
+ * @brief   Run the virtual clock on to the time of a write, letting OSAL
+ *          see it so that osal_GetSystemClock() follows.
+ *
+ * @param   ms - virtual milliseconds to run
+ *
+ * @return  none
+ */
+static void nvReplayClock( uint32 ms )
+{
+  while ( ms != 0 )
+  {
+    uint32 step = (ms > NV_REPLAY_STEP_MS) ? NV_REPLAY_STEP_MS : ms;
+
+    halSimClockAdvance( step * 1000 );
+    osal_run_system();
+    ms -= step;
+  }
+}
+
+/*********************************************************************
+ * @fn      main
+ */
+int main( int argc, char **argv )
+{
+  static uint8 buf[NV_REPLAY_LEN_MAX];
+  osalNvStats_t stats;
+  osalNvPageStats_t page;
+  uint32 repeats = 1, rep, writes, failed = 0;
+  uint32 last = 0;
+  uint16 id;
+  size_t cnt;
+  uint8 idx;
+  FILE *fp;
+  int i;
+
+  for ( i = 1; (i < argc - 1) && (argv[i][0] == '-'); i++ )
+  {
+    if ( (strcmp( argv[i], "-r" ) == 0) && (i < argc - 2) )
+    {
+      repeats = strtoul( argv[++i], NULL, 0 );
+    }
+    else
+    {
+      break;
+    }
+  }
+
+  if ( (i != argc - 1) || (repeats == 0) )
+  {
+    fprintf( stderr, "usage: nv_replay [-r repeats] trace\n" );
+    return 2;
+  }
+
+  fp = fopen( argv[i], "r" );
+  if ( fp == NULL )
+  {
+    fprintf( stderr, "nv_replay: cannot read %s\n", argv[i] );
+    return 1;
+  }
+  if ( nvReplayRead( fp, argv[i] ) < 0 )
+  {
+    fclose( fp );
+    return 1;
+  }
+  fclose( fp );
+
+  if ( replayCnt == 0 )
+  {
+    fprintf( stderr, "nv_replay: %s holds no writes\n", argv[i] );
+    return 1;
+  }
+
+  hostTestBoot();
+  osal_nv_init( NULL );
+
+  for ( id = 0; id < replayItemCnt; id++ )
+  {
+    if ( osal_nv_item_init( replayItems[id].id, replayItems[id].len, NULL ) == NV_OPER_FAILED )
+    {
+      fprintf( stderr, "nv_replay: the items do not fit in %u pages\n", HAL_NV_PAGE_CNT );
+      return 1;
+    }
+  }
+  osal_nv_stats_reset();
+
+  /* Replay the trace back to back, the next pass starting one mean write interval after the
+   * last write of the previous one; the data of each write differs from the last.
+   */
+  for ( rep = 0; rep < repeats; rep++ )
+  {
+    uint32 start = replayRecs[0].ms;
+    uint32 gap = (replayRecs[replayCnt - 1].ms - start) / replayCnt;
+
+    for ( cnt = 0; cnt < replayCnt; cnt++ )
+    {
+      const nvReplayRec_t *pRec = &replayRecs[cnt];
+      uint32 now = pRec->ms - start;
+
+      if ( rep != 0 )
+      {
+        now += gap;
+      }
+      nvReplayClock( (cnt == 0) ? now : (now - last) );
+      last = now;
+
+      osal_memset( buf, (uint8)(rep * replayCnt + cnt), pRec->len );
+      if ( osal_nv_write( pRec->id, pRec->offset, pRec->len, buf ) != SUCCESS )
+      {
+        failed++;
+      }
+    }
+  }
+
+  osal_nv_stats_get( &stats );
+
+  printf( "%lu writes of %u items, %lu replays, %u NV pages\n",
+          (unsigned long)(replayCnt * repeats), replayItemCnt, (unsigned long)repeats,
+          HAL_NV_PAGE_CNT );
+  printf( "flash bytes written   %lu (%lu per hour)\n",
+          (unsigned long)stats.bytes, (unsigned long)stats.bytesPerHour );
+  printf( "page erases           %u\n\n", stats.erases );
+
+  printf( "page  erases  free  lost\n" );
+  for ( idx = 0; osal_nv_page_stats_get( idx, &page ) == SUCCESS; idx++ )
+  {
+    printf( "%4u  %6u  %4u  %4u\n", idx, page.erases, page.free, page.lost );
+  }
+
+  printf( "\nitem    writes (sampled)\n" );
+  for ( idx = 0; osal_nv_item_stats_get( idx, &id, &writes ) == SUCCESS; idx++ )
+  {
+    printf( "%04X  %8lu\n", id, (unsigned long)writes );
+  }
+
+  if ( stats.lifeHours == OSAL_NV_LIFE_UNKNOWN )
+  {
+    printf( "\nno page erased - replay the trace more times (-r) to project the lifetime\n" );
+  }
+  else
+  {
+    printf( "\nprojected lifetime    %lu hours (%.1f years)\n",
+            (unsigned long)stats.lifeHours, stats.lifeHours / (24.0 * 365) );
+  }
+
+  if ( failed != 0 )
+  {
+    printf( "%lu writes failed\n", (unsigned long)failed );
+    return 1;
+  }
+
+  return 0;
+}
+
+/*********************************************************************
+*********************************************************************/
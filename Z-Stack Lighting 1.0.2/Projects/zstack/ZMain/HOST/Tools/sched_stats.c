@@ -0,0 +1,280 @@
+/**************************************************************************************************
+  Filename:       sched_stats.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Report of the OSAL scheduler statistics read over MT.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * This tool reports the OSAL scheduler statistics read with
+ * MT_SYS_SCHED_STATS (see MT_SysSchedStats() in MT_SYS.c): for each task
+ * and each event of the watched task, the number of runs, the average
+ * and longest run, and the average and longest wait from the event set
+ * to the run. Rows whose longest run or wait is over the deadline are
+ * marked with '!' - the handler to look at when a response is late.
+ *
+ * Input: one read per line, as hex bytes - the TaskId and EventBit of
+ * the request, then the data field of the SRSP. Blank lines and lines
+ * starting with '#' are skipped.
+ *
+ * Usage: sched_stats [-t usec] [-d msec] stats
+ *   -t  microseconds per tick of OSAL_SCHED_TIME() (default 320)
+ *   -d  deadline in milliseconds (default none)
+ */
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include <ctype.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// TaskId, EventBit and the SRSP data
+#define SCHED_STATS_LINE_LEN       19
+
+#define SCHED_STATS_TASK           0xFF
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+typedef struct
+{
+  uint8_t  taskId;
+  uint8_t  eventBit;
+  uint8_t  status;
+  uint32_t runCnt;
+  uint32_t runTotal;
+  uint16_t runMax;
+  uint32_t waitTotal;
+  uint16_t waitMax;
+} schedStatsRec_t;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+static uint32_t schedStatsUint32( const uint8_t *pBuf )
+{
+  return ( pBuf[0] | (pBuf[1] << 8) | ((uint32_t)pBuf[2] << 16) | ((uint32_t)pBuf[3] << 24) );
+}
+
+/*********************************************************************
+ * @fn      schedStatsParse
+ *
+ * @brief   Decode one line of hex bytes into a statistics record.
+ *
+ * @param   line - text of the line
+ * @param   pRec - record to fill in
+ *
+ * @return  1 for a record, 0 for a line to skip, -1 for a bad line
+ */
+static int schedStatsParse( const char *line, schedStatsRec_t *pRec )
+{
+  uint8_t buf[SCHED_STATS_LINE_LEN];
+  size_t len = 0;
+  unsigned byte;
+  int n;
+
+  while ( isspace( (unsigned char)*line ) )
+  {
+    line++;
+  }
+  if ( (*line == '\0') || (*line == '#') )
+  {
+    return 0;
+  }
+
+  while ( *line != '\0' )
+  {
+    if ( isspace( (unsigned char)*line ) )
+    {
+      line++;
+    }
+    else if ( (len < sizeof( buf )) && (sscanf( line, "%2x%n", &byte, &n ) == 1) && (n == 2) )
+    {
+      buf[len++] = (uint8_t)byte;
+      line += 2;
+    }
+    else
+    {
+      return -1;
+    }
+  }
+
+  if ( len != SCHED_STATS_LINE_LEN )
+  {
+    return -1;
+  }
+
+  pRec->taskId = buf[0];
+  pRec->eventBit = buf[1];
+  pRec->status = buf[2];
+  pRec->runCnt = schedStatsUint32( buf + 3 );
+  pRec->runTotal = schedStatsUint32( buf + 7 );
+  pRec->runMax = buf[11] | (buf[12] << 8);
+  pRec->waitTotal = schedStatsUint32( buf + 13 );
+  pRec->waitMax = buf[17] | (buf[18] << 8);
+
+  return 1;
+}
+
+/*********************************************************************
+ * @fn      schedStatsPrint
+ *
+ * @brief   Print one row of the report.
+ *
+ * @param   pRec - statistics
+ * @param   tick - microseconds per tick
+ * @param   deadline - deadline in microseconds, 0 for none
+ *
+ * @return  1 if the row is over the deadline
+ */
+static int schedStatsPrint( const schedStatsRec_t *pRec, double tick, double deadline )
+{
+  double runMax = pRec->runMax * tick;
+  double waitMax = pRec->waitMax * tick;
+  int late = (deadline > 0) && ((runMax > deadline) || (waitMax > deadline));
+  char event[8];
+
+  if ( pRec->eventBit == SCHED_STATS_TASK )
+  {
+    strcpy( event, "all" );
+  }
+  else
+  {
+    sprintf( event, "0x%04X", (1u << (pRec->eventBit & 0x0F)) );
+  }
+
+  if ( pRec->status != 0 )
+  {
+    printf( "%4u  %-6s  status 0x%02X\n", pRec->taskId, event, pRec->status );
+    return 0;
+  }
+
+  printf( "%4u  %-6s  %8lu  %10.1f  %10.1f",
+          pRec->taskId, event, (unsigned long)pRec->runCnt,
+          pRec->runCnt ? (pRec->runTotal * tick / pRec->runCnt) : 0.0, runMax );
+
+  // There is no wait time per event
+  if ( pRec->eventBit == SCHED_STATS_TASK )
+  {
+    printf( "  %11.1f  %11.1f",
+            pRec->runCnt ? (pRec->waitTotal * tick / pRec->runCnt) : 0.0, waitMax );
+  }
+
+  printf( "%s\n", late ? "  !" : "" );
+
+  return late;
+}
+
+/*********************************************************************
+ * @fn      main
+ */
+int main( int argc, char **argv )
+{
+  double tick = 320;
+  double deadline = 0;
+  char line[256];
+  unsigned lineNum = 0;
+  unsigned late = 0;
+  FILE *fp;
+  int i;
+
+  for ( i = 1; (i < argc - 1) && (argv[i][0] == '-'); i++ )
+  {
+    if ( (strcmp( argv[i], "-t" ) == 0) && (i < argc - 2) )
+    {
+      tick = atof( argv[++i] );
+    }
+    else if ( (strcmp( argv[i], "-d" ) == 0) && (i < argc - 2) )
+    {
+      deadline = atof( argv[++i] ) * 1000;
+    }
+    else
+    {
+      break;
+    }
+  }
+
+  if ( i != argc - 1 )
+  {
+    fprintf( stderr, "usage: sched_stats [-t usec] [-d msec] stats\n" );
+    return 2;
+  }
+
+  fp = fopen( argv[i], "r" );
+  if ( fp == NULL )
+  {
+    fprintf( stderr, "sched_stats: cannot read %s\n", argv[i] );
+    return 1;
+  }
+
+  printf( "task  event       runs  run avg us  run max us  wait avg us  wait max us\n" );
+  while ( fgets( line, sizeof( line ), fp ) != NULL )
+  {
+    schedStatsRec_t rec;
+    int rtrn;
+
+    lineNum++;
+    rtrn = schedStatsParse( line, &rec );
+    if ( rtrn < 0 )
+    {
+      fprintf( stderr, "sched_stats: %s:%u: not a scheduler statistics read\n", argv[i], lineNum );
+    }
+    else if ( rtrn > 0 )
+    {
+      late += schedStatsPrint( &rec, tick, deadline );
+    }
+  }
+  fclose( fp );
+
+  if ( deadline > 0 )
+  {
+    printf( "%u over the %.1f ms deadline (!)\n", late, deadline / 1000 );
+  }
+
+  return 0;
+}
+
+/*********************************************************************
+*********************************************************************/
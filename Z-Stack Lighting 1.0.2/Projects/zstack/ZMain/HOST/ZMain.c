@@ -0,0 +1,97 @@
+/**************************************************************************************************
+  Filename:       ZMain.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Startup and shutdown code for the OSAL host (x86-64 Linux) simulation.
+
+
+  Copyright 2012 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include "hal_drivers.h"
+#include "hal_sim.h"
+#include "OnBoard.h"
+#include "OSAL.h"
+#include "ZComDef.h"
+
+/*********************************************************************
+ * @fn      main
+ * @brief   First function called after startup.
+ *
+ *          The task table (tasksArr, tasksCnt and osalInitTasks) is
+ *          supplied by the OSAL_*.c file linked with the simulation.
+ *          When HAL_SIM_RUN_MSEC is defined the loop stops once the
+ *          virtual clock reaches that many milliseconds.
+ *
+ * @return  don't care
+ */
+int main( void )
+{
+  // Turn off interrupts
+  osal_int_disable( INTS_ALL );
+
+  // Reset the virtual clock
+  HAL_BOARD_INIT();
+
+  // Initialize board I/O
+  InitBoard( OB_COLD );
+
+  // Initialze HAL drivers
+  HalDriverInit();
+
+  // Initialize the operating system
+  osal_init_system();
+
+  // Allow interrupts
+  osal_int_enable( INTS_ALL );
+
+  // Final board initialization
+  InitBoard( OB_READY );
+
+#if defined HAL_SIM_RUN_MSEC
+  while ( halSimClockMs() < HAL_SIM_RUN_MSEC )
+  {
+    osal_run_system();
+  }
+#else
+  osal_start_system(); // No Return from here
+#endif
+
+  return 0;
+} // main()
+
+/*********************************************************************
+*********************************************************************/
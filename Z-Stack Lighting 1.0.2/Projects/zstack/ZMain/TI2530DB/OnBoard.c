@@ -392,6 +392,7 @@ void Onboard_wait( uint16 timeout )
  *********************************************************************/
 __near_func void Onboard_soft_reset( void )
 {
+  OSAL_NV_FLUSH();
   HAL_DISABLE_INTERRUPTS();
   // Abort all DMA channels to insure that ongoing operations do not
   // interfere with re-configuration.
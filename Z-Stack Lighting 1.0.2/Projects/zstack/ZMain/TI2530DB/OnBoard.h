@@ -54,6 +54,7 @@ extern "C"
 #include "hal_uart.h"
 #include "hal_sleep.h"
 #include "osal.h"
+#include "OSAL_Nv.h"
 
 /*********************************************************************
  * GLOBAL VARIABLES
@@ -177,6 +178,7 @@ extern uint8 aExtendedAddress[8];
 // Disables interrupts, forces WatchDog reset
 #define SystemReset()       \
 {                           \
+  OSAL_NV_FLUSH();          \
   HAL_DISABLE_INTERRUPTS(); \
   HAL_SYSTEM_RESET();       \
 }